@@ -0,0 +1,507 @@
+#ifndef ALGEBRA_DECOMPOSITIONS_3_3_HPP
+#define ALGEBRA_DECOMPOSITIONS_3_3_HPP
+
+#include "algebra/matrix.hpp"
+#include "algebra/vector.hpp"
+#include "algebra/trigonometry.hpp"
+#include "parallel/execution.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace algebra
+{
+
+namespace impl
+{
+
+/// \ingroup algebra
+/// \brief It implements the decompositions of 3x3 matrices on plain arrays, the rows of the matrices being the first
+///		index.
+/// \tparam U the type of the elements. It must be float or double.
+template< typename U>
+struct decompositions_3_3
+{
+	static void cross( const U* a, const U* b, U* r)
+	{
+		r[0] = a[1]*b[2] - a[2]*b[1];
+		r[1] = a[2]*b[0] - a[0]*b[2];
+		r[2] = a[0]*b[1] - a[1]*b[0];
+	}
+
+	static U dot( const U* a, const U* b) { return a[0]*b[0] + a[1]*b[1] + a[2]*b[2]; }
+
+	/// \brief It calculates the unit eigenvector of a simple eigenvalue, as the largest cross product of the rows of
+	///		<c>A - eigenvalue * I</c>.
+	static void eigenvector0( const U a[3][3], const U& eigenvalue, U* evec)
+	{
+		const U row0[3] = { a[0][0] - eigenvalue, a[0][1], a[0][2] };
+		const U row1[3] = { a[0][1], a[1][1] - eigenvalue, a[1][2] };
+		const U row2[3] = { a[0][2], a[1][2], a[2][2] - eigenvalue };
+		U r[3][3];
+		cross( row0, row1, r[0]);
+		cross( row0, row2, r[1]);
+		cross( row1, row2, r[2]);
+		const U d[3] = { dot( r[0], r[0]), dot( r[1], r[1]), dot( r[2], r[2]) };
+		const unsigned best = d[0] >= d[1] ? (d[0] >= d[2] ? 0 : 2) : (d[1] >= d[2] ? 1 : 2);
+		const U inv_length = U( 1) / std::sqrt( d[best]);
+		evec[0] = r[best][0] * inv_length;
+		evec[1] = r[best][1] * inv_length;
+		evec[2] = r[best][2] * inv_length;
+	}
+
+	/// \brief It calculates two unit vectors which make a right handed orthonormal basis with the given unit vector.
+	static void orthogonal_complement( const U* w, U* u, U* v)
+	{
+		if( std::abs( w[0]) > std::abs( w[1]))
+		{
+			const U inv_length = U( 1) / std::sqrt( w[0]*w[0] + w[2]*w[2]);
+			u[0] = -w[2] * inv_length; u[1] = 0; u[2] = w[0] * inv_length;
+		}
+		else
+		{
+			const U inv_length = U( 1) / std::sqrt( w[1]*w[1] + w[2]*w[2]);
+			u[0] = 0; u[1] = w[2] * inv_length; u[2] = -w[1] * inv_length;
+		}
+		cross( w, u, v);
+	}
+
+	/// \brief It calculates the unit eigenvector of the second eigenvalue, in the plane orthogonal to the eigenvector
+	///		of the first one. It works even when the two remaining eigenvalues are equal.
+	static void eigenvector1( const U a[3][3], const U* evec0, const U& eigenvalue, U* evec)
+	{
+		U u[3], v[3], au[3], av[3];
+		orthogonal_complement( evec0, u, v);
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			au[r] = a[r][0]*u[0] + a[r][1]*u[1] + a[r][2]*u[2];
+			av[r] = a[r][0]*v[0] + a[r][1]*v[1] + a[r][2]*v[2];
+		}
+		U m00 = dot( u, au) - eigenvalue, m01 = dot( u, av), m11 = dot( v, av) - eigenvalue;
+		const U abs00 = std::abs( m00), abs01 = std::abs( m01), abs11 = std::abs( m11);
+		U cu = 1, cv = 0;
+		if( abs00 >= abs11)
+		{
+			if( std::max( abs00, abs01) > 0)
+			{
+				if( abs00 >= abs01)
+				{
+					m01 /= m00; m00 = U( 1) / std::sqrt( 1 + m01*m01); m01 *= m00;
+				}
+				else
+				{
+					m00 /= m01; m01 = U( 1) / std::sqrt( 1 + m00*m00); m00 *= m01;
+				}
+				cu = m01; cv = -m00;
+			}
+		}
+		else
+		{
+			if( std::max( abs11, abs01) > 0)
+			{
+				if( abs11 >= abs01)
+				{
+					m01 /= m11; m11 = U( 1) / std::sqrt( 1 + m01*m01); m01 *= m11;
+				}
+				else
+				{
+					m11 /= m01; m01 = U( 1) / std::sqrt( 1 + m11*m11); m11 *= m01;
+				}
+				cu = m11; cv = -m01;
+			}
+		}
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			evec[i] = cu*u[i] + cv*v[i];
+		}
+	}
+
+	/// \brief It applies a Jacobi rotation annihilating the element (p, q) of the symmetric matrix b, and accumulates
+	///		it in the columns of q_mat.
+	static void jacobi_rotate( U b[3][3], U q_mat[3][3], unsigned p, unsigned q)
+	{
+		const U bpq = b[p][q];
+		if( bpq == 0)
+		{
+			return;
+		}
+		const U theta = (b[q][q] - b[p][p]) / (2 * bpq);
+		const U t = (theta >= 0 ? U( 1) : U( -1)) / (std::abs( theta) + std::sqrt( theta*theta + 1));
+		const U c = U( 1) / std::sqrt( t*t + 1), s = t*c;
+		for( unsigned k = 0; k < 3; ++k)
+		{
+			const U bkp = b[k][p], bkq = b[k][q];
+			b[k][p] = c*bkp - s*bkq;
+			b[k][q] = s*bkp + c*bkq;
+		}
+		for( unsigned k = 0; k < 3; ++k)
+		{
+			const U bpk = b[p][k], bqk = b[q][k];
+			b[p][k] = c*bpk - s*bqk;
+			b[q][k] = s*bpk + c*bqk;
+		}
+		for( unsigned k = 0; k < 3; ++k)
+		{
+			const U qkp = q_mat[k][p], qkq = q_mat[k][q];
+			q_mat[k][p] = c*qkp - s*qkq;
+			q_mat[k][q] = s*qkp + c*qkq;
+		}
+	}
+
+	/// \brief It calculates the eigenvalues, in increasing order, and the eigenvectors (the columns of evecs, making a
+	///		rotation) of the symmetric matrix a. Only the upper triangle of the matrix is used.
+	static void symmetric_eigen( const U a_in[3][3], U* evals, U evecs[3][3])
+	{
+		// Scaling avoids the overflow of the cubes and keeps the relative precision.
+		const U max_abs = std::max( std::max( std::max( std::abs( a_in[0][0]), std::abs( a_in[0][1])),
+			std::max( std::abs( a_in[0][2]), std::abs( a_in[1][1]))),
+			std::max( std::abs( a_in[1][2]), std::abs( a_in[2][2])));
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				evecs[r][c] = r == c ? U( 1) : U( 0);
+			}
+		}
+		if( max_abs == 0)
+		{
+			evals[0] = evals[1] = evals[2] = 0;
+			return;
+		}
+		const U inv_max = U( 1) / max_abs;
+		U a[3][3];
+		a[0][0] = a_in[0][0]*inv_max; a[0][1] = a_in[0][1]*inv_max; a[0][2] = a_in[0][2]*inv_max;
+		a[1][1] = a_in[1][1]*inv_max; a[1][2] = a_in[1][2]*inv_max; a[2][2] = a_in[2][2]*inv_max;
+		a[1][0] = a[0][1]; a[2][0] = a[0][2]; a[2][1] = a[1][2];
+
+		const U q = (a[0][0] + a[1][1] + a[2][2]) / 3;
+		const U b00 = a[0][0] - q, b11 = a[1][1] - q, b22 = a[2][2] - q;
+		const U off = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+		const U p = std::sqrt( (b00*b00 + b11*b11 + b22*b22 + 2*off) / 6);
+		if( p == 0)
+		{
+			evals[0] = evals[1] = evals[2] = q * max_abs;
+			return;
+		}
+		const U c00 = b11*b22 - a[1][2]*a[1][2];
+		const U c01 = a[0][1]*b22 - a[1][2]*a[0][2];
+		const U c02 = a[0][1]*a[1][2] - b11*a[0][2];
+		const U half_det = std::min( std::max( (b00*c00 - a[0][1]*c01 + a[0][2]*c02) / (2*p*p*p), U( -1)), U( 1));
+		// The roots of the characteristic polynomial: 2 cos( angle + 2 k pi/3).
+		U sin_angle, cos_angle;
+		sincos( std::acos( half_det) / 3, sin_angle, cos_angle);
+		const U sqrt3 = U( 1.73205080756887729353);
+		const U beta2 = 2 * cos_angle;
+		const U beta0 = -cos_angle - sqrt3 * sin_angle;
+		const U beta1 = -(beta0 + beta2);
+		evals[0] = q + p*beta0;
+		evals[1] = q + p*beta1;
+		evals[2] = q + p*beta2;
+
+		// The eigenvector of the eigenvalue farthest from the other two is calculated first.
+		U v0[3], v1[3], v2[3];
+		if( half_det >= 0)
+		{
+			eigenvector0( a, evals[2], v2);
+			eigenvector1( a, v2, evals[1], v1);
+			cross( v1, v2, v0);
+		}
+		else
+		{
+			eigenvector0( a, evals[0], v0);
+			eigenvector1( a, v0, evals[1], v1);
+			cross( v0, v1, v2);
+		}
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			evecs[r][0] = v0[r];
+			evecs[r][1] = v1[r];
+			evecs[r][2] = v2[r];
+		}
+
+		// Refinement: one Jacobi sweep on the matrix expressed in the eigenvector basis, which is almost diagonal.
+		U b[3][3], t[3][3];
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				t[r][c] = a[r][0]*evecs[0][c] + a[r][1]*evecs[1][c] + a[r][2]*evecs[2][c];
+			}
+		}
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				b[r][c] = evecs[0][r]*t[0][c] + evecs[1][r]*t[1][c] + evecs[2][r]*t[2][c];
+			}
+		}
+		jacobi_rotate( b, evecs, 0, 1);
+		jacobi_rotate( b, evecs, 0, 2);
+		jacobi_rotate( b, evecs, 1, 2);
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			evals[i] = b[i][i] * max_abs;
+		}
+		// The sweep may swap nearly equal eigenvalues.
+		if( evals[0] > evals[1])
+		{
+			swap_eigenpairs( evals, evecs, 0, 1);
+		}
+		if( evals[1] > evals[2])
+		{
+			swap_eigenpairs( evals, evecs, 1, 2);
+		}
+		if( evals[0] > evals[1])
+		{
+			swap_eigenpairs( evals, evecs, 0, 1);
+		}
+	}
+
+	/// \brief It swaps two eigenvalues and their eigenvectors. One of the eigenvectors is negated, so the eigenvectors
+	///		still make a rotation.
+	static void swap_eigenpairs( U* evals, U evecs[3][3], unsigned i, unsigned j)
+	{
+		std::swap( evals[i], evals[j]);
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			const U vi = evecs[r][i];
+			evecs[r][i] = evecs[r][j];
+			evecs[r][j] = -vi;
+		}
+	}
+
+	/// \brief It applies a Givens rotation on the rows p and q of b, annihilating the element (q, k), and accumulates
+	///		its transpose in the columns of u.
+	static void givens_rotate( U b[3][3], U u[3][3], unsigned p, unsigned q, unsigned k)
+	{
+		const U x = b[p][k], y = b[q][k];
+		const U r = std::sqrt( x*x + y*y);
+		if( r == 0)
+		{
+			return;
+		}
+		const U c = x / r, s = y / r;
+		for( unsigned j = 0; j < 3; ++j)
+		{
+			const U bp = b[p][j], bq = b[q][j];
+			b[p][j] = c*bp + s*bq;
+			b[q][j] = c*bq - s*bp;
+			const U up = u[j][p], uq = u[j][q];
+			u[j][p] = c*up + s*uq;
+			u[j][q] = c*uq - s*up;
+		}
+	}
+
+	/// \brief It calculates the singular value decomposition <c>A = U * diag( sigma) * V^T</c>, with U and V rotations
+	///		and the singular values in decreasing order of their absolute value. The last singular value is negative
+	///		when the determinant of A is negative.
+	static void svd( const U a[3][3], U u[3][3], U* sigma, U v[3][3])
+	{
+		// The right singular vectors are the eigenvectors of A^T * A.
+		U ata[3][3], evals[3], evecs[3][3];
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				ata[r][c] = a[0][r]*a[0][c] + a[1][r]*a[1][c] + a[2][r]*a[2][c];
+			}
+		}
+		symmetric_eigen( ata, evals, evecs);
+		// Decreasing order; the middle column is negated for keeping a rotation.
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			v[r][0] = evecs[r][2];
+			v[r][1] = -evecs[r][1];
+			v[r][2] = evecs[r][0];
+		}
+
+		// B = A * V has orthogonal columns; its QR decomposition gives U and the singular values.
+		U b[3][3];
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				b[r][c] = a[r][0]*v[0][c] + a[r][1]*v[1][c] + a[r][2]*v[2][c];
+				u[r][c] = r == c ? U( 1) : U( 0);
+			}
+		}
+		givens_rotate( b, u, 0, 1, 0);
+		givens_rotate( b, u, 0, 2, 0);
+		givens_rotate( b, u, 1, 2, 1);
+		sigma[0] = b[0][0];
+		sigma[1] = b[1][1];
+		sigma[2] = b[2][2];
+	}
+};
+
+/// \brief It copies a 3x3 matrix to a plain array.
+template< typename U, typename UT>
+void to_array( const matrix< 3, 3, U, UT>& m, U a[3][3])
+{
+	for( unsigned r = 0; r < 3; ++r)
+	{
+		for( unsigned c = 0; c < 3; ++c)
+		{
+			a[r][c] = m( r, c);
+		}
+	}
+}
+
+} // namespace impl
+
+/// \ingroup algebra
+/// \brief It calculates the eigenvalues and the eigenvectors of a symmetric 3x3 matrix.
+/// \tparam U the type of the elements. It must be float or double.
+/// \param m the symmetric matrix. Only its upper triangle is used.
+/// \param[out] eigenvalues the eigenvalues, in increasing order.
+/// \param[out] eigenvectors the matrix having as columns the unit eigenvectors, in the order of the eigenvalues. It is
+///		a rotation matrix (its determinant is 1).
+/// \details
+///		The eigenvalues are the roots of the characteristic polynomial, calculated in closed form. The eigenvector of
+///		the eigenvalue which is farthest from the other two is calculated from cross products, and the second one
+///		is calculated in the plane orthogonal to it, so the vectors are orthogonal even for repeated eigenvalues.
+///		The result is refined by a single Jacobi sweep. There are no iterations, so the cost is the same for all the
+///		matrices.
+/// \sa D. Eberly, "A Robust Eigensolver for 3x3 Symmetric Matrices", Geometric Tools, 2014.
+template< typename U, typename UT>
+void symmetric_eigen( const matrix< 3, 3, U, UT>& m, vector< 3, U, UT>& eigenvalues, matrix< 3, 3, U, UT>& eigenvectors)
+{
+	U a[3][3], evals[3], evecs[3][3];
+	impl::to_array( m, a);
+	impl::decompositions_3_3< U>::symmetric_eigen( a, evals, evecs);
+	eigenvalues = vector< 3, U, UT>( evals[0], evals[1], evals[2]);
+	eigenvectors = matrix< 3, 3, U, UT>( &evecs[0][0]);
+}
+
+/// \ingroup algebra
+/// \brief It calculates the eigenvalues and the eigenvectors of an array of symmetric 3x3 matrices.
+/// \param m the symmetric matrices.
+/// \param count the number of matrices.
+/// \param[out] eigenvalues the buffer receiving the eigenvalues of each matrix.
+/// \param[out] eigenvectors the buffer receiving the eigenvectors of each matrix.
+/// \copydetails symmetric_eigen( const matrix< 3, 3, U, UT>&, vector< 3, U, UT>&, matrix< 3, 3, U, UT>&)
+template< typename U, typename UT>
+void symmetric_eigen( const matrix< 3, 3, U, UT>* m, std::size_t count,
+	vector< 3, U, UT>* eigenvalues, matrix< 3, 3, U, UT>* eigenvectors)
+{
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		symmetric_eigen( m[i], eigenvalues[i], eigenvectors[i]);
+	}
+}
+
+/// \ingroup algebra
+/// \brief It calculates the singular value decomposition of a 3x3 matrix: <c>m = u * diag( sigma) * transposed( v)
+///		</c>.
+/// \tparam U the type of the elements. It must be float or double.
+/// \param m the decomposed matrix.
+/// \param[out] u the left singular vectors, as columns. It is a rotation matrix.
+/// \param[out] sigma the singular values, in decreasing order of their absolute values. The last one is negative if
+///		the determinant of \c m is negative, so that both \c u and \c v are rotations.
+/// \param[out] v the right singular vectors, as columns. It is a rotation matrix.
+/// \details
+///		The right singular vectors are calculated by symmetric_eigen() on <c>transposed( m) * m</c>. Then the product
+///		<c>m * v</c>, having orthogonal columns sorted by decreasing norm, is reduced to diagonal form by three Givens
+///		rotations, which make \c u. The signed singular values are the form of the decomposition needed for extracting
+///		rotations, e.g. for the Kabsch alignment and the polar decomposition.
+/// \sa A. McAdams et al., "Computing the Singular Value Decomposition of 3x3 matrices with minimal branching and
+///		elementary floating point operations", University of Wisconsin-Madison technical report 1690, 2011.
+template< typename U, typename UT>
+void svd( const matrix< 3, 3, U, UT>& m, matrix< 3, 3, U, UT>& u, vector< 3, U, UT>& sigma, matrix< 3, 3, U, UT>& v)
+{
+	U a[3][3], ua[3][3], s[3], va[3][3];
+	impl::to_array( m, a);
+	impl::decompositions_3_3< U>::svd( a, ua, s, va);
+	u = matrix< 3, 3, U, UT>( &ua[0][0]);
+	sigma = vector< 3, U, UT>( s[0], s[1], s[2]);
+	v = matrix< 3, 3, U, UT>( &va[0][0]);
+}
+
+/// \ingroup algebra
+/// \brief It calculates the singular value decompositions of an array of 3x3 matrices.
+/// \param m the decomposed matrices.
+/// \param count the number of matrices.
+/// \param[out] u the buffer receiving the left singular vectors of each matrix.
+/// \param[out] sigma the buffer receiving the singular values of each matrix.
+/// \param[out] v the buffer receiving the right singular vectors of each matrix.
+/// \copydetails svd( const matrix< 3, 3, U, UT>&, matrix< 3, 3, U, UT>&, vector< 3, U, UT>&, matrix< 3, 3, U, UT>&)
+template< typename U, typename UT>
+void svd( const matrix< 3, 3, U, UT>* m, std::size_t count,
+	matrix< 3, 3, U, UT>* u, vector< 3, U, UT>* sigma, matrix< 3, 3, U, UT>* v)
+{
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		svd( m[i], u[i], sigma[i], v[i]);
+	}
+}
+
+namespace impl
+{
+
+/// \ingroup algebra
+/// \brief The minimum number of decompositions processed by a parallel task.
+enum { DECOMPOSITIONS_3_3_MIN_GRAIN = 256 };
+
+/// \ingroup algebra
+/// \brief It calculates the eigen decompositions of a chunk of an array of symmetric matrices.
+template< typename U, typename UT>
+struct symmetric_eigen_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		algebra::symmetric_eigen( m + begin, end - begin, eigenvalues + begin, eigenvectors + begin);
+	}
+
+	const matrix< 3, 3, U, UT>* m;
+	vector< 3, U, UT>* eigenvalues;
+	matrix< 3, 3, U, UT>* eigenvectors;
+};
+
+/// \ingroup algebra
+/// \brief It calculates the singular value decompositions of a chunk of an array of matrices.
+template< typename U, typename UT>
+struct svd_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		algebra::svd( m + begin, end - begin, u + begin, sigma + begin, v + begin);
+	}
+
+	const matrix< 3, 3, U, UT>* m;
+	matrix< 3, 3, U, UT>* u;
+	vector< 3, U, UT>* sigma;
+	matrix< 3, 3, U, UT>* v;
+};
+
+} // namespace impl
+
+/// \ingroup algebra
+/// \brief It calculates the eigenvalues and the eigenvectors of an array of symmetric 3x3 matrices, as specified by
+///		the execution policy.
+/// \param policy the execution policy.
+/// \copydetails symmetric_eigen( const matrix< 3, 3, U, UT>*, std::size_t, vector< 3, U, UT>*, matrix< 3, 3, U, UT>*)
+template< typename P, typename U, typename UT>
+void symmetric_eigen( const P& policy, const matrix< 3, 3, U, UT>* m, std::size_t count,
+	vector< 3, U, UT>* eigenvalues, matrix< 3, 3, U, UT>* eigenvectors)
+{
+	impl::symmetric_eigen_chunk< U, UT> chunk = { m, eigenvalues, eigenvectors };
+	parallel::for_each_chunk( policy, 0, count, impl::DECOMPOSITIONS_3_3_MIN_GRAIN, chunk);
+}
+
+/// \ingroup algebra
+/// \brief It calculates the singular value decompositions of an array of 3x3 matrices, as specified by the execution
+///		policy.
+/// \param policy the execution policy.
+/// \copydetails svd( const matrix< 3, 3, U, UT>*, std::size_t, matrix< 3, 3, U, UT>*, vector< 3, U, UT>*,
+///		matrix< 3, 3, U, UT>*)
+template< typename P, typename U, typename UT>
+void svd( const P& policy, const matrix< 3, 3, U, UT>* m, std::size_t count,
+	matrix< 3, 3, U, UT>* u, vector< 3, U, UT>* sigma, matrix< 3, 3, U, UT>* v)
+{
+	impl::svd_chunk< U, UT> chunk = { m, u, sigma, v };
+	parallel::for_each_chunk( policy, 0, count, impl::DECOMPOSITIONS_3_3_MIN_GRAIN, chunk);
+}
+
+} // namespace algebra
+
+#endif // ALGEBRA_DECOMPOSITIONS_3_3_HPP
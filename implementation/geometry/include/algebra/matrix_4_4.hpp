@@ -257,6 +257,58 @@ public:
 		return *this;
 	}
 
+	/// \brief Matrix inversion.
+	/// \return the inverse matrix, as a new matrix. The original one remains untouched.
+	/// \details
+	///		It uses the cofactors expansion, with the 2x2 minors of the first two rows and of the last two rows computed 
+	///		only once. If the matrix is singular, the elements of the result are not valid numbers.
+	friend matrix inverted( const matrix& m)
+	{
+		const unit_type
+			s0 = m.a11_*m.a22_ - m.a21_*m.a12_,
+			s1 = m.a11_*m.a23_ - m.a21_*m.a13_,
+			s2 = m.a11_*m.a24_ - m.a21_*m.a14_,
+			s3 = m.a12_*m.a23_ - m.a22_*m.a13_,
+			s4 = m.a12_*m.a24_ - m.a22_*m.a14_,
+			s5 = m.a13_*m.a24_ - m.a23_*m.a14_,
+			c5 = m.a33_*m.a44_ - m.a43_*m.a34_,
+			c4 = m.a32_*m.a44_ - m.a42_*m.a34_,
+			c3 = m.a32_*m.a43_ - m.a42_*m.a33_,
+			c2 = m.a31_*m.a44_ - m.a41_*m.a34_,
+			c1 = m.a31_*m.a43_ - m.a41_*m.a33_,
+			c0 = m.a31_*m.a42_ - m.a41_*m.a32_;
+		const unit_type inv_det = unit_traits_type::one() / (s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0);
+
+		return matrix(
+			( m.a22_*c5 - m.a23_*c4 + m.a24_*c3) * inv_det,
+			(-m.a12_*c5 + m.a13_*c4 - m.a14_*c3) * inv_det,
+			( m.a42_*s5 - m.a43_*s4 + m.a44_*s3) * inv_det,
+			(-m.a32_*s5 + m.a33_*s4 - m.a34_*s3) * inv_det,
+
+			(-m.a21_*c5 + m.a23_*c2 - m.a24_*c1) * inv_det,
+			( m.a11_*c5 - m.a13_*c2 + m.a14_*c1) * inv_det,
+			(-m.a41_*s5 + m.a43_*s2 - m.a44_*s1) * inv_det,
+			( m.a31_*s5 - m.a33_*s2 + m.a34_*s1) * inv_det,
+
+			( m.a21_*c4 - m.a22_*c2 + m.a24_*c0) * inv_det,
+			(-m.a11_*c4 + m.a12_*c2 - m.a14_*c0) * inv_det,
+			( m.a41_*s4 - m.a42_*s2 + m.a44_*s0) * inv_det,
+			(-m.a31_*s4 + m.a32_*s2 - m.a34_*s0) * inv_det,
+
+			(-m.a21_*c3 + m.a22_*c1 - m.a23_*c0) * inv_det,
+			( m.a11_*c3 - m.a12_*c1 + m.a13_*c0) * inv_det,
+			(-m.a41_*s3 + m.a42_*s1 - m.a43_*s0) * inv_det,
+			( m.a31_*s3 - m.a32_*s1 + m.a33_*s0) * inv_det);
+	}
+
+	/// \brief Inverts this matrix.
+	/// \return this matrix, inverted.
+	matrix& invert()
+	{
+		*this = inverted( *this);
+		return *this;
+	}
+
 	/// \brief It calculates the determinant of the given matrix.
 	friend unit_type det( const matrix& m)
 	{
@@ -0,0 +1,552 @@
+#ifndef ALGEBRA_SOLVERS_HPP
+#define ALGEBRA_SOLVERS_HPP
+
+#include "algebra/matrix.hpp"
+#include "algebra/vector.hpp"
+#include "algebra/unit_traits.hpp"
+#include "parallel/execution.hpp"
+#include <boost/static_assert.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace algebra
+{
+
+namespace impl
+{
+
+/// \ingroup algebra
+/// \brief It calculates the magnitude under which a pivot of the decomposition of a N x N matrix is considered zero.
+/// \param max_abs the largest absolute value of the elements of the matrix.
+/// \details
+///		The rounding errors of the decomposition are proportional to the magnitude of the elements, so the pivots are
+///		compared relative to it, not with the zero check of the unit traits.
+template< unsigned N, typename U>
+U singularity_threshold( const U& max_abs)
+{
+	return U( 16 * N) * std::numeric_limits< U>::epsilon() * max_abs;
+}
+
+/// \ingroup algebra
+/// \brief It gets the largest absolute value of the elements of a N x N matrix.
+template< unsigned N, typename M>
+typename M::unit_type max_abs_element( const M& m)
+{
+	typename M::unit_type result = 0;
+	for( unsigned r = 0; r < N; ++r)
+	{
+		for( unsigned c = 0; c < N; ++c)
+		{
+			result = std::max( result, std::abs( m( r, c)));
+		}
+	}
+	return result;
+}
+
+} // namespace impl
+
+/// \ingroup algebra
+/// \brief It solves linear systems using the LU decomposition with partial pivoting: <c>P * A = L * U</c>.
+/// \tparam N the size of the system. The matrices of sizes 2, 3 and 4 are supported, which are the ones having an
+///		implementation.
+/// \tparam U the type of the elements.
+/// \tparam UT the traits of the element type.
+/// \details
+///		The decomposition is kept in a fixed size array and all the loops have bounds known at compile time, so there
+///		is no heap allocation and the compiler can unroll them. The decomposition can be reused for solving the system
+///		with several right hand sides. It works for any non singular matrix.
+template< unsigned N, typename U, typename UT = unit_traits< U> >
+class lu_decomposition
+{
+	BOOST_STATIC_ASSERT( 2 <= N && N <= 4);
+
+public:
+	typedef U unit_type;
+	typedef UT unit_traits_type;
+	typedef matrix< N, N, U, UT> matrix_type;
+	typedef vector< N, U, UT> vector_type;
+
+	/// \brief It calculates the decomposition of the given matrix.
+	explicit lu_decomposition( const matrix_type& a)
+		: singular_( false)
+		, sign_( 1)
+	{
+		const unit_type threshold = impl::singularity_threshold< N>( impl::max_abs_element< N>( a));
+		for( unsigned r = 0; r < N; ++r)
+		{
+			pivots_[r] = r;
+			for( unsigned c = 0; c < N; ++c)
+			{
+				lu_[r][c] = a( r, c);
+			}
+		}
+		for( unsigned k = 0; k < N; ++k)
+		{
+			unsigned pivot = k;
+			for( unsigned r = k + 1; r < N; ++r)
+			{
+				if( std::abs( lu_[r][k]) > std::abs( lu_[pivot][k]))
+				{
+					pivot = r;
+				}
+			}
+			if( pivot != k)
+			{
+				for( unsigned c = 0; c < N; ++c)
+				{
+					std::swap( lu_[k][c], lu_[pivot][c]);
+				}
+				std::swap( pivots_[k], pivots_[pivot]);
+				sign_ = -sign_;
+			}
+			if( std::abs( lu_[k][k]) <= threshold)
+			{
+				singular_ = true;
+				continue;
+			}
+			const unit_type inv_pivot = unit_traits_type::one() / lu_[k][k];
+			for( unsigned r = k + 1; r < N; ++r)
+			{
+				lu_[r][k] *= inv_pivot;
+				for( unsigned c = k + 1; c < N; ++c)
+				{
+					lu_[r][c] -= lu_[r][k] * lu_[k][c];
+				}
+			}
+		}
+	}
+
+	/// \brief It checks whether the matrix is singular, relative to the precision of the unit type.
+	bool is_singular() const { return singular_; }
+
+	/// \brief It calculates the determinant of the matrix.
+	unit_type det() const
+	{
+		unit_type result = sign_;
+		for( unsigned k = 0; k < N; ++k)
+		{
+			result *= lu_[k][k];
+		}
+		return result;
+	}
+
+	/// \brief It solves the system <c>A * x = b</c>.
+	/// \pre The matrix is not singular.
+	vector_type solve( const vector_type& b) const
+	{
+		unit_type x[N];
+		for( unsigned r = 0; r < N; ++r)
+		{
+			x[r] = b( pivots_[r]);
+			for( unsigned c = 0; c < r; ++c)
+			{
+				x[r] -= lu_[r][c] * x[c];
+			}
+		}
+		for( unsigned r = N; r-- > 0; )
+		{
+			for( unsigned c = r + 1; c < N; ++c)
+			{
+				x[r] -= lu_[r][c] * x[c];
+			}
+			x[r] /= lu_[r][r];
+		}
+		return vector_type( x, x + N);
+	}
+
+private:
+	unit_type lu_[N][N];
+	unsigned pivots_[N];
+	bool singular_;
+	unit_type sign_;
+};
+
+/// \ingroup algebra
+/// \brief It solves linear systems with symmetric positive definite matrices using the Cholesky decomposition:
+///		<c>A = L * L^T</c>.
+/// \copydetails lu_decomposition
+/// \details
+///		It needs about half of the operations of the LU decomposition and no pivoting, e.g. for the normal equations
+///		of the least squares fitting. Only the lower triangle of the matrix is used.
+template< unsigned N, typename U, typename UT = unit_traits< U> >
+class cholesky_decomposition
+{
+	BOOST_STATIC_ASSERT( 2 <= N && N <= 4);
+
+public:
+	typedef U unit_type;
+	typedef UT unit_traits_type;
+	typedef matrix< N, N, U, UT> matrix_type;
+	typedef vector< N, U, UT> vector_type;
+
+	/// \brief It calculates the decomposition of the given matrix.
+	explicit cholesky_decomposition( const matrix_type& a)
+		: positive_definite_( true)
+	{
+		const unit_type threshold = impl::singularity_threshold< N>( impl::max_abs_element< N>( a));
+		for( unsigned c = 0; c < N; ++c)
+		{
+			unit_type diag = a( c, c);
+			for( unsigned k = 0; k < c; ++k)
+			{
+				diag -= l_[c][k] * l_[c][k];
+			}
+			if( diag <= threshold)
+			{
+				positive_definite_ = false;
+				diag = unit_traits_type::one();
+			}
+			l_[c][c] = std::sqrt( diag);
+			const unit_type inv_diag = unit_traits_type::one() / l_[c][c];
+			for( unsigned r = c + 1; r < N; ++r)
+			{
+				unit_type value = a( r, c);
+				for( unsigned k = 0; k < c; ++k)
+				{
+					value -= l_[r][k] * l_[c][k];
+				}
+				l_[r][c] = value * inv_diag;
+			}
+		}
+	}
+
+	/// \brief It checks whether the matrix is positive definite, relative to the precision of the unit type.
+	bool is_positive_definite() const { return positive_definite_; }
+
+	/// \brief It solves the system <c>A * x = b</c>.
+	/// \pre The matrix is positive definite.
+	vector_type solve( const vector_type& b) const
+	{
+		unit_type x[N];
+		for( unsigned r = 0; r < N; ++r)
+		{
+			x[r] = b( r);
+			for( unsigned c = 0; c < r; ++c)
+			{
+				x[r] -= l_[r][c] * x[c];
+			}
+			x[r] /= l_[r][r];
+		}
+		for( unsigned r = N; r-- > 0; )
+		{
+			for( unsigned c = r + 1; c < N; ++c)
+			{
+				x[r] -= l_[c][r] * x[c];
+			}
+			x[r] /= l_[r][r];
+		}
+		return vector_type( x, x + N);
+	}
+
+private:
+	unit_type l_[N][N];
+	bool positive_definite_;
+};
+
+/// \ingroup algebra
+/// \brief It solves linear systems using the QR decomposition by Householder reflections: <c>A = Q * R</c>.
+/// \copydetails lu_decomposition
+/// \details
+///		It is about twice as expensive as the LU decomposition, but the orthogonal transformations don't amplify the
+///		rounding errors, so it is the most stable of the three for ill conditioned systems.
+template< unsigned N, typename U, typename UT = unit_traits< U> >
+class qr_decomposition
+{
+	BOOST_STATIC_ASSERT( 2 <= N && N <= 4);
+
+public:
+	typedef U unit_type;
+	typedef UT unit_traits_type;
+	typedef matrix< N, N, U, UT> matrix_type;
+	typedef vector< N, U, UT> vector_type;
+
+	/// \brief It calculates the decomposition of the given matrix.
+	explicit qr_decomposition( const matrix_type& a)
+		: singular_( false)
+	{
+		const unit_type threshold = impl::singularity_threshold< N>( impl::max_abs_element< N>( a));
+		for( unsigned r = 0; r < N; ++r)
+		{
+			for( unsigned c = 0; c < N; ++c)
+			{
+				r_[r][c] = a( r, c);
+			}
+		}
+		for( unsigned k = 0; k + 1 < N; ++k)
+		{
+			// The reflection maps the column below the diagonal to alpha * e_k; the sign of alpha avoids cancellation.
+			unit_type norm2 = unit_traits_type::zero();
+			for( unsigned r = k; r < N; ++r)
+			{
+				norm2 += r_[r][k] * r_[r][k];
+			}
+			const unit_type norm = std::sqrt( norm2);
+			const unit_type alpha = r_[k][k] > unit_traits_type::zero() ? -norm : norm;
+			unit_type vnorm2 = unit_traits_type::zero();
+			for( unsigned r = k; r < N; ++r)
+			{
+				v_[k][r] = r_[r][k] - (r == k ? alpha : unit_traits_type::zero());
+				vnorm2 += v_[k][r] * v_[k][r];
+			}
+			beta_[k] = vnorm2 > unit_traits_type::zero() ? 2 / vnorm2 : unit_traits_type::zero();
+			for( unsigned c = k; c < N; ++c)
+			{
+				unit_type s = unit_traits_type::zero();
+				for( unsigned r = k; r < N; ++r)
+				{
+					s += v_[k][r] * r_[r][c];
+				}
+				s *= beta_[k];
+				for( unsigned r = k; r < N; ++r)
+				{
+					r_[r][c] -= s * v_[k][r];
+				}
+			}
+		}
+		for( unsigned k = 0; k < N; ++k)
+		{
+			if( std::abs( r_[k][k]) <= threshold)
+			{
+				singular_ = true;
+			}
+		}
+	}
+
+	/// \brief It checks whether the matrix is singular, relative to the precision of the unit type.
+	bool is_singular() const { return singular_; }
+
+	/// \brief It solves the system <c>A * x = b</c>.
+	/// \pre The matrix is not singular.
+	vector_type solve( const vector_type& b) const
+	{
+		// x = R^-1 * Q^T * b, where Q^T is the product of the reflections.
+		unit_type x[N];
+		for( unsigned r = 0; r < N; ++r)
+		{
+			x[r] = b( r);
+		}
+		for( unsigned k = 0; k + 1 < N; ++k)
+		{
+			unit_type s = unit_traits_type::zero();
+			for( unsigned r = k; r < N; ++r)
+			{
+				s += v_[k][r] * x[r];
+			}
+			s *= beta_[k];
+			for( unsigned r = k; r < N; ++r)
+			{
+				x[r] -= s * v_[k][r];
+			}
+		}
+		for( unsigned r = N; r-- > 0; )
+		{
+			for( unsigned c = r + 1; c < N; ++c)
+			{
+				x[r] -= r_[r][c] * x[c];
+			}
+			x[r] /= r_[r][r];
+		}
+		return vector_type( x, x + N);
+	}
+
+private:
+	unit_type r_[N][N];
+	// The Householder vectors (only the elements from k to N-1 of the k-th vector are used) and their scale factors.
+	unit_type v_[N][N];
+	unit_type beta_[N];
+	bool singular_;
+};
+
+namespace impl
+{
+
+/// \ingroup algebra
+/// \brief It checks whether the decomposition can be used for solving systems.
+/// \{
+template< unsigned N, typename U, typename UT>
+bool is_solvable( const lu_decomposition< N, U, UT>& d) { return !d.is_singular(); }
+
+template< unsigned N, typename U, typename UT>
+bool is_solvable( const cholesky_decomposition< N, U, UT>& d) { return d.is_positive_definite(); }
+
+template< unsigned N, typename U, typename UT>
+bool is_solvable( const qr_decomposition< N, U, UT>& d) { return !d.is_singular(); }
+/// \}
+
+/// \ingroup algebra
+/// \brief It solves a system using the given type of decomposition.
+template< typename Decomposition, typename M, typename V>
+bool solve( const M& a, const V& b, V& x)
+{
+	const Decomposition decomposition( a);
+	if( !is_solvable( decomposition))
+	{
+		x = V();
+		return false;
+	}
+	x = decomposition.solve( b);
+	return true;
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the given type of decomposition.
+template< typename Decomposition, typename M, typename V>
+std::size_t solve( const M* a, const V* b, std::size_t count, V* x, bool* solved)
+{
+	std::size_t result = 0;
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		const bool ok = solve< Decomposition>( a[i], b[i], x[i]);
+		if( solved)
+		{
+			solved[i] = ok;
+		}
+		result += ok ? 1 : 0;
+	}
+	return result;
+}
+
+/// \ingroup algebra
+/// \brief It solves a chunk of an array of systems, adding the number of solved systems to the total.
+template< typename Decomposition, typename M, typename V>
+struct solve_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		const std::size_t count = solve< Decomposition>( a + begin, b + begin, end - begin, x + begin,
+			solved ? solved + begin : NULL);
+		boost::mutex::scoped_lock lock( *mutex);
+		*total += count;
+	}
+
+	const M* a;
+	const V* b;
+	V* x;
+	bool* solved;
+	boost::mutex* mutex;
+	std::size_t* total;
+};
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the given type of decomposition, as specified by the execution policy.
+template< typename Decomposition, typename P, typename M, typename V>
+std::size_t solve( const P& policy, const M* a, const V* b, std::size_t count, V* x, bool* solved)
+{
+	enum { MIN_GRAIN = 256 };
+	boost::mutex mutex;
+	std::size_t total = 0;
+	const solve_chunk< Decomposition, M, V> chunk = { a, b, x, solved, &mutex, &total };
+	parallel::for_each_chunk( policy, 0, count, MIN_GRAIN, chunk);
+	return total;
+}
+
+} // namespace impl
+
+/// \ingroup algebra
+/// \brief It solves the system <c>a * x = b</c> using the LU decomposition with partial pivoting.
+/// \param a the matrix of the system.
+/// \param b the right hand side.
+/// \param[out] x the solution, or the zero vector if the matrix is singular.
+/// \return true if the system was solved, false if the matrix is singular.
+template< unsigned N, typename U, typename UT>
+bool solve_lu( const matrix< N, N, U, UT>& a, const vector< N, U, UT>& b, vector< N, U, UT>& x)
+{
+	return impl::solve< lu_decomposition< N, U, UT> >( a, b, x);
+}
+
+/// \ingroup algebra
+/// \brief It solves the system <c>a * x = b</c> using the Cholesky decomposition.
+/// \param a the symmetric positive definite matrix of the system. Only its lower triangle is used.
+/// \param b the right hand side.
+/// \param[out] x the solution, or the zero vector if the matrix is not positive definite.
+/// \return true if the system was solved, false if the matrix is not positive definite.
+template< unsigned N, typename U, typename UT>
+bool solve_cholesky( const matrix< N, N, U, UT>& a, const vector< N, U, UT>& b, vector< N, U, UT>& x)
+{
+	return impl::solve< cholesky_decomposition< N, U, UT> >( a, b, x);
+}
+
+/// \ingroup algebra
+/// \brief It solves the system <c>a * x = b</c> using the QR decomposition.
+/// \copydetails solve_lu( const matrix< N, N, U, UT>&, const vector< N, U, UT>&, vector< N, U, UT>&)
+template< unsigned N, typename U, typename UT>
+bool solve_qr( const matrix< N, N, U, UT>& a, const vector< N, U, UT>& b, vector< N, U, UT>& x)
+{
+	return impl::solve< qr_decomposition< N, U, UT> >( a, b, x);
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the LU decomposition with partial pivoting.
+/// \param a the matrices of the systems.
+/// \param b the right hand sides.
+/// \param count the number of systems.
+/// \param[out] x the buffer receiving the solutions. The solutions of the singular systems are zero vectors.
+/// \param[out] solved optional buffer receiving, for each system, whether it was solved. It may be NULL.
+/// \return the number of solved systems.
+template< unsigned N, typename U, typename UT>
+std::size_t solve_lu( const matrix< N, N, U, UT>* a, const vector< N, U, UT>* b, std::size_t count,
+	vector< N, U, UT>* x, bool* solved = NULL)
+{
+	return impl::solve< lu_decomposition< N, U, UT> >( a, b, count, x, solved);
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the Cholesky decomposition.
+/// \copydetails solve_lu( const matrix< N, N, U, UT>*, const vector< N, U, UT>*, std::size_t, vector< N, U, UT>*, bool*)
+template< unsigned N, typename U, typename UT>
+std::size_t solve_cholesky( const matrix< N, N, U, UT>* a, const vector< N, U, UT>* b, std::size_t count,
+	vector< N, U, UT>* x, bool* solved = NULL)
+{
+	return impl::solve< cholesky_decomposition< N, U, UT> >( a, b, count, x, solved);
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the QR decomposition.
+/// \copydetails solve_lu( const matrix< N, N, U, UT>*, const vector< N, U, UT>*, std::size_t, vector< N, U, UT>*, bool*)
+template< unsigned N, typename U, typename UT>
+std::size_t solve_qr( const matrix< N, N, U, UT>* a, const vector< N, U, UT>* b, std::size_t count,
+	vector< N, U, UT>* x, bool* solved = NULL)
+{
+	return impl::solve< qr_decomposition< N, U, UT> >( a, b, count, x, solved);
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the LU decomposition with partial pivoting, as specified by the
+///		execution policy.
+/// \param policy the execution policy.
+/// \copydetails solve_lu( const matrix< N, N, U, UT>*, const vector< N, U, UT>*, std::size_t, vector< N, U, UT>*, bool*)
+template< typename P, unsigned N, typename U, typename UT>
+std::size_t solve_lu( const P& policy, const matrix< N, N, U, UT>* a, const vector< N, U, UT>* b, std::size_t count,
+	vector< N, U, UT>* x, bool* solved = NULL)
+{
+	return impl::solve< lu_decomposition< N, U, UT> >( policy, a, b, count, x, solved);
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the Cholesky decomposition, as specified by the execution policy.
+/// \copydetails solve_lu( const P&, const matrix< N, N, U, UT>*, const vector< N, U, UT>*, std::size_t,
+///		vector< N, U, UT>*, bool*)
+template< typename P, unsigned N, typename U, typename UT>
+std::size_t solve_cholesky( const P& policy, const matrix< N, N, U, UT>* a, const vector< N, U, UT>* b,
+	std::size_t count, vector< N, U, UT>* x, bool* solved = NULL)
+{
+	return impl::solve< cholesky_decomposition< N, U, UT> >( policy, a, b, count, x, solved);
+}
+
+/// \ingroup algebra
+/// \brief It solves an array of systems using the QR decomposition, as specified by the execution policy.
+/// \copydetails solve_lu( const P&, const matrix< N, N, U, UT>*, const vector< N, U, UT>*, std::size_t,
+///		vector< N, U, UT>*, bool*)
+template< typename P, unsigned N, typename U, typename UT>
+std::size_t solve_qr( const P& policy, const matrix< N, N, U, UT>* a, const vector< N, U, UT>* b, std::size_t count,
+	vector< N, U, UT>* x, bool* solved = NULL)
+{
+	return impl::solve< qr_decomposition< N, U, UT> >( policy, a, b, count, x, solved);
+}
+
+} // namespace algebra
+
+#endif // ALGEBRA_SOLVERS_HPP
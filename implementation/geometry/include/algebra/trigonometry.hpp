@@ -0,0 +1,174 @@
+#ifndef ALGEBRA_TRIGONOMETRY_HPP
+#define ALGEBRA_TRIGONOMETRY_HPP
+
+#include <cstddef>
+
+namespace algebra
+{
+
+/// \ingroup algebra
+/// \brief Precision tag selecting the short sine and cosine polynomials.
+/// \details
+///		The absolute error is around 1e-7 on the reduced range, which is the full precision of float. For double it
+///		trades precision for speed. For float the short polynomials are also the precise ones, so the tag matters only
+///		for double: both tags give the same float results.
+struct fast_trigonometry {};
+
+/// \ingroup algebra
+/// \brief Precision tag selecting the sine and cosine polynomials accurate to the full precision of the unit type.
+struct precise_trigonometry {};
+
+namespace impl
+{
+
+/// \ingroup algebra
+/// \brief It provides the constants used for the range reduction of the trigonometric functions.
+/// \details
+///		The value of pi/2 is split in three parts, so that <c>k * pi/2</c> can be subtracted from the angle without
+///		losing precision (Cody-Waite reduction). The first part has few significant bits, so the product with the
+///		quadrant index is exact as long as the angle is smaller than max_angle().
+template< typename U>
+struct trigonometry_constants;
+
+template<>
+struct trigonometry_constants< float>
+{
+	static float two_over_pi() { return 0.636619772367581343f; }
+	static float pi_over_2_hi() { return 1.5703125f; }
+	static float pi_over_2_mid() { return 4.837512969970703125e-4f; }
+	static float pi_over_2_lo() { return 7.54978995489188216e-8f; }
+	static float max_angle() { return 8192.0f; }
+};
+
+template<>
+struct trigonometry_constants< double>
+{
+	static double two_over_pi() { return 0.636619772367581343; }
+	static double pi_over_2_hi() { return 1.57079625129699707031; }
+	static double pi_over_2_mid() { return 7.54978941586159635336e-8; }
+	static double pi_over_2_lo() { return 5.39030285815811905290e-15; }
+	static double max_angle() { return 1.0e8; }
+};
+
+/// \ingroup algebra
+/// \brief It evaluates the sine and cosine polynomials on the reduced range <c>[-pi/4, pi/4]</c>.
+/// \tparam U the type of the angle.
+/// \tparam P the precision tag.
+/// \details
+///		The generic version uses the short minimax polynomials (degree 7 for sine, degree 8 for cosine).
+/// \sa Stephen L. Moshier, Cephes Math Library, sinf.c and sin.c
+template< typename U, typename P>
+struct sincos_polynomial
+{
+	/// \brief It calculates the sine of the reduced angle.
+	/// \param x the reduced angle.
+	/// \param z the square of the reduced angle.
+	static U sin( const U& x, const U& z)
+	{
+		return x + x*z*((U(-1.9515295891e-4)*z + U(8.3321608736e-3))*z + U(-1.6666654611e-1));
+	}
+
+	/// \brief It calculates the cosine of the reduced angle.
+	/// \param z the square of the reduced angle.
+	static U cos( const U& z)
+	{
+		return U(1) - U(0.5)*z
+			+ z*z*((U(2.443315711809948e-5)*z + U(-1.388731625493765e-3))*z + U(4.166664568298827e-2));
+	}
+};
+
+/// \ingroup algebra
+/// \brief It specializes the polynomials for double precision (degree 13 for sine, degree 14 for cosine).
+template<>
+struct sincos_polynomial< double, precise_trigonometry>
+{
+	/// \copydoc sincos_polynomial::sin
+	static double sin( const double& x, const double& z)
+	{
+		return x + x*z*(((((1.58962301576546568060e-10*z - 2.50507477628578072866e-8)*z
+			+ 2.75573136213857245213e-6)*z - 1.98412698295895385996e-4)*z
+			+ 8.33333333332211858878e-3)*z - 1.66666666666666307295e-1);
+	}
+
+	/// \copydoc sincos_polynomial::cos
+	static double cos( const double& z)
+	{
+		return 1.0 - 0.5*z + z*z*(((((-1.13585365213876817300e-11*z + 2.08757008419747316778e-9)*z
+			- 2.75573141792967388112e-7)*z + 2.48015872888517045348e-5)*z
+			- 1.38888888888730564116e-3)*z + 4.16666666666665929218e-2);
+	}
+};
+
+} // namespace impl
+
+/// \ingroup algebra
+/// \brief It calculates the sine and the cosine of the same angle, sharing the range reduction.
+/// \tparam U the type of the angle. It must be float or double.
+/// \tparam P the precision tag: fast_trigonometry or precise_trigonometry.
+/// \param angle the angle, in radians. Its absolute value must be smaller than
+///		<c>impl::trigonometry_constants<U>::max_angle()</c>.
+/// \param[out] s the sine of the angle.
+/// \param[out] c the cosine of the angle.
+/// \details
+///		The angle is reduced to <c>[-pi/4, pi/4]</c> by subtracting a multiple of pi/2, then both polynomials are
+///		evaluated and the quadrant selects which result goes to the sine and which to the cosine. There are no branches
+///		depending on the angle, so the function can be inlined in loops that are vectorized by the compiler.
+template< typename U, typename P>
+inline void sincos( const U& angle, U& s, U& c, P)
+{
+	typedef impl::trigonometry_constants< U> constants;
+	typedef impl::sincos_polynomial< U, P> polynomial;
+
+	const U scaled = angle * constants::two_over_pi();
+	const int k = static_cast< int>( scaled + (scaled < 0 ? U(-0.5) : U(0.5)));
+	const U fk = static_cast< U>( k);
+	const U x = ((angle - fk*constants::pi_over_2_hi()) - fk*constants::pi_over_2_mid()) - fk*constants::pi_over_2_lo();
+	const U z = x*x;
+
+	const U ps = polynomial::sin( x, z);
+	const U pc = polynomial::cos( z);
+	const int quadrant = k & 3;
+	const U rs = (quadrant & 1) ? pc : ps;
+	const U rc = (quadrant & 1) ? ps : pc;
+	s = (quadrant & 2) ? -rs : rs;
+	c = ((quadrant + 1) & 2) ? -rc : rc;
+}
+
+/// \ingroup algebra
+/// \brief It calculates the sine and the cosine of the same angle, using the precise polynomials.
+/// \copydetails sincos( const U&, U&, U&, P)
+template< typename U>
+inline void sincos( const U& angle, U& s, U& c)
+{
+	sincos( angle, s, c, precise_trigonometry());
+}
+
+/// \ingroup algebra
+/// \brief It calculates the sines and the cosines of an array of angles.
+/// \tparam U the type of the angles. It must be float or double.
+/// \tparam P the precision tag: fast_trigonometry or precise_trigonometry.
+/// \param angles the angles, in radians.
+/// \param count the number of angles.
+/// \param[out] s the buffer receiving the sines. It must have place for \c count values.
+/// \param[out] c the buffer receiving the cosines. It must have place for \c count values.
+template< typename U, typename P>
+void sincos( const U* angles, std::size_t count, U* s, U* c, P precision)
+{
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		sincos( angles[i], s[i], c[i], precision);
+	}
+}
+
+/// \ingroup algebra
+/// \brief It calculates the sines and the cosines of an array of angles, using the precise polynomials.
+/// \copydetails sincos( const U*, std::size_t, U*, U*, P)
+template< typename U>
+void sincos( const U* angles, std::size_t count, U* s, U* c)
+{
+	sincos( angles, count, s, c, precise_trigonometry());
+}
+
+} // namespace algebra
+
+#endif // ALGEBRA_TRIGONOMETRY_HPP
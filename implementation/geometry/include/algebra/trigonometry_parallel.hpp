@@ -0,0 +1,55 @@
+#ifndef ALGEBRA_TRIGONOMETRY_PARALLEL_HPP
+#define ALGEBRA_TRIGONOMETRY_PARALLEL_HPP
+
+#include "algebra/trigonometry.hpp"
+#include "parallel/execution.hpp"
+#include <cstddef>
+
+namespace algebra
+{
+
+namespace impl
+{
+
+/// \ingroup algebra
+/// \brief It calculates the sines and the cosines of a chunk of an array of angles.
+template< typename U, typename P>
+struct sincos_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		algebra::sincos( angles + begin, end - begin, s + begin, c + begin, P());
+	}
+
+	const U* angles;
+	U* s;
+	U* c;
+};
+
+} // namespace impl
+
+/// \ingroup algebra
+/// \brief It calculates the sines and the cosines of an array of angles, as specified by the execution policy.
+/// \param policy the execution policy.
+/// \copydetails sincos( const U*, std::size_t, U*, U*, P)
+template< typename EP, typename U, typename P>
+void sincos( const EP& policy, const U* angles, std::size_t count, U* s, U* c, P)
+{
+	enum { MIN_GRAIN = 4096 };
+	impl::sincos_chunk< U, P> chunk = { angles, s, c };
+	parallel::for_each_chunk( policy, 0, count, MIN_GRAIN, chunk);
+}
+
+/// \ingroup algebra
+/// \brief It calculates the sines and the cosines of an array of angles using the precise polynomials, as specified
+///		by the execution policy.
+/// \copydetails sincos( const EP&, const U*, std::size_t, U*, U*, P)
+template< typename EP, typename U>
+void sincos( const EP& policy, const U* angles, std::size_t count, U* s, U* c)
+{
+	sincos( policy, angles, count, s, c, precise_trigonometry());
+}
+
+} // namespace algebra
+
+#endif // ALGEBRA_TRIGONOMETRY_PARALLEL_HPP
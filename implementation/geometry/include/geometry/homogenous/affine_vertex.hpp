@@ -0,0 +1,152 @@
+#ifndef GEOMETRY_HOMOGENOUS_AFFINE_VERTEX_HPP
+#define GEOMETRY_HOMOGENOUS_AFFINE_VERTEX_HPP
+
+#include "geometry/impl/vertex_base.hpp"
+#include "geometry/vertex_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/transformation_concept.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/concept/requires.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It implements a vertex of three dimensional, homogenous coordinate system, having the weight coordinate 
+///		always 1.
+/// \tparam CS the coordinate system type.
+/// \details
+///		Most of the vertices have the weight coordinate 1, but the homogenous vertex still divides by it whenever the 
+///		carthesian coordinates are needed. This vertex stores only the carthesian coordinates: the accessors read them 
+///		directly and normalized() gives access to them without any computation. The division happens only when the 
+///		vertex is initialized from homogenous coordinates.
+///
+///		It implements the homogenous vertex concept, so it can be used by all the algorithms accepting homogenous 
+///		vertices. Use it as the base of the lines as well (<c>line< CS, affine_vertex< CS> ></c>), so the algorithms
+///		reading the line base don't divide either. The affine transformations keep the weight coordinate 1, so they are
+///		applied without any division; the result of a projective transformation is normalized.
+template< typename CS>
+class affine_vertex: public impl::vertex_base< CS>
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+public:
+	typedef typename CS::pos_rep pos_rep;
+
+	/// \brief It sets the origin coordinates.
+	affine_vertex()
+		: position_( 0, 0, 0) { }
+
+	/// \brief It initializes the coordinates of the vertex.
+	affine_vertex( const unit_type& x, const unit_type& y, const unit_type& z)
+		: position_( x, y, z) { }
+
+	/// \brief It initializes the vertex from homogenous coordinates, normalizing them.
+	affine_vertex( const unit_type& x, const unit_type& y, const unit_type& z, const unit_type& w)
+		: position_( x/w, y/w, z/w) { }
+
+	/// \brief It sets the coordinates from the position internal representation.
+	affine_vertex( const pos_rep& coords)
+		: position_( coords) { }
+
+	/// \brief It sets the coordinates from homogenous coordinates internal representation, normalizing them.
+	affine_vertex( const coord_vector& coords)
+		: position_( CS::normalize_coords( coords)) { }
+
+	/// \brief It initializes the vertex from a homogenous vertex, normalizing its coordinates.
+	explicit affine_vertex( const vertex< CS>& v)
+		: position_( v.normalized()) { }
+
+	/// \brief Coordinate accessors. They don't need any normalization.
+	/// \{
+	const unit_type& x() const { return position_( 0); }
+	const unit_type& y() const { return position_( 1); }
+	const unit_type& z() const { return position_( 2); }
+	unit_type w() const { return unit_traits_type::one(); }
+	/// \}
+
+	/// \brief It gives access to the carthesian coordinates. No computation is needed.
+	const pos_rep& normalized() const { return position_; }
+	void normalized( pos_rep& pos) const { pos = position_; }
+
+	/// \brief It applies the given transformation on the vertex.
+	/// \tparam T the transformation type, implementing Transformation concept (a homogenous transformation or a
+	///		cached_transformation).
+	/// \details
+	///		Only the first three rows of an affine transformation matrix are used. A projective transformation changes
+	///		the weight coordinate, so the transformed coordinates are divided by it.
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (affine_vertex&))
+		transform( const T& tr)
+	{
+		position_ = this->transformed_position( tr);
+		return *this;
+	}
+
+	/// \brief It gets the result of applying the given transformation on the vertex.
+	/// \see transform
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (affine_vertex))
+		transformed( const T& tr) const
+	{
+		return affine_vertex( this->transformed_position( tr));
+	}
+
+	/// \brief It checks whether the vertex is valid.
+	/// \details A vertex is valid if its coordinates are valid, finite numbers.
+	bool is_valid() const
+	{
+		return unit_traits_type::is_valid_number( position_( 0))
+			&& unit_traits_type::is_valid_number( position_( 1))
+			&& unit_traits_type::is_valid_number( position_( 2));
+	}
+
+private:
+	template< typename T>
+	pos_rep transformed_position( const T& tr) const
+	{
+		const typename T::transform_matrix& m = tr.tr_matrix();
+		const unit_type x = position_( 0), y = position_( 1), z = position_( 2);
+		const pos_rep result(
+			m( 0, 0)*x + m( 0, 1)*y + m( 0, 2)*z + m( 0, 3),
+			m( 1, 0)*x + m( 1, 1)*y + m( 1, 2)*z + m( 1, 3),
+			m( 2, 0)*x + m( 2, 1)*y + m( 2, 2)*z + m( 2, 3));
+		if( tr.is_affine())
+		{
+			return result;
+		}
+		const unit_type w = m( 3, 0)*x + m( 3, 1)*y + m( 3, 2)*z + m( 3, 3);
+		return pos_rep( result( 0) / w, result( 1) / w, result( 2) / w);
+	}
+
+private:
+	pos_rep position_;
+};
+
+
+namespace impl
+{
+
+/// \brief It specializes the vertex type checking for affine vertex class.
+/// \sa is_vertex< typename V, unsigned D, typename CSID>
+template< typename CS, unsigned D, typename CSID>
+struct is_vertex< affine_vertex< CS>, D, CSID >
+{
+	BOOST_STATIC_CONSTANT( bool, 
+		value = (
+			(CS::DIMENSIONS == D || D == 0) 
+			&& (
+				boost::is_same< typename CS::system_type, CSID>::value 
+				|| 
+				boost::is_same< CSID, void>::value))
+		);
+};
+
+} // namespace impl
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_AFFINE_VERTEX_HPP
@@ -0,0 +1,90 @@
+#ifndef GEOMETRY_HOMOGENOUS_CACHED_TRANSFORMATION_HPP
+#define GEOMETRY_HOMOGENOUS_CACHED_TRANSFORMATION_HPP
+
+#include "geometry/impl/transformation_base.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include <boost/concept/assert.hpp>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It wraps a homogenous transformation and caches the inverse of its transposed matrix.
+/// \tparam CS the coordinate system used by the transformation.
+/// \details
+///		The planes are transformed using the inverse transposed matrix. Computing it requires a matrix inversion, so 
+///		this class computes it only at the first plane transformation and reuses it afterwards. It can be used instead 
+///		of the wrapped transformation for all the geometric objects.
+/// \warning
+///		The cache is updated from const methods, so this class is not thread safe: if two threads transform planes 
+///		using the same object, call inverse_transpose() once before sharing it.
+template< typename CS>
+class cached_transformation: public impl::transformation_base< CS>
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+public:
+	typedef transformation< CS> transformation_type;
+	typedef typename transformation_type::transform_matrix transform_matrix;
+
+	/// \brief It wraps the given transformation.
+	explicit cached_transformation( const transformation_type& tr)
+		: tr_( tr)
+		, has_inverse_transpose_( false)
+	{
+	}
+
+	/// \brief It gets the wrapped transformation.
+	const transformation_type& get() const { return tr_; }
+
+	/// \brief It replaces the wrapped transformation, invalidating the cached matrix.
+	void reset( const transformation_type& tr)
+	{
+		tr_ = tr;
+		has_inverse_transpose_ = false;
+	}
+
+	/// \copydoc impl::htransformation_base::transformed
+	coord_vector transformed( const coord_vector& pos) const
+	{
+		return tr_.transformed( pos);
+	}
+
+	/// \copydoc impl::htransformation_base::transform
+	void transform( coord_vector& pos) const
+	{
+		tr_.transform( pos);
+	}
+
+	/// \copydoc impl::htransformation_base::transformed_direction
+	typename coord_system::dir_rep transformed_direction( const typename coord_system::dir_rep& dir) const
+	{
+		return tr_.transformed_direction( dir);
+	}
+
+	/// \copydoc impl::htransformation_base::is_affine
+	bool is_affine() const { return tr_.is_affine(); }
+
+	/// \brief It gets the inverse of the transposed transformation matrix. It is calculated only at the first call.
+	const transform_matrix& inverse_transpose() const
+	{
+		if( !has_inverse_transpose_)
+		{
+			inverse_transpose_ = tr_.inverse_transpose();
+			has_inverse_transpose_ = true;
+		}
+		return inverse_transpose_;
+	}
+
+	/// \copydoc impl::htransformation_base::tr_matrix
+	const transform_matrix& tr_matrix() const { return tr_.tr_matrix(); }
+
+private:
+	transformation_type tr_;
+	mutable transform_matrix inverse_transpose_;
+	mutable bool has_inverse_transpose_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_CACHED_TRANSFORMATION_HPP
@@ -0,0 +1,280 @@
+#ifndef GEOMETRY_HOMOGENOUS_COMPACT_DIRECTION_HPP
+#define GEOMETRY_HOMOGENOUS_COMPACT_DIRECTION_HPP
+
+#include "geometry/impl/direction_base.hpp"
+#include "geometry/direction_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It implements a three dimensional direction stored in 32 or 48 bits, using the octahedral encoding.
+/// \tparam CS the coordinate system of the direction. It must be a three dimensional homogenous coordinate system.
+/// \tparam Bits the size of the encoded direction: 32 (two components of 16 bits) or 48 (two components of 24 bits).
+/// \details
+///		The unit sphere is projected on the octahedron <c>|x| + |y| + |z| = 1</c>, and the lower half of the octahedron
+///		is folded over the upper half, so each direction is mapped to a point (u, v) of the square [-1, 1] x [-1, 1].
+///		The two coordinates are quantized uniformly on the available bits. The grid has an odd number of codes, centred
+///		on 0, so the coordinates 0 and &plusmn;1 are encoded exactly, and the axes survive the round trip without error.
+///		The maximum angular error is about 1e-4 radians for 32 bits and 5e-7 radians for 48 bits (the float unit type
+///		keeps only 24 significant bits, so for float the 48 bits encoding is limited by the precision of the decoded
+///		components).
+///
+///		The direction of zero length, or with components which are not finite, has no octahedral code; it is encoded as
+///		the direction of the Z axis, like the default constructed one.
+///
+///		The components are decoded at each access, so use decoded() for accessing the three components of the same
+///		direction, and decode() for processing arrays of directions. The class implements the Direction concept, and it
+///		can be converted to the direction type of the coordinate system, so it can be used for building lines.
+/// \sa Q. Meyer et al., "On Floating-Point Normal Vectors", Eurographics Symposium on Rendering 2010.
+template< typename CS, unsigned Bits = 32>
+class compact_direction: public impl::direction_base< CS>
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+	BOOST_STATIC_ASSERT( Bits == 32 || Bits == 48);
+
+	template< typename C, unsigned B, typename It> friend void decode( It, It,
+		typename C::unit_type*, typename C::unit_type*, typename C::unit_type*);
+
+public:
+	/// \brief The direction type of the coordinate system, used for decoding.
+	typedef direction< CS> direction_type;
+	enum
+	{
+		/// \brief The number of bits of each encoded coordinate.
+		COMPONENT_BITS = Bits / 2,
+		/// \brief The number of 16 bits words of the encoded direction.
+		WORDS = Bits / 16
+	};
+
+	/// \brief It creates the direction of the Z axis.
+	compact_direction()
+	{
+		this->encode_( 0, 0, 1);
+	}
+
+	/// \brief It encodes the given direction components. They don't have to be normalized.
+	/// \details If the components are all zero, or not finite, the direction of the Z axis is encoded.
+	compact_direction( const unit_type& dx, const unit_type& dy, const unit_type& dz)
+	{
+		this->encode_( dx, dy, dz);
+	}
+
+	/// \brief It encodes the given direction.
+	/// \tparam Dir the direction type, implementing the 3D direction concept.
+	template< typename Dir>
+	compact_direction( const Dir& dir, typename boost::enable_if< impl::is_direction< Dir, 3> >::type* = NULL)
+	{
+		BOOST_CONCEPT_ASSERT( (Direction3D< Dir>));
+		this->encode_( dir.dx(), dir.dy(), dir.dz());
+	}
+
+	/// \brief Access to direction components. Each call decodes the direction.
+	/// \{
+	unit_type dx() const { return this->decoded_components().template at<0>(); }
+	unit_type dy() const { return this->decoded_components().template at<1>(); }
+	unit_type dz() const { return this->decoded_components().template at<2>(); }
+	/// \}
+
+	/// \brief It decodes the normalized direction components.
+	typename CS::dir_rep decoded_components() const
+	{
+		unit_type x, y, z;
+		compact_direction::decode_( this->u_(), this->v_(), x, y, z);
+		return typename CS::dir_rep( x, y, z);
+	}
+
+	/// \brief It decodes the direction.
+	direction_type decoded() const { return direction_type( this->decoded_components()); }
+
+	/// \brief Conversion to the direction type of the coordinate system.
+	operator direction_type() const { return this->decoded(); }
+
+	/// \brief It compares the encoded values: the directions are equal if they are encoded in the same bits.
+	/// \{
+	bool operator==( const compact_direction& other) const
+	{
+		for( unsigned i = 0; i < WORDS; ++i)
+		{
+			if( words_[i] != other.words_[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool operator!=( const compact_direction& other) const { return !(*this == other); }
+	/// \}
+
+private:
+	/// \brief The mask of the bits of an encoded coordinate.
+	static boost::uint32_t mask_() { return (boost::uint32_t( 1) << COMPONENT_BITS) - 1; }
+
+	/// \brief The code of the coordinate 0. The codes of -1 and 1 are 0 and twice this value, so the last code of the
+	///		mask is never used.
+	static boost::uint32_t half_range_() { return (boost::uint32_t( 1) << (COMPONENT_BITS - 1)) - 1; }
+
+	/// \brief It converts the coordinate from [-1, 1] to the nearest integer code.
+	/// \details
+	///		The calculation is made in double precision, since float cannot represent all the 24 bits codes. The value
+	///		is clamped before the conversion, so a value out of the range, or NaN, still gives a valid code.
+	static boost::uint32_t quantize_( const unit_type& value)
+	{
+		if( !(value > -1))
+		{
+			return 0;
+		}
+		if( !(value < 1))
+		{
+			return 2 * half_range_();
+		}
+		const double half_range = double( half_range_());
+		return static_cast< boost::uint32_t>( (double( value) + 1) * half_range + 0.5);
+	}
+
+	void encode_( const unit_type& dx, const unit_type& dy, const unit_type& dz)
+	{
+		const unit_type l1_norm = std::abs( dx) + std::abs( dy) + std::abs( dz);
+		if( !(l1_norm > 0 && l1_norm <= std::numeric_limits< unit_type>::max()))
+		{
+			// Zero length, infinite or NaN components: the direction of the Z axis.
+			this->encode_( 0, 0, 1);
+			return;
+		}
+		unit_type u = dx / l1_norm, v = dy / l1_norm;
+		if( dz < 0)
+		{
+			const unit_type fu = (1 - std::abs( v)) * (u >= 0 ? 1 : -1);
+			const unit_type fv = (1 - std::abs( u)) * (v >= 0 ? 1 : -1);
+			u = fu;
+			v = fv;
+		}
+		const boost::uint64_t bits =
+			boost::uint64_t( quantize_( u)) | (boost::uint64_t( quantize_( v)) << COMPONENT_BITS);
+		for( unsigned i = 0; i < WORDS; ++i)
+		{
+			words_[i] = static_cast< boost::uint16_t>( bits >> (16*i));
+		}
+	}
+
+	boost::uint64_t bits_() const
+	{
+		boost::uint64_t bits = 0;
+		for( unsigned i = 0; i < WORDS; ++i)
+		{
+			bits |= boost::uint64_t( words_[i]) << (16*i);
+		}
+		return bits;
+	}
+
+	boost::uint32_t u_() const { return static_cast< boost::uint32_t>( this->bits_() & mask_()); }
+	boost::uint32_t v_() const { return static_cast< boost::uint32_t>( this->bits_() >> COMPONENT_BITS); }
+
+	/// \brief It decodes the normalized components from the integer codes.
+	/// \details
+	///		There are no branches, so it can be inlined in loops vectorized by the compiler. The coordinates are divided
+	///		by the half range instead of multiplied by its inverse, so the codes of 0 and &plusmn;1 are decoded exactly.
+	static void decode_( boost::uint32_t code_u, boost::uint32_t code_v, unit_type& x, unit_type& y, unit_type& z)
+	{
+		const unit_type half_range = unit_type( half_range_());
+		const unit_type u = (unit_type( code_u) - half_range) / half_range;
+		const unit_type v = (unit_type( code_v) - half_range) / half_range;
+		z = 1 - std::abs( u) - std::abs( v);
+		const unit_type t = z < 0 ? -z : unit_type( 0);
+		// The unfolded components keep the sign of the folded ones, also when the independently quantized coordinates
+		// of a direction on the fold edge would give them a tiny opposite value.
+		const unit_type ax = std::max( std::abs( u) - t, unit_type( 0));
+		const unit_type ay = std::max( std::abs( v) - t, unit_type( 0));
+		x = u >= 0 ? ax : -ax;
+		y = v >= 0 ? ay : -ay;
+		const unit_type inv_norm = 1 / std::sqrt( x*x + y*y + z*z);
+		x *= inv_norm;
+		y *= inv_norm;
+		z *= inv_norm;
+	}
+
+	boost::uint16_t words_[WORDS];
+};
+
+/// \ingroup geometry
+/// \brief It decodes a sequence of compact directions into separate arrays of components.
+/// \tparam CS the coordinate system of the directions.
+/// \tparam Bits the size of the encoded directions.
+/// \tparam It the iterator type of the compact direction sequence.
+/// \param first the beginning of the sequence.
+/// \param last the end of the sequence.
+/// \param[out] dx the buffer receiving the X components. It must have place for all the directions of the sequence.
+/// \param[out] dy the buffer receiving the Y components.
+/// \param[out] dz the buffer receiving the Z components.
+/// \details
+///		The integer codes are extracted in blocks of 32 directions, then the components are decoded for the whole block,
+///		so the decoding loop can be vectorized by the compiler.
+template< typename CS, unsigned Bits, typename It>
+void decode( It first, It last,
+	typename CS::unit_type* dx, typename CS::unit_type* dy, typename CS::unit_type* dz)
+{
+	enum { BLOCK_SIZE = 32 };
+	typedef compact_direction< CS, Bits> compact_type;
+	boost::uint32_t u[BLOCK_SIZE], v[BLOCK_SIZE];
+	while( first != last)
+	{
+		unsigned n = 0;
+		for( ; n < BLOCK_SIZE && first != last; ++n, ++first)
+		{
+			const compact_type& dir = *first;
+			u[n] = dir.u_();
+			v[n] = dir.v_();
+		}
+		for( unsigned i = 0; i < n; ++i)
+		{
+			compact_type::decode_( u[i], v[i], dx[i], dy[i], dz[i]);
+		}
+		dx += n; dy += n; dz += n;
+	}
+}
+
+/// \ingroup geometry
+/// \brief It decodes an array of compact directions into separate arrays of components.
+/// \copydetails decode( It, It, typename CS::unit_type*, typename CS::unit_type*, typename CS::unit_type*)
+template< typename CS, unsigned Bits>
+inline void decode( const compact_direction< CS, Bits>* first, const compact_direction< CS, Bits>* last,
+	typename CS::unit_type* dx, typename CS::unit_type* dy, typename CS::unit_type* dz)
+{
+	decode< CS, Bits, const compact_direction< CS, Bits>*>( first, last, dx, dy, dz);
+}
+
+/// \ingroup geometry
+/// \brief It encodes the directions given in separate arrays of components.
+/// \tparam CS the coordinate system of the directions.
+/// \tparam Bits the size of the encoded directions.
+/// \param dx the X components.
+/// \param dy the Y components.
+/// \param dz the Z components.
+/// \param count the number of directions.
+/// \param[out] out the buffer receiving the encoded directions.
+template< typename CS, unsigned Bits>
+void encode(
+	const typename CS::unit_type* dx, const typename CS::unit_type* dy, const typename CS::unit_type* dz,
+	std::size_t count, compact_direction< CS, Bits>* out)
+{
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		out[i] = compact_direction< CS, Bits>( dx[i], dy[i], dz[i]);
+	}
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_COMPACT_DIRECTION_HPP
@@ -0,0 +1,88 @@
+#ifndef GEOMETRY_HOMOGENOUS_COMPACT_DIRECTION_PARALLEL_HPP
+#define GEOMETRY_HOMOGENOUS_COMPACT_DIRECTION_PARALLEL_HPP
+
+#include "geometry/homogenous/compact_direction.hpp"
+#include "parallel/execution.hpp"
+#include <boost/utility/enable_if.hpp>
+#include <cstddef>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The minimum number of directions encoded or decoded by a parallel task.
+enum { COMPACT_DIRECTION_MIN_GRAIN = 8192 };
+
+/// \ingroup geometry
+/// \brief It decodes a chunk of an array of compact directions.
+template< typename CS, unsigned Bits>
+struct compact_decode_chunk
+{
+	typedef typename CS::unit_type unit_type;
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		geometry::decode< CS, Bits, const compact_direction< CS, Bits>*>(
+			directions + begin, directions + end, dx + begin, dy + begin, dz + begin);
+	}
+
+	const compact_direction< CS, Bits>* directions;
+	unit_type* dx;
+	unit_type* dy;
+	unit_type* dz;
+};
+
+/// \ingroup geometry
+/// \brief It encodes a chunk of the arrays of direction components.
+template< typename CS, unsigned Bits>
+struct compact_encode_chunk
+{
+	typedef typename CS::unit_type unit_type;
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		geometry::encode< CS, Bits>( dx + begin, dy + begin, dz + begin, end - begin, out + begin);
+	}
+
+	const unit_type* dx;
+	const unit_type* dy;
+	const unit_type* dz;
+	compact_direction< CS, Bits>* out;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It decodes an array of compact directions into separate arrays of components, as specified by the execution
+///		policy.
+/// \param policy the execution policy.
+/// \copydetails decode( It, It, typename CS::unit_type*, typename CS::unit_type*, typename CS::unit_type*)
+template< typename P, typename CS, unsigned Bits>
+typename boost::enable_if< parallel::is_execution_policy< P> >::type decode( const P& policy,
+	const compact_direction< CS, Bits>* first, const compact_direction< CS, Bits>* last,
+	typename CS::unit_type* dx, typename CS::unit_type* dy, typename CS::unit_type* dz)
+{
+	const impl::compact_decode_chunk< CS, Bits> chunk = { first, dx, dy, dz };
+	parallel::for_each_chunk( policy, 0, last - first, impl::COMPACT_DIRECTION_MIN_GRAIN, chunk);
+}
+
+/// \ingroup geometry
+/// \brief It encodes the directions given in separate arrays of components, as specified by the execution policy.
+/// \param policy the execution policy.
+/// \copydetails encode( const typename CS::unit_type*, const typename CS::unit_type*, const typename CS::unit_type*,
+///		std::size_t, compact_direction< CS, Bits>*)
+template< typename P, typename CS, unsigned Bits>
+typename boost::enable_if< parallel::is_execution_policy< P> >::type encode( const P& policy,
+	const typename CS::unit_type* dx, const typename CS::unit_type* dy, const typename CS::unit_type* dz,
+	std::size_t count, compact_direction< CS, Bits>* out)
+{
+	const impl::compact_encode_chunk< CS, Bits> chunk = { dx, dy, dz, out };
+	parallel::for_each_chunk( policy, 0, count, impl::COMPACT_DIRECTION_MIN_GRAIN, chunk);
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_COMPACT_DIRECTION_PARALLEL_HPP
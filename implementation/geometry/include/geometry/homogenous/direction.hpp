@@ -3,7 +3,9 @@
 
 #include "geometry/direction.hpp"
 #include "geometry/plane_concept.hpp"
+#include "geometry/transformation_concept.hpp"
 #include <boost/concept/assert.hpp>
+#include <boost/concept/requires.hpp>
 #include <cmath>
 
 namespace geometry
@@ -33,6 +35,29 @@ public:
 
 	const dir_rep& representation() const { return this->dir(); }
 
+	/// \brief It applies the linear part of the given transformation on this direction.
+	/// \tparam T the transformation type, implementing Transformation concept. It should provide the transformation of
+	///		direction components.
+	/// \details The translation doesn't change the directions, so only the linear part of the transformation is used.
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (Derived&))
+		transform( const T& tr)
+	{
+		this->dir() = tr.transformed_direction( this->dir());
+		this->normalize();
+		return static_cast<Derived&>(*this);
+	}
+
+	/// \brief It gets the result of applying the linear part of the given transformation on this direction.
+	/// \tparam T the transformation type, implementing Transformation concept. It should provide the transformation of
+	///		direction components.
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (Derived))
+		transformed( const T& tr) const
+	{
+		return Derived( tr.transformed_direction( this->dir()));
+	}
+
 protected:
 	/// \brief It ensures that the norm of the direction is always one.
 	void normalize()
@@ -0,0 +1,522 @@
+#ifndef GEOMETRY_HOMOGENOUS_FRUSTUM_HPP
+#define GEOMETRY_HOMOGENOUS_FRUSTUM_HPP
+
+#include "geometry/plane.hpp"
+#include "geometry/vertex_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The minimum number of visibility words (of 32 objects each) written by a parallel culling task.
+enum { CULLING_MIN_GRAIN = 64 };
+
+/// \ingroup geometry
+/// \brief It culls the vertices of a chunk of visibility words.
+template< typename F, typename RandomIt>
+struct cull_points_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		const std::size_t last = std::min( end * F::BLOCK_SIZE, count);
+		frustum->cull_points( first + begin * F::BLOCK_SIZE, first + last, visibility + begin, plane_mask);
+	}
+
+	const F* frustum;
+	RandomIt first;
+	std::size_t count;
+	boost::uint32_t* visibility;
+	unsigned plane_mask;
+};
+
+/// \ingroup geometry
+/// \brief It culls the spheres of a chunk of visibility words.
+template< typename F, typename RandomIt, typename RandomRIt>
+struct cull_spheres_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		const std::size_t last = std::min( end * F::BLOCK_SIZE, count);
+		frustum->cull_spheres( first + begin * F::BLOCK_SIZE, first + last, radius + begin * F::BLOCK_SIZE,
+			visibility + begin, plane_mask);
+	}
+
+	const F* frustum;
+	RandomIt first;
+	RandomRIt radius;
+	std::size_t count;
+	boost::uint32_t* visibility;
+	unsigned plane_mask;
+};
+
+/// \ingroup geometry
+/// \brief It culls the boxes of a chunk of visibility words.
+template< typename F, typename RandomIt>
+struct cull_boxes_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		const std::size_t last = std::min( end * F::BLOCK_SIZE, count);
+		frustum->cull_boxes( first + begin * F::BLOCK_SIZE, first + last, max_corner + begin * F::BLOCK_SIZE,
+			visibility + begin, plane_mask);
+	}
+
+	const F* frustum;
+	RandomIt first;
+	RandomIt max_corner;
+	std::size_t count;
+	boost::uint32_t* visibility;
+	unsigned plane_mask;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It implements the view frustum, the volume bounded by the six clipping planes of a projection.
+/// \tparam CS the coordinate system used by the frustum. It must be a three dimensional homogenous coordinate system.
+/// \details
+///		The planes are extracted from the projection transformation (Gribb-Hartmann method): a point p is visible if
+///		the transformed point <c>(x', y', z', w') = M*p</c> satisfies <c>-w' <= x', y', z' <= w'</c>. Each of these six
+///		conditions is a linear inequality in p, whose coefficients are the sum or difference between the fourth row and
+///		one of the first three rows of M. The planes are normalized and their normals point inside the frustum, so the
+///		signed distance of a point to each plane is positive for the points inside.
+///
+///		The culling methods for a single object support the usual optimizations of the hierarchical traversal:
+///		\li plane masking: the planes fully containing a parent volume don't need to be tested for its children. The
+///			plane mask parameter gives the planes to be tested and it is updated with the planes intersecting the
+///			object.
+///		\li plane coherency: the plane that rejected an object in the previous frame is very likely to reject it
+///			again, so it is tested first. The first plane parameter gives that plane and it is updated with the
+///			rejecting plane.
+///
+///		The batched culling methods test a sequence of objects against the same planes and write one visibility bit
+///		for each object. The objects are processed in blocks of 32, one plane at a time, so the loops over the objects
+///		of a block can be vectorized by the compiler. Their overloads receiving an execution policy split the sequence
+///		in chunks of whole blocks, so each task writes its own visibility words.
+template< typename CS>
+class frustum
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+public:
+	typedef CS coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	typedef typename coord_system::unit_traits_type unit_traits_type;
+	typedef plane< CS> plane_type;
+	typedef vertex< CS> vertex_type;
+	typedef transformation< CS> transformation_type;
+
+	/// \brief The identifiers of the frustum planes.
+	enum plane_id
+	{
+		LEFT_PLANE = 0,
+		RIGHT_PLANE,
+		BOTTOM_PLANE,
+		TOP_PLANE,
+		NEAR_PLANE,
+		FAR_PLANE,
+		PLANES_COUNT
+	};
+
+	enum
+	{
+		ALL_PLANES = (1 << PLANES_COUNT) - 1,	///< The plane mask selecting all the planes.
+		BLOCK_SIZE = 32							///< The number of objects processed together by the batched methods.
+	};
+
+	/// \brief The result of the culling test of a volume.
+	enum classification
+	{
+		OUTSIDE = 0,	///< The volume is completely outside of the frustum.
+		INTERSECTS,		///< The volume is partially inside the frustum.
+		INSIDE			///< The volume is completely inside the frustum.
+	};
+
+public:
+	/// \brief It creates the frustum of the given projection.
+	/// \param projection the projection transformation (usually the product of projection and view transformations).
+	explicit frustum( const transformation_type& projection)
+	{
+		const typename transformation_type::transform_matrix& m = projection.tr_matrix();
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			// The plane with even index is w' + coord' >= 0, the one with odd index is w' - coord' >= 0
+			this->set_plane( 2*i, m( 3, 0) + m( i, 0), m( 3, 1) + m( i, 1), m( 3, 2) + m( i, 2), m( 3, 3) + m( i, 3));
+			this->set_plane( 2*i + 1, m( 3, 0) - m( i, 0), m( 3, 1) - m( i, 1), m( 3, 2) - m( i, 2), m( 3, 3) - m( i, 3));
+		}
+	}
+
+	/// \brief It gets the plane with the given identifier.
+	/// \pre i < PLANES_COUNT
+	plane_type get_plane( unsigned i) const
+	{
+		assert( i < PLANES_COUNT);
+		return plane_type( a_[i], b_[i], c_[i], d_[i]);
+	}
+
+	/// \brief It gets the signed distance from the given position to the given plane.
+	/// \pre i < PLANES_COUNT
+	unit_type distance( unsigned i, const unit_type& x, const unit_type& y, const unit_type& z) const
+	{
+		assert( i < PLANES_COUNT);
+		return a_[i]*x + b_[i]*y + c_[i]*z + d_[i];
+	}
+
+	/// \brief It checks whether the given vertex is inside the frustum.
+	/// \tparam V the vertex type, implementing the 3D vertex concept.
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3>, bool>::type contains( const V& v) const
+	{
+		BOOST_CONCEPT_ASSERT( (Vertex3D<V>));
+		const unit_type x = v.x(), y = v.y(), z = v.z();
+		for( unsigned i = 0; i < PLANES_COUNT; ++i)
+		{
+			if( this->distance( i, x, y, z) < unit_traits_type::zero())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// \brief It classifies a sphere against the frustum.
+	/// \tparam V the vertex type, implementing the 3D vertex concept.
+	/// \param center the center of the sphere.
+	/// \param radius the radius of the sphere.
+	/// \param[in,out] plane_mask the planes to be tested. On return, it contains the planes intersecting the sphere.
+	/// \param[in,out] first_plane the plane to be tested first. If the sphere is outside, it is set to the plane that
+	///		rejected the sphere.
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3>, classification>::type
+		classify_sphere( const V& center, const unit_type& radius, unsigned& plane_mask, unsigned& first_plane) const
+	{
+		BOOST_CONCEPT_ASSERT( (Vertex3D<V>));
+		assert( first_plane < PLANES_COUNT);
+		const unit_type x = center.x(), y = center.y(), z = center.z();
+		unsigned out_mask = 0;
+		for( unsigned k = 0; k < PLANES_COUNT; ++k)
+		{
+			// Start with the coherent plane, then continue with the others in order.
+			unsigned i = (first_plane + k) % PLANES_COUNT;
+			if( !(plane_mask & (1u << i)))
+			{
+				continue;
+			}
+			unit_type dist = this->distance( i, x, y, z);
+			if( dist < -radius)
+			{
+				first_plane = i;
+				return OUTSIDE;
+			}
+			if( dist < radius)
+			{
+				out_mask |= 1u << i;
+			}
+		}
+		plane_mask = out_mask;
+		return out_mask ? INTERSECTS : INSIDE;
+	}
+
+	/// \brief It classifies a sphere against the frustum, testing all the planes.
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3>, classification>::type
+		classify_sphere( const V& center, const unit_type& radius) const
+	{
+		unsigned plane_mask = ALL_PLANES, first_plane = 0;
+		return this->classify_sphere( center, radius, plane_mask, first_plane);
+	}
+
+	/// \brief It classifies an axis aligned box against the frustum.
+	/// \tparam V the vertex type, implementing the 3D vertex concept.
+	/// \param min_corner the corner of the box having the minimum coordinates.
+	/// \param max_corner the corner of the box having the maximum coordinates.
+	/// \param[in,out] plane_mask the planes to be tested. On return, it contains the planes intersecting the box.
+	/// \param[in,out] first_plane the plane to be tested first. If the box is outside, it is set to the plane that
+	///		rejected the box.
+	/// \details
+	///		For each plane, it tests only the box corner which is the farthest along the plane normal (if it is outside,
+	///		the whole box is outside) and the opposite one (if it is inside, the whole box is inside the plane).
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3>, classification>::type
+		classify_box( const V& min_corner, const V& max_corner, unsigned& plane_mask, unsigned& first_plane) const
+	{
+		BOOST_CONCEPT_ASSERT( (Vertex3D<V>));
+		assert( first_plane < PLANES_COUNT);
+		const unit_type
+			min_x = min_corner.x(), min_y = min_corner.y(), min_z = min_corner.z(),
+			max_x = max_corner.x(), max_y = max_corner.y(), max_z = max_corner.z();
+		unsigned out_mask = 0;
+		for( unsigned k = 0; k < PLANES_COUNT; ++k)
+		{
+			unsigned i = (first_plane + k) % PLANES_COUNT;
+			if( !(plane_mask & (1u << i)))
+			{
+				continue;
+			}
+			const bool pos_a = a_[i] >= 0, pos_b = b_[i] >= 0, pos_c = c_[i] >= 0;
+			if( this->distance( i, pos_a ? max_x : min_x, pos_b ? max_y : min_y, pos_c ? max_z : min_z)
+				< unit_traits_type::zero())
+			{
+				first_plane = i;
+				return OUTSIDE;
+			}
+			if( this->distance( i, pos_a ? min_x : max_x, pos_b ? min_y : max_y, pos_c ? min_z : max_z)
+				< unit_traits_type::zero())
+			{
+				out_mask |= 1u << i;
+			}
+		}
+		plane_mask = out_mask;
+		return out_mask ? INTERSECTS : INSIDE;
+	}
+
+	/// \brief It classifies an axis aligned box against the frustum, testing all the planes.
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3>, classification>::type
+		classify_box( const V& min_corner, const V& max_corner) const
+	{
+		unsigned plane_mask = ALL_PLANES, first_plane = 0;
+		return this->classify_box( min_corner, max_corner, plane_mask, first_plane);
+	}
+
+	/// \brief It culls a sequence of vertices.
+	/// \tparam VIt the iterator type of the vertex sequence. The vertices must implement the 3D vertex concept.
+	/// \param first the beginning of the vertex sequence.
+	/// \param last the end of the vertex sequence.
+	/// \param[out] visibility the visibility bits: the bit <c>i % 32</c> of the word <c>i / 32</c> is set if the
+	///		vertex i is inside the frustum. The buffer must have place for at least <c>(n + 31) / 32</c> words.
+	/// \param plane_mask the planes to be tested (e.g. the planes intersecting the volume bounding the vertices).
+	/// \return the number of visible vertices.
+	template< typename VIt>
+	unsigned cull_points( VIt first, VIt last, boost::uint32_t* visibility, unsigned plane_mask = ALL_PLANES) const
+	{
+		unit_type x[BLOCK_SIZE], y[BLOCK_SIZE], z[BLOCK_SIZE];
+		unsigned visible = 0;
+		while( first != last)
+		{
+			unsigned n = 0;
+			for( ; n < BLOCK_SIZE && first != last; ++n, ++first)
+			{
+				x[n] = first->x(); y[n] = first->y(); z[n] = first->z();
+			}
+			*visibility = this->cull_block( x, y, z, x, y, z, n, plane_mask);
+			visible += count_bits( *visibility++);
+		}
+		return visible;
+	}
+
+	/// \brief It culls a sequence of spheres.
+	/// \tparam VIt the iterator type of the sphere centers. The vertices must implement the 3D vertex concept.
+	/// \tparam RIt the iterator type of the sphere radii.
+	/// \param first the beginning of the sphere center sequence.
+	/// \param last the end of the sphere center sequence.
+	/// \param radius the beginning of the sphere radius sequence.
+	/// \param[out] visibility the visibility bits: the bit <c>i % 32</c> of the word <c>i / 32</c> is set if the
+	///		sphere i is at least partially inside the frustum. The buffer must have place for at least
+	///		<c>(n + 31) / 32</c> words.
+	/// \param plane_mask the planes to be tested (e.g. the planes intersecting the volume bounding the spheres).
+	/// \return the number of visible spheres.
+	template< typename VIt, typename RIt>
+	unsigned cull_spheres( VIt first, VIt last, RIt radius, boost::uint32_t* visibility,
+		unsigned plane_mask = ALL_PLANES) const
+	{
+		unit_type x[BLOCK_SIZE], y[BLOCK_SIZE], z[BLOCK_SIZE], r[BLOCK_SIZE];
+		unsigned visible = 0;
+		while( first != last)
+		{
+			unsigned n = 0;
+			for( ; n < BLOCK_SIZE && first != last; ++n, ++first, ++radius)
+			{
+				x[n] = first->x(); y[n] = first->y(); z[n] = first->z(); r[n] = *radius;
+			}
+
+			unsigned char inside[BLOCK_SIZE];
+			std::fill( inside, inside + n, 1);
+			for( unsigned i = 0; i < PLANES_COUNT; ++i)
+			{
+				if( !(plane_mask & (1u << i)))
+				{
+					continue;
+				}
+				const unit_type a = a_[i], b = b_[i], c = c_[i], d = d_[i];
+				for( unsigned j = 0; j < n; ++j)
+				{
+					inside[j] &= (a*x[j] + b*y[j] + c*z[j] + d >= -r[j]);
+				}
+			}
+
+			*visibility = pack_bits( inside, n);
+			visible += count_bits( *visibility++);
+		}
+		return visible;
+	}
+
+	/// \brief It culls a sequence of axis aligned boxes.
+	/// \tparam VIt the iterator type of the box corners. The vertices must implement the 3D vertex concept.
+	/// \param first the beginning of the sequence of minimum corners.
+	/// \param last the end of the sequence of minimum corners.
+	/// \param max_corner the beginning of the sequence of maximum corners.
+	/// \param[out] visibility the visibility bits: the bit <c>i % 32</c> of the word <c>i / 32</c> is set if the
+	///		box i is at least partially inside the frustum. The buffer must have place for at least
+	///		<c>(n + 31) / 32</c> words.
+	/// \param plane_mask the planes to be tested (e.g. the planes intersecting the volume bounding the boxes).
+	/// \return the number of visible boxes.
+	/// \details
+	///		A box is rejected if its farthest corner along the normal of one plane is outside that plane. This is
+	///		conservative: a few boxes near the frustum edges are reported visible even if they are outside.
+	template< typename VIt>
+	unsigned cull_boxes( VIt first, VIt last, VIt max_corner, boost::uint32_t* visibility,
+		unsigned plane_mask = ALL_PLANES) const
+	{
+		unit_type
+			min_x[BLOCK_SIZE], min_y[BLOCK_SIZE], min_z[BLOCK_SIZE],
+			max_x[BLOCK_SIZE], max_y[BLOCK_SIZE], max_z[BLOCK_SIZE];
+		unsigned visible = 0;
+		while( first != last)
+		{
+			unsigned n = 0;
+			for( ; n < BLOCK_SIZE && first != last; ++n, ++first, ++max_corner)
+			{
+				min_x[n] = first->x(); min_y[n] = first->y(); min_z[n] = first->z();
+				max_x[n] = max_corner->x(); max_y[n] = max_corner->y(); max_z[n] = max_corner->z();
+			}
+			*visibility = this->cull_block( min_x, min_y, min_z, max_x, max_y, max_z, n, plane_mask);
+			visible += count_bits( *visibility++);
+		}
+		return visible;
+	}
+
+	/// \brief It culls a random access sequence of vertices, as specified by the execution policy.
+	/// \param policy the execution policy.
+	/// \copydetails cull_points( VIt, VIt, boost::uint32_t*, unsigned) const
+	template< typename P, typename RandomIt>
+	typename boost::enable_if< parallel::is_execution_policy< P>, unsigned>::type cull_points( const P& policy,
+		RandomIt first, RandomIt last, boost::uint32_t* visibility, unsigned plane_mask = ALL_PLANES) const
+	{
+		const std::size_t count = last - first, words = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		const impl::cull_points_chunk< frustum, RandomIt> chunk = { this, first, count, visibility, plane_mask };
+		parallel::for_each_chunk( policy, 0, words, impl::CULLING_MIN_GRAIN, chunk);
+		return count_bits( visibility, words);
+	}
+
+	/// \brief It culls a random access sequence of spheres, as specified by the execution policy.
+	/// \param policy the execution policy.
+	/// \copydetails cull_spheres( VIt, VIt, RIt, boost::uint32_t*, unsigned) const
+	template< typename P, typename RandomIt, typename RandomRIt>
+	typename boost::enable_if< parallel::is_execution_policy< P>, unsigned>::type cull_spheres( const P& policy,
+		RandomIt first, RandomIt last, RandomRIt radius, boost::uint32_t* visibility,
+		unsigned plane_mask = ALL_PLANES) const
+	{
+		const std::size_t count = last - first, words = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		const impl::cull_spheres_chunk< frustum, RandomIt, RandomRIt> chunk =
+			{ this, first, radius, count, visibility, plane_mask };
+		parallel::for_each_chunk( policy, 0, words, impl::CULLING_MIN_GRAIN, chunk);
+		return count_bits( visibility, words);
+	}
+
+	/// \brief It culls a random access sequence of axis aligned boxes, as specified by the execution policy.
+	/// \param policy the execution policy.
+	/// \copydetails cull_boxes( VIt, VIt, VIt, boost::uint32_t*, unsigned) const
+	template< typename P, typename RandomIt>
+	typename boost::enable_if< parallel::is_execution_policy< P>, unsigned>::type cull_boxes( const P& policy,
+		RandomIt first, RandomIt last, RandomIt max_corner, boost::uint32_t* visibility,
+		unsigned plane_mask = ALL_PLANES) const
+	{
+		const std::size_t count = last - first, words = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+		const impl::cull_boxes_chunk< frustum, RandomIt> chunk =
+			{ this, first, max_corner, count, visibility, plane_mask };
+		parallel::for_each_chunk( policy, 0, words, impl::CULLING_MIN_GRAIN, chunk);
+		return count_bits( visibility, words);
+	}
+
+private:
+	void set_plane( unsigned i, const unit_type& a, const unit_type& b, const unit_type& c, const unit_type& d)
+	{
+		unit_type norm = std::sqrt( a*a + b*b + c*c);
+		assert( !unit_traits_type::is_zero( norm));
+		a_[i] = a / norm;
+		b_[i] = b / norm;
+		c_[i] = c / norm;
+		d_[i] = d / norm;
+	}
+
+	/// \brief It culls a block of boxes, testing for each plane the corner farthest along the plane normal.
+	/// \details The points are culled as boxes having the same minimum and maximum corners.
+	boost::uint32_t cull_block(
+		const unit_type* min_x, const unit_type* min_y, const unit_type* min_z,
+		const unit_type* max_x, const unit_type* max_y, const unit_type* max_z,
+		unsigned n, unsigned plane_mask) const
+	{
+		unsigned char inside[BLOCK_SIZE];
+		std::fill( inside, inside + n, 1);
+		for( unsigned i = 0; i < PLANES_COUNT; ++i)
+		{
+			if( !(plane_mask & (1u << i)))
+			{
+				continue;
+			}
+			// The choice of the corner depends only on the plane, so it is done once for the whole block.
+			const unit_type a = a_[i], b = b_[i], c = c_[i], d = d_[i];
+			const unit_type
+				*x = a >= 0 ? max_x : min_x,
+				*y = b >= 0 ? max_y : min_y,
+				*z = c >= 0 ? max_z : min_z;
+			for( unsigned j = 0; j < n; ++j)
+			{
+				inside[j] &= (a*x[j] + b*y[j] + c*z[j] + d >= 0);
+			}
+		}
+		return pack_bits( inside, n);
+	}
+
+	static boost::uint32_t pack_bits( const unsigned char* flags, unsigned n)
+	{
+		boost::uint32_t bits = 0;
+		for( unsigned j = 0; j < n; ++j)
+		{
+			bits |= boost::uint32_t( flags[j]) << j;
+		}
+		return bits;
+	}
+
+	static unsigned count_bits( boost::uint32_t bits)
+	{
+		unsigned count = 0;
+		for( ; bits; bits &= bits - 1)
+		{
+			++count;
+		}
+		return count;
+	}
+
+	static unsigned count_bits( const boost::uint32_t* words, std::size_t count)
+	{
+		unsigned bits = 0;
+		for( std::size_t i = 0; i < count; ++i)
+		{
+			bits += count_bits( words[i]);
+		}
+		return bits;
+	}
+
+private:
+	unit_type a_[PLANES_COUNT], b_[PLANES_COUNT], c_[PLANES_COUNT], d_[PLANES_COUNT];
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_FRUSTUM_HPP
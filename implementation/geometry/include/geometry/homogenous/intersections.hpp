@@ -3,6 +3,12 @@
 
 #include "geometry/homogenous/shortest_segment.hpp"
 #include "geometry/plane_concept.hpp"
+#include "geometry/ray_concept.hpp"
+#include "geometry/segment_concept.hpp"
+#include "geometry/homogenous/ray_packet.hpp"
+#include "algebra/tolerance_policy_concept.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/utility/enable_if.hpp>
 #include <cmath>
 
 namespace geometry
@@ -108,6 +114,602 @@ intersect( const P& p1, const P& p2)
 	return L( typename L::vertex_type( p0), typename L::direction_type( n1_x_n2));
 }
 
+namespace impl
+{
+
+/// \brief It calculates the vertex shared by three planes, using Cramer's rule.
+/// \return false if the planes don't have a single common point, true otherwise.
+/// \details
+///		The check of degenerate cases uses the determinant of the normals divided by the norms of the normals. That 
+///		value is the volume of the parallelepiped built on the unit normals, so it doesn't depend on the scale of the 
+///		plane coefficients. The given predicate receives it and returns true if it should be considered zero.
+template< typename P, typename IsZero>
+bool intersect_planes( 
+	const P& p1, const P& p2, const P& p3, 
+	typename P::coord_system::pos_rep& result, 
+	const IsZero& is_zero)
+{
+	typedef typename P::coord_system coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	typedef typename coord_system::dir_rep::matrix_type matrix_type;
+
+	// We have the system of equations Ni.p = -di, for i = 1..3, written as A*p = B, where the rows of A are the 
+	// normals of the planes.
+	matrix_type a( 
+		p1.a(), p1.b(), p1.c(),
+		p2.a(), p2.b(), p2.c(),
+		p3.a(), p3.b(), p3.c());
+	unit_type det = a.det();
+
+	unit_type norms = 
+		std::sqrt( p1.a()*p1.a() + p1.b()*p1.b() + p1.c()*p1.c())
+		* std::sqrt( p2.a()*p2.a() + p2.b()*p2.b() + p2.c()*p2.c())
+		* std::sqrt( p3.a()*p3.a() + p3.b()*p3.b() + p3.c()*p3.c());
+	if( is_zero( norms) || is_zero( det / norms))
+	{
+		// At least two of the planes are parallel, or the three planes share a common line.
+		return false;
+	}
+
+	// Each coordinate is the determinant of the matrix having the corresponding column replaced by B, divided by the 
+	// determinant of A.
+	const unit_type d1 = -p1.d(), d2 = -p2.d(), d3 = -p3.d();
+	matrix_type 
+		ax( 
+			d1, p1.b(), p1.c(),
+			d2, p2.b(), p2.c(),
+			d3, p3.b(), p3.c()),
+		ay(
+			p1.a(), d1, p1.c(),
+			p2.a(), d2, p2.c(),
+			p3.a(), d3, p3.c()),
+		az(
+			p1.a(), p1.b(), d1,
+			p2.a(), p2.b(), d2,
+			p3.a(), p3.b(), d3);
+	result = typename coord_system::pos_rep( ax.det() / det, ay.det() / det, az.det() / det);
+	return true;
+}
+
+/// \brief It adapts a tolerance policy to the zero checking predicate of the plane intersection.
+template< typename TP>
+class tolerance_is_zero
+{
+public:
+	explicit tolerance_is_zero( const TP& tolerance)
+		: tolerance_( tolerance) { }
+
+	bool operator()( const typename TP::unit_type& value) const
+	{
+		return tolerance_.equals( value, typename TP::unit_type( 0));
+	}
+
+private:
+	const TP& tolerance_;
+};
+
+/// \brief The zero checking predicate of the plane intersection, relying on the unit traits.
+template< typename UT>
+struct traits_is_zero
+{
+	bool operator()( const typename UT::unit_type& value) const
+	{
+		return UT::is_zero( value);
+	}
+};
+
+} // namespace impl
+
+
+/// \ingroup geometry
+/// \brief It calculates the intersection point of three planes.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \tparam P the type of the plane, implementing Plane concept
+/// \tparam TP the tolerance policy used for deciding whether the planes have a single common point.
+/// \param p1 the first plane involved in the calculation.
+/// \param p2 the second plane involved in the calculation.
+/// \param p3 the third plane involved in the calculation.
+/// \param tolerance the tolerance for the determinant of the unit normals of the planes.
+/// \return the common vertex of the planes or an invalid one if at least two planes are parallel or the planes share 
+///		a common line.
+/// \details
+///		It solves directly the system of the three plane equations with Cramer's rule, instead of intersecting the 
+///		line of two planes with the third one.
+template< typename V, typename P, typename TP>
+typename boost::enable_if_c<
+		impl::is_plane< P, 3, hcoord_system_tag>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		V>::type
+	intersect( const P& p1, const P& p2, const P& p3, const TP& tolerance)
+{
+	BOOST_CONCEPT_ASSERT( (Plane<P>));
+	BOOST_CONCEPT_ASSERT( (algebra::TolerancePolicy<TP>));
+	typedef typename V::unit_traits_type unit_traits_type;
+
+	typename P::coord_system::pos_rep result;
+	if( impl::intersect_planes( p1, p2, p3, result, impl::tolerance_is_zero< TP>( tolerance)))
+	{
+		return V( result);
+	}
+	else
+		return V( unit_traits_type::infinity(), unit_traits_type::infinity(), unit_traits_type::infinity());
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection point of three planes.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \tparam P the type of the plane, implementing Plane concept
+/// \param p1 the first plane involved in the calculation.
+/// \param p2 the second plane involved in the calculation.
+/// \param p3 the third plane involved in the calculation.
+/// \return the common vertex of the planes or an invalid one if at least two planes are parallel or the planes share 
+///		a common line.
+/// \details The degenerate cases are detected using the zero checking of the unit traits.
+template< typename V, typename P>
+typename boost::enable_if_c<
+		impl::is_plane< P, 3, hcoord_system_tag>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		V>::type
+	intersect( const P& p1, const P& p2, const P& p3)
+{
+	BOOST_CONCEPT_ASSERT( (Plane<P>));
+	typedef typename V::unit_traits_type unit_traits_type;
+
+	typename P::coord_system::pos_rep result;
+	if( impl::intersect_planes( p1, p2, p3, result, impl::traits_is_zero< unit_traits_type>()))
+	{
+		return V( result);
+	}
+	else
+		return V( unit_traits_type::infinity(), unit_traits_type::infinity(), unit_traits_type::infinity());
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection points of a sequence of plane triples.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \tparam PIt the iterator type of the plane sequences. The planes must implement Plane concept.
+/// \tparam VIt the output iterator type, accepting vertices of type V.
+/// \tparam TP the tolerance policy used for deciding whether the planes have a single common point.
+/// \param first1 the beginning of the sequence of the first planes of the triples.
+/// \param last1 the end of the sequence of the first planes of the triples.
+/// \param first2 the beginning of the sequence of the second planes of the triples.
+/// \param first3 the beginning of the sequence of the third planes of the triples.
+/// \param out the beginning of the destination sequence.
+/// \param tolerance the tolerance for the determinant of the unit normals of the planes.
+/// \return the output iterator after the last written vertex.
+/// \details
+///		For each position i, it writes the intersection of the planes <c>first1[i]</c>, <c>first2[i]</c> and 
+///		<c>first3[i]</c>, or an invalid vertex if they don't have a single common point. The three input sequences and 
+///		the output sequence must have the same length.
+template< typename V, typename PIt, typename VIt, typename TP>
+typename boost::enable_if_c< impl::is_vertex< V, 3, hcoord_system_tag>::value, VIt>::type
+	intersect( PIt first1, PIt last1, PIt first2, PIt first3, VIt out, const TP& tolerance)
+{
+	BOOST_CONCEPT_ASSERT( (algebra::TolerancePolicy<TP>));
+	for( ; first1 != last1; ++first1, ++first2, ++first3, ++out)
+	{
+		*out = intersect< V>( *first1, *first2, *first3, tolerance);
+	}
+	return out;
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection points of a sequence of plane triples.
+/// \details 
+///		It is the same as the version receiving the tolerance policy, except the degenerate cases are detected using 
+///		the zero checking of the unit traits.
+template< typename V, typename PIt, typename VIt>
+typename boost::enable_if_c< impl::is_vertex< V, 3, hcoord_system_tag>::value, VIt>::type
+	intersect( PIt first1, PIt last1, PIt first2, PIt first3, VIt out)
+{
+	for( ; first1 != last1; ++first1, ++first2, ++first3, ++out)
+	{
+		*out = intersect< V>( *first1, *first2, *first3);
+	}
+	return out;
+}
+
+
+namespace impl
+{
+
+/// \brief It calculates the parameter of the point where the line <c>origin + t*dir</c> crosses the given plane.
+/// \return false if the line is parallel with the plane, true otherwise.
+template< typename CS, typename P>
+bool intersect_line_plane( 
+	const typename CS::pos_rep& origin, 
+	const typename CS::dir_rep& dir, 
+	const P& p, 
+	typename CS::unit_type& t)
+{
+	typedef typename CS::unit_traits_type unit_traits_type;
+	typedef typename CS::unit_type unit_type;
+
+	// We have the plane defined as N.p + d = 0 and the points of the line as p = O + t*D. Replacing p gives:
+	//		t = -(N.O + d) / N.D
+	typename CS::dir_rep normal( p.a(), p.b(), p.c());
+	unit_type denom = normal * dir;
+	if( unit_traits_type::is_zero( denom))
+	{
+		return false;
+	}
+	t = -(normal * origin + p.d()) / denom;
+	return true;
+}
+
+/// \brief It calculates the parameter of the point where the line <c>origin + t*dir</c> crosses the given triangle.
+/// \return false if the line is parallel with the triangle plane or it misses the triangle, true otherwise.
+/// \details It uses Moller-Trumbore algorithm, which doesn't need the plane of the triangle.
+template< typename CS>
+bool intersect_line_triangle( 
+	const typename CS::pos_rep& origin, 
+	const typename CS::dir_rep& dir, 
+	const typename CS::pos_rep& v0,
+	const typename CS::pos_rep& v1,
+	const typename CS::pos_rep& v2,
+	typename CS::unit_type& t)
+{
+	typedef typename CS::unit_traits_type unit_traits_type;
+	typedef typename CS::unit_type unit_type;
+
+	// The point of the triangle is written using barycentric coordinates as: 
+	//		O + t*D = (1-u-v)*V0 + u*V1 + v*V2
+	// and the system of equations is solved using Cramer's rule, with the determinants written as triple products.
+	typename CS::dir_rep 
+		e1 = v1 - v0,
+		e2 = v2 - v0,
+		pvec = dir % e2;
+	unit_type det = e1 * pvec;
+	if( unit_traits_type::is_zero( det))
+	{
+		return false;
+	}
+
+	unit_type inv_det = unit_traits_type::one() / det;
+	typename CS::dir_rep tvec = origin - v0;
+	unit_type u = (tvec * pvec) * inv_det;
+	if( u < unit_traits_type::zero() || u > unit_traits_type::one())
+	{
+		return false;
+	}
+
+	typename CS::dir_rep qvec = tvec % e1;
+	unit_type v = (dir * qvec) * inv_det;
+	if( v < unit_traits_type::zero() || u + v > unit_traits_type::one())
+	{
+		return false;
+	}
+
+	t = (e2 * qvec) * inv_det;
+	return true;
+}
+
+} // namespace impl
+
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a ray and a plane.
+/// \tparam R the ray type, implementing Ray concept.
+/// \tparam P the plane type, implementing Plane concept.
+/// \param r the ray involved in calculation
+/// \param p the plane involved in calculation
+/// \param[out] t the distance from the ray origin to the intersection point. It is set only if there is an intersection.
+/// \return true if the ray hits the plane, false if the ray is parallel with the plane or it points away from it.
+template< typename R, typename P>
+typename boost::enable_if_c<
+		impl::is_ray< R, 3, hcoord_system_tag>::value && impl::is_plane< P, 3, hcoord_system_tag>::value,
+		bool>::type
+	intersect( const R& r, const P& p, typename R::unit_type& t)
+{
+	BOOST_CONCEPT_ASSERT( (Ray3D<R>));
+	BOOST_CONCEPT_ASSERT( (Plane<P>));
+	typedef typename R::coord_system coord_system;
+
+	typename R::unit_type param;
+	if( !impl::intersect_line_plane< coord_system>( r.origin().normalized(), r.dir().representation(), p, param)
+		|| param < R::unit_traits_type::zero())
+	{
+		return false;
+	}
+	t = param;
+	return true;
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a ray and a plane.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \tparam R the ray type, implementing Ray concept.
+/// \tparam P the plane type, implementing Plane concept.
+/// \param r the ray involved in calculation
+/// \param p the plane involved in calculation
+/// \return the intersection vertex or an invalid one if the ray doesn't hit the plane.
+template< typename V, typename R, typename P>
+typename boost::enable_if_c<
+		impl::is_ray< R, 3, hcoord_system_tag>::value && impl::is_plane< P, 3, hcoord_system_tag>::value
+			&& impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		V>::type
+	intersect( const R& r, const P& p)
+{
+	typedef typename V::unit_traits_type unit_traits_type;
+	typename R::unit_type t;
+	if( intersect( r, p, t))
+	{
+		return V( r.origin().normalized() + t * r.dir().representation());
+	}
+	else
+		return V( unit_traits_type::infinity(), unit_traits_type::infinity(), unit_traits_type::infinity());
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a ray and a triangle.
+/// \tparam R the ray type, implementing Ray concept.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \param r the ray involved in calculation
+/// \param v0 the first vertex of the triangle.
+/// \param v1 the second vertex of the triangle.
+/// \param v2 the third vertex of the triangle.
+/// \param[out] t the distance from the ray origin to the intersection point. It is set only if there is an intersection.
+/// \return true if the ray hits the triangle, false otherwise.
+/// \details The triangle is hit from both sides, no back face culling is performed.
+template< typename R, typename V>
+typename boost::enable_if_c<
+		impl::is_ray< R, 3, hcoord_system_tag>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		bool>::type
+	intersect( const R& r, const V& v0, const V& v1, const V& v2, typename R::unit_type& t)
+{
+	BOOST_CONCEPT_ASSERT( (Ray3D<R>));
+	typedef typename R::coord_system coord_system;
+
+	typename R::unit_type param;
+	if( !impl::intersect_line_triangle< coord_system>( 
+			r.origin().normalized(), r.dir().representation(), v0.normalized(), v1.normalized(), v2.normalized(), param)
+		|| param < R::unit_traits_type::zero())
+	{
+		return false;
+	}
+	t = param;
+	return true;
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a ray and a triangle.
+/// \tparam R the ray type, implementing Ray concept.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \param r the ray involved in calculation
+/// \param v0 the first vertex of the triangle.
+/// \param v1 the second vertex of the triangle.
+/// \param v2 the third vertex of the triangle.
+/// \return the intersection vertex or an invalid one if the ray doesn't hit the triangle.
+template< typename R, typename V>
+typename boost::enable_if_c<
+		impl::is_ray< R, 3, hcoord_system_tag>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		V>::type
+	intersect( const R& r, const V& v0, const V& v1, const V& v2)
+{
+	typedef typename V::unit_traits_type unit_traits_type;
+	typename R::unit_type t;
+	if( intersect( r, v0, v1, v2, t))
+	{
+		return V( r.origin().normalized() + t * r.dir().representation());
+	}
+	else
+		return V( unit_traits_type::infinity(), unit_traits_type::infinity(), unit_traits_type::infinity());
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a segment and a plane.
+/// \tparam S the segment type, implementing Segment concept.
+/// \tparam P the plane type, implementing Plane concept.
+/// \param s the segment involved in calculation
+/// \param p the plane involved in calculation
+/// \param[out] t the position of the intersection point on the segment: 0 for the first end, 1 for the second one. 
+///		It is set only if there is an intersection.
+/// \return true if the segment crosses the plane, false otherwise.
+template< typename S, typename P>
+typename boost::enable_if_c<
+		impl::is_segment< S, 3, hcoord_system_tag>::value && impl::is_plane< P, 3, hcoord_system_tag>::value,
+		bool>::type
+	intersect( const S& s, const P& p, typename S::unit_type& t)
+{
+	BOOST_CONCEPT_ASSERT( (Segment3D<S>));
+	BOOST_CONCEPT_ASSERT( (Plane<P>));
+	typedef typename S::coord_system coord_system;
+	typedef typename S::unit_traits_type unit_traits_type;
+
+	typename coord_system::pos_rep first = s.first().normalized();
+	typename S::unit_type param;
+	if( !impl::intersect_line_plane< coord_system>( first, s.second().normalized() - first, p, param)
+		|| param < unit_traits_type::zero() || param > unit_traits_type::one())
+	{
+		return false;
+	}
+	t = param;
+	return true;
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a segment and a plane.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \tparam S the segment type, implementing Segment concept.
+/// \tparam P the plane type, implementing Plane concept.
+/// \param s the segment involved in calculation
+/// \param p the plane involved in calculation
+/// \return the intersection vertex or an invalid one if the segment doesn't cross the plane.
+template< typename V, typename S, typename P>
+typename boost::enable_if_c<
+		impl::is_segment< S, 3, hcoord_system_tag>::value && impl::is_plane< P, 3, hcoord_system_tag>::value
+			&& impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		V>::type
+	intersect( const S& s, const P& p)
+{
+	typedef typename V::unit_traits_type unit_traits_type;
+	typename S::unit_type t;
+	if( intersect( s, p, t))
+	{
+		typename S::coord_system::pos_rep first = s.first().normalized();
+		return V( first + t * (s.second().normalized() - first));
+	}
+	else
+		return V( unit_traits_type::infinity(), unit_traits_type::infinity(), unit_traits_type::infinity());
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a segment and a triangle.
+/// \tparam S the segment type, implementing Segment concept.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \param s the segment involved in calculation
+/// \param v0 the first vertex of the triangle.
+/// \param v1 the second vertex of the triangle.
+/// \param v2 the third vertex of the triangle.
+/// \param[out] t the position of the intersection point on the segment: 0 for the first end, 1 for the second one. 
+///		It is set only if there is an intersection.
+/// \return true if the segment crosses the triangle, false otherwise.
+template< typename S, typename V>
+typename boost::enable_if_c<
+		impl::is_segment< S, 3, hcoord_system_tag>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		bool>::type
+	intersect( const S& s, const V& v0, const V& v1, const V& v2, typename S::unit_type& t)
+{
+	BOOST_CONCEPT_ASSERT( (Segment3D<S>));
+	typedef typename S::coord_system coord_system;
+	typedef typename S::unit_traits_type unit_traits_type;
+
+	typename coord_system::pos_rep first = s.first().normalized();
+	typename S::unit_type param;
+	if( !impl::intersect_line_triangle< coord_system>( 
+			first, s.second().normalized() - first, v0.normalized(), v1.normalized(), v2.normalized(), param)
+		|| param < unit_traits_type::zero() || param > unit_traits_type::one())
+	{
+		return false;
+	}
+	t = param;
+	return true;
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection between a segment and a triangle.
+/// \tparam S the segment type, implementing Segment concept.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \param s the segment involved in calculation
+/// \param v0 the first vertex of the triangle.
+/// \param v1 the second vertex of the triangle.
+/// \param v2 the third vertex of the triangle.
+/// \return the intersection vertex or an invalid one if the segment doesn't cross the triangle.
+template< typename S, typename V>
+typename boost::enable_if_c<
+		impl::is_segment< S, 3, hcoord_system_tag>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		V>::type
+	intersect( const S& s, const V& v0, const V& v1, const V& v2)
+{
+	typedef typename V::unit_traits_type unit_traits_type;
+	typename S::unit_type t;
+	if( intersect( s, v0, v1, v2, t))
+	{
+		typename S::coord_system::pos_rep first = s.first().normalized();
+		return V( first + t * (s.second().normalized() - first));
+	}
+	else
+		return V( unit_traits_type::infinity(), unit_traits_type::infinity(), unit_traits_type::infinity());
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersections between a packet of rays and a plane.
+/// \tparam CS the coordinate system of the rays. It must be a three dimensional homogenous coordinate system.
+/// \tparam N the number of rays in the packet.
+/// \tparam P the plane type, implementing Plane concept.
+/// \param rays the packet of rays involved in calculation.
+/// \param p the plane involved in calculation.
+/// \param[out] t the distances from the ray origins to the intersection points. The distance is infinity for the 
+///		rays which don't hit the plane.
+/// \return a bit mask having the bit i set if the ray i hits the plane.
+/// \details
+///		All the rays are processed in the same way, without branches, so the loop over the rays can be vectorized.
+template< typename CS, unsigned N, typename P>
+typename boost::enable_if_c< impl::is_plane< P, 3, hcoord_system_tag>::value, unsigned>::type
+	intersect( const ray_packet< CS, N>& rays, const P& p, typename CS::unit_type (&t)[N])
+{
+	BOOST_CONCEPT_ASSERT( (Plane<P>));
+	typedef typename CS::unit_traits_type unit_traits_type;
+	typedef typename CS::unit_type unit_type;
+
+	const unit_type a = p.a(), b = p.b(), c = p.c(), d = p.d();
+	const unit_type *x = rays.x(), *y = rays.y(), *z = rays.z(), *dx = rays.dx(), *dy = rays.dy(), *dz = rays.dz();
+
+	unsigned mask = 0;
+	for( unsigned i = 0; i < N; ++i)
+	{
+		unit_type denom = a*dx[i] + b*dy[i] + c*dz[i];
+		unit_type param = -(a*x[i] + b*y[i] + c*z[i] + d) / denom;
+		bool hit = !unit_traits_type::is_zero( denom) && param >= unit_traits_type::zero();
+		t[i] = hit ? param : unit_traits_type::infinity();
+		mask |= unsigned( hit) << i;
+	}
+	return mask;
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersections between a packet of rays and a triangle.
+/// \tparam CS the coordinate system of the rays. It must be a three dimensional homogenous coordinate system.
+/// \tparam N the number of rays in the packet.
+/// \tparam V the vertex type, implementing Homogenous Vertex concept.
+/// \param rays the packet of rays involved in calculation.
+/// \param v0 the first vertex of the triangle.
+/// \param v1 the second vertex of the triangle.
+/// \param v2 the third vertex of the triangle.
+/// \param[out] t the distances from the ray origins to the intersection points. The distance is infinity for the 
+///		rays which don't hit the triangle.
+/// \return a bit mask having the bit i set if the ray i hits the triangle.
+/// \details
+///		It uses the Moller-Trumbore algorithm, like the single ray version. The triangle edges are calculated once for 
+///		the whole packet and the rays are processed without branches, so the loop over the rays can be vectorized.
+template< typename CS, unsigned N, typename V>
+typename boost::enable_if_c< impl::is_vertex< V, 3, hcoord_system_tag>::value, unsigned>::type
+	intersect( const ray_packet< CS, N>& rays, const V& v0, const V& v1, const V& v2, typename CS::unit_type (&t)[N])
+{
+	typedef typename CS::unit_traits_type unit_traits_type;
+	typedef typename CS::unit_type unit_type;
+
+	typename CS::pos_rep p0 = v0.normalized();
+	typename CS::dir_rep 
+		e1 = v1.normalized() - p0,
+		e2 = v2.normalized() - p0;
+	const unit_type 
+		e1x = e1( 0), e1y = e1( 1), e1z = e1( 2),
+		e2x = e2( 0), e2y = e2( 1), e2z = e2( 2),
+		p0x = p0( 0), p0y = p0( 1), p0z = p0( 2);
+	const unit_type *x = rays.x(), *y = rays.y(), *z = rays.z(), *dx = rays.dx(), *dy = rays.dy(), *dz = rays.dz();
+
+	unsigned mask = 0;
+	for( unsigned i = 0; i < N; ++i)
+	{
+		// pvec = D x E2
+		unit_type 
+			px = dy[i]*e2z - dz[i]*e2y,
+			py = dz[i]*e2x - dx[i]*e2z,
+			pz = dx[i]*e2y - dy[i]*e2x;
+		unit_type det = e1x*px + e1y*py + e1z*pz;
+		bool valid = !unit_traits_type::is_zero( det);
+		unit_type inv_det = unit_traits_type::one() / (valid ? det : unit_traits_type::one());
+
+		// tvec = O - V0
+		unit_type tx = x[i] - p0x, ty = y[i] - p0y, tz = z[i] - p0z;
+		unit_type u = (tx*px + ty*py + tz*pz) * inv_det;
+
+		// qvec = tvec x E1
+		unit_type 
+			qx = ty*e1z - tz*e1y,
+			qy = tz*e1x - tx*e1z,
+			qz = tx*e1y - ty*e1x;
+		unit_type v = (dx[i]*qx + dy[i]*qy + dz[i]*qz) * inv_det;
+		unit_type param = (e2x*qx + e2y*qy + e2z*qz) * inv_det;
+
+		bool hit = valid 
+			&& u >= unit_traits_type::zero() && v >= unit_traits_type::zero() && u + v <= unit_traits_type::one()
+			&& param >= unit_traits_type::zero();
+		t[i] = hit ? param : unit_traits_type::infinity();
+		mask |= unsigned( hit) << i;
+	}
+	return mask;
+}
+
 } // namespace geometry
 
 #endif // GEOMETRY_HOMOGENOUS_INTERSECTIONS_HPP
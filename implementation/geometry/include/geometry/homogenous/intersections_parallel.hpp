@@ -0,0 +1,95 @@
+#ifndef GEOMETRY_HOMOGENOUS_INTERSECTIONS_PARALLEL_HPP
+#define GEOMETRY_HOMOGENOUS_INTERSECTIONS_PARALLEL_HPP
+
+#include "geometry/homogenous/intersections.hpp"
+#include "algebra/tolerance_policy_concept.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstddef>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The minimum number of plane triples intersected by a parallel task.
+enum { PLANE_TRIPLES_MIN_GRAIN = 2048 };
+
+/// \ingroup geometry
+/// \brief It intersects a chunk of a sequence of plane triples, using the given tolerance policy.
+template< typename V, typename PIt, typename VIt, typename TP>
+struct intersect_triples_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		geometry::intersect< V>( first1 + begin, first1 + end, first2 + begin, first3 + begin, out + begin, *tolerance);
+	}
+
+	PIt first1;
+	PIt first2;
+	PIt first3;
+	VIt out;
+	const TP* tolerance;
+};
+
+/// \ingroup geometry
+/// \brief It intersects a chunk of a sequence of plane triples, using the zero checking of the unit traits.
+template< typename V, typename PIt, typename VIt>
+struct intersect_triples_chunk< V, PIt, VIt, void>
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		geometry::intersect< V>( first1 + begin, first1 + end, first2 + begin, first3 + begin, out + begin);
+	}
+
+	PIt first1;
+	PIt first2;
+	PIt first3;
+	VIt out;
+	const void* tolerance;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It calculates the intersection points of a random access sequence of plane triples, as specified by the
+///		execution policy.
+/// \param policy the execution policy.
+/// \copydetails intersect( PIt, PIt, PIt, PIt, VIt, const TP&)
+///
+///		The output iterator must be a random access iterator as well.
+template< typename V, typename P, typename PIt, typename VIt, typename TP>
+typename boost::enable_if_c<
+		parallel::is_execution_policy< P>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		VIt>::type
+	intersect( const P& policy, PIt first1, PIt last1, PIt first2, PIt first3, VIt out, const TP& tolerance)
+{
+	BOOST_CONCEPT_ASSERT( (algebra::TolerancePolicy<TP>));
+	const impl::intersect_triples_chunk< V, PIt, VIt, TP> chunk = { first1, first2, first3, out, &tolerance };
+	parallel::for_each_chunk( policy, 0, last1 - first1, impl::PLANE_TRIPLES_MIN_GRAIN, chunk);
+	return out + (last1 - first1);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the intersection points of a random access sequence of plane triples, as specified by the
+///		execution policy.
+/// \details
+///		It is the same as the version receiving the tolerance policy, except the degenerate cases are detected using
+///		the zero checking of the unit traits.
+template< typename V, typename P, typename PIt, typename VIt>
+typename boost::enable_if_c<
+		parallel::is_execution_policy< P>::value && impl::is_vertex< V, 3, hcoord_system_tag>::value,
+		VIt>::type
+	intersect( const P& policy, PIt first1, PIt last1, PIt first2, PIt first3, VIt out)
+{
+	const impl::intersect_triples_chunk< V, PIt, VIt, void> chunk = { first1, first2, first3, out, NULL };
+	parallel::for_each_chunk( policy, 0, last1 - first1, impl::PLANE_TRIPLES_MIN_GRAIN, chunk);
+	return out + (last1 - first1);
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_INTERSECTIONS_PARALLEL_HPP
@@ -15,7 +15,9 @@ namespace geometry
 {
 
 /// \brief It checks whether two given directions are parallel or not.
-/// \tparam Dir the direction type, implementing the 3D direction concept.
+/// \tparam Dir1 the type of the first direction, implementing the 3D direction concept.
+/// \tparam Dir2 the type of the second direction, implementing the 3D direction concept. The two directions can have 
+///		different representations (e.g. a direction and a compact direction).
 /// \tparam TP the tolerance policy to be used for comparing the calculation results with the expected results.
 /// \param d1 the first direction to be compared.
 /// \param d2 the second direction to be compared.
@@ -23,13 +25,14 @@ namespace geometry
 /// \details
 ///		It calculates the cosinus of the angle between the two given directions. If the absolute value of that cosinus 
 ///		is 1 (considering the given tolerance), it means that the two directions are parallel.
-template< typename Dir, typename TP>
-typename boost::enable_if< impl::is_direction< Dir, 3>, bool>::type 
-	are_parallel( const Dir& d1, const Dir& d2, const TP& tolerance)
+template< typename Dir1, typename Dir2, typename TP>
+typename boost::enable_if_c< impl::is_direction< Dir1, 3>::value && impl::is_direction< Dir2, 3>::value, bool>::type 
+	are_parallel( const Dir1& d1, const Dir2& d2, const TP& tolerance)
 {
-	typedef typename Dir::unit_type unit_type;
+	typedef typename Dir1::unit_type unit_type;
 	BOOST_CONCEPT_ASSERT( (algebra::TolerancePolicy< TP>));
-	BOOST_CONCEPT_ASSERT( (Direction3D<Dir>));
+	BOOST_CONCEPT_ASSERT( (Direction3D<Dir1>));
+	BOOST_CONCEPT_ASSERT( (Direction3D<Dir2>));
 	// We know that the norm of direction concept is always 1, so we "simply" the computation, by making only the dot 
 	// product:
 	const unit_type cos_angle = d1.dx()*d2.dx() + d1.dy()*d2.dy() + d1.dz()*d2.dz();
@@ -0,0 +1,176 @@
+#ifndef GEOMETRY_HOMOGENOUS_PROJECTION_HPP
+#define GEOMETRY_HOMOGENOUS_PROJECTION_HPP
+
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It projects a sequence of vertices on the screen.
+/// \tparam CS the coordinate system of the projection. It must be a three dimensional homogenous coordinate system.
+/// \tparam VIt the iterator type of the vertex sequence. The vertices must implement the 3D vertex concept.
+/// \param projection the projection transformation (usually the product of projection and view transformations).
+/// \param first the beginning of the vertex sequence.
+/// \param last the end of the vertex sequence.
+/// \param width the width of the screen.
+/// \param height the height of the screen.
+/// \param[out] screen the buffer receiving the screen coordinates: three values (x, y, depth) for each vertex. The
+///		buffer must have place for at least <c>3*n</c> values.
+/// \param[out] visibility the visibility bits: the bit <c>i % 32</c> of the word <c>i / 32</c> is set if the vertex i
+///		is inside the view volume. The buffer must have place for at least <c>(n + 31) / 32</c> words.
+/// \return the number of visible vertices.
+/// \details
+///		For each vertex, it applies the transformation, tests the result against the view volume in homogenous
+///		coordinates (<c>-w <= x, y, z <= w</c>) and then divides by w. The normalized device coordinates are mapped to
+///		the screen with the origin in the lower left corner, and the depth to the range [0, 1]. The screen coordinates
+///		are written for all the vertices, but they are meaningful only for the visible ones.
+///
+///		The vertices are processed in blocks of 32: the coordinates are loaded in local arrays, then each step is done
+///		for the whole block, so the loops can be vectorized by the compiler.
+template< typename CS, typename VIt>
+unsigned project(
+	const transformation< CS>& projection,
+	VIt first, VIt last,
+	const typename CS::unit_type& width, const typename CS::unit_type& height,
+	typename CS::unit_type* screen,
+	boost::uint32_t* visibility)
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+	typedef typename CS::unit_type unit_type;
+	typedef typename CS::unit_traits_type unit_traits_type;
+	enum { BLOCK_SIZE = 32 };
+
+	const typename transformation< CS>::transform_matrix& m = projection.tr_matrix();
+	const unit_type
+		m11 = m( 0, 0), m12 = m( 0, 1), m13 = m( 0, 2), m14 = m( 0, 3),
+		m21 = m( 1, 0), m22 = m( 1, 1), m23 = m( 1, 2), m24 = m( 1, 3),
+		m31 = m( 2, 0), m32 = m( 2, 1), m33 = m( 2, 2), m34 = m( 2, 3),
+		m41 = m( 3, 0), m42 = m( 3, 1), m43 = m( 3, 2), m44 = m( 3, 3);
+	const unit_type
+		half_width = width / 2,
+		half_height = height / 2,
+		half = unit_traits_type::one() / 2;
+
+	unit_type x[BLOCK_SIZE], y[BLOCK_SIZE], z[BLOCK_SIZE];
+	unit_type cx[BLOCK_SIZE], cy[BLOCK_SIZE], cz[BLOCK_SIZE], cw[BLOCK_SIZE];
+	unsigned visible = 0;
+	while( first != last)
+	{
+		unsigned n = 0;
+		for( ; n < BLOCK_SIZE && first != last; ++n, ++first)
+		{
+			x[n] = first->x(); y[n] = first->y(); z[n] = first->z();
+		}
+
+		// Transformation to clip coordinates.
+		for( unsigned i = 0; i < n; ++i)
+		{
+			cx[i] = m11*x[i] + m12*y[i] + m13*z[i] + m14;
+			cy[i] = m21*x[i] + m22*y[i] + m23*z[i] + m24;
+			cz[i] = m31*x[i] + m32*y[i] + m33*z[i] + m34;
+			cw[i] = m41*x[i] + m42*y[i] + m43*z[i] + m44;
+		}
+
+		// Clip test.
+		boost::uint32_t bits = 0;
+		for( unsigned i = 0; i < n; ++i)
+		{
+			bool inside =
+				-cw[i] <= cx[i] && cx[i] <= cw[i]
+				&& -cw[i] <= cy[i] && cy[i] <= cw[i]
+				&& -cw[i] <= cz[i] && cz[i] <= cw[i];
+			bits |= boost::uint32_t( inside) << i;
+		}
+		*visibility++ = bits;
+		for( ; bits; bits &= bits - 1)
+		{
+			++visible;
+		}
+
+		// Perspective division and viewport mapping.
+		for( unsigned i = 0; i < n; ++i, screen += 3)
+		{
+			unit_type inv_w = unit_traits_type::one() / cw[i];
+			screen[0] = (cx[i]*inv_w + 1) * half_width;
+			screen[1] = (cy[i]*inv_w + 1) * half_height;
+			screen[2] = (cz[i]*inv_w + 1) * half;
+		}
+	}
+	return visible;
+}
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The minimum number of visibility words (of 32 vertices each) written by a parallel projection task.
+enum { PROJECTION_MIN_GRAIN = 32 };
+
+/// \ingroup geometry
+/// \brief It projects the vertices of a chunk of visibility words.
+template< typename CS, typename RandomIt>
+struct project_chunk
+{
+	typedef typename CS::unit_type unit_type;
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		const std::size_t last = std::min( end * 32, count);
+		geometry::project( *projection, first + begin * 32, first + last, width, height, screen + 3 * 32 * begin,
+			visibility + begin);
+	}
+
+	const transformation< CS>* projection;
+	RandomIt first;
+	std::size_t count;
+	unit_type width;
+	unit_type height;
+	unit_type* screen;
+	boost::uint32_t* visibility;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It projects a random access sequence of vertices on the screen, as specified by the execution policy.
+/// \param policy the execution policy.
+/// \copydetails project( const transformation< CS>&, VIt, VIt, const typename CS::unit_type&,
+///		const typename CS::unit_type&, typename CS::unit_type*, boost::uint32_t*)
+///
+///		The sequence is split in chunks of whole blocks, so each task writes its own visibility words.
+template< typename P, typename CS, typename RandomIt>
+typename boost::enable_if< parallel::is_execution_policy< P>, unsigned>::type project(
+	const P& policy,
+	const transformation< CS>& projection,
+	RandomIt first, RandomIt last,
+	const typename CS::unit_type& width, const typename CS::unit_type& height,
+	typename CS::unit_type* screen,
+	boost::uint32_t* visibility)
+{
+	const std::size_t count = last - first, words = (count + 31) / 32;
+	const impl::project_chunk< CS, RandomIt> chunk = { &projection, first, count, width, height, screen, visibility };
+	parallel::for_each_chunk( policy, 0, words, impl::PROJECTION_MIN_GRAIN, chunk);
+	unsigned visible = 0;
+	for( std::size_t i = 0; i < words; ++i)
+	{
+		for( boost::uint32_t bits = visibility[i]; bits; bits &= bits - 1)
+		{
+			++visible;
+		}
+	}
+	return visible;
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_PROJECTION_HPP
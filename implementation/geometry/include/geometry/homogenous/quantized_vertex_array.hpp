@@ -0,0 +1,381 @@
+#ifndef GEOMETRY_HOMOGENOUS_QUANTIZED_VERTEX_ARRAY_HPP
+#define GEOMETRY_HOMOGENOUS_QUANTIZED_VERTEX_ARRAY_HPP
+
+#include "geometry/vertex_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace geometry
+{
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It packs the three integer coordinates of a quantized vertex.
+/// \tparam Bits the number of bits of each coordinate.
+template< unsigned Bits>
+struct quantized_storage;
+
+/// \ingroup geometry
+/// \brief It stores the coordinates of 16 bits in three 16 bits words (6 bytes per vertex).
+template<>
+struct quantized_storage< 16>
+{
+	typedef boost::uint16_t word_type;
+	enum { WORDS = 3 };
+
+	static void pack( boost::uint32_t x, boost::uint32_t y, boost::uint32_t z, word_type* words)
+	{
+		words[0] = static_cast< word_type>( x);
+		words[1] = static_cast< word_type>( y);
+		words[2] = static_cast< word_type>( z);
+	}
+
+	static void unpack( const word_type* words, boost::uint32_t& x, boost::uint32_t& y, boost::uint32_t& z)
+	{
+		x = words[0];
+		y = words[1];
+		z = words[2];
+	}
+};
+
+/// \ingroup geometry
+/// \brief It stores the coordinates of 21 bits in one 64 bits word (8 bytes per vertex).
+template<>
+struct quantized_storage< 21>
+{
+	typedef boost::uint64_t word_type;
+	enum { WORDS = 1 };
+
+	static void pack( boost::uint32_t x, boost::uint32_t y, boost::uint32_t z, word_type* words)
+	{
+		words[0] = word_type( x) | (word_type( y) << 21) | (word_type( z) << 42);
+	}
+
+	static void unpack( const word_type* words, boost::uint32_t& x, boost::uint32_t& y, boost::uint32_t& z)
+	{
+		const boost::uint32_t mask = (1U << 21) - 1;
+		x = static_cast< boost::uint32_t>( words[0]) & mask;
+		y = static_cast< boost::uint32_t>( words[0] >> 21) & mask;
+		z = static_cast< boost::uint32_t>( words[0] >> 42) & mask;
+	}
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It stores vertices with integer coordinates, relative to a bounding box.
+/// \tparam CS the coordinate system of the vertices. It must be a three dimensional homogenous coordinate system.
+/// \tparam Bits the number of bits of each coordinate: 16 (6 bytes per vertex) or 21 (8 bytes per vertex).
+/// \details
+///		The bounding box is divided uniformly in <c>2^Bits - 1</c> steps on each axis, and each coordinate is stored as
+///		the index of the nearest step. The decoded coordinate is <c>origin + code * step</c>, so the error is at most
+///		half of the step on each axis. The vertices outside the bounding box are clamped to it.
+///
+///		The dequantization is an affine transformation of the integer codes, so a transformation applied on the decoded
+///		vertices can be folded in the dequantization matrix: decode() with a transformation produces the transformed
+///		coordinates in a single pass.
+template< typename CS, unsigned Bits = 16>
+class quantized_vertex_array
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+	BOOST_STATIC_ASSERT( Bits == 16 || Bits == 21);
+
+	typedef quantized_vertex_array< CS, Bits> my_type_;
+	typedef impl::quantized_storage< Bits> storage_;
+	typedef typename storage_::word_type word_type_;
+
+public:
+	typedef CS coord_system;
+	typedef typename CS::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+	enum
+	{
+		/// \brief The number of bytes used for storing a vertex.
+		BYTES_PER_VERTEX = sizeof( word_type_) * storage_::WORDS,
+		/// \brief The number of vertices decoded together.
+		BLOCK_SIZE = 32
+	};
+
+	/// \brief It creates an empty array for vertices inside the given bounding box.
+	/// \tparam V the vertex type, implementing the 3D vertex concept.
+	/// \param min_corner the corner of the bounding box having the minimum coordinates.
+	/// \param max_corner the corner of the bounding box having the maximum coordinates.
+	template< typename V>
+	quantized_vertex_array( const V& min_corner, const V& max_corner,
+		typename boost::enable_if< impl::is_vertex< V, 3> >::type* = NULL)
+	{
+		BOOST_CONCEPT_ASSERT( (Vertex3D< V>));
+		this->init_( min_corner.x(), min_corner.y(), min_corner.z(), max_corner.x(), max_corner.y(), max_corner.z());
+	}
+
+	/// \brief It quantizes the given vertices, using their bounding box.
+	/// \tparam VIt the iterator type of the vertex sequence. The vertices must implement the 3D vertex concept.
+	template< typename VIt>
+	static my_type_ bounding( VIt first, VIt last)
+	{
+		assert( first != last);
+		unit_type min_x = first->x(), min_y = first->y(), min_z = first->z();
+		unit_type max_x = min_x, max_y = min_y, max_z = min_z;
+		std::size_t count = 0;
+		for( VIt it = first; it != last; ++it, ++count)
+		{
+			const unit_type x = it->x(), y = it->y(), z = it->z();
+			min_x = x < min_x ? x : min_x; max_x = x > max_x ? x : max_x;
+			min_y = y < min_y ? y : min_y; max_y = y > max_y ? y : max_y;
+			min_z = z < min_z ? z : min_z; max_z = z > max_z ? z : max_z;
+		}
+		my_type_ result( vertex_type( min_x, min_y, min_z), vertex_type( max_x, max_y, max_z));
+		result.reserve( count);
+		for( ; first != last; ++first)
+		{
+			result.push_back( first->x(), first->y(), first->z());
+		}
+		return result;
+	}
+
+	/// \brief It gets the number of vertices.
+	std::size_t size() const { return codes_.size() / storage_::WORDS; }
+
+	/// \brief It reserves memory for the given number of vertices.
+	void reserve( std::size_t count) { codes_.reserve( count * storage_::WORDS); }
+
+	/// \brief It adds a vertex, given by its coordinates.
+	void push_back( const unit_type& x, const unit_type& y, const unit_type& z)
+	{
+		word_type_ words[storage_::WORDS];
+		storage_::pack( this->quantize_( x, 0), this->quantize_( y, 1), this->quantize_( z, 2), words);
+		codes_.insert( codes_.end(), words, words + storage_::WORDS);
+	}
+
+	/// \brief It adds a vertex.
+	/// \tparam V the vertex type, implementing the 3D vertex concept.
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3> >::type push_back( const V& v)
+	{
+		BOOST_CONCEPT_ASSERT( (Vertex3D< V>));
+		this->push_back( v.x(), v.y(), v.z());
+	}
+
+	/// \brief It decodes the vertex with the given index.
+	vertex_type operator[]( std::size_t index) const
+	{
+		boost::uint32_t cx, cy, cz;
+		storage_::unpack( &codes_[index * storage_::WORDS], cx, cy, cz);
+		return vertex_type(
+			origin_[0] + unit_type( cx) * step_[0],
+			origin_[1] + unit_type( cy) * step_[1],
+			origin_[2] + unit_type( cz) * step_[2]);
+	}
+
+	/// \brief It gets the distance between two consecutive values of the given axis (0 for X, 1 for Y, 2 for Z).
+	const unit_type& step( unsigned axis) const { return step_[axis]; }
+
+	/// \brief It decodes a range of vertices into separate arrays of coordinates.
+	/// \tparam T the type of the decoded coordinates (float or double).
+	/// \param first the index of the first vertex to decode.
+	/// \param count the number of vertices to decode.
+	/// \param[out] x the buffer receiving the X coordinates. It must have place for \c count values.
+	/// \param[out] y the buffer receiving the Y coordinates.
+	/// \param[out] z the buffer receiving the Z coordinates.
+	template< typename T>
+	void decode( std::size_t first, std::size_t count, T* x, T* y, T* z) const
+	{
+		this->decode( parallel::seq, first, count, x, y, z);
+	}
+
+	/// \brief It decodes a range of vertices into separate arrays of coordinates, as specified by the execution policy.
+	/// \param policy the execution policy.
+	/// \copydetails decode( std::size_t, std::size_t, T*, T*, T*)
+	template< typename P, typename T>
+	typename boost::enable_if< parallel::is_execution_policy< P> >::type decode( const P& policy,
+		std::size_t first, std::size_t count, T* x, T* y, T* z) const
+	{
+		const T m[4][4] = {
+			{ T( step_[0]), 0, 0, T( origin_[0]) },
+			{ 0, T( step_[1]), 0, T( origin_[1]) },
+			{ 0, 0, T( step_[2]), T( origin_[2]) },
+			{ 0, 0, 0, 1 } };
+		this->decode_chunks_( policy, first, count, m, false, x, y, z);
+	}
+
+	/// \brief It decodes a range of vertices and applies the given transformation on them.
+	/// \tparam T the type of the decoded coordinates (float or double).
+	/// \tparam Tr the transformation type (a homogenous transformation, a cached_transformation or a chain).
+	/// \details
+	///		The transformation is multiplied with the dequantization matrix, so the transformed coordinates are calculated
+	///		directly from the integer codes. If the transformation is not affine, the coordinates are divided by the
+	///		weight coordinate.
+	/// \copydetails decode( std::size_t, std::size_t, T*, T*, T*)
+	template< typename T, typename Tr>
+	typename boost::disable_if< parallel::is_execution_policy< Tr> >::type decode( const Tr& tr,
+		std::size_t first, std::size_t count, T* x, T* y, T* z) const
+	{
+		this->decode( parallel::seq, tr, first, count, x, y, z);
+	}
+
+	/// \brief It decodes a range of vertices and applies the given transformation on them, as specified by the
+	///		execution policy.
+	/// \param policy the execution policy.
+	/// \copydetails decode( const Tr&, std::size_t, std::size_t, T*, T*, T*)
+	template< typename P, typename T, typename Tr>
+	void decode( const P& policy, const Tr& tr, std::size_t first, std::size_t count, T* x, T* y, T* z) const
+	{
+		const typename Tr::transform_matrix& t = tr.tr_matrix();
+		T m[4][4];
+		for( unsigned r = 0; r < 4; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				m[r][c] = T( t( r, c) * step_[c]);
+			}
+			m[r][3] = T( t( r, 0)*origin_[0] + t( r, 1)*origin_[1] + t( r, 2)*origin_[2] + t( r, 3));
+		}
+		this->decode_chunks_( policy, first, count, m, !tr.is_affine(), x, y, z);
+	}
+
+private:
+	/// \brief It decodes a chunk of the range of vertices.
+	template< typename T>
+	struct decode_chunk_
+	{
+		void operator()( std::size_t begin, std::size_t end) const
+		{
+			if( projective)
+			{
+				array->decode_projective_( first + begin, end - begin, m, x + begin, y + begin, z + begin);
+			}
+			else
+			{
+				array->decode_( first + begin, end - begin, m, x + begin, y + begin, z + begin);
+			}
+		}
+
+		const my_type_* array;
+		const T (*m)[4];
+		bool projective;
+		std::size_t first;
+		T* x;
+		T* y;
+		T* z;
+	};
+
+	template< typename P, typename T>
+	void decode_chunks_( const P& policy, std::size_t first, std::size_t count, const T (&m)[4][4], bool projective,
+		T* x, T* y, T* z) const
+	{
+		enum { MIN_GRAIN = 64 * BLOCK_SIZE };
+		const decode_chunk_< T> chunk = { this, m, projective, first, x, y, z };
+		parallel::for_each_chunk( policy, 0, count, MIN_GRAIN, chunk);
+	}
+
+	static boost::uint32_t max_code_() { return (boost::uint32_t( 1) << Bits) - 1; }
+
+	void init_(
+		const unit_type& min_x, const unit_type& min_y, const unit_type& min_z,
+		const unit_type& max_x, const unit_type& max_y, const unit_type& max_z)
+	{
+		const unit_type min[3] = { min_x, min_y, min_z }, max[3] = { max_x, max_y, max_z };
+		for( unsigned axis = 0; axis < 3; ++axis)
+		{
+			assert( min[axis] <= max[axis]);
+			origin_[axis] = min[axis];
+			step_[axis] = (max[axis] - min[axis]) / unit_type( max_code_());
+			// A flat box keeps all the values in the origin.
+			inv_step_[axis] = step_[axis] > 0 ? 1 / step_[axis] : unit_type( 0);
+		}
+	}
+
+	boost::uint32_t quantize_( const unit_type& value, unsigned axis) const
+	{
+		const unit_type scaled = (value - origin_[axis]) * inv_step_[axis] + unit_type( 0.5);
+		if( !(scaled > 0))
+		{
+			return 0;
+		}
+		return scaled < unit_type( max_code_()) ? static_cast< boost::uint32_t>( scaled) : max_code_();
+	}
+
+	/// \brief It extracts the integer codes of a block of vertices.
+	void unpack_block_( std::size_t first, unsigned n,
+		boost::uint32_t* cx, boost::uint32_t* cy, boost::uint32_t* cz) const
+	{
+		const word_type_* words = &codes_[first * storage_::WORDS];
+		for( unsigned i = 0; i < n; ++i, words += storage_::WORDS)
+		{
+			storage_::unpack( words, cx[i], cy[i], cz[i]);
+		}
+	}
+
+	/// \brief It decodes the vertices using the first three rows of the given matrix.
+	template< typename T, typename M>
+	void decode_( std::size_t first, std::size_t count, const M& m, T* x, T* y, T* z) const
+	{
+		assert( first + count <= this->size());
+		const T
+			m11 = m[0][0], m12 = m[0][1], m13 = m[0][2], m14 = m[0][3],
+			m21 = m[1][0], m22 = m[1][1], m23 = m[1][2], m24 = m[1][3],
+			m31 = m[2][0], m32 = m[2][1], m33 = m[2][2], m34 = m[2][3];
+		boost::uint32_t cx[BLOCK_SIZE], cy[BLOCK_SIZE], cz[BLOCK_SIZE];
+		while( count > 0)
+		{
+			const unsigned n = count < BLOCK_SIZE ? unsigned( count) : unsigned( BLOCK_SIZE);
+			this->unpack_block_( first, n, cx, cy, cz);
+			for( unsigned i = 0; i < n; ++i)
+			{
+				const T qx = T( cx[i]), qy = T( cy[i]), qz = T( cz[i]);
+				x[i] = m11*qx + m12*qy + m13*qz + m14;
+				y[i] = m21*qx + m22*qy + m23*qz + m24;
+				z[i] = m31*qx + m32*qy + m33*qz + m34;
+			}
+			first += n; count -= n;
+			x += n; y += n; z += n;
+		}
+	}
+
+	/// \brief It decodes the vertices using the given matrix, dividing by the weight coordinate.
+	template< typename T>
+	void decode_projective_( std::size_t first, std::size_t count, const T (*m)[4], T* x, T* y, T* z) const
+	{
+		assert( first + count <= this->size());
+		const T
+			m11 = m[0][0], m12 = m[0][1], m13 = m[0][2], m14 = m[0][3],
+			m21 = m[1][0], m22 = m[1][1], m23 = m[1][2], m24 = m[1][3],
+			m31 = m[2][0], m32 = m[2][1], m33 = m[2][2], m34 = m[2][3],
+			m41 = m[3][0], m42 = m[3][1], m43 = m[3][2], m44 = m[3][3];
+		boost::uint32_t cx[BLOCK_SIZE], cy[BLOCK_SIZE], cz[BLOCK_SIZE];
+		while( count > 0)
+		{
+			const unsigned n = count < BLOCK_SIZE ? unsigned( count) : unsigned( BLOCK_SIZE);
+			this->unpack_block_( first, n, cx, cy, cz);
+			for( unsigned i = 0; i < n; ++i)
+			{
+				const T qx = T( cx[i]), qy = T( cy[i]), qz = T( cz[i]);
+				const T inv_w = 1 / (m41*qx + m42*qy + m43*qz + m44);
+				x[i] = (m11*qx + m12*qy + m13*qz + m14) * inv_w;
+				y[i] = (m21*qx + m22*qy + m23*qz + m24) * inv_w;
+				z[i] = (m31*qx + m32*qy + m33*qz + m34) * inv_w;
+			}
+			first += n; count -= n;
+			x += n; y += n; z += n;
+		}
+	}
+
+	unit_type origin_[3];
+	unit_type step_[3];
+	unit_type inv_step_[3];
+	std::vector< word_type_> codes_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_QUANTIZED_VERTEX_ARRAY_HPP
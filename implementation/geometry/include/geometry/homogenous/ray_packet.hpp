@@ -0,0 +1,102 @@
+#ifndef GEOMETRY_HOMOGENOUS_RAY_PACKET_HPP
+#define GEOMETRY_HOMOGENOUS_RAY_PACKET_HPP
+
+#include "geometry/ray.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <cassert>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It groups a fixed number of rays, so that they are traced together.
+/// \tparam CS the coordinate system used by the rays. It must be a three dimensional homogenous coordinate system.
+/// \tparam N the number of rays in the packet (usually 4 or 8, the width of the SIMD registers).
+/// \details
+///		The rays are stored as structure of arrays: one array of N values for each origin coordinate and for each 
+///		direction component. The origins are stored already normalized, so the intersection kernels don't have to 
+///		divide by the weight coordinate. The loops of the kernels run over the N lanes of the same component, so they 
+///		can be vectorized by the compiler.
+template< typename CS, unsigned N>
+class ray_packet
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+	// The hit results are reported as bit masks, one bit per ray.
+	BOOST_STATIC_ASSERT( N > 0 && N <= 32);
+public:
+	enum { SIZE = N };
+
+	typedef CS coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	typedef typename coord_system::unit_traits_type unit_traits_type;
+	typedef ray< CS> ray_type;
+
+	/// \brief It creates a packet of rays starting from origin, oriented along X axis.
+	ray_packet()
+	{
+		for( unsigned i = 0; i < N; ++i)
+		{
+			x_[i] = y_[i] = z_[i] = dy_[i] = dz_[i] = unit_traits_type::zero();
+			dx_[i] = unit_traits_type::one();
+		}
+	}
+
+	/// \brief It creates a packet using the rays of the sequence pointed by the provided iterator.
+	/// \pre The provided sequence has at least N rays.
+	/// \tparam It the type of iterator providing access to the sequence of rays.
+	template< typename It>
+	explicit ray_packet( It begin)
+	{
+		for( unsigned i = 0; i < N; ++i, ++begin)
+		{
+			this->set( i, *begin);
+		}
+	}
+
+	/// \brief It sets the ray at the given position in the packet.
+	/// \pre i < N
+	void set( unsigned i, const ray_type& r)
+	{
+		assert( i < N);
+		typename coord_system::pos_rep origin = r.origin().normalized();
+		x_[i] = origin( 0); y_[i] = origin( 1); z_[i] = origin( 2);
+		dx_[i] = r.dir().dx(); dy_[i] = r.dir().dy(); dz_[i] = r.dir().dz();
+	}
+
+	/// \brief It gets the ray at the given position in the packet.
+	/// \pre i < N
+	ray_type get( unsigned i) const
+	{
+		assert( i < N);
+		return ray_type( 
+			typename ray_type::vertex_type( x_[i], y_[i], z_[i]), 
+			typename ray_type::direction_type( dx_[i], dy_[i], dz_[i]));
+	}
+
+	/// \brief Access to the arrays of origin coordinates, one value for each ray.
+	/// \{
+	const unit_type* x() const { return x_; }
+	const unit_type* y() const { return y_; }
+	const unit_type* z() const { return z_; }
+	/// \}
+
+	/// \brief Access to the arrays of direction components, one value for each ray.
+	/// \{
+	const unit_type* dx() const { return dx_; }
+	const unit_type* dy() const { return dy_; }
+	const unit_type* dz() const { return dz_; }
+	/// \}
+
+private:
+	unit_type x_[N], y_[N], z_[N];
+	unit_type dx_[N], dy_[N], dz_[N];
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_RAY_PACKET_HPP
@@ -0,0 +1,266 @@
+#ifndef GEOMETRY_HOMOGENOUS_SNAPSHOT_STORE_HPP
+#define GEOMETRY_HOMOGENOUS_SNAPSHOT_STORE_HPP
+
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/line.hpp"
+#include "geometry/plane.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+#if defined( _MSC_VER)
+#	include <intrin.h>
+#	pragma intrinsic( _ReadWriteBarrier)
+#endif
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It keeps the reads and writes following it from being done before the reads preceding it (acquire fence).
+/// \details
+///		Visual C++ targets only x86 and x64, which don't reorder a read with the following reads and writes, so only the
+///		compiler has to be stopped; GCC issues a full barrier.
+inline void acquire_fence()
+{
+#if defined( _MSC_VER)
+	_ReadWriteBarrier();
+#elif defined( __GNUC__)
+	__sync_synchronize();
+#else
+#	error "impl::acquire_fence() is not implemented for this compiler."
+#endif
+}
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief An array stored in chunks of fixed size, which are shared between the copies of the array.
+/// \tparam T the type of the elements.
+/// \details
+///		Copying the array copies only the table of the chunks. A chunk is copied when it is changed while another copy
+///		of the array still uses it (copy on write), so the copies of an array with a few changed elements share all
+///		the other chunks.
+///
+///		The chunks shared with other copies are never written, so a copy may be read by any number of threads while
+///		another copy is changed by one thread.
+template< typename T>
+class shared_chunk_array
+{
+	typedef std::vector< T> chunk_;
+	typedef boost::shared_ptr< chunk_> chunk_pointer_;
+
+public:
+	typedef T value_type;
+	enum
+	{
+		/// \brief The number of elements of a chunk.
+		CHUNK_SIZE = 1024
+	};
+
+	shared_chunk_array()
+		: size_( 0)
+	{
+	}
+
+	std::size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	const T& operator[]( std::size_t index) const
+	{
+		assert( index < size_);
+		return (*chunks_[index / CHUNK_SIZE])[index % CHUNK_SIZE];
+	}
+
+	/// \brief It changes the element having the given index.
+	void set( std::size_t index, const T& value)
+	{
+		assert( index < size_);
+		(*this->writable_chunk_( index / CHUNK_SIZE))[index % CHUNK_SIZE] = value;
+	}
+
+	void push_back( const T& value)
+	{
+		if( size_ % CHUNK_SIZE == 0)
+		{
+			chunks_.push_back( chunk_pointer_( new chunk_()));
+			chunks_.back()->reserve( CHUNK_SIZE);
+		}
+		this->writable_chunk_( chunks_.size() - 1)->push_back( value);
+		++size_;
+	}
+
+	void pop_back()
+	{
+		assert( size_ > 0);
+		this->writable_chunk_( chunks_.size() - 1)->pop_back();
+		if( --size_ % CHUNK_SIZE == 0)
+		{
+			chunks_.pop_back();
+		}
+	}
+
+	void clear()
+	{
+		chunks_.clear();
+		size_ = 0;
+	}
+
+	/// \brief It gets the number of chunks.
+	std::size_t chunk_count() const { return chunks_.size(); }
+
+	/// \brief It checks whether the given chunk is shared with the other array.
+	bool shares_chunk( const shared_chunk_array& other, std::size_t chunk) const
+	{
+		return chunk < chunks_.size() && chunk < other.chunks_.size() && chunks_[chunk] == other.chunks_[chunk];
+	}
+
+private:
+	/// \brief It gets the given chunk, after copying it if it is shared.
+	/// \details
+	///		The count of references can decrease concurrently (when another thread releases a copy of the array), but it
+	///		cannot increase, as the other copies don't have access to this array. So a chunk found unique stays unique.
+	///
+	///		Reading the count doesn't order the following writes after the reads of the chunk made by the thread which
+	///		released the last other reference. The reference counts are decremented with a release barrier, so an
+	///		acquire fence after finding the chunk unique completes the synchronization: the chunk is written only after
+	///		all the readers are done with it.
+	chunk_* writable_chunk_( std::size_t chunk)
+	{
+		chunk_pointer_& pointer = chunks_[chunk];
+		if( pointer.unique())
+		{
+			impl::acquire_fence();
+		}
+		else
+		{
+			chunk_pointer_ copy( new chunk_());
+			copy->reserve( CHUNK_SIZE);
+			copy->assign( pointer->begin(), pointer->end());
+			pointer = copy;
+		}
+		return pointer.get();
+	}
+
+	std::vector< chunk_pointer_> chunks_;
+	std::size_t size_;
+};
+
+/// \ingroup geometry
+/// \brief A version of the geometry kept by a snapshot_store.
+/// \tparam CS the coordinate system of the geometry.
+template< typename CS>
+struct geometry_snapshot
+{
+	typedef vertex< CS> vertex_type;
+	typedef line< CS> line_type;
+	typedef plane< CS> plane_type;
+
+	geometry_snapshot()
+		: version( 0)
+	{
+	}
+
+	/// \brief The number of the version, incremented at each publication.
+	std::size_t version;
+	shared_chunk_array< vertex_type> vertices;
+	shared_chunk_array< line_type> lines;
+	shared_chunk_array< plane_type> planes;
+};
+
+/// \ingroup geometry
+/// \brief It keeps versions of a set of vertices, lines and planes, which are read by several threads while a writer
+///		thread prepares the next version.
+/// \tparam CS the coordinate system of the geometry. It must be a three dimensional homogenous coordinate system.
+/// \details
+///		The published versions are immutable. A reader pins the current version by getting a snapshot(), and reads it
+///		without any synchronization for as long as it keeps it; the version is released when its last reader drops it.
+///		The writer changes the next() version, which shares the unchanged chunks with the published one, and makes it
+///		current by publish():
+///		\code
+///		// Writer thread.
+///		store.next().vertices.push_back( v);
+///		store.next().planes.set( 3, p);
+///		store.publish();
+///
+///		// Reader threads.
+///		const snapshot_store< CS>::snapshot_pointer snapshot = store.snapshot();
+///		for( std::size_t i = 0; i < snapshot->vertices.size(); ++i) { ... snapshot->vertices[i] ... }
+///		\endcode
+///		The only shared state is the pointer to the current version, guarded by a mutex held for copying it; the
+///		versions are reclaimed by reference counting. There must be a single writer at a time.
+template< typename CS>
+class snapshot_store
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+
+public:
+	typedef geometry_snapshot< CS> snapshot_type;
+	typedef boost::shared_ptr< const snapshot_type> snapshot_pointer;
+
+	/// \brief It creates a store whose current version is empty.
+	snapshot_store()
+		: current_( new snapshot_type())
+	{
+	}
+
+	/// \brief It gets the current version. It may be called from any thread.
+	snapshot_pointer snapshot() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return current_;
+	}
+
+	/// \brief It gets the version being prepared by the writer. At the first call after a publication, it starts as a
+	///		copy of the current version.
+	snapshot_type& next()
+	{
+		if( !next_)
+		{
+			next_.reset( new snapshot_type( *this->snapshot()));
+			++next_->version;
+		}
+		return *next_;
+	}
+
+	/// \brief It makes the prepared version current.
+	/// \return the published version.
+	snapshot_pointer publish()
+	{
+		this->next();
+		const snapshot_pointer published( next_);
+		next_.reset();
+		// The previous version is released after the mutex, as it may be its last reference.
+		snapshot_pointer previous;
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			previous = current_;
+			current_ = published;
+		}
+		return published;
+	}
+
+	/// \brief It drops the changes of the prepared version.
+	void discard() { next_.reset(); }
+
+private:
+	mutable boost::mutex mutex_;
+	snapshot_pointer current_;
+	boost::shared_ptr< snapshot_type> next_;
+
+	snapshot_store( const snapshot_store&);
+	snapshot_store& operator=( const snapshot_store&);
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_SNAPSHOT_STORE_HPP
@@ -0,0 +1,313 @@
+#ifndef GEOMETRY_HOMOGENOUS_TRANSFORM_HIERARCHY_HPP
+#define GEOMETRY_HOMOGENOUS_TRANSFORM_HIERARCHY_HPP
+
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It keeps a hierarchy of nodes with local transformations and calculates their world transformations.
+/// \tparam CS the coordinate system of the transformations. It must be a three dimensional homogenous coordinate
+///		system.
+/// \details
+///		Each node has a local transformation, relative to its parent. The world transformation of a node is the product
+///		of the world transformation of its parent with its local transformation; for the root nodes it is the local
+///		transformation.
+///
+///		The world transformations are kept in a flat array, in the depth first order of the hierarchy, so the subtree of
+///		each node occupies a contiguous range following the node. Changing a local transformation only marks the node
+///		as dirty; update() recalculates only the ranges of the dirty subtrees. The subtrees are independent of each
+///		other, so they can be recalculated in parallel. A large subtree is split in the subtrees of its children, which
+///		become tasks of their own (and are split further in their turn), so the work can be shared even when a single
+///		node near the root was changed.
+///
+///		Adding nodes invalidates the order, which is rebuilt (and all the world transformations recalculated) at the
+///		next update.
+template< typename CS>
+class transform_hierarchy
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+
+	typedef transform_hierarchy< CS> my_type_;
+	typedef std::pair< std::size_t, std::size_t> range_;
+	typedef std::vector< range_> ranges_;
+
+public:
+	typedef transformation< CS> transformation_type;
+	typedef unsigned node_id;
+	enum
+	{
+		/// \brief The parent of the root nodes.
+		NO_PARENT = ~0U,
+		/// \brief The minimum number of nodes of a subtree for splitting it in parallel tasks.
+		PARALLEL_THRESHOLD = 1024
+	};
+
+	/// \brief It creates an empty hierarchy.
+	transform_hierarchy()
+		: order_valid_( true)
+	{
+	}
+
+	/// \brief It gets the number of nodes.
+	std::size_t size() const { return local_.size(); }
+
+	/// \brief It adds a new node.
+	/// \param local the transformation of the node, relative to its parent.
+	/// \param parent the parent node, or NO_PARENT for a root node.
+	/// \return the identifier of the new node. The identifiers are given in increasing order, starting from 0.
+	node_id add_node( const transformation_type& local, node_id parent = NO_PARENT)
+	{
+		assert( parent == NO_PARENT || parent < local_.size());
+		node_id id = static_cast< node_id>( local_.size());
+		local_.push_back( local);
+		parent_.push_back( parent);
+		dirty_.push_back( false);
+		position_.push_back( 0);
+		order_valid_ = false;
+		return id;
+	}
+
+	/// \brief It gets the parent of the given node, or NO_PARENT for a root node.
+	node_id parent( node_id node) const { return parent_[node]; }
+
+	/// \brief It gets the local transformation of the given node.
+	const transformation_type& local( node_id node) const { return local_[node]; }
+
+	/// \brief It changes the local transformation of the given node, marking its subtree as dirty.
+	void set_local( node_id node, const transformation_type& local)
+	{
+		local_[node] = local;
+		if( !dirty_[node])
+		{
+			dirty_[node] = true;
+			dirty_nodes_.push_back( node);
+		}
+	}
+
+	/// \brief It checks whether update() has to be called before getting the world transformations.
+	bool is_dirty() const { return !order_valid_ || !dirty_nodes_.empty(); }
+
+	/// \brief It gets the world transformation of the given node, as calculated at the last update.
+	const transformation_type& world( node_id node) const
+	{
+		assert( order_valid_);
+		return world_[position_[node]];
+	}
+
+	/// \brief It recalculates the world transformations of the dirty subtrees, in the calling thread.
+	/// \return the number of recalculated world transformations.
+	std::size_t update()
+	{
+		return this->update( parallel::seq);
+	}
+
+	/// \brief It recalculates the world transformations of the dirty subtrees, as specified by the execution policy.
+	/// \return the number of recalculated world transformations.
+	template< typename P>
+	std::size_t update( const P& policy)
+	{
+		ranges_ ranges;
+		if( !order_valid_)
+		{
+			this->rebuild_order_();
+			if( !order_.empty())
+			{
+				ranges.push_back( range_( 0, order_.size()));
+			}
+		}
+		else
+		{
+			for( std::size_t i = 0; i < dirty_nodes_.size(); ++i)
+			{
+				std::size_t pos = position_[dirty_nodes_[i]];
+				ranges.push_back( range_( pos, subtree_end_[pos]));
+			}
+			std::sort( ranges.begin(), ranges.end());
+			// Remove the subtrees contained in other dirty subtrees.
+			std::size_t kept = 0;
+			for( std::size_t i = 0; i < ranges.size(); ++i)
+			{
+				if( kept == 0 || ranges[i].first >= ranges[kept-1].second)
+				{
+					ranges[kept++] = ranges[i];
+				}
+			}
+			ranges.resize( kept);
+		}
+		for( std::size_t i = 0; i < dirty_nodes_.size(); ++i)
+		{
+			dirty_[dirty_nodes_[i]] = false;
+		}
+		dirty_nodes_.clear();
+
+		std::size_t total = 0;
+		for( std::size_t i = 0; i < ranges.size(); ++i)
+		{
+			total += ranges[i].second - ranges[i].first;
+		}
+		if( total < PARALLEL_THRESHOLD)
+		{
+			this->update_ranges_( &ranges);
+		}
+		else
+		{
+			this->update_subtrees_( policy, &ranges);
+		}
+		return total;
+	}
+
+private:
+	/// \brief It calculates the depth first order of the nodes and the end of each subtree.
+	void rebuild_order_()
+	{
+		const std::size_t n = local_.size();
+		// Children lists, in the order of the identifiers. The roots are collected in reverse order, as they are used 
+		// as a stack.
+		std::vector< node_id> first_child( n, NO_PARENT), next_sibling( n, NO_PARENT), roots;
+		for( std::size_t i = n; i-- > 0; )
+		{
+			if( parent_[i] == NO_PARENT)
+			{
+				roots.push_back( static_cast< node_id>( i));
+			}
+			else
+			{
+				next_sibling[i] = first_child[parent_[i]];
+				first_child[parent_[i]] = static_cast< node_id>( i);
+			}
+		}
+
+		order_.resize( n);
+		parent_position_.resize( n);
+		subtree_end_.resize( n);
+		world_.resize( n, transformation_type( transformation_type::transform_matrix::IDENTITY()));
+		std::size_t pos = 0;
+		std::vector< node_id> stack( roots.begin(), roots.end());
+		while( !stack.empty())
+		{
+			node_id node = stack.back();
+			stack.pop_back();
+			position_[node] = pos;
+			order_[pos] = node;
+			parent_position_[pos] = parent_[node] == NO_PARENT ? std::size_t( NO_PARENT) : position_[parent_[node]];
+			subtree_end_[pos] = pos + 1;
+			++pos;
+			// The children are pushed in reverse order, so they are visited in the order of the identifiers.
+			std::size_t children_begin = stack.size();
+			for( node_id child = first_child[node]; child != NO_PARENT; child = next_sibling[child])
+			{
+				stack.push_back( child);
+			}
+			std::reverse( stack.begin() + children_begin, stack.end());
+		}
+		// Each subtree ends where the last subtree of its children ends.
+		for( std::size_t i = n; i-- > 0; )
+		{
+			if( parent_position_[i] != NO_PARENT && subtree_end_[parent_position_[i]] < subtree_end_[i])
+			{
+				subtree_end_[parent_position_[i]] = subtree_end_[i];
+			}
+		}
+		order_valid_ = true;
+	}
+
+	/// \brief It recalculates the world transformations of the nodes in the given position ranges.
+	void update_ranges_( const ranges_* ranges)
+	{
+		for( std::size_t r = 0; r < ranges->size(); ++r)
+		{
+			for( std::size_t pos = (*ranges)[r].first; pos < (*ranges)[r].second; ++pos)
+			{
+				this->update_node_( pos);
+			}
+		}
+	}
+
+	void update_node_( std::size_t pos)
+	{
+		const transformation_type& local = local_[order_[pos]];
+		const std::size_t parent_pos = parent_position_[pos];
+		if( parent_pos == NO_PARENT)
+		{
+			world_[pos] = local;
+		}
+		else
+		{
+			world_[pos] = transformation_type( world_[parent_pos].tr_matrix() * local.tr_matrix());
+		}
+	}
+
+	void update_subtrees_( const parallel::sequenced_policy&, const ranges_* ranges)
+	{
+		this->update_ranges_( ranges);
+	}
+
+	/// \brief It recalculates the given subtrees in parallel tasks.
+	template< typename P>
+	void update_subtrees_( const P& policy, const ranges_* ranges)
+	{
+		parallel::for_each_chunk( policy, 0, ranges->size(), 1,
+			boost::bind( &my_type_::update_subtree_chunk_< P>, this, &policy, ranges, _1, _2));
+	}
+
+	template< typename P>
+	void update_subtree_chunk_( const P* policy, const ranges_* ranges, std::size_t begin, std::size_t end)
+	{
+		for( std::size_t r = begin; r < end; ++r)
+		{
+			this->update_subtree_( *policy, (*ranges)[r]);
+		}
+	}
+
+	/// \brief It recalculates a subtree, splitting it in the subtrees of the children of its root if it is large.
+	template< typename P>
+	void update_subtree_( const P& policy, const range_& range)
+	{
+		if( range.second - range.first < PARALLEL_THRESHOLD)
+		{
+			for( std::size_t pos = range.first; pos < range.second; ++pos)
+			{
+				this->update_node_( pos);
+			}
+			return;
+		}
+		this->update_node_( range.first);
+		ranges_ children;
+		for( std::size_t child = range.first + 1; child < range.second; child = subtree_end_[child])
+		{
+			children.push_back( range_( child, subtree_end_[child]));
+		}
+		this->update_subtrees_( policy, &children);
+	}
+
+	// Indexed by node identifier.
+	std::vector< transformation_type> local_;
+	std::vector< node_id> parent_;
+	std::vector< bool> dirty_;
+	std::vector< std::size_t> position_;
+	std::vector< node_id> dirty_nodes_;
+
+	// Indexed by position in the depth first order.
+	std::vector< node_id> order_;
+	std::vector< std::size_t> parent_position_;
+	std::vector< std::size_t> subtree_end_;
+	std::vector< transformation_type> world_;
+	bool order_valid_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_TRANSFORM_HIERARCHY_HPP
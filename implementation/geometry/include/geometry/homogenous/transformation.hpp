@@ -6,8 +6,10 @@
 #include "geometry/line_concept.hpp"
 #include "geometry/vertex_concept.hpp"
 #include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "algebra/trigonometry.hpp"
 #include <boost/concept/assert.hpp>
 #include <cmath>
+#include <cstddef>
 
 namespace geometry
 {
@@ -49,8 +51,52 @@ public:
 		pos = this->tr_matrix() * pos;
 	}
 
-private:
-	transform_matrix& tr_matrix() { return static_cast< Derived*>( this)->tr_; }
+	/// \brief It applies the linear part of the transformation (without the translation) on the given direction.
+	/// \return the transformed direction components. They are not normalized.
+	typename coord_system::dir_rep transformed_direction( const typename coord_system::dir_rep& dir) const
+	{
+		const transform_matrix& m = this->tr_matrix();
+		typename coord_system::dir_rep result;
+		for( unsigned r = 0; r < coord_system::DIMENSIONS; ++r)
+		{
+			unit_type value = unit_traits_type::zero();
+			for( unsigned c = 0; c < coord_system::DIMENSIONS; ++c)
+			{
+				value += m( r, c) * dir( c);
+			}
+			result( r) = value;
+		}
+		return result;
+	}
+
+	/// \brief It calculates the inverse of the transposed transformation matrix, used for transforming the planes.
+	/// \details 
+	///		The inversion is calculated at each call. Use cached_transformation for transforming many planes with the 
+	///		same transformation.
+	transform_matrix inverse_transpose() const
+	{
+		return transposed( inverted( this->tr_matrix()));
+	}
+
+	/// \brief It checks whether the transformation is affine.
+	/// \details 
+	///		A transformation is affine if the last row of the matrix is (0, ..., 0, 1). The affine transformations keep 
+	///		the weight coordinate unchanged, so they can be applied on affine vertices.
+	bool is_affine() const
+	{
+		const transform_matrix& m = this->tr_matrix();
+		const unsigned last = coord_system::DIMENSIONS;
+		for( unsigned c = 0; c < last; ++c)
+		{
+			if( m( last, c) != unit_traits_type::zero())
+			{
+				return false;
+			}
+		}
+		return m( last, last) == unit_traits_type::one();
+	}
+
+	/// \brief It gets the transformation matrix.
 	const transform_matrix& tr_matrix() const { return static_cast< const Derived*>( this)->tr_; }
 };
 
@@ -128,53 +174,50 @@ public:
 
 	/// \brief It creates the rotation around X axis.
 	/// \param angle the rotation angle, in radians.
+	/// \details The sine and the cosine are calculated as by rotation<D>( const unit_type&, P) with the precise tag.
 	/// \sa http://en.wikipedia.org/wiki/Rotation_matrix
 	template< unsigned D>
 	static typename boost::enable_if_c< D == 1, my_type_>::type rotation( const unit_type& angle)
 	{
-		unit_type 
-			cos = std::cos( angle),
-			sin = std::sin( angle);
-		return my_type_( 
-			1,   0,	   0, 0,
-			0, cos, -sin, 0,
-			0, sin,  cos, 0,
-			0,   0,    0, 1
-			);
+		return rotation< D>( angle, algebra::precise_trigonometry());
 	}
 
 	/// \brief It creates the rotation around Y axis.
 	/// \param angle the rotation angle, in radians.
+	/// \details The sine and the cosine are calculated as by rotation<D>( const unit_type&, P) with the precise tag.
 	/// \sa http://en.wikipedia.org/wiki/Rotation_matrix
 	template< unsigned D>
 	static typename boost::enable_if_c< D == 2, my_type_>::type rotation( const unit_type& angle)
 	{
-		unit_type 
-			cos = std::cos( angle),
-			sin = std::sin( angle);
-		return transformation( 
-			 cos, 0, sin, 0,
-			   0, 1,   0, 0, 
-			-sin, 0, cos, 0,
-			   0, 0,   0, 1
-			);
+		return rotation< D>( angle, algebra::precise_trigonometry());
 	}
 
 	/// \brief It creates the rotation around Z axis.
 	/// \param angle the rotation angle, in radians.
+	/// \details The sine and the cosine are calculated as by rotation<D>( const unit_type&, P) with the precise tag.
 	/// \sa http://en.wikipedia.org/wiki/Rotation_matrix
 	template< unsigned D>
 	static typename boost::enable_if_c< D == 3, my_type_>::type rotation( const unit_type& angle)
 	{
-		unit_type
-			cos = std::cos( angle),
-			sin = std::sin( angle);
-		return my_type_( 
-			cos, -sin, 0, 0,
-			sin,  cos, 0, 0,
-			  0,    0, 1, 0,
-			  0,    0, 0, 1
-			);
+		return rotation< D>( angle, algebra::precise_trigonometry());
+	}
+
+	/// \brief It creates the rotation around one of the axes, with the given precision of the sine and cosine.
+	/// \tparam D the rotation axis: 1 for X, 2 for Y, 3 for Z.
+	/// \tparam P the precision tag of the sine and cosine calculation (algebra::fast_trigonometry or
+	///		algebra::precise_trigonometry). For float, both tags give the same results.
+	/// \param angle the rotation angle, in radians.
+	/// \details
+	///		The sine and the cosine are calculated by algebra::sincos, as by rotations(), so a single rotation is equal
+	///		to the one built for the same angle in an array. The angles too large for algebra::sincos use std::sin and
+	///		std::cos.
+	template< unsigned D, typename P>
+	static my_type_ rotation( const unit_type& angle, P precision)
+	{
+		BOOST_STATIC_ASSERT( 1 <= D && D <= 3);
+		unit_type sin, cos;
+		my_type_::sincos_( angle, sin, cos, precision);
+		return axis_rotation_< D>( sin, cos);
 	}
 
 	/// \brief It creates the rotation transformation about an arbitrary direction.
@@ -183,27 +226,116 @@ public:
 	/// \param direction the direction to rotate about.
 	/// \details
 	///		This transformation is equivalent with rotation about a line of the given direction, passing through origin.
+	///		The sine and the cosine are calculated as by rotation( const Dir&, const unit_type&, P), with the precise
+	///		tag.
 	/// \sa http://en.wikipedia.org/wiki/Rotation_matrix#Rotation_about_an_arbitrary_vector
 	template< typename Dir>
 	static typename boost::enable_if< impl::is_direction< Dir, CS::DIMENSIONS>, my_type_>::type
 		rotation( const Dir& direction, const unit_type& angle)
+	{
+		return my_type_::rotation( direction, angle, algebra::precise_trigonometry());
+	}
+
+	/// \brief It creates the rotation transformation about an arbitrary direction, with the given precision of the
+	///		sine and cosine.
+	/// \tparam Dir the direction type, implementing Direction concept.
+	/// \tparam P the precision tag of the sine and cosine calculation.
+	/// \param direction the direction to rotate about.
+	/// \param angle the rotation angle, in radians.
+	/// \copydetails rotation( const unit_type&, P)
+	template< typename Dir, typename P>
+	static typename boost::enable_if< impl::is_direction< Dir, CS::DIMENSIONS>, my_type_>::type
+		rotation( const Dir& direction, const unit_type& angle, P precision)
 	{
 		BOOST_CONCEPT_ASSERT( (Direction< Dir>));
-		unit_type 
-			cos = std::cos( angle),
-			sin = std::sin( angle);
-		unit_type 
-			lx = direction.dx(), ly = direction.dy(), lz = direction.dz(), 
-			lx2 = lx*lx, ly2 = ly*ly, lz2 = lz*lz,
-			lxly = lx*ly, lxlz = lx*lz, lylz = ly*lz,
-			lxsin = lx*sin, lysin = ly*sin, lzsin = lz*sin;
-		
-		return my_type_(
-			lx2+(1-lx2)*cos,    lxly*(1-cos)-lzsin,  lxly*(1-cos)+lysin, 0,
-			lxly*(1-cos)+lzsin, ly2+(1-ly2)*cos,     lylz*(1-cos)-lxsin, 0,
-			lxlz*(1-cos)-lysin, lylz*(1-cos)+lxsin,  lz2+(1-lz2)*cos,    0,
-			0,                  0,                   0,                  1
-			);
+		unit_type sin, cos;
+		my_type_::sincos_( angle, sin, cos, precision);
+		return my_type_::direction_rotation_( direction.dx(), direction.dy(), direction.dz(), sin, cos);
+	}
+
+	/// \brief It creates the rotations around one of the axes for an array of angles.
+	/// \tparam D the rotation axis: 1 for X, 2 for Y, 3 for Z.
+	/// \tparam OutIt the output iterator type, accepting transformation objects.
+	/// \tparam P the precision tag of the sine and cosine calculation (algebra::fast_trigonometry or 
+	///		algebra::precise_trigonometry). For float, both tags give the same results.
+	/// \param angles the rotation angles, in radians.
+	/// \param count the number of angles.
+	/// \param out the output iterator receiving the rotations, in the order of the angles.
+	/// \return the output iterator after the last written rotation.
+	/// \details
+	///		The sines and cosines are calculated in blocks of angles with algebra::sincos, which shares the range 
+	///		reduction and can be vectorized by the compiler, then the matrices are built from the calculated values.
+	///
+	///		There is no overload receiving an execution policy: this header is used by all the geometric objects and
+	///		does not depend on the thread pool. For large arrays, call this function for chunks of the angles from
+	///		parallel::for_each_chunk(), writing to a random access sequence.
+	/// \sa rotation<D>( const unit_type&)
+	template< unsigned D, typename OutIt, typename P>
+	static OutIt rotations( const unit_type* angles, std::size_t count, OutIt out, P precision)
+	{
+		BOOST_STATIC_ASSERT( 1 <= D && D <= 3);
+		unit_type sin[BLOCK_SIZE_], cos[BLOCK_SIZE_];
+		for( std::size_t first = 0; first < count; first += BLOCK_SIZE_)
+		{
+			std::size_t n = count - first < BLOCK_SIZE_ ? count - first : BLOCK_SIZE_;
+			algebra::sincos( angles + first, n, sin, cos, precision);
+			for( std::size_t i = 0; i < n; ++i, ++out)
+			{
+				*out = axis_rotation_< D>( sin[i], cos[i]);
+			}
+		}
+		return out;
+	}
+
+	/// \brief It creates the rotations around one of the axes for an array of angles, using the precise sine and 
+	///		cosine calculation.
+	/// \copydetails rotations( const unit_type*, std::size_t, OutIt, P)
+	template< unsigned D, typename OutIt>
+	static OutIt rotations( const unit_type* angles, std::size_t count, OutIt out)
+	{
+		return rotations< D>( angles, count, out, algebra::precise_trigonometry());
+	}
+
+	/// \brief It creates the rotations about an arbitrary direction for an array of angles.
+	/// \tparam Dir the direction type, implementing Direction concept.
+	/// \tparam OutIt the output iterator type, accepting transformation objects.
+	/// \tparam P the precision tag of the sine and cosine calculation.
+	/// \param direction the direction to rotate about.
+	/// \param angles the rotation angles, in radians.
+	/// \param count the number of angles.
+	/// \param out the output iterator receiving the rotations, in the order of the angles.
+	/// \return the output iterator after the last written rotation.
+	/// \details
+	///		The sines and cosines are calculated in blocks of angles with algebra::sincos. For large arrays, call this
+	///		function for chunks of the angles from parallel::for_each_chunk().
+	/// \sa rotation( const Dir&, const unit_type&)
+	template< typename Dir, typename OutIt, typename P>
+	static typename boost::enable_if< impl::is_direction< Dir, CS::DIMENSIONS>, OutIt>::type
+		rotations( const Dir& direction, const unit_type* angles, std::size_t count, OutIt out, P precision)
+	{
+		BOOST_CONCEPT_ASSERT( (Direction< Dir>));
+		const unit_type lx = direction.dx(), ly = direction.dy(), lz = direction.dz();
+		unit_type sin[BLOCK_SIZE_], cos[BLOCK_SIZE_];
+		for( std::size_t first = 0; first < count; first += BLOCK_SIZE_)
+		{
+			std::size_t n = count - first < BLOCK_SIZE_ ? count - first : BLOCK_SIZE_;
+			algebra::sincos( angles + first, n, sin, cos, precision);
+			for( std::size_t i = 0; i < n; ++i, ++out)
+			{
+				*out = my_type_::direction_rotation_( lx, ly, lz, sin[i], cos[i]);
+			}
+		}
+		return out;
+	}
+
+	/// \brief It creates the rotations about an arbitrary direction for an array of angles, using the precise sine and
+	///		cosine calculation.
+	/// \copydetails rotations( const Dir&, const unit_type*, std::size_t, OutIt, P)
+	template< typename Dir, typename OutIt>
+	static typename boost::enable_if< impl::is_direction< Dir, CS::DIMENSIONS>, OutIt>::type
+		rotations( const Dir& direction, const unit_type* angles, std::size_t count, OutIt out)
+	{
+		return my_type_::rotations( direction, angles, count, out, algebra::precise_trigonometry());
 	}
 
 	/// \brief It creates the rotation transformation about an arbitrary line.
@@ -275,7 +407,134 @@ public:
 		return my_type_::scaling( center, unif_scale, unif_scale, unif_scale);
 	}
 
+	/// \brief It creates the perspective projection of the given view volume.
+	/// \param left the coordinate of the left clipping plane, on the near plane.
+	/// \param right the coordinate of the right clipping plane, on the near plane.
+	/// \param bottom the coordinate of the bottom clipping plane, on the near plane.
+	/// \param top the coordinate of the top clipping plane, on the near plane.
+	/// \param near_dist the distance to the near clipping plane. It must be positive.
+	/// \param far_dist the distance to the far clipping plane. It must be greater than near_dist.
+	/// \details
+	///		It uses the OpenGL conventions: the camera is in origin, looking along -Z axis, and the view volume is mapped 
+	///		to the cube [-1, 1] in normalized device coordinates (after the division by the weight coordinate).
+	/// \sa http://www.opengl.org/sdk/docs/man/xhtml/glFrustum.xml
+	static my_type_ perspective( 
+		const unit_type& left, const unit_type& right, 
+		const unit_type& bottom, const unit_type& top, 
+		const unit_type& near_dist, const unit_type& far_dist)
+	{
+		return my_type_(
+			2*near_dist/(right-left), 0, (right+left)/(right-left), 0,
+			0, 2*near_dist/(top-bottom), (top+bottom)/(top-bottom), 0,
+			0, 0, -(far_dist+near_dist)/(far_dist-near_dist), -2*far_dist*near_dist/(far_dist-near_dist),
+			0, 0, -1, 0);
+	}
+
+	/// \brief It creates the perspective projection with the given field of view, symmetric around the view axis.
+	/// \param fov_y the vertical field of view angle, in radians.
+	/// \param aspect the ratio between the width and the height of the view.
+	/// \param near_dist the distance to the near clipping plane. It must be positive.
+	/// \param far_dist the distance to the far clipping plane. It must be greater than near_dist.
+	/// \sa http://www.opengl.org/sdk/docs/man/xhtml/gluPerspective.xml
+	static my_type_ perspective( 
+		const unit_type& fov_y, const unit_type& aspect, const unit_type& near_dist, const unit_type& far_dist)
+	{
+		unit_type f = 1 / std::tan( fov_y / 2);
+		return my_type_(
+			f/aspect, 0, 0, 0,
+			0, f, 0, 0,
+			0, 0, (far_dist+near_dist)/(near_dist-far_dist), 2*far_dist*near_dist/(near_dist-far_dist),
+			0, 0, -1, 0);
+	}
+
+	/// \brief It creates the orthographic projection of the given view volume.
+	/// \param left the coordinate of the left clipping plane.
+	/// \param right the coordinate of the right clipping plane.
+	/// \param bottom the coordinate of the bottom clipping plane.
+	/// \param top the coordinate of the top clipping plane.
+	/// \param near_dist the distance to the near clipping plane.
+	/// \param far_dist the distance to the far clipping plane.
+	/// \details It uses the same conventions as the perspective projection.
+	/// \sa http://www.opengl.org/sdk/docs/man/xhtml/glOrtho.xml
+	static my_type_ orthographic(
+		const unit_type& left, const unit_type& right, 
+		const unit_type& bottom, const unit_type& top, 
+		const unit_type& near_dist, const unit_type& far_dist)
+	{
+		return my_type_(
+			2/(right-left), 0, 0, -(right+left)/(right-left),
+			0, 2/(top-bottom), 0, -(top+bottom)/(top-bottom),
+			0, 0, -2/(far_dist-near_dist), -(far_dist+near_dist)/(far_dist-near_dist),
+			0, 0, 0, 1);
+	}
+
 private:
+	enum { BLOCK_SIZE_ = 32 };
+
+	/// \brief It calculates the sine and the cosine of a single angle, falling back to the standard functions for the
+	///		angles out of the range of algebra::sincos.
+	template< typename P>
+	static void sincos_( const unit_type& angle, unit_type& sin, unit_type& cos, P precision)
+	{
+		if( std::abs( angle) < algebra::impl::trigonometry_constants< unit_type>::max_angle())
+		{
+			algebra::sincos( angle, sin, cos, precision);
+		}
+		else
+		{
+			sin = std::sin( angle);
+			cos = std::cos( angle);
+		}
+	}
+
+	/// \brief It builds the rotation around one of the axes from the sine and the cosine of the angle.
+	template< unsigned D>
+	static my_type_ axis_rotation_( const unit_type& sin, const unit_type& cos)
+	{
+		BOOST_STATIC_ASSERT( 1 <= D && D <= 3);
+		switch( D)
+		{
+		case 1:
+			return my_type_( 
+				1,   0,	   0, 0,
+				0, cos, -sin, 0,
+				0, sin,  cos, 0,
+				0,   0,    0, 1
+				);
+		case 2:
+			return my_type_( 
+				 cos, 0, sin, 0,
+				   0, 1,   0, 0, 
+				-sin, 0, cos, 0,
+				   0, 0,   0, 1
+				);
+		default:
+			return my_type_( 
+				cos, -sin, 0, 0,
+				sin,  cos, 0, 0,
+				  0,    0, 1, 0,
+				  0,    0, 0, 1
+				);
+		}
+	}
+
+	/// \brief It builds the rotation about the direction (lx, ly, lz) from the sine and the cosine of the angle.
+	static my_type_ direction_rotation_( 
+		const unit_type& lx, const unit_type& ly, const unit_type& lz, const unit_type& sin, const unit_type& cos)
+	{
+		unit_type 
+			lx2 = lx*lx, ly2 = ly*ly, lz2 = lz*lz,
+			lxly = lx*ly, lxlz = lx*lz, lylz = ly*lz,
+			lxsin = lx*sin, lysin = ly*sin, lzsin = lz*sin;
+		
+		return my_type_(
+			lx2+(1-lx2)*cos,    lxly*(1-cos)-lzsin,  lxlz*(1-cos)+lysin, 0,
+			lxly*(1-cos)+lzsin, ly2+(1-ly2)*cos,     lylz*(1-cos)-lxsin, 0,
+			lxlz*(1-cos)-lysin, lylz*(1-cos)+lxsin,  lz2+(1-lz2)*cos,    0,
+			0,                  0,                   0,                  1
+			);
+	}
+
 	transform_matrix tr_;
 };
 } // namespace geometry
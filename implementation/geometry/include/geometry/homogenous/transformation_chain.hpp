@@ -0,0 +1,325 @@
+#ifndef GEOMETRY_HOMOGENOUS_TRANSFORMATION_CHAIN_HPP
+#define GEOMETRY_HOMOGENOUS_TRANSFORMATION_CHAIN_HPP
+
+#include "geometry/impl/transformation_base.hpp"
+#include "geometry/direction_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cmath>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It composes translations, rotations and scalings symbolically and folds them into a single matrix only when
+///		the composed transformation is applied.
+/// \tparam CS the coordinate system used by the transformation. It must be a three dimensional homogenous coordinate
+///		system.
+/// \tparam N the maximum number of symbolic steps kept by the chain.
+/// \details
+///		Each step is applied after the steps already in the chain, so the composed matrix is <c>Sn * ... * S2 * S1</c>.
+///		A step is merged with the previous one when they have the same structure: two translations are added, two
+///		scalings are multiplied and two rotations about the same axis are added.
+///
+///		The matrix is calculated when the chain is applied for the first time after a change. Each symbolic step is
+///		applied by updating only the affected rows of the accumulated matrix, so a translation or a scaling costs 12
+///		operations and a rotation about one of the axes costs 16, instead of a full 4x4 product. A general matrix step
+///		(then( const transformation_type&)) folds the chain immediately, and so does a new step added to a full chain.
+///
+///		The chain can be used instead of a transformation for all the geometric objects.
+/// \warning
+///		The folded matrix is updated from const methods, so this class is not thread safe: call tr_matrix() once before
+///		sharing the chain between threads.
+template< typename CS, unsigned N = 16>
+class transformation_chain: public impl::transformation_base< CS>
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+	BOOST_STATIC_ASSERT( N > 0);
+
+	typedef transformation_chain< CS, N> my_type_;
+	template< typename C, unsigned M> friend class transformation_chain;
+
+public:
+	typedef transformation< CS> transformation_type;
+	typedef typename transformation_type::transform_matrix transform_matrix;
+	enum { MAX_STEPS = N };
+
+	/// \brief It creates the identity transformation.
+	transformation_chain()
+		: count_( 0)
+		, has_prefix_( false)
+		, folded_valid_( false)
+	{
+	}
+
+	/// \brief It creates the chain starting with the given transformation.
+	explicit transformation_chain( const transformation_type& tr)
+		: prefix_( tr.tr_matrix())
+		, count_( 0)
+		, has_prefix_( true)
+		, folded_valid_( false)
+	{
+	}
+
+	/// \brief It appends a translation.
+	my_type_& translate( const unit_type& dx, const unit_type& dy, const unit_type& dz)
+	{
+		return this->append_( TRANSLATION, dx, dy, dz, unit_traits_type::zero());
+	}
+
+	/// \brief It appends a scaling around origin.
+	my_type_& scale( const unit_type& xscale, const unit_type& yscale, const unit_type& zscale)
+	{
+		return this->append_( SCALING, xscale, yscale, zscale, unit_traits_type::zero());
+	}
+
+	/// \brief It appends a uniform scaling around origin.
+	my_type_& scale( const unit_type& unif_scale)
+	{
+		return this->scale( unif_scale, unif_scale, unif_scale);
+	}
+
+	/// \brief It appends a rotation around one of the axes.
+	/// \tparam D the rotation axis: 1 for X, 2 for Y, 3 for Z.
+	/// \param angle the rotation angle, in radians.
+	template< unsigned D>
+	my_type_& rotate( const unit_type& angle)
+	{
+		BOOST_STATIC_ASSERT( 1 <= D && D <= 3);
+		return this->append_( 
+			kind_( ROTATION_X + D - 1), 
+			unit_traits_type::zero(), unit_traits_type::zero(), unit_traits_type::zero(), angle);
+	}
+
+	/// \brief It appends a rotation about an arbitrary direction, passing through origin.
+	/// \tparam Dir the direction type, implementing Direction concept.
+	/// \param direction the direction to rotate about.
+	/// \param angle the rotation angle, in radians.
+	template< typename Dir>
+	typename boost::enable_if< impl::is_direction< Dir, 3>, my_type_&>::type
+		rotate( const Dir& direction, const unit_type& angle)
+	{
+		BOOST_CONCEPT_ASSERT( (Direction< Dir>));
+		return this->append_( ROTATION, direction.dx(), direction.dy(), direction.dz(), angle);
+	}
+
+	/// \brief It appends a general transformation.
+	/// \details The steps accumulated so far are folded, since the product with a general matrix cannot be simplified.
+	my_type_& then( const transformation_type& tr)
+	{
+		prefix_ = tr.tr_matrix() * this->tr_matrix();
+		has_prefix_ = true;
+		count_ = 0;
+		folded_valid_ = false;
+		return *this;
+	}
+
+	/// \brief It appends all the steps of another chain.
+	/// \details The chain may be appended to itself, which repeats its steps.
+	template< unsigned M>
+	my_type_& then( const transformation_chain< CS, M>& other)
+	{
+		if( static_cast< const void*>( &other) == this)
+		{
+			// Appending changes the steps being read.
+			const transformation_chain< CS, M> copy( other);
+			return this->then( copy);
+		}
+		if( other.has_prefix_)
+		{
+			this->then( transformation_type( other.prefix_));
+		}
+		for( unsigned i = 0; i < other.count_; ++i)
+		{
+			const typename transformation_chain< CS, M>::step_& step = other.steps_[i];
+			this->append_( kind_( step.kind), step.p[0], step.p[1], step.p[2], step.p[3]);
+		}
+		return *this;
+	}
+
+	/// \brief It gets the number of symbolic steps, after merging.
+	unsigned steps_count() const { return count_; }
+
+	/// \brief It gets the composed transformation matrix, folding the steps if they changed since the last call.
+	const transform_matrix& tr_matrix() const
+	{
+		if( !folded_valid_)
+		{
+			folded_ = has_prefix_ ? prefix_ : transform_matrix::IDENTITY();
+			for( unsigned i = 0; i < count_; ++i)
+			{
+				my_type_::apply_step_( steps_[i], folded_);
+			}
+			folded_valid_ = true;
+		}
+		return folded_;
+	}
+
+	/// \brief It gets the composed transformation.
+	transformation_type to_transformation() const { return transformation_type( this->tr_matrix()); }
+
+	/// \copydoc impl::htransformation_base::transformed
+	coord_vector transformed( const coord_vector& pos) const
+	{
+		return this->tr_matrix() * pos;
+	}
+
+	/// \copydoc impl::htransformation_base::transform
+	void transform( coord_vector& pos) const
+	{
+		pos = this->tr_matrix() * pos;
+	}
+
+	/// \copydoc impl::htransformation_base::transformed_direction
+	typename coord_system::dir_rep transformed_direction( const typename coord_system::dir_rep& dir) const
+	{
+		return this->to_transformation().transformed_direction( dir);
+	}
+
+	/// \copydoc impl::htransformation_base::inverse_transpose
+	transform_matrix inverse_transpose() const
+	{
+		return transposed( inverted( this->tr_matrix()));
+	}
+
+	/// \copydoc impl::htransformation_base::is_affine
+	bool is_affine() const
+	{
+		const transform_matrix& m = this->tr_matrix();
+		return m( 3, 0) == unit_traits_type::zero() && m( 3, 1) == unit_traits_type::zero()
+			&& m( 3, 2) == unit_traits_type::zero() && m( 3, 3) == unit_traits_type::one();
+	}
+
+private:
+	enum kind_ { TRANSLATION, SCALING, ROTATION_X, ROTATION_Y, ROTATION_Z, ROTATION };
+
+	/// \brief Symbolic step: the translation or scaling factors, or the rotation axis and angle.
+	struct step_
+	{
+		int kind;
+		unit_type p[4];
+	};
+
+	/// \brief It appends a step, merging it with the last one if they have the same structure.
+	my_type_& append_( kind_ kind, const unit_type& p0, const unit_type& p1, const unit_type& p2, const unit_type& p3)
+	{
+		folded_valid_ = false;
+		if( count_ > 0 && steps_[count_-1].kind == kind)
+		{
+			unit_type* last = steps_[count_-1].p;
+			switch( kind)
+			{
+			case TRANSLATION:
+				last[0] += p0; last[1] += p1; last[2] += p2;
+				return *this;
+			case SCALING:
+				last[0] *= p0; last[1] *= p1; last[2] *= p2;
+				return *this;
+			case ROTATION:
+				if( last[0] == p0 && last[1] == p1 && last[2] == p2)
+				{
+					last[3] += p3;
+					return *this;
+				}
+				break;
+			default:
+				last[3] += p3;
+				return *this;
+			}
+		}
+
+		if( count_ == N)
+		{
+			prefix_ = this->tr_matrix();
+			has_prefix_ = true;
+			count_ = 0;
+			folded_valid_ = false;
+		}
+		step_& step = steps_[count_++];
+		step.kind = kind;
+		step.p[0] = p0; step.p[1] = p1; step.p[2] = p2; step.p[3] = p3;
+		return *this;
+	}
+
+	/// \brief It multiplies the rows r1 and r2 of the matrix, on the left, by the rotation with the given sine and
+	///		cosine.
+	static void rotate_rows_( transform_matrix& m, unsigned r1, unsigned r2, const unit_type& sin, const unit_type& cos)
+	{
+		for( unsigned c = 0; c < 4; ++c)
+		{
+			const unit_type a = m( r1, c), b = m( r2, c);
+			m( r1, c) = cos*a - sin*b;
+			m( r2, c) = sin*a + cos*b;
+		}
+	}
+
+	/// \brief It multiplies the matrix, on the left, with the matrix of the step.
+	static void apply_step_( const step_& step, transform_matrix& m)
+	{
+		const unit_type* p = step.p;
+		switch( step.kind)
+		{
+		case TRANSLATION:
+			for( unsigned c = 0; c < 4; ++c)
+			{
+				const unit_type w = m( 3, c);
+				m( 0, c) += p[0]*w;
+				m( 1, c) += p[1]*w;
+				m( 2, c) += p[2]*w;
+			}
+			break;
+		case SCALING:
+			for( unsigned c = 0; c < 4; ++c)
+			{
+				m( 0, c) *= p[0];
+				m( 1, c) *= p[1];
+				m( 2, c) *= p[2];
+			}
+			break;
+		case ROTATION_X:
+			my_type_::rotate_rows_( m, 1, 2, std::sin( p[3]), std::cos( p[3]));
+			break;
+		case ROTATION_Y:
+			my_type_::rotate_rows_( m, 2, 0, std::sin( p[3]), std::cos( p[3]));
+			break;
+		case ROTATION_Z:
+			my_type_::rotate_rows_( m, 0, 1, std::sin( p[3]), std::cos( p[3]));
+			break;
+		default:
+			{
+				const unit_type
+					sin = std::sin( p[3]), cos = std::cos( p[3]),
+					lx = p[0], ly = p[1], lz = p[2],
+					lxly = lx*ly, lxlz = lx*lz, lylz = ly*lz,
+					lxsin = lx*sin, lysin = ly*sin, lzsin = lz*sin;
+				const unit_type r[3][3] = {
+					{ lx*lx+(1-lx*lx)*cos, lxly*(1-cos)-lzsin,  lxlz*(1-cos)+lysin },
+					{ lxly*(1-cos)+lzsin,  ly*ly+(1-ly*ly)*cos, lylz*(1-cos)-lxsin },
+					{ lxlz*(1-cos)-lysin,  lylz*(1-cos)+lxsin,  lz*lz+(1-lz*lz)*cos } };
+				for( unsigned c = 0; c < 4; ++c)
+				{
+					const unit_type a = m( 0, c), b = m( 1, c), d = m( 2, c);
+					m( 0, c) = r[0][0]*a + r[0][1]*b + r[0][2]*d;
+					m( 1, c) = r[1][0]*a + r[1][1]*b + r[1][2]*d;
+					m( 2, c) = r[2][0]*a + r[2][1]*b + r[2][2]*d;
+				}
+			}
+			break;
+		}
+	}
+
+	transform_matrix prefix_;
+	step_ steps_[N];
+	unsigned count_;
+	bool has_prefix_;
+	mutable transform_matrix folded_;
+	mutable bool folded_valid_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_TRANSFORMATION_CHAIN_HPP
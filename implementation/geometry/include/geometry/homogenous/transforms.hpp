@@ -0,0 +1,174 @@
+#ifndef GEOMETRY_HOMOGENOUS_TRANSFORMS_HPP
+#define GEOMETRY_HOMOGENOUS_TRANSFORMS_HPP
+
+#include "geometry/line_concept.hpp"
+#include "geometry/plane_concept.hpp"
+#include "geometry/transformation_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/homogenous/cached_transformation.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <iterator>
+
+namespace geometry
+{
+namespace impl
+{
+
+/// \brief It transforms a plane using the inverse of the transposed transformation matrix.
+template< typename P, typename M>
+P transformed_plane( const P& p, const M& inverse_transpose)
+{
+	typename P::coord_system::coord_vector coefs = 
+		inverse_transpose * typename P::coord_system::coord_vector( p.a(), p.b(), p.c(), p.d());
+	return P( coefs( 0), coefs( 1), coefs( 2), coefs( 3));
+}
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It gets the result of applying the given transformation on a line.
+/// \tparam L the line type, implementing the Line concept.
+/// \tparam T the transformation type (a homogenous transformation or a cached_transformation).
+/// \details
+///		It transforms the base of the line and a second vertex of the line, so the result is correct for the projective
+///		transformations too, not only for the affine ones.
+template< typename L, typename T>
+typename boost::enable_if< impl::is_line< L, 3, hcoord_system_tag>, L>::type
+	transformed( const L& l, const T& tr)
+{
+	BOOST_CONCEPT_ASSERT( (Line3D<L>));
+	typedef typename L::vertex_type vertex_type;
+	typedef typename L::direction_type direction_type;
+
+	vertex_type 
+		base = l.base().transformed( tr),
+		second( l.base().normalized() + l.dir().representation());
+	second.transform( tr);
+	return L( base, direction_type( second.normalized() - base.normalized()));
+}
+
+/// \ingroup geometry
+/// \brief It applies the given transformation on a line.
+/// \see transformed( const L&, const T&)
+template< typename L, typename T>
+typename boost::enable_if< impl::is_line< L, 3, hcoord_system_tag>, L&>::type
+	transform( L& l, const T& tr)
+{
+	l = transformed( l, tr);
+	return l;
+}
+
+/// \ingroup geometry
+/// \brief It gets the result of applying the given transformation on a plane.
+/// \tparam P the plane type, implementing the Plane concept.
+/// \tparam T the transformation type (a homogenous transformation or a cached_transformation).
+/// \details
+///		The plane coefficients are transformed using the inverse of the transposed transformation matrix. Use a 
+///		cached_transformation for transforming more planes with the same transformation, so the inversion is done only 
+///		once.
+template< typename P, typename T>
+typename boost::enable_if< impl::is_plane< P, 3, hcoord_system_tag>, P>::type
+	transformed( const P& p, const T& tr)
+{
+	BOOST_CONCEPT_ASSERT( (Plane<P>));
+	return impl::transformed_plane( p, tr.inverse_transpose());
+}
+
+/// \ingroup geometry
+/// \brief It applies the given transformation on a plane.
+/// \see transformed( const P&, const T&)
+template< typename P, typename T>
+typename boost::enable_if< impl::is_plane< P, 3, hcoord_system_tag>, P&>::type
+	transform( P& p, const T& tr)
+{
+	p = transformed( p, tr);
+	return p;
+}
+
+/// \ingroup geometry
+/// \brief It transforms a sequence of planes.
+/// \tparam PIt the iterator type of the plane sequence. The planes must implement the Plane concept, in a three
+///		dimensional homogenous coordinate system.
+/// \tparam OutIt the output iterator type, accepting planes.
+/// \tparam T the transformation type (a homogenous transformation or a cached_transformation), implementing the
+///		Transformation concept.
+/// \param first the beginning of the plane sequence.
+/// \param last the end of the plane sequence.
+/// \param out the beginning of the destination sequence. It can be the same as the source sequence.
+/// \param tr the transformation to apply.
+/// \return the output iterator after the last written plane.
+/// \details The inverse transposed matrix is calculated only once for the whole sequence.
+template< typename PIt, typename OutIt, typename T>
+typename boost::enable_if< impl::is_plane< typename std::iterator_traits< PIt>::value_type, 3, hcoord_system_tag>,
+	OutIt>::type transformed( PIt first, PIt last, OutIt out, const T& tr)
+{
+	typedef typename std::iterator_traits< PIt>::value_type plane_type;
+	BOOST_CONCEPT_ASSERT( (Plane<plane_type>));
+	BOOST_CONCEPT_ASSERT( (Transformation<T>));
+	const typename plane_type::coord_system::transform_matrix inverse_transpose = tr.inverse_transpose();
+	for( ; first != last; ++first, ++out)
+	{
+		*out = impl::transformed_plane( *first, inverse_transpose);
+	}
+	return out;
+}
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The minimum number of planes transformed by a parallel task.
+enum { PLANE_TRANSFORM_MIN_GRAIN = 4096 };
+
+/// \ingroup geometry
+/// \brief It transforms a chunk of a plane sequence.
+template< typename PIt, typename OutIt, typename M>
+struct transform_planes_chunk
+{
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		OutIt o = out + begin;
+		for( PIt it = first + begin, last = first + end; it != last; ++it, ++o)
+		{
+			*o = impl::transformed_plane( *it, *inverse_transpose);
+		}
+	}
+
+	PIt first;
+	OutIt out;
+	const M* inverse_transpose;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It transforms a random access sequence of planes, as specified by the execution policy.
+/// \param policy the execution policy.
+/// \copydetails transformed( PIt, PIt, OutIt, const T&)
+///
+///		The output iterator must be a random access iterator as well.
+template< typename P, typename PIt, typename OutIt, typename T>
+typename boost::enable_if_c<
+		parallel::is_execution_policy< P>::value
+		&& impl::is_plane< typename std::iterator_traits< PIt>::value_type, 3, hcoord_system_tag>::value,
+		OutIt>::type
+	transformed( const P& policy, PIt first, PIt last, OutIt out, const T& tr)
+{
+	typedef typename std::iterator_traits< PIt>::value_type plane_type;
+	typedef typename plane_type::coord_system::transform_matrix transform_matrix;
+	BOOST_CONCEPT_ASSERT( (Plane<plane_type>));
+	BOOST_CONCEPT_ASSERT( (Transformation<T>));
+	const transform_matrix inverse_transpose = tr.inverse_transpose();
+	const impl::transform_planes_chunk< PIt, OutIt, transform_matrix> chunk = { first, out, &inverse_transpose };
+	parallel::for_each_chunk( policy, 0, last - first, impl::PLANE_TRANSFORM_MIN_GRAIN, chunk);
+	return out + (last - first);
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_TRANSFORMS_HPP
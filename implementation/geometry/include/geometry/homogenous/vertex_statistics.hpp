@@ -0,0 +1,396 @@
+#ifndef GEOMETRY_HOMOGENOUS_VERTEX_STATISTICS_HPP
+#define GEOMETRY_HOMOGENOUS_VERTEX_STATISTICS_HPP
+
+#include "geometry/vertex_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include <boost/concept/assert.hpp>
+#include "parallel/execution.hpp"
+#include <boost/static_assert.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It accumulates the bounding box, the centroid and the covariance of a set of three dimensional vertices.
+/// \tparam CS the coordinate system of the vertices. It must be a three dimensional homogenous coordinate system.
+/// \details
+///		The statistics are accumulated in double precision, whatever the unit type. The centroid and the sums of the
+///		products of the deviations from it are updated incrementally (Welford), and two sets of statistics are merged
+///		using the pairwise formulas (Chan), so there is no cancellation even for vertices far from origin.
+/// \sa T. F. Chan, G. H. Golub, R. J. LeVeque, "Updating Formulae and a Pairwise Algorithm for Computing Sample
+///		Variances", Stanford CS report STAN-CS-79-773, 1979.
+template< typename CS>
+class vertex_statistics
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+
+	typedef vertex_statistics< CS> my_type_;
+
+public:
+	typedef typename CS::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+	typedef algebra::matrix< 3, 3, unit_type, typename CS::unit_traits_type> covariance_matrix;
+
+	/// \brief It creates the statistics of an empty set.
+	vertex_statistics()
+		: count_( 0)
+	{
+		std::fill( mean_, mean_ + 3, 0.0);
+		std::fill( comoments_, comoments_ + 6, 0.0);
+		std::fill( min_, min_ + 3, 0.0);
+		std::fill( max_, max_ + 3, 0.0);
+	}
+
+	/// \brief It adds a vertex, given by its carthesian coordinates.
+	void add( const unit_type& x, const unit_type& y, const unit_type& z)
+	{
+		const double p[3] = { double( x), double( y), double( z) };
+		if( count_ == 0)
+		{
+			std::copy( p, p + 3, min_);
+			std::copy( p, p + 3, max_);
+		}
+		++count_;
+		double delta[3];
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			delta[i] = p[i] - mean_[i];
+			mean_[i] += delta[i] / double( count_);
+			min_[i] = std::min( min_[i], p[i]);
+			max_[i] = std::max( max_[i], p[i]);
+		}
+		// The deviation from the old centroid times the deviation from the new one.
+		unsigned k = 0;
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			for( unsigned j = i; j < 3; ++j, ++k)
+			{
+				comoments_[k] += delta[i] * (p[j] - mean_[j]);
+			}
+		}
+	}
+
+	/// \brief It adds a vertex.
+	/// \tparam V the vertex type, implementing the 3D vertex concept.
+	template< typename V>
+	void add( const V& v)
+	{
+		BOOST_CONCEPT_ASSERT( (Vertex3D< V>));
+		this->add( v.x(), v.y(), v.z());
+	}
+
+	/// \brief It adds the vertices accumulated by other statistics.
+	void merge( const my_type_& other)
+	{
+		if( other.count_ == 0)
+		{
+			return;
+		}
+		if( count_ == 0)
+		{
+			*this = other;
+			return;
+		}
+		const double n1 = double( count_), n2 = double( other.count_), n = n1 + n2;
+		double delta[3];
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			delta[i] = other.mean_[i] - mean_[i];
+			mean_[i] += delta[i] * (n2 / n);
+			min_[i] = std::min( min_[i], other.min_[i]);
+			max_[i] = std::max( max_[i], other.max_[i]);
+		}
+		const double weight = n1 * n2 / n;
+		unsigned k = 0;
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			for( unsigned j = i; j < 3; ++j, ++k)
+			{
+				comoments_[k] += other.comoments_[k] + delta[i] * delta[j] * weight;
+			}
+		}
+		count_ += other.count_;
+	}
+
+	/// \brief It gets the number of vertices.
+	std::size_t count() const { return count_; }
+
+	/// \brief It gets the corners of the bounding box. They are the origin for an empty set.
+	/// \{
+	vertex_type min_corner() const
+	{
+		return vertex_type( unit_type( min_[0]), unit_type( min_[1]), unit_type( min_[2]));
+	}
+
+	vertex_type max_corner() const
+	{
+		return vertex_type( unit_type( max_[0]), unit_type( max_[1]), unit_type( max_[2]));
+	}
+	/// \}
+
+	/// \brief It gets the centroid of the vertices. It is the origin for an empty set.
+	vertex_type centroid() const
+	{
+		return vertex_type( unit_type( mean_[0]), unit_type( mean_[1]), unit_type( mean_[2]));
+	}
+
+	/// \brief It gets the covariance matrix of the vertices.
+	/// \param sample if true, the sums are divided by <c>count - 1</c> (sample covariance), otherwise by \c count
+	///		(population covariance).
+	covariance_matrix covariance( bool sample = false) const
+	{
+		covariance_matrix result;
+		const std::size_t divisor = sample ? count_ - 1 : count_;
+		if( count_ == 0 || divisor == 0)
+		{
+			return result;
+		}
+		unsigned k = 0;
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			for( unsigned j = i; j < 3; ++j, ++k)
+			{
+				result( i, j) = result( j, i) = unit_type( comoments_[k] / double( divisor));
+			}
+		}
+		return result;
+	}
+
+	/// \brief It calculates the statistics of a block of vertices given by their carthesian coordinates.
+	/// \details
+	///		The coordinates are shifted by the first vertex, which is close enough to the centroid of the block for
+	///		keeping the plain sums of products accurate. The loop has no divisions, so it can be vectorized.
+	static my_type_ from_block( const unit_type* x, const unit_type* y, const unit_type* z, std::size_t count)
+	{
+		my_type_ result;
+		if( count == 0)
+		{
+			return result;
+		}
+		const double shift[3] = { double( x[0]), double( y[0]), double( z[0]) };
+		double sums[3] = { 0, 0, 0 }, products[6] = { 0, 0, 0, 0, 0, 0 };
+		std::copy( shift, shift + 3, result.min_);
+		std::copy( shift, shift + 3, result.max_);
+		for( std::size_t i = 0; i < count; ++i)
+		{
+			const double p[3] = { double( x[i]), double( y[i]), double( z[i]) };
+			const double d[3] = { p[0] - shift[0], p[1] - shift[1], p[2] - shift[2] };
+			sums[0] += d[0]; sums[1] += d[1]; sums[2] += d[2];
+			products[0] += d[0]*d[0]; products[1] += d[0]*d[1]; products[2] += d[0]*d[2];
+			products[3] += d[1]*d[1]; products[4] += d[1]*d[2]; products[5] += d[2]*d[2];
+			for( unsigned j = 0; j < 3; ++j)
+			{
+				result.min_[j] = std::min( result.min_[j], p[j]);
+				result.max_[j] = std::max( result.max_[j], p[j]);
+			}
+		}
+		result.count_ = count;
+		const double n = double( count);
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			result.mean_[i] = shift[i] + sums[i] / n;
+		}
+		unsigned k = 0;
+		for( unsigned i = 0; i < 3; ++i)
+		{
+			for( unsigned j = i; j < 3; ++j, ++k)
+			{
+				result.comoments_[k] = products[k] - sums[i] * sums[j] / n;
+			}
+		}
+		return result;
+	}
+
+private:
+	std::size_t count_;
+	double mean_[3];
+	// The sums of the products of deviations from the centroid: xx, xy, xz, yy, yz, zz.
+	double comoments_[6];
+	double min_[3], max_[3];
+};
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It calculates the statistics of fixed size blocks of vertices, as specified by an execution policy, then
+///		merges them in the order of the blocks.
+/// \details
+///		The blocks don't depend on the execution policy, and neither does the merging order, so the result is the same
+///		for any policy and any number of threads.
+template< typename CS, typename Source>
+class statistics_reduction
+{
+public:
+	typedef vertex_statistics< CS> statistics_type;
+	enum
+	{
+		/// \brief The number of vertices of a block.
+		BLOCK_SIZE = 4096,
+		/// \brief The number of vertices copied at once in the coordinate buffers.
+		BUFFER_SIZE = 256
+	};
+
+	statistics_reduction( const Source& source, std::size_t count)
+		: source_( source)
+		, count_( count)
+		, blocks_( (count + BLOCK_SIZE - 1) / BLOCK_SIZE)
+	{
+	}
+
+	template< typename P>
+	statistics_type reduce( const P& policy)
+	{
+		parallel::for_each_chunk( policy, 0, blocks_.size(), 1,
+			boost::bind( &statistics_reduction::reduce_blocks_, this, _1, _2));
+
+		statistics_type result;
+		for( std::size_t b = 0; b < blocks_.size(); ++b)
+		{
+			result.merge( blocks_[b]);
+		}
+		return result;
+	}
+
+private:
+	void reduce_blocks_( std::size_t first_block, std::size_t last_block)
+	{
+		for( std::size_t b = first_block; b < last_block; ++b)
+		{
+			const std::size_t begin = b * BLOCK_SIZE, end = std::min( count_, begin + BLOCK_SIZE);
+			statistics_type& block = blocks_[b];
+			typename CS::unit_type x[BUFFER_SIZE], y[BUFFER_SIZE], z[BUFFER_SIZE];
+			for( std::size_t i = begin; i < end; i += BUFFER_SIZE)
+			{
+				const std::size_t n = std::min( std::size_t( BUFFER_SIZE), end - i);
+				source_.get( i, n, x, y, z);
+				block.merge( statistics_type::from_block( x, y, z, n));
+			}
+		}
+	}
+
+	Source source_;
+	std::size_t count_;
+	std::vector< statistics_type> blocks_;
+};
+
+/// \ingroup geometry
+/// \brief It reads the coordinates from a random access sequence of vertices.
+template< typename CS, typename RandomIt>
+struct vertex_range_source
+{
+	vertex_range_source( RandomIt first): first_( first) {}
+
+	void get( std::size_t begin, std::size_t count,
+		typename CS::unit_type* x, typename CS::unit_type* y, typename CS::unit_type* z) const
+	{
+		RandomIt it = first_ + begin;
+		for( std::size_t i = 0; i < count; ++i, ++it)
+		{
+			x[i] = it->x();
+			y[i] = it->y();
+			z[i] = it->z();
+		}
+	}
+
+	RandomIt first_;
+};
+
+/// \ingroup geometry
+/// \brief It reads the coordinates from separate arrays.
+template< typename CS>
+struct coordinate_arrays_source
+{
+	typedef typename CS::unit_type unit_type;
+
+	coordinate_arrays_source( const unit_type* x, const unit_type* y, const unit_type* z): x_( x), y_( y), z_( z) {}
+
+	void get( std::size_t begin, std::size_t count, unit_type* x, unit_type* y, unit_type* z) const
+	{
+		std::copy( x_ + begin, x_ + begin + count, x);
+		std::copy( y_ + begin, y_ + begin + count, y);
+		std::copy( z_ + begin, z_ + begin + count, z);
+	}
+
+	const unit_type* x_;
+	const unit_type* y_;
+	const unit_type* z_;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It calculates the bounding box, the centroid and the covariance of a sequence of vertices, in a single pass.
+/// \tparam RandomIt the random access iterator type of the vertex sequence. The vertices must implement the 3D vertex
+///		concept and must use the CS coordinate system.
+/// \param policy the execution policy (parallel::seq, parallel::par or parallel::par_vec).
+/// \param first the beginning of the sequence.
+/// \param last the end of the sequence.
+/// \details
+///		The vertices are processed in blocks of impl::statistics_reduction::BLOCK_SIZE vertices, and the block results
+///		are merged in order, so the result is the same for any execution policy. Each vertex is read once; for the
+///		homogenous vertex, reading the carthesian coordinates costs a division by the weight coordinate, which the
+///		affine vertex avoids.
+template< typename P, typename RandomIt>
+typename boost::enable_if< parallel::is_execution_policy< P>,
+	vertex_statistics< typename std::iterator_traits< RandomIt>::value_type::coord_system> >::type
+	calculate_statistics( const P& policy, RandomIt first, RandomIt last)
+{
+	typedef typename std::iterator_traits< RandomIt>::value_type vertex_type;
+	typedef typename vertex_type::coord_system coord_system;
+	BOOST_CONCEPT_ASSERT( (Vertex3D< vertex_type>));
+	typedef impl::vertex_range_source< coord_system, RandomIt> source_type;
+	return impl::statistics_reduction< coord_system, source_type>(
+		source_type( first), static_cast< std::size_t>( last - first)).reduce( policy);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the statistics of a sequence of vertices in the calling thread.
+/// \see calculate_statistics( const P&, RandomIt, RandomIt)
+template< typename RandomIt>
+vertex_statistics< typename std::iterator_traits< RandomIt>::value_type::coord_system>
+	calculate_statistics( RandomIt first, RandomIt last)
+{
+	return calculate_statistics( parallel::seq, first, last);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the bounding box, the centroid and the covariance of vertices given by separate arrays of
+///		carthesian coordinates, in a single pass.
+/// \tparam CS the coordinate system of the vertices.
+/// \param policy the execution policy.
+/// \param x the X coordinates.
+/// \param y the Y coordinates.
+/// \param z the Z coordinates.
+/// \param count the number of vertices.
+/// \copydetails calculate_statistics( const P&, RandomIt, RandomIt)
+template< typename CS, typename P>
+vertex_statistics< CS> calculate_statistics( const P& policy,
+	const typename CS::unit_type* x, const typename CS::unit_type* y, const typename CS::unit_type* z,
+	std::size_t count)
+{
+	typedef impl::coordinate_arrays_source< CS> source_type;
+	return impl::statistics_reduction< CS, source_type>( source_type( x, y, z), count).reduce( policy);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the statistics of vertices given by separate arrays of coordinates, in the calling thread.
+template< typename CS>
+vertex_statistics< CS> calculate_statistics(
+	const typename CS::unit_type* x, const typename CS::unit_type* y, const typename CS::unit_type* z,
+	std::size_t count)
+{
+	return calculate_statistics< CS>( parallel::seq, x, y, z, count);
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_VERTEX_STATISTICS_HPP
@@ -0,0 +1,468 @@
+#ifndef GEOMETRY_HOMOGENOUS_VERTEX_VIEW_HPP
+#define GEOMETRY_HOMOGENOUS_VERTEX_VIEW_HPP
+
+#include "geometry/impl/vertex_base.hpp"
+#include "geometry/vertex_concept.hpp"
+#include "geometry/transformation_concept.hpp"
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/concept/requires.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It implements the reading of the coordinates, common to the writable and the read only vertex views.
+/// \tparam CS the coordinate system type.
+/// \tparam COMPONENTS the number of coordinates stored in the buffer for each vertex.
+/// \tparam U the type of the referred coordinates: \c unit_type for the writable views, <c>const unit_type</c> for
+///		the read only ones.
+template< typename CS, unsigned COMPONENTS, typename U>
+class vertex_view_base: public vertex_base< CS>
+{
+	BOOST_CONCEPT_ASSERT( (HCoordSystem<CS>));
+	BOOST_STATIC_ASSERT( CS::DIMENSIONS == 3);
+	BOOST_STATIC_ASSERT( COMPONENTS == 3 || COMPONENTS == 4);
+public:
+	typedef typename CS::pos_rep pos_rep;
+	enum { COMPONENT_COUNT = COMPONENTS };
+
+	/// \brief Coordinate accessors. For the homogenous buffers, they divide by the weight coordinate.
+	/// \{
+	unit_type x() const { return COMPONENTS == 4 ? data_[0] / data_[3] : data_[0]; }
+	unit_type y() const { return COMPONENTS == 4 ? data_[1] / data_[3] : data_[1]; }
+	unit_type z() const { return COMPONENTS == 4 ? data_[2] / data_[3] : data_[2]; }
+	unit_type w() const { return COMPONENTS == 4 ? data_[3] : unit_traits_type::one(); }
+	/// \}
+
+	pos_rep normalized() const { return pos_rep( this->x(), this->y(), this->z()); }
+	void normalized( pos_rep& pos) const { pos = this->normalized(); }
+
+	/// \brief It gets the homogenous coordinates.
+	coord_vector coordinates() const { return coord_vector( data_[0], data_[1], data_[2], this->w()); }
+
+	/// \brief It checks whether the vertex is valid.
+	/// \details A vertex is valid if its coordinates are valid, finite numbers.
+	bool is_valid() const
+	{
+		for( unsigned i = 0; i < COMPONENTS; ++i)
+		{
+			if( !unit_traits_type::is_valid_number( data_[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// \brief It gets the address of the referred coordinates.
+	const unit_type* data() const { return data_; }
+
+	/// \brief It checks whether the coordinates are stored in the view object.
+	bool owns_coordinates() const { return data_ == storage_; }
+
+	/// \brief It copies the referred coordinates in a vertex object.
+	operator vertex< CS>() const { return vertex< CS>( this->coordinates()); }
+
+protected:
+	explicit vertex_view_base( U* data)
+		: data_( data) { }
+
+	/// \brief It creates a view owning its coordinates.
+	vertex_view_base( const unit_type& x, const unit_type& y, const unit_type& z, const unit_type& w)
+		: data_( storage_)
+	{
+		store_( storage_, x, y, z, w);
+	}
+
+	/// \brief It copies the view. If the source owns its coordinates, the copy owns a copy of them.
+	vertex_view_base( const vertex_view_base& source)
+		: data_( source.owns_coordinates() ? storage_ : source.data_)
+	{
+		std::copy( source.storage_, source.storage_ + COMPONENTS, storage_);
+	}
+
+	/// \brief It makes the view refer the coordinates referred by the source, without writing them.
+	void rebind_( const vertex_view_base& source)
+	{
+		std::copy( source.storage_, source.storage_ + COMPONENTS, storage_);
+		data_ = source.owns_coordinates() ? storage_ : source.data_;
+	}
+
+	static void store_( unit_type* data, const unit_type& x, const unit_type& y, const unit_type& z,
+		const unit_type& w)
+	{
+		if( COMPONENTS == 4)
+		{
+			data[0] = x; data[1] = y; data[2] = z; data[COMPONENTS - 1] = w;
+		}
+		else
+		{
+			data[0] = x / w; data[1] = y / w; data[2] = z / w;
+		}
+	}
+
+	U* data_;
+	unit_type storage_[COMPONENTS];
+
+private:
+	vertex_view_base& operator=( const vertex_view_base&);
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It implements a vertex of three dimensional, homogenous coordinate system, which uses the coordinates stored
+///		in a buffer owned by somebody else.
+/// \tparam CS the coordinate system type.
+/// \tparam COMPONENTS the number of coordinates stored in the buffer for each vertex: 3 for carthesian coordinates
+///		(the weight coordinate is 1), 4 for homogenous coordinates.
+/// \details
+///		The view is a reference, like the reference of an element of a container: reading the coordinates reads the
+///		buffer, transform() and the assignment write the buffer, and a copy of the view refers the same coordinates.
+///		The views are usually obtained from a strided_range over an interleaved buffer (e.g. a vertex buffer of a
+///		graphics API, or the output of a sensor driver), so the algorithms accepting homogenous vertices run on the
+///		buffer without creating a vertex object for each element. The value type of the strided ranges is \c vertex,
+///		so the algorithms which keep elements aside (e.g. sorting) keep copies of the coordinates; swapping two views
+///		swaps the referred coordinates.
+///
+///		Since the vertex concept requires creating vertices from coordinates, the vertices created by the other
+///		constructors (e.g. the vertices returned by shortest_segment) store their coordinates in the view object.
+///
+///		See const_vertex_view for the read only access.
+template< typename CS, unsigned COMPONENTS = 3>
+class vertex_view: public impl::vertex_view_base< CS, COMPONENTS, typename CS::unit_type>
+{
+	typedef vertex_view< CS, COMPONENTS> my_type_;
+	typedef impl::vertex_view_base< CS, COMPONENTS, typename CS::unit_type> base_type_;
+public:
+	/// \brief It creates a view of the coordinates starting at the given address.
+	explicit vertex_view( unit_type* data)
+		: base_type_( data) { }
+
+	/// \brief It creates a vertex in origin, owning its coordinates.
+	vertex_view()
+		: base_type_( 0, 0, 0, unit_traits_type::one()) { }
+
+	/// \brief It creates a vertex owning its coordinates.
+	vertex_view( const unit_type& x, const unit_type& y, const unit_type& z)
+		: base_type_( x, y, z, unit_traits_type::one()) { }
+
+	/// \brief It creates a vertex owning its coordinates, from homogenous coordinates.
+	vertex_view( const unit_type& x, const unit_type& y, const unit_type& z, const unit_type& w)
+		: base_type_( x, y, z, w) { }
+
+	/// \brief It creates a vertex owning its coordinates, from the position internal representation.
+	vertex_view( const pos_rep& coords)
+		: base_type_( coords( 0), coords( 1), coords( 2), unit_traits_type::one()) { }
+
+	/// \brief It creates a vertex owning its coordinates, from the homogenous coordinates internal representation.
+	vertex_view( const coord_vector& coords)
+		: base_type_( coords( 0), coords( 1), coords( 2), coords( 3)) { }
+
+	/// \brief It writes the coordinates of the given vertex in the place referred by this one.
+	my_type_& operator=( const my_type_& source)
+	{
+		this->store_( source.coordinates());
+		return *this;
+	}
+
+	/// \brief It writes the coordinates of another homogenous vertex (e.g. the value type of the strided ranges) in
+	///		the place referred by this one. The homogenous buffers receive the normalized coordinates.
+	template< typename V>
+	typename boost::enable_if< impl::is_vertex< V, 3, hcoord_system_tag>, my_type_&>::type
+		operator=( const V& source)
+	{
+		this->store_( coord_vector( source.x(), source.y(), source.z(), unit_traits_type::one()));
+		return *this;
+	}
+
+	/// \brief It applies the given transformation, writing the result in the place referred by the view.
+	/// \details For the carthesian buffers, the result is normalized before being stored.
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (my_type_&))
+		transform( const T& tr)
+	{
+		coord_vector coords = this->coordinates();
+		tr.transform( coords);
+		this->store_( coords);
+		return *this;
+	}
+
+	/// \brief It gets the result of applying the given transformation, as a vertex owning its coordinates.
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (my_type_))
+		transformed( const T& tr) const
+	{
+		return my_type_( tr.transformed( this->coordinates()));
+	}
+
+	/// \brief It gets the address of the referred coordinates.
+	/// \{
+	unit_type* data() { return this->data_; }
+	const unit_type* data() const { return this->data_; }
+	/// \}
+
+	/// \brief It swaps the coordinates referred by the given views.
+	/// \details
+	///		The views given by the strided iterators are temporary objects, which is why they are accepted by constant
+	///		reference: constant is the view, not the referred buffer.
+	/// \{
+	friend void swap( const my_type_& a, const my_type_& b)
+	{
+		std::swap_ranges( a.data_, a.data_ + COMPONENTS, b.data_);
+	}
+
+	friend void swap( my_type_& a, my_type_& b)
+	{
+		std::swap_ranges( a.data_, a.data_ + COMPONENTS, b.data_);
+	}
+	/// \}
+
+private:
+	void store_( const coord_vector& coords)
+	{
+		base_type_::store_( this->data_, coords( 0), coords( 1), coords( 2), coords( 3));
+	}
+};
+
+/// \ingroup geometry
+/// \brief It implements a read only view of the coordinates of a three dimensional, homogenous vertex, stored in a
+///		buffer owned by somebody else.
+/// \tparam CS the coordinate system type.
+/// \tparam COMPONENTS the number of coordinates stored in the buffer for each vertex (3 or 4).
+/// \details
+///		It is the vertex_view of the constant buffers: it has no way of writing the referred coordinates. The assignment
+///		makes the view refer the coordinates of the source, like the assignment of a pointer.
+template< typename CS, unsigned COMPONENTS = 3>
+class const_vertex_view: public impl::vertex_view_base< CS, COMPONENTS, const typename CS::unit_type>
+{
+	typedef const_vertex_view< CS, COMPONENTS> my_type_;
+	typedef impl::vertex_view_base< CS, COMPONENTS, const typename CS::unit_type> base_type_;
+public:
+	/// \brief It creates a view of the coordinates starting at the given address.
+	explicit const_vertex_view( const unit_type* data)
+		: base_type_( data) { }
+
+	/// \brief It creates a vertex in origin, owning its coordinates.
+	const_vertex_view()
+		: base_type_( 0, 0, 0, unit_traits_type::one()) { }
+
+	/// \brief It creates a vertex owning its coordinates.
+	const_vertex_view( const unit_type& x, const unit_type& y, const unit_type& z)
+		: base_type_( x, y, z, unit_traits_type::one()) { }
+
+	/// \brief It creates a vertex owning its coordinates, from homogenous coordinates.
+	const_vertex_view( const unit_type& x, const unit_type& y, const unit_type& z, const unit_type& w)
+		: base_type_( x, y, z, w) { }
+
+	/// \brief It creates a vertex owning its coordinates, from the position internal representation.
+	const_vertex_view( const pos_rep& coords)
+		: base_type_( coords( 0), coords( 1), coords( 2), unit_traits_type::one()) { }
+
+	/// \brief It creates a vertex owning its coordinates, from the homogenous coordinates internal representation.
+	const_vertex_view( const coord_vector& coords)
+		: base_type_( coords( 0), coords( 1), coords( 2), coords( 3)) { }
+
+	/// \brief It creates a read only view of the coordinates referred by a writable view.
+	const_vertex_view( const vertex_view< CS, COMPONENTS>& source)
+		: base_type_( source.data())
+	{
+		if( source.owns_coordinates())
+		{
+			this->rebind_( my_type_( source.coordinates()));
+		}
+	}
+
+	/// \brief It makes the view refer the coordinates referred by the source.
+	my_type_& operator=( const my_type_& source)
+	{
+		this->rebind_( source);
+		return *this;
+	}
+
+	/// \brief It gets the result of applying the given transformation, as a vertex owning its coordinates.
+	template< typename T>
+	BOOST_CONCEPT_REQUIRES( ((Transformation<T>)), (my_type_))
+		transformed( const T& tr) const
+	{
+		return my_type_( tr.transformed( this->coordinates()));
+	}
+};
+
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It gives the types used by the strided iterators for the given view type.
+/// \details The const vertex_view types give read only access, as the const_vertex_view types.
+template< typename V>
+struct view_traits;
+
+template< typename CS, unsigned COMPONENTS>
+struct view_traits< vertex_view< CS, COMPONENTS> >
+{
+	typedef vertex< CS> value_type;
+	typedef vertex_view< CS, COMPONENTS> reference;
+	typedef typename CS::unit_type unit_type;
+	typedef unit_type* unit_pointer;
+	typedef char* byte_pointer;
+	enum { COMPONENT_COUNT = COMPONENTS };
+};
+
+template< typename CS, unsigned COMPONENTS>
+struct view_traits< const_vertex_view< CS, COMPONENTS> >
+{
+	typedef vertex< CS> value_type;
+	typedef const_vertex_view< CS, COMPONENTS> reference;
+	typedef typename CS::unit_type unit_type;
+	typedef const unit_type* unit_pointer;
+	typedef const char* byte_pointer;
+	enum { COMPONENT_COUNT = COMPONENTS };
+};
+
+template< typename CS, unsigned COMPONENTS>
+struct view_traits< const vertex_view< CS, COMPONENTS> >: view_traits< const_vertex_view< CS, COMPONENTS> > {};
+
+template< typename CS, unsigned COMPONENTS>
+struct view_traits< const const_vertex_view< CS, COMPONENTS> >: view_traits< const_vertex_view< CS, COMPONENTS> > {};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It iterates a buffer of interleaved vertex coordinates, giving vertex views of its elements.
+/// \tparam V the vertex view type. The const_vertex_view and the const vertex_view types give read only access to the
+///		buffer.
+/// \details
+///		The distance between two consecutive elements is given in bytes, so the buffer may hold other attributes
+///		(e.g. colors or normals) between the coordinates. The coordinates have to be properly aligned.
+///
+///		The iterator dereferences to a view (its reference type), while its value type is the vertex class, so the
+///		standard algorithms keeping elements aside (e.g. std::sort) keep copies of the coordinates, not views of the
+///		places they are about to overwrite.
+template< typename V>
+class strided_iterator: public std::iterator< std::random_access_iterator_tag,
+	typename impl::view_traits< V>::value_type, std::ptrdiff_t, void, typename impl::view_traits< V>::reference>
+{
+	typedef impl::view_traits< V> traits_;
+	typedef typename traits_::byte_pointer byte_pointer_;
+public:
+	typedef typename traits_::reference reference;
+	typedef typename traits_::unit_type unit_type;
+	typedef typename traits_::unit_pointer unit_pointer;
+
+	strided_iterator()
+		: data_( NULL)
+		, stride_( 0) { }
+
+	strided_iterator( unit_pointer data, std::ptrdiff_t stride)
+		: data_( reinterpret_cast< byte_pointer_>( data))
+		, stride_( stride) { }
+
+	reference operator*() const { return reference( reinterpret_cast< unit_pointer>( data_)); }
+	reference operator[]( std::ptrdiff_t n) const
+	{
+		return reference( reinterpret_cast< unit_pointer>( data_ + n*stride_));
+	}
+
+	strided_iterator& operator++() { data_ += stride_; return *this; }
+	strided_iterator& operator--() { data_ -= stride_; return *this; }
+	strided_iterator operator++( int) { strided_iterator result( *this); data_ += stride_; return result; }
+	strided_iterator operator--( int) { strided_iterator result( *this); data_ -= stride_; return result; }
+	strided_iterator& operator+=( std::ptrdiff_t n) { data_ += n*stride_; return *this; }
+	strided_iterator& operator-=( std::ptrdiff_t n) { data_ -= n*stride_; return *this; }
+	strided_iterator operator+( std::ptrdiff_t n) const { strided_iterator result( *this); return result += n; }
+	strided_iterator operator-( std::ptrdiff_t n) const { strided_iterator result( *this); return result -= n; }
+	std::ptrdiff_t operator-( const strided_iterator& other) const { return (data_ - other.data_) / stride_; }
+
+	bool operator==( const strided_iterator& other) const { return data_ == other.data_; }
+	bool operator!=( const strided_iterator& other) const { return data_ != other.data_; }
+	bool operator<( const strided_iterator& other) const { return data_ < other.data_; }
+	bool operator>( const strided_iterator& other) const { return data_ > other.data_; }
+	bool operator<=( const strided_iterator& other) const { return data_ <= other.data_; }
+	bool operator>=( const strided_iterator& other) const { return data_ >= other.data_; }
+
+private:
+	byte_pointer_ data_;
+	std::ptrdiff_t stride_;
+};
+
+/// \ingroup geometry
+/// \brief It gives access to a buffer of interleaved vertex coordinates, as a sequence of vertex views.
+/// \tparam V the vertex view type (e.g. <c>vertex_view< CS, 3></c> for a <c>float[3]</c> buffer). The
+///		const_vertex_view and the const vertex_view types give read only access to the buffer.
+/// \details
+///		The buffer is not copied and stays owned by the caller; it has to live as long as the range and the views
+///		obtained from it.
+template< typename V>
+class strided_range
+{
+public:
+	typedef strided_iterator< V> iterator;
+	typedef iterator const_iterator;
+	typedef typename iterator::reference reference;
+	typedef typename iterator::unit_type unit_type;
+	typedef typename iterator::unit_pointer unit_pointer;
+
+	/// \brief It creates the range.
+	/// \param data the address of the first coordinate of the first element.
+	/// \param count the number of elements.
+	/// \param stride the distance between two consecutive elements, in bytes. By default, the coordinates are packed.
+	strided_range( unit_pointer data, std::size_t count,
+		std::ptrdiff_t stride = impl::view_traits< V>::COMPONENT_COUNT * sizeof( unit_type))
+		: begin_( data, stride)
+		, count_( count) { }
+
+	iterator begin() const { return begin_; }
+	iterator end() const { return begin_ + std::ptrdiff_t( count_); }
+	std::size_t size() const { return count_; }
+	bool empty() const { return count_ == 0; }
+	reference operator[]( std::size_t index) const { return begin_[std::ptrdiff_t( index)]; }
+
+private:
+	iterator begin_;
+	std::size_t count_;
+};
+
+
+namespace impl
+{
+
+/// \brief It specializes the vertex type checking for the vertex view classes.
+/// \sa is_vertex< typename V, unsigned D, typename CSID>
+/// \{
+template< typename CS, unsigned COMPONENTS, unsigned D, typename CSID>
+struct is_vertex< vertex_view< CS, COMPONENTS>, D, CSID >
+{
+	BOOST_STATIC_CONSTANT( bool,
+		value = (
+			(CS::DIMENSIONS == D || D == 0)
+			&& (
+				boost::is_same< typename CS::system_type, CSID>::value
+				||
+				boost::is_same< CSID, void>::value))
+		);
+};
+
+template< typename CS, unsigned COMPONENTS, unsigned D, typename CSID>
+struct is_vertex< const_vertex_view< CS, COMPONENTS>, D, CSID >: is_vertex< vertex_view< CS, COMPONENTS>, D, CSID>
+{
+};
+/// \}
+
+} // namespace impl
+
+} // namespace geometry
+
+#endif // GEOMETRY_HOMOGENOUS_VERTEX_VIEW_HPP
@@ -0,0 +1,421 @@
+#ifndef GEOMETRY_IO_BINARY_FILE_HPP
+#define GEOMETRY_IO_BINARY_FILE_HPP
+
+#include "geometry/homogenous/hcoord_system_concept.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/line.hpp"
+#include "geometry/plane.hpp"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/exceptions.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief The kinds of geometric objects stored in the binary files.
+enum binary_section_kind
+{
+	VERTEX_SECTION = 1,
+	DIRECTION_SECTION = 2,
+	LINE_SECTION = 3,
+	PLANE_SECTION = 4
+};
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It describes how a geometric object type is stored in the binary files.
+/// \details
+///		The objects are stored with their memory representation, so they can be used directly from the mapped file.
+///		The specializations check at compile time that the representation is made only of the expected number of units,
+///		without padding.
+template< typename T>
+struct binary_record;
+
+template< typename CS>
+struct binary_record< vertex< CS> >
+{
+	enum { KIND = VERTEX_SECTION, UNITS = CS::DIMENSIONS + 1 };
+	typedef typename CS::unit_type unit_type;
+	BOOST_STATIC_ASSERT( sizeof( vertex< CS>) == UNITS * sizeof( unit_type));
+};
+
+template< typename CS>
+struct binary_record< direction< CS> >
+{
+	enum { KIND = DIRECTION_SECTION, UNITS = CS::DIMENSIONS };
+	typedef typename CS::unit_type unit_type;
+	BOOST_STATIC_ASSERT( sizeof( direction< CS>) == UNITS * sizeof( unit_type));
+};
+
+template< typename CS>
+struct binary_record< line< CS> >
+{
+	enum { KIND = LINE_SECTION, UNITS = 2 * CS::DIMENSIONS + 1 };
+	typedef typename CS::unit_type unit_type;
+	BOOST_STATIC_ASSERT( sizeof( line< CS>) == UNITS * sizeof( unit_type));
+};
+
+template< typename CS>
+struct binary_record< plane< CS> >
+{
+	enum { KIND = PLANE_SECTION, UNITS = 4 };
+	typedef typename CS::unit_type unit_type;
+	BOOST_STATIC_ASSERT( sizeof( plane< CS>) == UNITS * sizeof( unit_type));
+};
+
+/// \ingroup geometry
+/// \brief The header at the beginning of a binary file.
+struct binary_file_header
+{
+	char magic[8];
+	boost::uint32_t version;
+	boost::uint32_t byte_order;
+	boost::uint32_t sections;
+	boost::uint32_t reserved;
+	boost::uint64_t section_table;
+	boost::uint8_t padding[32];
+};
+
+/// \ingroup geometry
+/// \brief The description of a section, in the table at the end of a binary file.
+struct binary_section_entry
+{
+	boost::uint32_t kind;
+	boost::uint32_t unit_size;
+	boost::uint32_t dimensions;
+	boost::uint32_t record_size;
+	boost::uint64_t count;
+	boost::uint64_t offset;
+};
+
+/// \ingroup geometry
+/// \brief The constants of the binary format.
+struct binary_format
+{
+	enum
+	{
+		VERSION = 1,
+		/// \brief The value of byte_order read on a little endian machine.
+		BYTE_ORDER_MARK = 0x01020304,
+		/// \brief The alignment of the sections, large enough for the vector instructions and for the cache lines.
+		ALIGNMENT = 64
+	};
+
+	static const char* magic() { return "MGEOBIN"; }
+
+	static bool is_little_endian()
+	{
+		const boost::uint32_t value = 1;
+		return *reinterpret_cast< const unsigned char*>( &value) == 1;
+	}
+};
+
+BOOST_STATIC_ASSERT( sizeof( binary_file_header) == 64);
+BOOST_STATIC_ASSERT( sizeof( binary_section_entry) == 32);
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It writes collections of geometric objects in the native binary format.
+/// \details
+///		The file starts with a header, followed by the sections, each one holding an array of objects of the same type
+///		(vertices, directions, lines or planes of a three dimensional homogenous coordinate system, with float or
+///		double units). The sections are aligned to 64 bytes. The table describing the sections is written at the end,
+///		by close(), so the number of sections doesn't have to be known in advance.
+///
+///		All the values are little endian. The objects are written with their memory representation, so the writer is
+///		available only on little endian machines.
+class binary_file_writer
+{
+public:
+	/// \brief It creates the file, overwriting an existing one.
+	explicit binary_file_writer( const char* path)
+		: stream_( path, std::ios::out | std::ios::binary | std::ios::trunc)
+		, closed_( false)
+	{
+		if( !impl::binary_format::is_little_endian())
+		{
+			stream_.setstate( std::ios::failbit);
+		}
+		impl::binary_file_header header;
+		std::memset( &header, 0, sizeof( header));
+		stream_.write( reinterpret_cast< const char*>( &header), sizeof( header));
+	}
+
+	/// \brief It closes the file, if close() was not called.
+	~binary_file_writer()
+	{
+		this->close();
+	}
+
+	/// \brief It checks whether all the operations succeeded so far.
+	bool good() const { return !stream_.fail(); }
+
+	/// \brief It writes a section with the given objects.
+	/// \tparam T the type of the objects: vertex, direction, line or plane of a 3D homogenous coordinate system.
+	/// \return the index of the section in the file.
+	template< typename T>
+	std::size_t write( const T* objects, std::size_t count)
+	{
+		typedef impl::binary_record< T> record;
+		this->align_();
+		impl::binary_section_entry entry;
+		entry.kind = record::KIND;
+		entry.unit_size = sizeof( typename record::unit_type);
+		entry.dimensions = T::coord_system::DIMENSIONS;
+		entry.record_size = sizeof( T);
+		entry.count = count;
+		entry.offset = static_cast< boost::uint64_t>( stream_.tellp());
+		if( count > 0)
+		{
+			stream_.write( reinterpret_cast< const char*>( objects), std::streamsize( count * sizeof( T)));
+		}
+		sections_.push_back( entry);
+		return sections_.size() - 1;
+	}
+
+	/// \brief It writes a section with the objects of a vector.
+	template< typename T>
+	std::size_t write( const std::vector< T>& objects)
+	{
+		return this->write( objects.empty() ? static_cast< const T*>( NULL) : &objects[0], objects.size());
+	}
+
+	/// \brief It writes the section table and the header, then closes the file.
+	/// \return true if the file was written successfully.
+	bool close()
+	{
+		if( closed_)
+		{
+			return this->good();
+		}
+		closed_ = true;
+		this->align_();
+		impl::binary_file_header header;
+		std::memset( &header, 0, sizeof( header));
+		std::memcpy( header.magic, impl::binary_format::magic(), 8);
+		header.version = impl::binary_format::VERSION;
+		header.byte_order = impl::binary_format::BYTE_ORDER_MARK;
+		header.sections = static_cast< boost::uint32_t>( sections_.size());
+		header.section_table = static_cast< boost::uint64_t>( stream_.tellp());
+		if( !sections_.empty())
+		{
+			stream_.write( reinterpret_cast< const char*>( &sections_[0]),
+				std::streamsize( sections_.size() * sizeof( impl::binary_section_entry)));
+		}
+		stream_.seekp( 0);
+		stream_.write( reinterpret_cast< const char*>( &header), sizeof( header));
+		stream_.close();
+		return this->good();
+	}
+
+private:
+	void align_()
+	{
+		static const char zeros[impl::binary_format::ALIGNMENT] = { 0 };
+		const std::size_t position = static_cast< std::size_t>( stream_.tellp());
+		const std::size_t misalignment = position % impl::binary_format::ALIGNMENT;
+		if( misalignment != 0)
+		{
+			stream_.write( zeros, std::streamsize( impl::binary_format::ALIGNMENT - misalignment));
+		}
+	}
+
+	std::ofstream stream_;
+	std::vector< impl::binary_section_entry> sections_;
+	bool closed_;
+};
+
+/// \ingroup geometry
+/// \brief It gives read only access to an array of geometric objects stored in a mapped binary file.
+/// \tparam T the type of the objects.
+/// \details
+///		The objects are not copied: the view points in the mapped file, which stays mapped as long as there are views
+///		referring it. An invalid view is empty.
+template< typename T>
+class mapped_array
+{
+public:
+	typedef T value_type;
+	typedef const T* const_iterator;
+
+	/// \brief It creates an empty view.
+	mapped_array()
+		: begin_( NULL)
+		, size_( 0)
+	{
+	}
+
+	mapped_array( const boost::shared_ptr< boost::interprocess::mapped_region>& region, const T* begin,
+		std::size_t size)
+		: region_( region)
+		, begin_( begin)
+		, size_( size)
+	{
+	}
+
+	std::size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	const_iterator begin() const { return begin_; }
+	const_iterator end() const { return begin_ + size_; }
+	const T& operator[]( std::size_t index) const { return begin_[index]; }
+
+private:
+	boost::shared_ptr< boost::interprocess::mapped_region> region_;
+	const T* begin_;
+	std::size_t size_;
+};
+
+/// \ingroup geometry
+/// \brief It maps a file written by binary_file_writer and gives access to its sections without copying them.
+/// \details
+///		Opening the file reads only the header and the section table, so it takes the same time for any file size; the
+///		pages of the sections are loaded by the operating system when they are accessed.
+class binary_file
+{
+public:
+	/// \brief It creates a closed file.
+	binary_file() {}
+
+	/// \brief It maps the given file.
+	explicit binary_file( const char* path)
+	{
+		this->open( path);
+	}
+
+	/// \brief It maps the given file, after closing the current one.
+	/// \return false if the file cannot be mapped or if it is not a valid binary file of this version.
+	bool open( const char* path)
+	{
+		this->close();
+		if( !impl::binary_format::is_little_endian())
+		{
+			return false;
+		}
+		try
+		{
+			boost::interprocess::file_mapping mapping( path, boost::interprocess::read_only);
+			region_.reset( new boost::interprocess::mapped_region( mapping, boost::interprocess::read_only));
+		}
+		catch( const boost::interprocess::interprocess_exception&)
+		{
+			region_.reset();
+			return false;
+		}
+		if( !this->read_table_())
+		{
+			this->close();
+			return false;
+		}
+		return true;
+	}
+
+	/// \brief It unmaps the file. The views already created remain valid.
+	void close()
+	{
+		region_.reset();
+		sections_.clear();
+	}
+
+	bool is_open() const { return region_.get() != NULL; }
+
+	/// \brief It gets the number of sections.
+	std::size_t sections() const { return sections_.size(); }
+
+	/// \brief It gets the kind of objects stored in the given section.
+	binary_section_kind kind( std::size_t section) const
+	{
+		return static_cast< binary_section_kind>( sections_[section].kind);
+	}
+
+	/// \brief It gets the number of objects stored in the given section.
+	std::size_t count( std::size_t section) const { return static_cast< std::size_t>( sections_[section].count); }
+
+	/// \brief It checks whether the given section stores objects of the given type.
+	template< typename T>
+	bool holds( std::size_t section) const
+	{
+		typedef impl::binary_record< T> record;
+		if( section >= sections_.size())
+		{
+			return false;
+		}
+		const impl::binary_section_entry& entry = sections_[section];
+		return entry.kind == boost::uint32_t( record::KIND)
+			&& entry.unit_size == sizeof( typename record::unit_type)
+			&& entry.dimensions == boost::uint32_t( T::coord_system::DIMENSIONS)
+			&& entry.record_size == sizeof( T);
+	}
+
+	/// \brief It gets the view of the objects stored in the given section.
+	/// \tparam T the type of the objects.
+	/// \return the view of the objects, or an empty view if the section doesn't hold objects of the given type.
+	template< typename T>
+	mapped_array< T> view( std::size_t section) const
+	{
+		if( !this->holds< T>( section))
+		{
+			return mapped_array< T>();
+		}
+		const char* base = static_cast< const char*>( region_->get_address());
+		return mapped_array< T>( region_, reinterpret_cast< const T*>( base + sections_[section].offset),
+			static_cast< std::size_t>( sections_[section].count));
+	}
+
+private:
+	bool read_table_()
+	{
+		const std::size_t size = region_->get_size();
+		const char* base = static_cast< const char*>( region_->get_address());
+		if( size < sizeof( impl::binary_file_header))
+		{
+			return false;
+		}
+		impl::binary_file_header header;
+		std::memcpy( &header, base, sizeof( header));
+		if( std::memcmp( header.magic, impl::binary_format::magic(), 8) != 0
+			|| header.version != impl::binary_format::VERSION
+			|| header.byte_order != impl::binary_format::BYTE_ORDER_MARK
+			|| header.section_table > size
+			|| (size - header.section_table) / sizeof( impl::binary_section_entry) < header.sections)
+		{
+			return false;
+		}
+		sections_.resize( header.sections);
+		if( header.sections > 0)
+		{
+			std::memcpy( &sections_[0], base + header.section_table,
+				header.sections * sizeof( impl::binary_section_entry));
+		}
+		for( std::size_t i = 0; i < sections_.size(); ++i)
+		{
+			const impl::binary_section_entry& entry = sections_[i];
+			if( entry.offset % impl::binary_format::ALIGNMENT != 0
+				|| entry.offset > size
+				|| entry.record_size == 0
+				|| (size - entry.offset) / entry.record_size < entry.count)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	boost::shared_ptr< boost::interprocess::mapped_region> region_;
+	std::vector< impl::binary_section_entry> sections_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_BINARY_FILE_HPP
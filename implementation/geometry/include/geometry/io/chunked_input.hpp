@@ -0,0 +1,464 @@
+#ifndef GEOMETRY_IO_CHUNKED_INPUT_HPP
+#define GEOMETRY_IO_CHUNKED_INPUT_HPP
+
+#include "parallel/bounded_queue.hpp"
+#include <boost/cstdint.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <cstddef>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It reads a file sequentially, a background thread reading the following blocks ahead.
+/// \details
+///		The I/O thread reads blocks of BLOCK_SIZE bytes and queues them, up to DEPTH blocks ahead of the consumer, so
+///		the decoding of a block overlaps with the reading of the next ones and the disk gets a continuous stream of
+///		large requests. The consumed blocks are reused.
+class read_ahead_file
+{
+	struct block_
+	{
+		block_(): data( BLOCK_SIZE), size( 0), last( false), failed( false) {}
+
+		std::vector< char> data;
+		std::size_t size;
+		/// \brief It is set for the block reaching the end of the file, or the read error.
+		bool last;
+		bool failed;
+	};
+	typedef boost::shared_ptr< block_> block_pointer_;
+	typedef parallel::bounded_queue< block_pointer_> queue_;
+
+public:
+	enum
+	{
+		/// \brief The size of the read requests.
+		BLOCK_SIZE = 1 << 18,
+		/// \brief The maximum number of blocks read ahead.
+		DEPTH = 4
+	};
+
+	read_ahead_file()
+		: file_( NULL)
+		, offset_( 0)
+		, failed_( false)
+	{
+	}
+
+	~read_ahead_file()
+	{
+		this->close();
+	}
+
+	/// \brief It opens the given file, after closing the current one, and starts reading it.
+	bool open( const char* path)
+	{
+		this->close();
+		file_ = std::fopen( path, "rb");
+		if( file_ == NULL)
+		{
+			return false;
+		}
+		ready_.reset( new queue_( DEPTH));
+		thread_.reset( new boost::thread( boost::bind( &read_ahead_file::run_, this)));
+		return true;
+	}
+
+	/// \brief It stops the I/O thread and closes the file.
+	void close()
+	{
+		if( thread_)
+		{
+			ready_->cancel();
+			thread_->join();
+			thread_.reset();
+		}
+		if( file_ != NULL)
+		{
+			std::fclose( file_);
+			file_ = NULL;
+		}
+		current_.reset();
+		offset_ = 0;
+		failed_ = false;
+	}
+
+	bool is_open() const { return file_ != NULL; }
+
+	/// \brief It checks whether a read error occurred.
+	bool failed() const { return failed_; }
+
+	/// \brief It copies the next bytes of the file, waiting for the I/O thread if they were not read yet.
+	/// \return the number of copied bytes. It is smaller than the requested size only at the end of the file or after
+	///		a read error.
+	std::size_t read( char* destination, std::size_t size)
+	{
+		std::size_t copied = 0;
+		while( copied < size && file_ != NULL)
+		{
+			if( !current_ || offset_ == current_->size)
+			{
+				if( current_ && current_->last)
+				{
+					break;
+				}
+				this->recycle_( current_);
+				current_.reset();
+				offset_ = 0;
+				if( !ready_->pop( current_))
+				{
+					break;
+				}
+				failed_ = failed_ || current_->failed;
+				continue;
+			}
+			const std::size_t n = std::min( size - copied, current_->size - offset_);
+			std::memcpy( destination + copied, &current_->data[0] + offset_, n);
+			offset_ += n;
+			copied += n;
+		}
+		return copied;
+	}
+
+private:
+	void run_()
+	{
+		for( ;;)
+		{
+			block_pointer_ block = this->take_block_();
+			block->size = std::fread( &block->data[0], 1, BLOCK_SIZE, file_);
+			block->last = block->size < BLOCK_SIZE;
+			block->failed = block->last && std::ferror( file_) != 0;
+			if( !ready_->push( block) || block->last)
+			{
+				break;
+			}
+		}
+	}
+
+	block_pointer_ take_block_()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		if( free_.empty())
+		{
+			return block_pointer_( new block_());
+		}
+		block_pointer_ block = free_.back();
+		free_.pop_back();
+		return block;
+	}
+
+	void recycle_( const block_pointer_& block)
+	{
+		if( block)
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			free_.push_back( block);
+		}
+	}
+
+	std::FILE* file_;
+	boost::scoped_ptr< queue_> ready_;
+	boost::scoped_ptr< boost::thread> thread_;
+	/// \brief The block being consumed, and the position of the next byte in it.
+	block_pointer_ current_;
+	std::size_t offset_;
+	bool failed_;
+	/// \brief It protects the free blocks.
+	boost::mutex mutex_;
+	std::vector< block_pointer_> free_;
+
+	read_ahead_file( const read_ahead_file&);
+	read_ahead_file& operator=( const read_ahead_file&);
+};
+
+/// \ingroup geometry
+/// \brief It reads a file through a buffer of fixed size, as lines of text or as binary blocks.
+/// \details
+///		The memory used doesn't depend on the size of the file: the lines and the blocks are returned as pointers in the
+///		buffer, valid until the next read operation. A line or a block larger than the buffer is reported as a failure.
+///		The file is read ahead by a background thread (see read_ahead_file), so the parsing of the buffer overlaps
+///		with the reading of the following data.
+class chunked_input
+{
+public:
+	/// \brief The default size of the buffer.
+	enum { DEFAULT_CAPACITY = 1 << 20 };
+
+	explicit chunked_input( std::size_t capacity = DEFAULT_CAPACITY)
+		: buffer_( capacity)
+		, begin_( 0)
+		, end_( 0)
+		, eof_( false)
+		, failed_( false)
+	{
+	}
+
+	~chunked_input()
+	{
+		this->close();
+	}
+
+	/// \brief It opens the given file, after closing the current one.
+	bool open( const char* path)
+	{
+		this->close();
+		failed_ = !file_.open( path);
+		return !failed_;
+	}
+
+	void close()
+	{
+		file_.close();
+		begin_ = end_ = 0;
+		eof_ = false;
+		failed_ = false;
+	}
+
+	bool is_open() const { return file_.is_open(); }
+
+	/// \brief It checks whether a read error occurred, or a line or a block didn't fit the buffer.
+	bool failed() const { return failed_; }
+
+	/// \brief It gets the next line, without the line terminator (LF or CR LF).
+	/// \param[out] begin the beginning of the line.
+	/// \param[out] end the end of the line.
+	/// \return false at the end of the file or at failure.
+	bool next_line( const char*& begin, const char*& end)
+	{
+		std::size_t searched = begin_;
+		for( ;;)
+		{
+			const char* data = &buffer_[0];
+			const void* found = std::memchr( data + searched, '\n', end_ - searched);
+			if( found != NULL)
+			{
+				begin = data + begin_;
+				end = static_cast< const char*>( found);
+				begin_ = end - data + 1;
+				break;
+			}
+			if( eof_ || failed_)
+			{
+				if( begin_ == end_)
+				{
+					return false;
+				}
+				// The last line, without terminator.
+				begin = data + begin_;
+				end = data + end_;
+				begin_ = end_;
+				break;
+			}
+			searched = end_ - begin_;
+			if( !this->fill_())
+			{
+				return false;
+			}
+		}
+		if( end != begin && *(end - 1) == '\r')
+		{
+			--end;
+		}
+		return true;
+	}
+
+	/// \brief It gets the next block of the given size.
+	/// \return the beginning of the block, or NULL if the file ends before the block.
+	const char* take( std::size_t size)
+	{
+		while( end_ - begin_ < size)
+		{
+			if( eof_ || failed_ || !this->fill_())
+			{
+				return NULL;
+			}
+		}
+		const char* result = &buffer_[0] + begin_;
+		begin_ += size;
+		return result;
+	}
+
+private:
+	/// \brief It moves the unread data at the beginning of the buffer, then fills the rest of the buffer from the file.
+	bool fill_()
+	{
+		if( !file_.is_open())
+		{
+			failed_ = true;
+			return false;
+		}
+		if( begin_ > 0)
+		{
+			std::memmove( &buffer_[0], &buffer_[0] + begin_, end_ - begin_);
+			end_ -= begin_;
+			begin_ = 0;
+		}
+		if( end_ == buffer_.size())
+		{
+			failed_ = true;
+			return false;
+		}
+		const std::size_t read = file_.read( &buffer_[0] + end_, buffer_.size() - end_);
+		end_ += read;
+		if( read == 0)
+		{
+			failed_ = file_.failed();
+			eof_ = !failed_;
+		}
+		return true;
+	}
+
+	read_ahead_file file_;
+	std::vector< char> buffer_;
+	std::size_t begin_;
+	std::size_t end_;
+	bool eof_;
+	bool failed_;
+};
+
+/// \ingroup geometry
+/// \brief It skips the spaces, tabs and commas separating the values of a text line.
+inline const char* skip_separators( const char* current, const char* end)
+{
+	while( current != end && (*current == ' ' || *current == '\t' || *current == ','))
+	{
+		++current;
+	}
+	return current;
+}
+
+/// \ingroup geometry
+/// \brief It parses a decimal number, after skipping the separators.
+/// \param[in,out] current the position in the text. On success, it is moved after the number.
+/// \param end the end of the text.
+/// \param[out] value the parsed value.
+/// \return false if there is no number at the current position.
+/// \details
+///		The parser doesn't depend on the locale and doesn't need a terminated string. The first 19 significant digits
+///		are accumulated in an integer; when it fits 53 bits and the decimal exponent is at most 22 in absolute value,
+///		the result is obtained with one exact multiplication or division, so it is correctly rounded. This covers the
+///		values written by the usual scanning and modelling tools; for other values, the result may differ from the
+///		correctly rounded one by one unit in the last place.
+inline bool parse_number( const char*& current, const char* end, double& value)
+{
+	static const double EXACT_POWERS[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+		1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	const boost::uint64_t MAX_EXACT_MANTISSA = boost::uint64_t( 1) << 53;
+
+	const char* p = skip_separators( current, end);
+	bool negative = false;
+	if( p != end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		++p;
+	}
+
+	boost::uint64_t mantissa = 0;
+	int digits = 0, exponent = 0;
+	bool has_digits = false;
+	for( ; p != end && *p >= '0' && *p <= '9'; ++p)
+	{
+		has_digits = true;
+		if( digits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			digits += mantissa != 0;
+		}
+		else
+		{
+			++exponent;
+		}
+	}
+	if( p != end && *p == '.')
+	{
+		for( ++p; p != end && *p >= '0' && *p <= '9'; ++p)
+		{
+			has_digits = true;
+			if( digits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				digits += mantissa != 0;
+				--exponent;
+			}
+		}
+	}
+	if( !has_digits)
+	{
+		return false;
+	}
+	if( p != end && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool negative_exponent = false;
+		if( q != end && (*q == '-' || *q == '+'))
+		{
+			negative_exponent = *q == '-';
+			++q;
+		}
+		if( q != end && *q >= '0' && *q <= '9')
+		{
+			int written = 0;
+			for( ; q != end && *q >= '0' && *q <= '9'; ++q)
+			{
+				if( written < 10000)
+				{
+					written = written * 10 + (*q - '0');
+				}
+			}
+			exponent += negative_exponent ? -written : written;
+			p = q;
+		}
+	}
+
+	double result = double( mantissa);
+	if( mantissa != 0 && exponent != 0)
+	{
+		if( mantissa <= MAX_EXACT_MANTISSA && exponent > 0 && exponent <= 22)
+		{
+			result *= EXACT_POWERS[exponent];
+		}
+		else if( mantissa <= MAX_EXACT_MANTISSA && exponent < 0 && exponent >= -22)
+		{
+			result /= EXACT_POWERS[-exponent];
+		}
+		else if( exponent < -300)
+		{
+			// Two steps, to avoid the underflow of the power of ten for the values close to the smallest double.
+			result = result * std::pow( 10.0, exponent + 300) * 1e-300;
+		}
+		else
+		{
+			result *= std::pow( 10.0, exponent);
+		}
+	}
+	value = negative ? -result : result;
+	current = p;
+	return true;
+}
+
+/// \ingroup geometry
+/// \brief It checks whether the text contains only separators from the given position.
+inline bool at_line_end( const char* current, const char* end)
+{
+	return skip_separators( current, end) == end;
+}
+
+} // namespace impl
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_CHUNKED_INPUT_HPP
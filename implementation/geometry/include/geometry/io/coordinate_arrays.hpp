@@ -0,0 +1,52 @@
+#ifndef GEOMETRY_IO_COORDINATE_ARRAYS_HPP
+#define GEOMETRY_IO_COORDINATE_ARRAYS_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It stores the carthesian coordinates of 3D points as separate contiguous arrays (structure of arrays).
+/// \tparam U the type of the coordinates.
+/// \details
+///		This is the output of the point readers. The arrays can be used directly by the batched algorithms working on
+///		coordinate arrays (e.g. calculate_statistics), without building a vertex object for each point.
+template< typename U>
+struct coordinate_arrays
+{
+	typedef U unit_type;
+
+	std::vector< U> x;
+	std::vector< U> y;
+	std::vector< U> z;
+
+	std::size_t size() const { return x.size(); }
+	bool empty() const { return x.empty(); }
+
+	void clear()
+	{
+		x.clear();
+		y.clear();
+		z.clear();
+	}
+
+	void reserve( std::size_t count)
+	{
+		x.reserve( count);
+		y.reserve( count);
+		z.reserve( count);
+	}
+
+	void push_back( const U& px, const U& py, const U& pz)
+	{
+		x.push_back( px);
+		y.push_back( py);
+		z.push_back( pz);
+	}
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_COORDINATE_ARRAYS_HPP
@@ -0,0 +1,86 @@
+#ifndef GEOMETRY_IO_OBJ_READER_HPP
+#define GEOMETRY_IO_OBJ_READER_HPP
+
+#include "geometry/io/chunked_input.hpp"
+#include "geometry/io/coordinate_arrays.hpp"
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It reads the vertices of a Wavefront OBJ file, in chunks.
+/// \details
+///		Only the geometric vertices (the <c>v x y z [w]</c> lines) are read; the optional weight is ignored, as are the
+///		other statements (normals, texture coordinates, faces, groups, materials). The file is processed as described
+///		for xyz_reader.
+class obj_reader
+{
+public:
+	obj_reader()
+		: failed_( false)
+	{
+	}
+
+	explicit obj_reader( const char* path)
+	{
+		this->open( path);
+	}
+
+	/// \brief It opens the given file, after closing the current one.
+	bool open( const char* path)
+	{
+		failed_ = !input_.open( path);
+		return !failed_;
+	}
+
+	/// \brief It closes the file, stopping the reading ahead.
+	void close()
+	{
+		input_.close();
+		failed_ = false;
+	}
+
+	bool is_open() const { return input_.is_open(); }
+
+	/// \brief It checks whether the file couldn't be read or contains an invalid vertex statement.
+	bool failed() const { return failed_ || input_.failed(); }
+
+	/// \copydoc xyz_reader::read
+	template< typename U>
+	std::size_t read( coordinate_arrays< U>& points, std::size_t max_count)
+	{
+		std::size_t count = 0;
+		const char* begin;
+		const char* end;
+		while( count < max_count && !failed_ && input_.next_line( begin, end))
+		{
+			while( begin != end && (*begin == ' ' || *begin == '\t'))
+			{
+				++begin;
+			}
+			if( end - begin < 2 || begin[0] != 'v' || (begin[1] != ' ' && begin[1] != '\t'))
+			{
+				continue;
+			}
+			begin += 2;
+			double x, y, z;
+			if( !impl::parse_number( begin, end, x) || !impl::parse_number( begin, end, y)
+				|| !impl::parse_number( begin, end, z))
+			{
+				failed_ = true;
+				break;
+			}
+			points.push_back( U( x), U( y), U( z));
+			++count;
+		}
+		return count;
+	}
+
+private:
+	impl::chunked_input input_;
+	bool failed_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_OBJ_READER_HPP
@@ -0,0 +1,473 @@
+#ifndef GEOMETRY_IO_PLY_READER_HPP
+#define GEOMETRY_IO_PLY_READER_HPP
+
+#include "geometry/io/chunked_input.hpp"
+#include "geometry/io/coordinate_arrays.hpp"
+#include <boost/cstdint.hpp>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The scalar types of the PLY properties.
+enum ply_scalar
+{
+	PLY_INVALID,
+	PLY_INT8,
+	PLY_UINT8,
+	PLY_INT16,
+	PLY_UINT16,
+	PLY_INT32,
+	PLY_UINT32,
+	PLY_FLOAT32,
+	PLY_FLOAT64
+};
+
+/// \ingroup geometry
+/// \brief It gets the scalar type with the given name (both the old and the new names are accepted).
+inline ply_scalar ply_scalar_from_name( const std::string& name)
+{
+	static const char* const NAMES[][2] = {
+		{ "char", "int8" }, { "uchar", "uint8" }, { "short", "int16" }, { "ushort", "uint16" },
+		{ "int", "int32" }, { "uint", "uint32" }, { "float", "float32" }, { "double", "float64" } };
+	for( int i = 0; i < 8; ++i)
+	{
+		if( name == NAMES[i][0] || name == NAMES[i][1])
+		{
+			return static_cast< ply_scalar>( PLY_INT8 + i);
+		}
+	}
+	return PLY_INVALID;
+}
+
+/// \ingroup geometry
+/// \brief It gets the size in bytes of the given scalar type.
+inline std::size_t ply_scalar_size( ply_scalar type)
+{
+	static const std::size_t SIZES[] = { 0, 1, 1, 2, 2, 4, 4, 4, 8 };
+	return SIZES[type];
+}
+
+/// \ingroup geometry
+/// \brief It decodes a binary scalar value.
+/// \param data the bytes of the value.
+/// \param type the type of the value.
+/// \param swap whether the byte order of the value is different from the byte order of the machine.
+inline double decode_ply_scalar( const char* data, ply_scalar type, bool swap)
+{
+	char bytes[8];
+	const std::size_t size = ply_scalar_size( type);
+	std::memcpy( bytes, data, size);
+	if( swap)
+	{
+		std::reverse( bytes, bytes + size);
+	}
+	switch( type)
+	{
+	case PLY_INT8: { boost::int8_t v; std::memcpy( &v, bytes, 1); return v; }
+	case PLY_UINT8: { boost::uint8_t v; std::memcpy( &v, bytes, 1); return v; }
+	case PLY_INT16: { boost::int16_t v; std::memcpy( &v, bytes, 2); return v; }
+	case PLY_UINT16: { boost::uint16_t v; std::memcpy( &v, bytes, 2); return v; }
+	case PLY_INT32: { boost::int32_t v; std::memcpy( &v, bytes, 4); return v; }
+	case PLY_UINT32: { boost::uint32_t v; std::memcpy( &v, bytes, 4); return v; }
+	case PLY_FLOAT32: { float v; std::memcpy( &v, bytes, 4); return v; }
+	case PLY_FLOAT64: { double v; std::memcpy( &v, bytes, 8); return v; }
+	default: return 0;
+	}
+}
+
+/// \ingroup geometry
+/// \brief It checks whether the element count of a list property is valid: a non-negative integer not greater than
+///		the given limit. The NaN and the infinite counts are rejected.
+inline bool is_ply_list_count( double count, double limit)
+{
+	return count >= 0 && count <= limit && std::floor( count) == count;
+}
+
+/// \ingroup geometry
+/// \brief The description of a PLY property.
+struct ply_property
+{
+	std::string name;
+	ply_scalar type;
+	/// \brief The type of the element count, for the list properties; PLY_INVALID for the scalar properties.
+	ply_scalar count_type;
+};
+
+/// \ingroup geometry
+/// \brief The description of a PLY element.
+struct ply_element
+{
+	std::string name;
+	boost::uint64_t count;
+	std::vector< ply_property> properties;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It reads the vertices of a PLY file, in chunks.
+/// \details
+///		The ASCII, binary little endian and binary big endian encodings are supported. The X, Y and Z properties of the
+///		vertex element are read, with any scalar type; the other properties and the elements following the vertices
+///		(e.g. the faces) are ignored. The elements preceding the vertices are skipped record by record.
+///
+///		The binary records are decoded directly from the input buffer, so the memory used doesn't depend on the size
+///		of the file. The file is processed as described for xyz_reader.
+class ply_reader
+{
+public:
+	ply_reader()
+		: format_( ASCII)
+		, swap_( false)
+		, vertex_element_( 0)
+		, record_size_( 0)
+		, fixed_size_( false)
+		, remaining_( 0)
+		, failed_( false)
+	{
+		std::fill( coordinates_, coordinates_ + 3, std::size_t( 0));
+		std::fill( offsets_, offsets_ + 3, std::size_t( 0));
+	}
+
+	explicit ply_reader( const char* path)
+		: format_( ASCII)
+		, swap_( false)
+		, vertex_element_( 0)
+		, record_size_( 0)
+		, fixed_size_( false)
+		, remaining_( 0)
+		, failed_( false)
+	{
+		std::fill( coordinates_, coordinates_ + 3, std::size_t( 0));
+		std::fill( offsets_, offsets_ + 3, std::size_t( 0));
+		this->open( path);
+	}
+
+	/// \brief It opens the given file and reads its header, after closing the current one.
+	/// \return false if the file cannot be read, or it is not a valid PLY file with X, Y and Z vertex properties.
+	bool open( const char* path)
+	{
+		elements_.clear();
+		vertex_element_ = 0;
+		remaining_ = 0;
+		failed_ = !input_.open( path) || !this->read_header_() || !this->skip_to_vertices_();
+		return !failed_;
+	}
+
+	/// \brief It closes the file, stopping the reading ahead. The header of the file is forgotten.
+	void close()
+	{
+		input_.close();
+		elements_.clear();
+		vertex_element_ = 0;
+		remaining_ = 0;
+		failed_ = false;
+	}
+
+	bool is_open() const { return input_.is_open(); }
+
+	/// \brief It checks whether the file couldn't be read or it is not valid.
+	bool failed() const { return failed_ || input_.failed(); }
+
+	/// \brief It gets the number of vertices declared in the header.
+	boost::uint64_t vertex_count() const
+	{
+		return vertex_element_ < elements_.size() ? elements_[vertex_element_].count : 0;
+	}
+
+	/// \copydoc xyz_reader::read
+	template< typename U>
+	std::size_t read( coordinate_arrays< U>& points, std::size_t max_count)
+	{
+		std::size_t count = 0;
+		double record[3];
+		while( count < max_count && remaining_ > 0 && !failed_)
+		{
+			if( !this->read_vertex_( record))
+			{
+				failed_ = true;
+				break;
+			}
+			points.push_back( U( record[0]), U( record[1]), U( record[2]));
+			++count;
+			--remaining_;
+		}
+		return count;
+	}
+
+private:
+	enum format_type { ASCII, BINARY_LITTLE_ENDIAN, BINARY_BIG_ENDIAN };
+
+	bool read_header_()
+	{
+		const char* begin;
+		const char* end;
+		if( !input_.next_line( begin, end) || std::string( begin, end) != "ply")
+		{
+			return false;
+		}
+		bool has_format = false;
+		for( ;;)
+		{
+			if( !input_.next_line( begin, end))
+			{
+				return false;
+			}
+			std::istringstream line( std::string( begin, end));
+			std::string keyword;
+			line >> keyword;
+			if( keyword == "end_header")
+			{
+				break;
+			}
+			else if( keyword == "format")
+			{
+				std::string name;
+				line >> name;
+				if( name == "ascii") format_ = ASCII;
+				else if( name == "binary_little_endian") format_ = BINARY_LITTLE_ENDIAN;
+				else if( name == "binary_big_endian") format_ = BINARY_BIG_ENDIAN;
+				else return false;
+				has_format = true;
+			}
+			else if( keyword == "element")
+			{
+				impl::ply_element element;
+				if( !(line >> element.name >> element.count))
+				{
+					return false;
+				}
+				elements_.push_back( element);
+			}
+			else if( keyword == "property")
+			{
+				impl::ply_property property;
+				std::string type;
+				if( elements_.empty() || !(line >> type))
+				{
+					return false;
+				}
+				property.count_type = impl::PLY_INVALID;
+				if( type == "list")
+				{
+					std::string count_type;
+					line >> count_type >> type;
+					property.count_type = impl::ply_scalar_from_name( count_type);
+					if( property.count_type == impl::PLY_INVALID)
+					{
+						return false;
+					}
+				}
+				property.type = impl::ply_scalar_from_name( type);
+				if( property.type == impl::PLY_INVALID || !(line >> property.name))
+				{
+					return false;
+				}
+				elements_.back().properties.push_back( property);
+			}
+			// The comments and the obj_info lines are ignored.
+		}
+
+		const boost::uint32_t value = 1;
+		const bool little_endian = *reinterpret_cast< const unsigned char*>( &value) == 1;
+		swap_ = format_ != ASCII && (format_ == BINARY_LITTLE_ENDIAN) != little_endian;
+		return has_format && this->find_vertex_properties_();
+	}
+
+	bool find_vertex_properties_()
+	{
+		for( vertex_element_ = 0; vertex_element_ < elements_.size(); ++vertex_element_)
+		{
+			if( elements_[vertex_element_].name == "vertex")
+			{
+				break;
+			}
+		}
+		if( vertex_element_ == elements_.size())
+		{
+			return false;
+		}
+		const std::vector< impl::ply_property>& properties = elements_[vertex_element_].properties;
+		static const char* const NAMES[] = { "x", "y", "z" };
+		fixed_size_ = true;
+		record_size_ = 0;
+		for( int i = 0; i < 3; ++i)
+		{
+			coordinates_[i] = properties.size();
+		}
+		for( std::size_t p = 0; p < properties.size(); ++p)
+		{
+			for( int i = 0; i < 3; ++i)
+			{
+				if( properties[p].name == NAMES[i] && properties[p].count_type == impl::PLY_INVALID)
+				{
+					coordinates_[i] = p;
+					offsets_[i] = record_size_;
+				}
+			}
+			fixed_size_ = fixed_size_ && properties[p].count_type == impl::PLY_INVALID;
+			record_size_ += impl::ply_scalar_size( properties[p].type);
+		}
+		remaining_ = elements_[vertex_element_].count;
+		return coordinates_[0] < properties.size() && coordinates_[1] < properties.size()
+			&& coordinates_[2] < properties.size();
+	}
+
+	bool skip_to_vertices_()
+	{
+		for( std::size_t e = 0; e < vertex_element_; ++e)
+		{
+			for( boost::uint64_t i = 0; i < elements_[e].count; ++i)
+			{
+				if( !this->read_record_( elements_[e], NULL))
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool read_vertex_( double* coordinates)
+	{
+		if( format_ != ASCII && fixed_size_)
+		{
+			// The most common case: the vertex record has a fixed size, so the coordinates are at fixed offsets.
+			const char* data = input_.take( record_size_);
+			if( data == NULL)
+			{
+				return false;
+			}
+			const std::vector< impl::ply_property>& properties = elements_[vertex_element_].properties;
+			for( int i = 0; i < 3; ++i)
+			{
+				coordinates[i] = impl::decode_ply_scalar( data + offsets_[i], properties[coordinates_[i]].type, swap_);
+			}
+			return true;
+		}
+		return this->read_record_( elements_[vertex_element_], coordinates);
+	}
+
+	/// \brief It reads a record of the given element.
+	/// \param coordinates receives the vertex coordinates, if not NULL.
+	bool read_record_( const impl::ply_element& element, double* coordinates)
+	{
+		if( format_ == ASCII)
+		{
+			const char* begin;
+			const char* end;
+			if( !input_.next_line( begin, end))
+			{
+				return false;
+			}
+			for( std::size_t p = 0; p < element.properties.size(); ++p)
+			{
+				double value;
+				if( !impl::parse_number( begin, end, value))
+				{
+					return false;
+				}
+				if( element.properties[p].count_type != impl::PLY_INVALID)
+				{
+					// Each value takes at least one character and a separator.
+					if( !impl::is_ply_list_count( value, double( end - begin + 1) / 2))
+					{
+						return false;
+					}
+					for( boost::uint64_t n = boost::uint64_t( value); n > 0; --n)
+					{
+						if( !impl::parse_number( begin, end, value))
+						{
+							return false;
+						}
+					}
+				}
+				else if( coordinates != NULL)
+				{
+					this->store_coordinate_( p, value, coordinates);
+				}
+			}
+			return true;
+		}
+
+		for( std::size_t p = 0; p < element.properties.size(); ++p)
+		{
+			const impl::ply_property& property = element.properties[p];
+			const std::size_t size = impl::ply_scalar_size( property.type);
+			if( property.count_type != impl::PLY_INVALID)
+			{
+				const char* data = input_.take( impl::ply_scalar_size( property.count_type));
+				if( data == NULL)
+				{
+					return false;
+				}
+				const double count = impl::decode_ply_scalar( data, property.count_type, swap_);
+				if( !impl::is_ply_list_count( count, std::numeric_limits< boost::uint32_t>::max()))
+				{
+					return false;
+				}
+				const boost::uint64_t n = boost::uint64_t( count);
+				for( boost::uint64_t i = 0; i < n; ++i)
+				{
+					if( input_.take( size) == NULL)
+					{
+						return false;
+					}
+				}
+			}
+			else
+			{
+				const char* data = input_.take( size);
+				if( data == NULL)
+				{
+					return false;
+				}
+				if( coordinates != NULL)
+				{
+					this->store_coordinate_( p, impl::decode_ply_scalar( data, property.type, swap_), coordinates);
+				}
+			}
+		}
+		return true;
+	}
+
+	void store_coordinate_( std::size_t property, double value, double* coordinates) const
+	{
+		for( int i = 0; i < 3; ++i)
+		{
+			if( coordinates_[i] == property)
+			{
+				coordinates[i] = value;
+			}
+		}
+	}
+
+	impl::chunked_input input_;
+	std::vector< impl::ply_element> elements_;
+	format_type format_;
+	bool swap_;
+	std::size_t vertex_element_;
+	/// \brief The indices of the X, Y and Z properties of the vertex element.
+	std::size_t coordinates_[3];
+	/// \brief The offsets of the X, Y and Z properties in the vertex record, when it has a fixed size.
+	std::size_t offsets_[3];
+	std::size_t record_size_;
+	bool fixed_size_;
+	boost::uint64_t remaining_;
+	bool failed_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_PLY_READER_HPP
@@ -0,0 +1,62 @@
+#ifndef GEOMETRY_IO_POINT_BATCH_SOURCE_HPP
+#define GEOMETRY_IO_POINT_BATCH_SOURCE_HPP
+
+#include "geometry/io/coordinate_arrays.hpp"
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It reads the points of a file in batches of coordinate arrays, as the source of a parallel::pipeline.
+/// \tparam R the point reader type (xyz_reader, obj_reader or ply_reader).
+/// \tparam U the type of the coordinates.
+/// \details
+///		The reader reads the file ahead in a background thread, and the pipeline decodes the next batch while the
+///		following stages process the previous ones, so reading, decoding and processing overlap:
+///		\code
+///		xyz_reader reader( path);
+///		parallel::pipeline< coordinate_arrays< float> > p;
+///		p.source( point_batches< float>( reader, 1 << 16)).stage( transform_batch).sink( write_batch);
+///		if( !p.run() || reader.failed()) { ... }
+///		\endcode
+///		The stream of batches ends at the end of the file or at the first error; use the failed() method of the reader
+///		for telling them apart.
+template< typename R, typename U>
+class point_batch_source
+{
+public:
+	/// \param reader the opened reader. It has to live while the source is used.
+	/// \param batch_size the maximum number of points of a batch.
+	point_batch_source( R& reader, std::size_t batch_size)
+		: reader_( &reader)
+		, batch_size_( batch_size)
+	{
+	}
+
+	/// \brief It reads the next batch, replacing the points of the given one.
+	/// \return false if there are no more points.
+	bool operator()( coordinate_arrays< U>& batch) const
+	{
+		batch.clear();
+		batch.reserve( batch_size_);
+		return reader_->read( batch, batch_size_) > 0;
+	}
+
+private:
+	R* reader_;
+	std::size_t batch_size_;
+};
+
+/// \ingroup geometry
+/// \brief It creates a source of batches of points read by the given reader.
+/// \see point_batch_source
+template< typename U, typename R>
+point_batch_source< R, U> point_batches( R& reader, std::size_t batch_size)
+{
+	return point_batch_source< R, U>( reader, batch_size);
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_POINT_BATCH_SOURCE_HPP
@@ -0,0 +1,791 @@
+#ifndef GEOMETRY_IO_TILED_POINT_STORE_HPP
+#define GEOMETRY_IO_TILED_POINT_STORE_HPP
+
+#include "geometry/io/coordinate_arrays.hpp"
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <limits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief The header of the index file of a tiled point store.
+struct tiled_store_header
+{
+	char magic[8];
+	boost::uint32_t version;
+	boost::uint32_t byte_order;
+	boost::uint32_t unit_size;
+	boost::uint32_t tiles;
+};
+
+/// \ingroup geometry
+/// \brief The description of a tile, in the index file of a tiled point store.
+struct tiled_store_entry
+{
+	/// \brief The index of the grid cell; it gives the name of the tile file.
+	boost::uint64_t cell;
+	boost::uint64_t count;
+	double min[3];
+	double max[3];
+};
+
+BOOST_STATIC_ASSERT( sizeof( tiled_store_header) == 24);
+BOOST_STATIC_ASSERT( sizeof( tiled_store_entry) == 64);
+
+/// \ingroup geometry
+/// \brief The constants and the file names of the tiled point stores.
+struct tiled_store_format
+{
+	enum { VERSION = 1, BYTE_ORDER_MARK = 0x01020304 };
+
+	static const char* magic() { return "MGEOTIL"; }
+
+	static std::string index_path( const std::string& prefix) { return prefix + ".index"; }
+
+	static std::string tile_path( const std::string& prefix, boost::uint64_t cell)
+	{
+		std::ostringstream path;
+		path << prefix << "." << cell << ".tile";
+		return path.str();
+	}
+};
+
+/// \ingroup geometry
+/// \brief It writes the index file of a tiled point store.
+inline bool write_tiled_store_index( const std::string& prefix, std::size_t unit_size,
+	const std::vector< tiled_store_entry>& tiles)
+{
+	tiled_store_header header;
+	std::memset( &header, 0, sizeof( header));
+	std::memcpy( header.magic, tiled_store_format::magic(), 8);
+	header.version = tiled_store_format::VERSION;
+	header.byte_order = tiled_store_format::BYTE_ORDER_MARK;
+	header.unit_size = static_cast< boost::uint32_t>( unit_size);
+	header.tiles = static_cast< boost::uint32_t>( tiles.size());
+
+	std::FILE* file = std::fopen( tiled_store_format::index_path( prefix).c_str(), "wb");
+	if( file == NULL)
+	{
+		return false;
+	}
+	bool written = std::fwrite( &header, sizeof( header), 1, file) == 1;
+	if( written && !tiles.empty())
+	{
+		written = std::fwrite( &tiles[0], sizeof( tiles[0]), tiles.size(), file) == tiles.size();
+	}
+	return std::fclose( file) == 0 && written;
+}
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It creates a tiled point store, distributing the points in the cells of a regular 3D grid.
+/// \tparam U the type of the stored coordinates.
+/// \details
+///		The points of each cell are stored in a separate tile file, as interleaved coordinates; the index file describes
+///		the non empty tiles and their bounding boxes. The points are buffered in memory and appended to the tile files
+///		when the buffered number of points reaches the given limit, so the memory used doesn't depend on the size of
+///		the point cloud. The points outside the grid are stored in the nearest border cell; the points having a
+///		coordinate which is not a finite number are ignored.
+///
+///		The files use the byte order of the machine; a store can be read only on machines with the same byte order.
+template< typename U>
+class tiled_point_store_builder
+{
+public:
+	/// \brief It starts creating the store.
+	/// \param prefix the path prefix of the store files.
+	/// \param min the minimum corner of the grid.
+	/// \param max the maximum corner of the grid.
+	/// \param cells the number of cells of the grid, on each axis.
+	/// \param buffer_limit the maximum number of points kept in memory.
+	tiled_point_store_builder( const char* prefix, const U min[3], const U max[3], const unsigned cells[3],
+		std::size_t buffer_limit = 1 << 20)
+		: prefix_( prefix)
+		, buffered_( 0)
+		, buffer_limit_( buffer_limit)
+		, ignored_( 0)
+		, failed_( false)
+		, closed_( false)
+	{
+		std::size_t cell_count = 1;
+		for( int i = 0; i < 3; ++i)
+		{
+			min_[i] = min[i];
+			cells_[i] = std::max( cells[i], 1U);
+			cell_size_[i] = (double( max[i]) - double( min[i])) / cells_[i];
+			if( !(cell_size_[i] > 0))
+			{
+				cell_size_[i] = 1;
+			}
+			cell_count *= cells_[i];
+		}
+		buffers_.resize( cell_count);
+		entries_.resize( cell_count);
+		for( std::size_t c = 0; c < cell_count; ++c)
+		{
+			entries_[c].cell = c;
+			entries_[c].count = 0;
+		}
+	}
+
+	~tiled_point_store_builder()
+	{
+		this->close();
+	}
+
+	/// \brief It checks whether all the operations succeeded so far.
+	bool good() const { return !failed_; }
+
+	/// \brief It gets the number of points ignored because of their NaN or infinite coordinates.
+	std::size_t ignored() const { return ignored_; }
+
+	/// \brief It adds a point to the store. The point is ignored if a coordinate is NaN or infinite.
+	void add( const U& x, const U& y, const U& z)
+	{
+		const U coordinates[3] = { x, y, z };
+		for( int i = 0; i < 3; ++i)
+		{
+			// It also rejects NaN, so the cell index below is always converted from a value in the grid range.
+			if( !(std::abs( double( coordinates[i])) <= std::numeric_limits< double>::max()))
+			{
+				++ignored_;
+				return;
+			}
+		}
+		std::size_t cell = 0;
+		for( int i = 2; i >= 0; --i)
+		{
+			const double position = (double( coordinates[i]) - min_[i]) / cell_size_[i];
+			const unsigned index = position <= 0 ? 0U
+				: position >= cells_[i] ? cells_[i] - 1 : static_cast< unsigned>( position);
+			cell = cell * cells_[i] + index;
+		}
+
+		impl::tiled_store_entry& entry = entries_[cell];
+		for( int i = 0; i < 3; ++i)
+		{
+			if( entry.count == 0 || coordinates[i] < entry.min[i]) entry.min[i] = coordinates[i];
+			if( entry.count == 0 || coordinates[i] > entry.max[i]) entry.max[i] = coordinates[i];
+		}
+		++entry.count;
+		buffers_[cell].insert( buffers_[cell].end(), coordinates, coordinates + 3);
+		if( ++buffered_ >= buffer_limit_)
+		{
+			this->flush_();
+		}
+	}
+
+	/// \brief It adds the given points to the store.
+	template< typename V>
+	void add( const coordinate_arrays< V>& points)
+	{
+		for( std::size_t i = 0; i < points.size(); ++i)
+		{
+			this->add( U( points.x[i]), U( points.y[i]), U( points.z[i]));
+		}
+	}
+
+	/// \brief It writes the buffered points and the index file.
+	/// \return true if the store was written successfully.
+	bool close()
+	{
+		if( closed_)
+		{
+			return !failed_;
+		}
+		closed_ = true;
+		this->flush_();
+
+		std::vector< impl::tiled_store_entry> tiles;
+		for( std::size_t c = 0; c < entries_.size(); ++c)
+		{
+			if( entries_[c].count > 0)
+			{
+				tiles.push_back( entries_[c]);
+			}
+		}
+		failed_ = !impl::write_tiled_store_index( prefix_, sizeof( U), tiles) || failed_;
+		return !failed_;
+	}
+
+private:
+	void flush_()
+	{
+		for( std::size_t c = 0; c < buffers_.size(); ++c)
+		{
+			std::vector< U>& buffer = buffers_[c];
+			if( buffer.empty())
+			{
+				continue;
+			}
+			std::FILE* file = std::fopen( impl::tiled_store_format::tile_path( prefix_, c).c_str(),
+				entries_[c].count * 3 == buffer.size() ? "wb" : "ab");
+			if( file == NULL || std::fwrite( &buffer[0], sizeof( U), buffer.size(), file) != buffer.size())
+			{
+				failed_ = true;
+			}
+			if( file != NULL && std::fclose( file) != 0)
+			{
+				failed_ = true;
+			}
+			std::vector< U>().swap( buffer);
+		}
+		buffered_ = 0;
+	}
+
+	std::string prefix_;
+	double min_[3];
+	double cell_size_[3];
+	unsigned cells_[3];
+	/// \brief The interleaved coordinates of the buffered points, for each cell.
+	std::vector< std::vector< U> > buffers_;
+	std::vector< impl::tiled_store_entry> entries_;
+	std::size_t buffered_;
+	std::size_t buffer_limit_;
+	std::size_t ignored_;
+	bool failed_;
+	bool closed_;
+};
+
+/// \ingroup geometry
+/// \brief It gives access to a point cloud larger than the memory, stored as tiles by tiled_point_store_builder.
+/// \tparam U the type of the stored coordinates.
+/// \details
+///		The tiles are loaded on demand, as coordinate arrays, and kept in a cache limited by a memory budget; when the
+///		budget is exceeded, the least recently used tiles are dropped. The tiles given to the caller are shared
+///		pointers, so a dropped tile stays valid as long as the caller uses it.
+///
+///		The streaming operations (for_each_tile, query, update_tiles) request the next tiles to a background I/O thread
+///		while the caller processes the current one, so reading the files overlaps the computation. The tiles are read
+///		explicitly into memory, so the paging doesn't depend on the operating system policy for mapped files.
+///
+///		A prefetched tile is not dropped from the cache before the caller gets it, so prefetching never causes a tile
+///		to be read twice; the tiles are prefetched only while all the pending ones fit in the budget.
+///
+///		The methods should be called from a single thread.
+template< typename U>
+class tiled_point_store
+{
+public:
+	typedef coordinate_arrays< U> tile_type;
+	typedef boost::shared_ptr< const tile_type> tile_pointer;
+
+	/// \brief The number of tiles requested in advance by the streaming operations.
+	enum { PREFETCH_DEPTH = 2 };
+
+	tiled_point_store()
+		: budget_( 0)
+		, used_( 0)
+		, prefetched_( 0)
+		, reads_( 0)
+		, stopping_( false)
+		, failed_( false)
+	{
+	}
+
+	/// \brief It opens the given store.
+	/// \see open
+	tiled_point_store( const char* prefix, std::size_t budget)
+		: budget_( 0)
+		, used_( 0)
+		, prefetched_( 0)
+		, reads_( 0)
+		, stopping_( false)
+		, failed_( false)
+	{
+		this->open( prefix, budget);
+	}
+
+	~tiled_point_store()
+	{
+		this->close();
+	}
+
+	/// \brief It opens a store, after closing the current one.
+	/// \param prefix the path prefix of the store files.
+	/// \param budget the maximum size of the cached tiles, in bytes. At least one tile is kept, whatever its size.
+	/// \return false if the index file cannot be read.
+	bool open( const char* prefix, std::size_t budget)
+	{
+		this->close();
+		prefix_ = prefix;
+		budget_ = budget;
+		if( !this->read_index_())
+		{
+			tiles_.clear();
+			return false;
+		}
+		slots_.assign( tiles_.size(), cache_slot());
+		stopping_ = false;
+		failed_ = false;
+		io_thread_.reset( new boost::thread( boost::bind( &tiled_point_store::run_io_, this)));
+		return true;
+	}
+
+	/// \brief It stops the I/O thread and drops the cached tiles.
+	void close()
+	{
+		if( io_thread_)
+		{
+			{
+				boost::mutex::scoped_lock lock( mutex_);
+				stopping_ = true;
+			}
+			requested_.notify_all();
+			io_thread_->join();
+			io_thread_.reset();
+		}
+		slots_.clear();
+		lru_.clear();
+		requests_.clear();
+		used_ = 0;
+		prefetched_ = 0;
+		reads_ = 0;
+	}
+
+	bool is_open() const { return io_thread_.get() != NULL; }
+
+	/// \brief It checks whether a tile couldn't be read or written.
+	bool failed() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return failed_;
+	}
+
+	std::size_t tile_count() const { return tiles_.size(); }
+
+	/// \brief It gets the number of points of the given tile.
+	std::size_t point_count( std::size_t tile) const { return static_cast< std::size_t>( tiles_[tile].count); }
+
+	/// \brief It gets the bounding box of the given tile.
+	void tile_bounds( std::size_t tile, U min[3], U max[3]) const
+	{
+		for( int i = 0; i < 3; ++i)
+		{
+			min[i] = U( tiles_[tile].min[i]);
+			max[i] = U( tiles_[tile].max[i]);
+		}
+	}
+
+	/// \brief It gets the size of the cached tiles, in bytes.
+	std::size_t cached_size() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return used_;
+	}
+
+	/// \brief It gets the number of tile files read since the store was opened.
+	std::size_t tile_reads() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return reads_;
+	}
+
+	/// \brief It requests the given tile to the I/O thread, if it is not cached yet.
+	/// \details
+	///		The tile is kept in the cache until it is got by tile(). It is not requested if the tiles prefetched and not
+	///		got yet, together with it, would exceed the budget.
+	void prefetch( std::size_t tile)
+	{
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			cache_slot& slot = slots_[tile];
+			const std::size_t size = 3 * static_cast< std::size_t>( tiles_[tile].count) * sizeof( U);
+			if( slot.state != EMPTY || prefetched_ + size > budget_)
+			{
+				return;
+			}
+			slot.state = QUEUED;
+			slot.prefetched = size;
+			prefetched_ += size;
+			requests_.push_back( tile);
+		}
+		requested_.notify_one();
+	}
+
+	/// \brief It gets the given tile, loading it if needed.
+	/// \return the tile, or a null pointer if it cannot be read.
+	tile_pointer tile( std::size_t index)
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		for( ;;)
+		{
+			cache_slot& slot = slots_[index];
+			if( slot.state == LOADED)
+			{
+				this->unpin_( slot);
+				lru_.splice( lru_.begin(), lru_, slot.lru);
+				return slot.points;
+			}
+			if( slot.state == LOADING)
+			{
+				loaded_.wait( lock);
+				continue;
+			}
+			if( slot.state == QUEUED)
+			{
+				requests_.erase( std::find( requests_.begin(), requests_.end(), index));
+				this->unpin_( slot);
+			}
+			slot.state = LOADING;
+			lock.unlock();
+			const tile_pointer points = this->load_( index);
+			lock.lock();
+			++reads_;
+			this->insert_( index, points);
+			loaded_.notify_all();
+			return points;
+		}
+	}
+
+	/// \brief It calls the given function for each tile, in the order of the index.
+	/// \param f the function, called as <c>f( const tile_type& points, std::size_t tile)</c>.
+	/// \return false if a tile cannot be read; the processing stops at that tile.
+	template< typename F>
+	bool for_each_tile( F f)
+	{
+		std::vector< std::size_t> order( tiles_.size());
+		for( std::size_t i = 0; i < order.size(); ++i)
+		{
+			order[i] = i;
+		}
+		return this->visit_( order, f);
+	}
+
+	/// \brief It calls the given function for each tile intersecting the given box.
+	/// \param min the minimum corner of the box.
+	/// \param max the maximum corner of the box.
+	/// \param f the function, called as <c>f( const tile_type& points, std::size_t tile)</c>. The tiles may contain
+	///		points outside the box.
+	/// \return false if a tile cannot be read; the processing stops at that tile.
+	template< typename F>
+	bool query( const U min[3], const U max[3], F f)
+	{
+		std::vector< std::size_t> order;
+		for( std::size_t t = 0; t < tiles_.size(); ++t)
+		{
+			bool intersects = true;
+			for( int i = 0; i < 3; ++i)
+			{
+				intersects = intersects && tiles_[t].min[i] <= max[i] && min[i] <= tiles_[t].max[i];
+			}
+			if( intersects)
+			{
+				order.push_back( t);
+			}
+		}
+		return this->visit_( order, f);
+	}
+
+	/// \brief It modifies all the tiles with the given function and writes them back.
+	/// \param f the function, called as <c>f( tile_type& points, std::size_t tile)</c>. It may change the coordinates
+	///		and the number of points.
+	/// \return false if a tile cannot be read or written.
+	/// \details
+	///		The points stay in their tiles; the bounding boxes of the tiles are updated. Transforming a store is done
+	///		by applying the transformation on the coordinate arrays of each tile.
+	template< typename F>
+	bool update_tiles( F f)
+	{
+		bool valid = true;
+		for( std::size_t t = 0; t < tiles_.size() && valid; ++t)
+		{
+			for( std::size_t k = t + 1; k < tiles_.size() && k <= t + PREFETCH_DEPTH; ++k)
+			{
+				this->prefetch( k);
+			}
+			const tile_pointer source = this->tile( t);
+			valid = source.get() != NULL;
+			if( valid)
+			{
+				const boost::shared_ptr< tile_type> points( new tile_type( *source));
+				f( *points, t);
+				valid = this->store_( t, *points);
+				if( valid)
+				{
+					boost::mutex::scoped_lock lock( mutex_);
+					this->drop_( t);
+					this->insert_( t, points);
+				}
+			}
+		}
+		this->cancel_prefetches_();
+		return valid && impl::write_tiled_store_index( prefix_, sizeof( U), tiles_);
+	}
+
+private:
+	enum slot_state { EMPTY, QUEUED, LOADING, LOADED };
+
+	struct cache_slot
+	{
+		cache_slot(): state( EMPTY), prefetched( 0) {}
+
+		slot_state state;
+		/// \brief The size reserved in the budget by prefetch(), until the tile is got by tile(); 0 if the tile is not
+		///		prefetched.
+		std::size_t prefetched;
+		tile_pointer points;
+		std::list< std::size_t>::iterator lru;
+	};
+
+	template< typename F>
+	bool visit_( const std::vector< std::size_t>& order, F& f)
+	{
+		bool valid = true;
+		for( std::size_t k = 0; k < order.size() && valid; ++k)
+		{
+			for( std::size_t n = k + 1; n < order.size() && n <= k + PREFETCH_DEPTH; ++n)
+			{
+				this->prefetch( order[n]);
+			}
+			const tile_pointer points = this->tile( order[k]);
+			valid = points.get() != NULL;
+			if( valid)
+			{
+				f( *points, order[k]);
+			}
+		}
+		this->cancel_prefetches_();
+		return valid;
+	}
+
+	bool read_index_()
+	{
+		std::FILE* file = std::fopen( impl::tiled_store_format::index_path( prefix_).c_str(), "rb");
+		if( file == NULL)
+		{
+			return false;
+		}
+		impl::tiled_store_header header;
+		bool valid = std::fread( &header, sizeof( header), 1, file) == 1
+			&& std::memcmp( header.magic, impl::tiled_store_format::magic(), 8) == 0
+			&& header.version == impl::tiled_store_format::VERSION
+			&& header.byte_order == impl::tiled_store_format::BYTE_ORDER_MARK
+			&& header.unit_size == sizeof( U);
+		if( valid)
+		{
+			tiles_.resize( header.tiles);
+			valid = header.tiles == 0 || std::fread( &tiles_[0], sizeof( tiles_[0]), tiles_.size(), file) == tiles_.size();
+		}
+		std::fclose( file);
+		return valid;
+	}
+
+	/// \brief It reads a tile file, without locking.
+	tile_pointer load_( std::size_t index) const
+	{
+		const std::size_t count = static_cast< std::size_t>( tiles_[index].count);
+		std::FILE* file = std::fopen( impl::tiled_store_format::tile_path( prefix_, tiles_[index].cell).c_str(), "rb");
+		if( file == NULL)
+		{
+			return tile_pointer();
+		}
+		const boost::shared_ptr< tile_type> points( new tile_type());
+		points->x.resize( count);
+		points->y.resize( count);
+		points->z.resize( count);
+		// The interleaved coordinates are read in blocks, to limit the temporary memory.
+		enum { BLOCK_SIZE = 1 << 16 };
+		std::vector< U> block( 3 * std::min( count, std::size_t( BLOCK_SIZE)));
+		bool valid = true;
+		for( std::size_t begin = 0; begin < count && valid; begin += BLOCK_SIZE)
+		{
+			const std::size_t size = std::min( std::size_t( BLOCK_SIZE), count - begin);
+			valid = std::fread( &block[0], sizeof( U), 3 * size, file) == 3 * size;
+			for( std::size_t i = 0; i < size && valid; ++i)
+			{
+				points->x[begin + i] = block[3*i];
+				points->y[begin + i] = block[3*i + 1];
+				points->z[begin + i] = block[3*i + 2];
+			}
+		}
+		std::fclose( file);
+		return valid ? tile_pointer( points) : tile_pointer();
+	}
+
+	/// \brief It writes a tile file and updates its description.
+	bool store_( std::size_t index, const tile_type& points)
+	{
+		impl::tiled_store_entry& entry = tiles_[index];
+		std::FILE* file = std::fopen( impl::tiled_store_format::tile_path( prefix_, entry.cell).c_str(), "wb");
+		bool valid = file != NULL;
+		std::vector< U> interleaved( 3 * points.size());
+		for( std::size_t i = 0; i < points.size(); ++i)
+		{
+			interleaved[3*i] = points.x[i];
+			interleaved[3*i + 1] = points.y[i];
+			interleaved[3*i + 2] = points.z[i];
+			const U coordinates[3] = { points.x[i], points.y[i], points.z[i] };
+			for( int c = 0; c < 3; ++c)
+			{
+				if( i == 0 || coordinates[c] < entry.min[c]) entry.min[c] = coordinates[c];
+				if( i == 0 || coordinates[c] > entry.max[c]) entry.max[c] = coordinates[c];
+			}
+		}
+		entry.count = points.size();
+		if( valid && !interleaved.empty())
+		{
+			valid = std::fwrite( &interleaved[0], sizeof( U), interleaved.size(), file) == interleaved.size();
+		}
+		if( file != NULL)
+		{
+			valid = std::fclose( file) == 0 && valid;
+		}
+		if( !valid)
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			failed_ = true;
+		}
+		return valid;
+	}
+
+	static std::size_t size_of_( const tile_pointer& points)
+	{
+		return points ? 3 * points->size() * sizeof( U) : 0;
+	}
+
+	/// \brief It caches a loaded tile and drops the least recently used tiles exceeding the budget. The mutex is locked.
+	void insert_( std::size_t index, const tile_pointer& points)
+	{
+		cache_slot& slot = slots_[index];
+		if( !points)
+		{
+			this->unpin_( slot);
+			slot.state = EMPTY;
+			failed_ = true;
+			return;
+		}
+		slot.state = LOADED;
+		slot.points = points;
+		lru_.push_front( index);
+		slot.lru = lru_.begin();
+		used_ += size_of_( points);
+		this->trim_();
+	}
+
+	/// \brief It drops the least recently used tiles exceeding the budget. The mutex is locked.
+	/// \details The most recently used tile and the prefetched tiles not got yet are kept.
+	void trim_()
+	{
+		std::list< std::size_t>::iterator it = lru_.end();
+		while( used_ > budget_ && it != lru_.begin())
+		{
+			--it;
+			if( it != lru_.begin() && slots_[*it].prefetched == 0)
+			{
+				const std::size_t victim = *it++;
+				this->drop_( victim);
+			}
+		}
+	}
+
+	/// \brief It releases the size reserved in the budget for a prefetched tile. The mutex is locked.
+	void unpin_( cache_slot& slot)
+	{
+		prefetched_ -= slot.prefetched;
+		slot.prefetched = 0;
+	}
+
+	/// \brief It cancels the requests not served yet and unpins the prefetched tiles, at the end of a streaming
+	///		operation, so the cache is again limited by the budget.
+	void cancel_prefetches_()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		for( std::size_t i = 0; i < requests_.size(); ++i)
+		{
+			slots_[requests_[i]].state = EMPTY;
+		}
+		requests_.clear();
+		for( std::size_t i = 0; i < slots_.size(); ++i)
+		{
+			this->unpin_( slots_[i]);
+		}
+		this->trim_();
+	}
+
+	/// \brief It drops a tile from the cache. The mutex is locked.
+	void drop_( std::size_t index)
+	{
+		cache_slot& slot = slots_[index];
+		if( slot.state != LOADED)
+		{
+			return;
+		}
+		used_ -= size_of_( slot.points);
+		lru_.erase( slot.lru);
+		slot.points.reset();
+		slot.state = EMPTY;
+	}
+
+	/// \brief The loop of the I/O thread: it loads the requested tiles.
+	void run_io_()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		for( ;;)
+		{
+			while( requests_.empty() && !stopping_)
+			{
+				requested_.wait( lock);
+			}
+			if( stopping_)
+			{
+				return;
+			}
+			const std::size_t index = requests_.front();
+			requests_.pop_front();
+			slots_[index].state = LOADING;
+			lock.unlock();
+			const tile_pointer points = this->load_( index);
+			lock.lock();
+			++reads_;
+			this->insert_( index, points);
+			loaded_.notify_all();
+		}
+	}
+
+	std::string prefix_;
+	std::vector< impl::tiled_store_entry> tiles_;
+	std::vector< cache_slot> slots_;
+	/// \brief The cached tiles, the most recently used first.
+	std::list< std::size_t> lru_;
+	std::deque< std::size_t> requests_;
+	std::size_t budget_;
+	std::size_t used_;
+	/// \brief The size reserved in the budget by the prefetched tiles not got yet.
+	std::size_t prefetched_;
+	std::size_t reads_;
+	bool stopping_;
+	bool failed_;
+	mutable boost::mutex mutex_;
+	boost::condition_variable requested_;
+	boost::condition_variable loaded_;
+	boost::shared_ptr< boost::thread> io_thread_;
+
+	tiled_point_store( const tiled_point_store&);
+	tiled_point_store& operator=( const tiled_point_store&);
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_TILED_POINT_STORE_HPP
@@ -0,0 +1,93 @@
+#ifndef GEOMETRY_IO_XYZ_READER_HPP
+#define GEOMETRY_IO_XYZ_READER_HPP
+
+#include "geometry/io/chunked_input.hpp"
+#include "geometry/io/coordinate_arrays.hpp"
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It reads the points of an XYZ file, in chunks.
+/// \details
+///		Each line holds the X, Y and Z coordinates of a point, separated by spaces, tabs or commas; the following
+///		values (e.g. colors or normals) are ignored. The empty lines and the lines starting with # are skipped.
+///
+///		The file is read through a buffer of fixed size and the points are decoded directly in coordinate arrays, so
+///		files of any size can be processed chunk by chunk:
+///		\code
+///		xyz_reader reader( path);
+///		coordinate_arrays< float> points;
+///		while( reader.read( points, 1 << 20) > 0) { process( points); points.clear(); }
+///		if( reader.failed()) { ... }
+///		\endcode
+class xyz_reader
+{
+public:
+	xyz_reader()
+		: failed_( false)
+	{
+	}
+
+	explicit xyz_reader( const char* path)
+	{
+		this->open( path);
+	}
+
+	/// \brief It opens the given file, after closing the current one.
+	bool open( const char* path)
+	{
+		failed_ = !input_.open( path);
+		return !failed_;
+	}
+
+	/// \brief It closes the file, stopping the reading ahead.
+	void close()
+	{
+		input_.close();
+		failed_ = false;
+	}
+
+	bool is_open() const { return input_.is_open(); }
+
+	/// \brief It checks whether the file couldn't be read or contains an invalid line.
+	bool failed() const { return failed_ || input_.failed(); }
+
+	/// \brief It reads the next points and appends them to the given arrays.
+	/// \param points the arrays receiving the coordinates.
+	/// \param max_count the maximum number of points to read.
+	/// \return the number of points read. It is zero at the end of the file or at failure.
+	template< typename U>
+	std::size_t read( coordinate_arrays< U>& points, std::size_t max_count)
+	{
+		std::size_t count = 0;
+		const char* begin;
+		const char* end;
+		while( count < max_count && !failed_ && input_.next_line( begin, end))
+		{
+			begin = impl::skip_separators( begin, end);
+			if( begin == end || *begin == '#')
+			{
+				continue;
+			}
+			double x, y, z;
+			if( !impl::parse_number( begin, end, x) || !impl::parse_number( begin, end, y)
+				|| !impl::parse_number( begin, end, z))
+			{
+				failed_ = true;
+				break;
+			}
+			points.push_back( U( x), U( y), U( z));
+			++count;
+		}
+		return count;
+	}
+
+private:
+	impl::chunked_input input_;
+	bool failed_;
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_IO_XYZ_READER_HPP
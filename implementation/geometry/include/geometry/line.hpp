@@ -4,6 +4,8 @@
 #include "geometry/line_concept.hpp"
 #include "geometry/vertex.hpp"
 #include "geometry/direction.hpp"
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_same.hpp>
 
 namespace geometry
 {
@@ -11,12 +13,16 @@ namespace geometry
 /// \ingroup geometry
 /// \brief It implements a line defined by a vertex and a direction.
 /// \tparam CS the coordinate system used by the line.
-template< typename CS>
+/// \tparam V the vertex type used as line position, in the same coordinate system. The algorithms read the base
+///		through its normalized coordinates, so a line based on an affine_vertex is processed without dividing by the
+///		weight coordinate.
+template< typename CS, typename V = vertex< CS> >
 class line: public impl::geometric_object< CS, line_tag>
 {
+	BOOST_STATIC_ASSERT( (boost::is_same< typename V::coord_system, CS>::value));
 public:
 	/// \brief The alias of the vertex type used as line position.
-	typedef vertex<CS> vertex_type;
+	typedef V vertex_type;
 	/// \brief The alis of the direction type used for line orientation.
 	typedef direction<CS> direction_type;
 public:
@@ -44,8 +50,8 @@ namespace impl
 {
 
 /// \see is_line< typename L, unsigned D, typename CSID>
-template< typename CS, unsigned D, typename CSID>
-struct is_line< line< CS>, D, CSID>
+template< typename CS, typename V, unsigned D, typename CSID>
+struct is_line< line< CS, V>, D, CSID>
 {
 	BOOST_STATIC_CONSTANT( bool, 
 		value = 
@@ -0,0 +1,196 @@
+#ifndef GEOMETRY_MEMORY_MONOTONIC_ARENA_HPP
+#define GEOMETRY_MEMORY_MONOTONIC_ARENA_HPP
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <map>
+#include <new>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It allocates memory by advancing a pointer in large blocks, and frees all of it at once.
+/// \details
+///		Allocating is a few instructions and deallocating does nothing; the memory is given back by release() or by
+///		the destructor. This suits the structures built once and dropped as a whole, e.g. the nodes of a spatial index
+///		or the temporary collections of an algorithm. The arena is not thread safe; see thread_local_arenas for
+///		parallel builds.
+///
+///		The arena implements the memory resource interface used by resource_allocator.
+class monotonic_arena
+{
+public:
+	enum
+	{
+		/// \brief The default size of the blocks requested from the system.
+		DEFAULT_BLOCK_SIZE = 64 * 1024,
+		/// \brief The alignment used when none is given; it suits all the scalar and SSE types.
+		DEFAULT_ALIGNMENT = 16
+	};
+
+	explicit monotonic_arena( std::size_t block_size = DEFAULT_BLOCK_SIZE)
+		: block_size_( block_size)
+		, current_( NULL)
+		, remaining_( 0)
+		, allocated_( 0)
+	{
+	}
+
+	~monotonic_arena()
+	{
+		this->release();
+	}
+
+	/// \brief It allocates memory of the given size and alignment.
+	/// \param size the size of the memory, in bytes.
+	/// \param alignment the alignment of the memory. It must be a power of two.
+	void* allocate( std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT)
+	{
+		assert( alignment > 0 && (alignment & (alignment - 1)) == 0);
+		// The large allocations get their own block, so the current block isn't wasted.
+		if( size + alignment > block_size_ / 4)
+		{
+			return align_( this->new_block_( size + alignment), alignment);
+		}
+		char* result = align_( current_, alignment);
+		if( current_ == NULL || std::size_t( result - current_) + size > remaining_)
+		{
+			current_ = this->new_block_( block_size_);
+			remaining_ = block_size_;
+			result = align_( current_, alignment);
+		}
+		remaining_ -= (result - current_) + size;
+		current_ = result + size;
+		return result;
+	}
+
+	/// \brief It does nothing: the memory is freed by release().
+	void deallocate( void*, std::size_t, std::size_t = DEFAULT_ALIGNMENT)
+	{
+	}
+
+	/// \brief It frees all the allocated memory.
+	void release()
+	{
+		for( std::size_t i = 0; i < blocks_.size(); ++i)
+		{
+			::operator delete( blocks_[i]);
+		}
+		blocks_.clear();
+		current_ = NULL;
+		remaining_ = 0;
+		allocated_ = 0;
+	}
+
+	/// \brief It gets the total size of the blocks requested from the system.
+	std::size_t allocated() const { return allocated_; }
+
+	bool is_equal( const monotonic_arena& other) const { return this == &other; }
+
+private:
+	static char* align_( char* p, std::size_t alignment)
+	{
+		const std::size_t misalignment = reinterpret_cast< std::size_t>( p) & (alignment - 1);
+		return misalignment == 0 ? p : p + (alignment - misalignment);
+	}
+
+	char* new_block_( std::size_t size)
+	{
+		char* block = static_cast< char*>( ::operator new( size));
+		blocks_.push_back( block);
+		allocated_ += size;
+		return block;
+	}
+
+	std::size_t block_size_;
+	std::vector< char*> blocks_;
+	char* current_;
+	std::size_t remaining_;
+	std::size_t allocated_;
+
+	monotonic_arena( const monotonic_arena&);
+	monotonic_arena& operator=( const monotonic_arena&);
+};
+
+/// \ingroup geometry
+/// \brief It keeps a monotonic arena for each thread, so the threads of a parallel build allocate without locking.
+/// \details
+///		Each task gets the arena of its thread by local() (once, as the lookup locks a mutex) and allocates from it;
+///		the structures built by the tasks may point to each other's memory, as all the arenas live until release()
+///		frees them together.
+class thread_local_arenas
+{
+	typedef std::map< boost::thread::id, monotonic_arena*> arena_map_;
+
+public:
+	explicit thread_local_arenas( std::size_t block_size = monotonic_arena::DEFAULT_BLOCK_SIZE)
+		: block_size_( block_size)
+	{
+	}
+
+	~thread_local_arenas()
+	{
+		for( arena_map_::iterator it = arenas_.begin(); it != arenas_.end(); ++it)
+		{
+			delete it->second;
+		}
+	}
+
+	/// \brief It gets the arena of the calling thread, creating it at the first call.
+	monotonic_arena& local()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		monotonic_arena*& arena = arenas_[boost::this_thread::get_id()];
+		if( arena == NULL)
+		{
+			arena = new monotonic_arena( block_size_);
+		}
+		return *arena;
+	}
+
+	/// \brief It gets the number of threads which used an arena.
+	std::size_t size() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return arenas_.size();
+	}
+
+	/// \brief It gets the total size of the blocks of all the arenas.
+	std::size_t allocated() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		std::size_t total = 0;
+		for( arena_map_::const_iterator it = arenas_.begin(); it != arenas_.end(); ++it)
+		{
+			total += it->second->allocated();
+		}
+		return total;
+	}
+
+	/// \brief It frees the memory of all the arenas. No thread may be allocating meanwhile.
+	void release()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		for( arena_map_::iterator it = arenas_.begin(); it != arenas_.end(); ++it)
+		{
+			it->second->release();
+		}
+	}
+
+private:
+	std::size_t block_size_;
+	mutable boost::mutex mutex_;
+	arena_map_ arenas_;
+
+	thread_local_arenas( const thread_local_arenas&);
+	thread_local_arenas& operator=( const thread_local_arenas&);
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_MEMORY_MONOTONIC_ARENA_HPP
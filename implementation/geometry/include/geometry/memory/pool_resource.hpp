@@ -0,0 +1,252 @@
+#ifndef GEOMETRY_MEMORY_POOL_RESOURCE_HPP
+#define GEOMETRY_MEMORY_POOL_RESOURCE_HPP
+
+#include <algorithm>
+#include <new>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace geometry
+{
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It gets the first address aligned as given, not below the given one.
+/// \param alignment the alignment. It must be a power of two.
+inline char* align_address( char* p, std::size_t alignment)
+{
+	const std::size_t misalignment = reinterpret_cast< std::size_t>( p) & (alignment - 1);
+	return misalignment == 0 ? p : p + (alignment - misalignment);
+}
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It allocates blocks of a fixed size, reusing the freed blocks.
+/// \details
+///		The blocks are cut from pages requested from the system; the freed blocks are kept in a list, so allocating
+///		and freeing a block is a few instructions. The pages are given back by release() or by the destructor. The pool
+///		is not thread safe.
+///
+///		The system allocator guarantees only 8 bytes alignment on some platforms (e.g. 32 bits Windows), so each page
+///		is requested ALIGNMENT - 1 bytes larger, and the blocks start at its first aligned address.
+class fixed_pool
+{
+	struct free_block_
+	{
+		free_block_* next;
+	};
+
+public:
+	enum
+	{
+		/// \brief The alignment of the blocks.
+		ALIGNMENT = 16,
+		/// \brief The default size of the pages requested from the system.
+		DEFAULT_PAGE_SIZE = 64 * 1024
+	};
+
+	/// \param block_size the size of the blocks. It is rounded up to a multiple of ALIGNMENT.
+	/// \param page_size the size of the pages requested from the system.
+	explicit fixed_pool( std::size_t block_size, std::size_t page_size = DEFAULT_PAGE_SIZE)
+		: block_size_( (std::max( block_size, sizeof( free_block_)) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+		, page_size_( std::max( page_size, block_size_))
+		, free_( NULL)
+		, next_( NULL)
+		, end_( NULL)
+	{
+	}
+
+	~fixed_pool()
+	{
+		this->release();
+	}
+
+	std::size_t block_size() const { return block_size_; }
+
+	void* allocate()
+	{
+		if( free_ != NULL)
+		{
+			free_block_* block = free_;
+			free_ = block->next;
+			return block;
+		}
+		if( std::size_t( end_ - next_) < block_size_)
+		{
+			char* page = static_cast< char*>( ::operator new( page_size_ + ALIGNMENT - 1));
+			pages_.push_back( page);
+			next_ = impl::align_address( page, ALIGNMENT);
+			end_ = next_ + page_size_;
+		}
+		void* block = next_;
+		next_ += block_size_;
+		return block;
+	}
+
+	void deallocate( void* p)
+	{
+		free_block_* block = static_cast< free_block_*>( p);
+		block->next = free_;
+		free_ = block;
+	}
+
+	/// \brief It frees all the pages, including the blocks still in use.
+	void release()
+	{
+		for( std::size_t i = 0; i < pages_.size(); ++i)
+		{
+			::operator delete( pages_[i]);
+		}
+		pages_.clear();
+		free_ = NULL;
+		next_ = end_ = NULL;
+	}
+
+	/// \brief It gets the total size of the pages, without the alignment padding.
+	std::size_t allocated() const { return pages_.size() * page_size_; }
+
+private:
+	std::size_t block_size_;
+	std::size_t page_size_;
+	std::vector< char*> pages_;
+	free_block_* free_;
+	/// \brief The part of the last page not given yet.
+	char* next_;
+	char* end_;
+
+	fixed_pool( const fixed_pool&);
+	fixed_pool& operator=( const fixed_pool&);
+};
+
+/// \ingroup geometry
+/// \brief It allocates small objects from fixed size pools, one for each size class, and larger ones from the system.
+/// \details
+///		It suits the node based containers (lists, sets, maps, trees), which allocate and free many nodes of the same
+///		size. The sizes are rounded up to multiples of GRANULARITY; the allocations larger than MAX_POOLED_SIZE, or
+///		aligned more strictly than GRANULARITY, go to the system. The resource is not thread safe.
+///
+///		The resource implements the memory resource interface used by resource_allocator.
+class pool_resource
+{
+public:
+	enum
+	{
+		/// \brief The difference between consecutive size classes, which is also the alignment of the pooled blocks.
+		GRANULARITY = fixed_pool::ALIGNMENT,
+		/// \brief The largest size allocated from the pools.
+		MAX_POOLED_SIZE = 512,
+		DEFAULT_ALIGNMENT = GRANULARITY
+	};
+
+	explicit pool_resource( std::size_t page_size = fixed_pool::DEFAULT_PAGE_SIZE)
+		: page_size_( page_size)
+		, pools_( MAX_POOLED_SIZE / GRANULARITY, static_cast< fixed_pool*>( NULL))
+	{
+	}
+
+	~pool_resource()
+	{
+		for( std::size_t i = 0; i < pools_.size(); ++i)
+		{
+			delete pools_[i];
+		}
+	}
+
+	/// \brief It allocates memory of the given size and alignment.
+	/// \param size the size of the memory, in bytes.
+	/// \param alignment the alignment of the memory. It must be a power of two.
+	void* allocate( std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT)
+	{
+		assert( alignment > 0 && (alignment & (alignment - 1)) == 0);
+		if( pool_resource::is_large_( size, alignment))
+		{
+			return pool_resource::allocate_large_( size, alignment);
+		}
+		return this->pool_( size).allocate();
+	}
+
+	/// \brief It frees memory allocated with the same size and alignment.
+	void deallocate( void* p, std::size_t size, std::size_t alignment = DEFAULT_ALIGNMENT)
+	{
+		if( pool_resource::is_large_( size, alignment))
+		{
+			pool_resource::deallocate_large_( p);
+			return;
+		}
+		this->pool_( size).deallocate( p);
+	}
+
+	/// \brief It frees the memory of all the pools, including the blocks still in use. The allocations larger than
+	///		MAX_POOLED_SIZE are not affected.
+	void release()
+	{
+		for( std::size_t i = 0; i < pools_.size(); ++i)
+		{
+			if( pools_[i] != NULL)
+			{
+				pools_[i]->release();
+			}
+		}
+	}
+
+	/// \brief It gets the total size of the pages of the pools.
+	std::size_t allocated() const
+	{
+		std::size_t total = 0;
+		for( std::size_t i = 0; i < pools_.size(); ++i)
+		{
+			total += pools_[i] != NULL ? pools_[i]->allocated() : 0;
+		}
+		return total;
+	}
+
+	bool is_equal( const pool_resource& other) const { return this == &other; }
+
+private:
+	static bool is_large_( std::size_t size, std::size_t alignment)
+	{
+		return size == 0 || size > MAX_POOLED_SIZE || alignment > GRANULARITY;
+	}
+
+	/// \brief It allocates memory from the system, aligned as requested.
+	/// \details
+	///		The memory is requested larger, so it can be aligned and the address given by the system can be stored just
+	///		before the aligned memory, for deallocate_large_().
+	static void* allocate_large_( std::size_t size, std::size_t alignment)
+	{
+		alignment = std::max( alignment, std::size_t( DEFAULT_ALIGNMENT));
+		char* block = static_cast< char*>( ::operator new( size + alignment + sizeof( void*)));
+		char* result = impl::align_address( block + sizeof( void*), alignment);
+		reinterpret_cast< void**>( result)[-1] = block;
+		return result;
+	}
+
+	static void deallocate_large_( void* p)
+	{
+		::operator delete( static_cast< void**>( p)[-1]);
+	}
+
+	fixed_pool& pool_( std::size_t size)
+	{
+		fixed_pool*& pool = pools_[(size - 1) / GRANULARITY];
+		if( pool == NULL)
+		{
+			pool = new fixed_pool( ((size - 1) / GRANULARITY + 1) * GRANULARITY, page_size_);
+		}
+		return *pool;
+	}
+
+	std::size_t page_size_;
+	std::vector< fixed_pool*> pools_;
+
+	pool_resource( const pool_resource&);
+	pool_resource& operator=( const pool_resource&);
+};
+
+} // namespace geometry
+
+#endif // GEOMETRY_MEMORY_POOL_RESOURCE_HPP
@@ -0,0 +1,99 @@
+#ifndef GEOMETRY_MEMORY_RESOURCE_ALLOCATOR_HPP
+#define GEOMETRY_MEMORY_RESOURCE_ALLOCATOR_HPP
+
+#include "geometry/memory/monotonic_arena.hpp"
+#include "geometry/memory/pool_resource.hpp"
+#include <boost/type_traits/alignment_of.hpp>
+#include <new>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief A standard allocator taking its memory from a memory resource.
+/// \tparam T the type of the allocated objects.
+/// \tparam R the type of the memory resource: monotonic_arena, pool_resource, or any type having the same
+///		<c>allocate( size, alignment)</c> and <c>deallocate( p, size, alignment)</c> functions.
+/// \details
+///		The allocator keeps a pointer to the resource, which must outlive the containers using it. The copies of the
+///		allocator, including those rebound by the node based containers, use the same resource:
+///		\code
+///		monotonic_arena arena;
+///		std::vector< vertex< CS>, resource_allocator< vertex< CS>, monotonic_arena> > vertices(
+///			resource_allocator< vertex< CS>, monotonic_arena>( arena));
+///
+///		pool_resource pool;
+///		const std::less< int> less;
+///		std::set< int, std::less< int>, resource_allocator< int, pool_resource> > indices(
+///			less, resource_allocator< int, pool_resource>( pool));
+///		\endcode
+template< typename T, typename R>
+class resource_allocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef R resource_type;
+
+	template< typename U>
+	struct rebind
+	{
+		typedef resource_allocator< U, R> other;
+	};
+
+	explicit resource_allocator( R& resource)
+		: resource_( &resource)
+	{
+	}
+
+	template< typename U>
+	resource_allocator( const resource_allocator< U, R>& other)
+		: resource_( other.resource())
+	{
+	}
+
+	R* resource() const { return resource_; }
+
+	pointer address( reference x) const { return &x; }
+	const_pointer address( const_reference x) const { return &x; }
+
+	pointer allocate( size_type n, const void* = NULL)
+	{
+		return static_cast< pointer>( resource_->allocate( n * sizeof( T), boost::alignment_of< T>::value));
+	}
+
+	void deallocate( pointer p, size_type n)
+	{
+		resource_->deallocate( p, n * sizeof( T), boost::alignment_of< T>::value);
+	}
+
+	size_type max_size() const { return size_type( -1) / sizeof( T); }
+
+	void construct( pointer p, const T& value) { new( p) T( value); }
+	void destroy( pointer p) { p->~T(); }
+
+private:
+	R* resource_;
+};
+
+template< typename T, typename U, typename R>
+bool operator==( const resource_allocator< T, R>& a, const resource_allocator< U, R>& b)
+{
+	return a.resource() == b.resource();
+}
+
+template< typename T, typename U, typename R>
+bool operator!=( const resource_allocator< T, R>& a, const resource_allocator< U, R>& b)
+{
+	return a.resource() != b.resource();
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_MEMORY_RESOURCE_ALLOCATOR_HPP
@@ -0,0 +1,64 @@
+#ifndef GEOMETRY_RAY_HPP
+#define GEOMETRY_RAY_HPP
+
+#include "geometry/ray_concept.hpp"
+#include "geometry/vertex.hpp"
+#include "geometry/direction.hpp"
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It implements a ray (half line) defined by an origin vertex and a direction.
+/// \tparam CS the coordinate system used by the ray.
+/// \details
+///		The points of the ray are <c>origin + t*dir</c>, with <c>t >= 0</c>. Since the direction has always the norm 1, 
+///		the parameter \c t is also the distance from the origin.
+template< typename CS>
+class ray: public impl::geometric_object< CS, ray_tag>
+{
+public:
+	/// \brief The alias of the vertex type used as ray origin.
+	typedef vertex<CS> vertex_type;
+	/// \brief The alias of the direction type used for ray orientation.
+	typedef direction<CS> direction_type;
+public:
+	/// \brief Initialization
+	/// \param origin the vertex the ray starts from.
+	/// \param dir the orientation of the ray.
+	ray( const vertex_type& origin, const direction_type& dir)
+		: origin_( origin)
+		, direction_( dir)
+	{}
+
+	/// \brief It gets the vertex the ray starts from.
+	const vertex_type& origin() const { return origin_; }
+
+	/// \brief It gets the orientation of the ray.
+	const direction_type& dir() const { return direction_; }
+
+private:
+	vertex_type origin_;
+	direction_type direction_;
+};
+
+
+namespace impl
+{
+
+/// \see is_ray< typename R, unsigned D, typename CSID>
+template< typename CS, unsigned D, typename CSID>
+struct is_ray< ray< CS>, D, CSID>
+{
+	BOOST_STATIC_CONSTANT( bool, 
+		value = 
+			(D == CS::DIMENSIONS || D == 0)
+		  &&
+		  (boost::is_same< CSID, void>::value || boost::is_same< typename CS::system_type, CSID>::value));
+};
+
+} // namespace impl
+
+} // geometry
+
+#endif // GEOMETRY_RAY_HPP
@@ -0,0 +1,75 @@
+#ifndef GEOMETRY_RAY_CONCEPT_HPP
+#define GEOMETRY_RAY_CONCEPT_HPP
+
+#include "geometry/geometric_object_concept.hpp"
+#include "geometry/vertex_concept.hpp"
+#include "geometry/direction_concept.hpp"
+#include "geometry/impl/enablers.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/concept/usage.hpp>
+
+namespace geometry
+{
+
+	struct ray_tag {};
+
+/// \ingroup geometry
+/// \brief It checks the requirements for a ray concept.
+template< typename R>
+class Ray: public GeometricObject< R, ray_tag>
+{
+public:
+	// Expect vertex alias.
+	typedef typename R::vertex_type vertex_type;
+	// Expect direction alias.
+	typedef typename R::direction_type direction_type;
+
+	BOOST_CONCEPT_ASSERT( (Vertex<vertex_type>));
+	BOOST_CONCEPT_ASSERT( (Direction<direction_type>));
+
+	BOOST_CONCEPT_USAGE( Ray)
+	{
+		// Require origin vertex
+		vertex_type origin = ray_.origin();
+
+		// Require direction.
+		direction_type dir = ray_.dir();
+
+		// Require initialization:
+		R ray( origin, dir);
+	}
+
+private:
+	R ray_;
+};
+
+template< typename R>
+class Ray3D: public Ray< R>
+{
+public:
+	BOOST_CONCEPT_ASSERT( (Vertex3D< typename R::vertex_type>));
+	BOOST_CONCEPT_ASSERT( (Direction3D< typename R::direction_type>));
+};
+
+namespace impl
+{
+
+/// \brief It checks that the given type is a ray in a coordinate system with the specified number of dimensions.
+/// \tparam R the type to be checked.
+/// \tparam D the expected number of dimensions of the coordinate system. 0 means ignore it.
+/// \tparam CSID the expected system type ID. void means ignore it.
+/// \details
+///		The default implementation assumes that the given type is not a ray type. The ray checking relies on the
+///		mechanism of partial template specialization, so in case a new ray type is implemented, a specialization of
+///		this class should be defined for that type of ray.
+template< typename R, unsigned D, typename CSID = void>
+struct is_ray
+{
+	BOOST_STATIC_CONSTANT( bool, value = false);
+};
+
+} // namespace impl
+
+} // geometry
+
+#endif // GEOMETRY_RAY_CONCEPT_HPP
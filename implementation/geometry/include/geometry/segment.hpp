@@ -0,0 +1,67 @@
+#ifndef GEOMETRY_SEGMENT_HPP
+#define GEOMETRY_SEGMENT_HPP
+
+#include "geometry/segment_concept.hpp"
+#include "geometry/vertex.hpp"
+#include <utility>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief It implements a segment defined by its two edge vertices.
+/// \tparam CS the coordinate system used by the segment.
+/// \details
+///		The points of the segment are <c>first + t*(second - first)</c>, with <c>t</c> in range <c>[0, 1]</c>.
+template< typename CS>
+class segment: public impl::geometric_object< CS, segment_tag>
+{
+public:
+	/// \brief The alias of the vertex type used for the segment edges.
+	typedef vertex<CS> vertex_type;
+public:
+	/// \brief Initialization
+	/// \param first the first edge of the segment.
+	/// \param second the second edge of the segment.
+	segment( const vertex_type& first, const vertex_type& second)
+		: first_( first)
+		, second_( second)
+	{}
+
+	/// \brief Initialization from a pair of vertices, as calculated by shortest_segment.
+	segment( const std::pair< vertex_type, vertex_type>& edges)
+		: first_( edges.first)
+		, second_( edges.second)
+	{}
+
+	/// \brief Access to the edges of the segment.
+	/// \{
+	const vertex_type& first() const { return first_; }
+	const vertex_type& second() const { return second_; }
+	/// \}
+
+private:
+	vertex_type first_;
+	vertex_type second_;
+};
+
+
+namespace impl
+{
+
+/// \see is_segment< typename S, unsigned D, typename CSID>
+template< typename CS, unsigned D, typename CSID>
+struct is_segment< segment< CS>, D, CSID>
+{
+	BOOST_STATIC_CONSTANT( bool, 
+		value = 
+			(D == CS::DIMENSIONS || D == 0)
+		  &&
+		  (boost::is_same< CSID, void>::value || boost::is_same< typename CS::system_type, CSID>::value));
+};
+
+} // namespace impl
+
+} // geometry
+
+#endif // GEOMETRY_SEGMENT_HPP
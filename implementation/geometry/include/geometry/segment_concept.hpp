@@ -0,0 +1,68 @@
+#ifndef GEOMETRY_SEGMENT_CONCEPT_HPP
+#define GEOMETRY_SEGMENT_CONCEPT_HPP
+
+#include "geometry/geometric_object_concept.hpp"
+#include "geometry/vertex_concept.hpp"
+#include "geometry/impl/enablers.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/concept/usage.hpp>
+
+namespace geometry
+{
+
+	struct segment_tag {};
+
+/// \ingroup geometry
+/// \brief It checks the requirements for a segment concept.
+template< typename S>
+class Segment: public GeometricObject< S, segment_tag>
+{
+public:
+	// Expect vertex alias.
+	typedef typename S::vertex_type vertex_type;
+
+	BOOST_CONCEPT_ASSERT( (Vertex<vertex_type>));
+
+	BOOST_CONCEPT_USAGE( Segment)
+	{
+		// Require the two edges
+		vertex_type first = segment_.first();
+		vertex_type second = segment_.second();
+
+		// Require initialization:
+		S segment( first, second);
+	}
+
+private:
+	S segment_;
+};
+
+template< typename S>
+class Segment3D: public Segment< S>
+{
+public:
+	BOOST_CONCEPT_ASSERT( (Vertex3D< typename S::vertex_type>));
+};
+
+namespace impl
+{
+
+/// \brief It checks that the given type is a segment in a coordinate system with the specified number of dimensions.
+/// \tparam S the type to be checked.
+/// \tparam D the expected number of dimensions of the coordinate system. 0 means ignore it.
+/// \tparam CSID the expected system type ID. void means ignore it.
+/// \details
+///		The default implementation assumes that the given type is not a segment type. The segment checking relies on 
+///		the mechanism of partial template specialization, so in case a new segment type is implemented, a 
+///		specialization of this class should be defined for that type of segment.
+template< typename S, unsigned D, typename CSID = void>
+struct is_segment
+{
+	BOOST_STATIC_CONSTANT( bool, value = false);
+};
+
+} // namespace impl
+
+} // geometry
+
+#endif // GEOMETRY_SEGMENT_CONCEPT_HPP
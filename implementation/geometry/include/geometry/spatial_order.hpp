@@ -0,0 +1,590 @@
+#ifndef GEOMETRY_SPATIAL_ORDER_HPP
+#define GEOMETRY_SPATIAL_ORDER_HPP
+
+#include "geometry/vertex_concept.hpp"
+#include "parallel/execution.hpp"
+#include <boost/concept/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace geometry
+{
+
+/// \ingroup geometry
+/// \brief The space filling curves used for ordering the vertices.
+enum space_filling_curve
+{
+	/// \brief The Z order curve: the bits of the cell coordinates are interleaved.
+	MORTON_CURVE,
+	/// \brief The Hilbert curve: consecutive cells along the curve are always adjacent.
+	HILBERT_CURVE
+};
+
+namespace impl
+{
+
+/// \ingroup geometry
+/// \brief It calculates the curve keys of the cells of a 2D or 3D grid.
+/// \tparam D the number of dimensions of the grid.
+/// \details The keys fit in 64 bits: the 2D grid has 32 bits per coordinate, the 3D grid has 21 bits per coordinate.
+template< unsigned D>
+struct curve_keys;
+
+template<>
+struct curve_keys< 2>
+{
+	enum { BITS = 32 };
+
+	/// \brief It spreads the lower 32 bits of the value, so that there is a free bit after each of them.
+	static boost::uint64_t spread( boost::uint64_t x)
+	{
+		x &= 0xFFFFFFFFULL;
+		x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+		x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+		x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		x = (x | (x << 2)) & 0x3333333333333333ULL;
+		x = (x | (x << 1)) & 0x5555555555555555ULL;
+		return x;
+	}
+
+	static boost::uint64_t morton( const boost::uint32_t* cell)
+	{
+		return spread( cell[0]) | (spread( cell[1]) << 1);
+	}
+
+	template< typename V>
+	static void coordinates( const V& v, double* coords)
+	{
+		coords[0] = double( v.x());
+		coords[1] = double( v.y());
+	}
+};
+
+template<>
+struct curve_keys< 3>
+{
+	enum { BITS = 21 };
+
+	/// \brief It spreads the lower 21 bits of the value, so that there are two free bits after each of them.
+	static boost::uint64_t spread( boost::uint64_t x)
+	{
+		x &= 0x1FFFFFULL;
+		x = (x | (x << 32)) & 0x001F00000000FFFFULL;
+		x = (x | (x << 16)) & 0x001F0000FF0000FFULL;
+		x = (x | (x << 8)) & 0x100F00F00F00F00FULL;
+		x = (x | (x << 4)) & 0x10C30C30C30C30C3ULL;
+		x = (x | (x << 2)) & 0x1249249249249249ULL;
+		return x;
+	}
+
+	static boost::uint64_t morton( const boost::uint32_t* cell)
+	{
+		return spread( cell[0]) | (spread( cell[1]) << 1) | (spread( cell[2]) << 2);
+	}
+
+	template< typename V>
+	static void coordinates( const V& v, double* coords)
+	{
+		coords[0] = double( v.x());
+		coords[1] = double( v.y());
+		coords[2] = double( v.z());
+	}
+};
+
+/// \ingroup geometry
+/// \brief It calculates the Hilbert key of a grid cell.
+/// \tparam D the number of dimensions of the grid.
+/// \param cell the cell coordinates. Only the lower curve_keys<D>::BITS bits are used.
+/// \details
+///		The cell coordinates are converted to the transposed Hilbert index, which is then interleaved the same way as
+///		the Morton key.
+/// \sa J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings 707, 2004.
+template< unsigned D>
+boost::uint64_t hilbert_key( const boost::uint32_t* cell)
+{
+	enum { BITS = curve_keys< D>::BITS };
+	const boost::uint32_t mask = static_cast< boost::uint32_t>( (boost::uint64_t( 1) << BITS) - 1);
+	boost::uint32_t x[D];
+	for( unsigned i = 0; i < D; ++i)
+	{
+		x[i] = cell[i] & mask;
+	}
+	const boost::uint32_t m = boost::uint32_t( 1) << (BITS - 1);
+	// Inverse undo.
+	for( boost::uint32_t q = m; q > 1; q >>= 1)
+	{
+		const boost::uint32_t p = q - 1;
+		for( unsigned i = 0; i < D; ++i)
+		{
+			if( x[i] & q)
+			{
+				x[0] ^= p;
+			}
+			else
+			{
+				const boost::uint32_t t = (x[0] ^ x[i]) & p;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+	// Gray encode.
+	for( unsigned i = 1; i < D; ++i)
+	{
+		x[i] ^= x[i-1];
+	}
+	boost::uint32_t t = 0;
+	for( boost::uint32_t q = m; q > 1; q >>= 1)
+	{
+		if( x[D-1] & q)
+		{
+			t ^= q - 1;
+		}
+	}
+	// The first coordinate holds the most significant bit of each level, so the order is reversed for interleaving.
+	boost::uint32_t reversed[D];
+	for( unsigned i = 0; i < D; ++i)
+	{
+		reversed[D-1-i] = x[i] ^ t;
+	}
+	return curve_keys< D>::morton( reversed);
+}
+
+/// \ingroup geometry
+/// \brief It maps the coordinates to the cells of the grid covering the bounding box of the vertices, and calculates the
+///		curve keys of the cells.
+/// \tparam D the number of dimensions of the grid.
+template< unsigned D>
+class curve_grid
+{
+public:
+	/// \brief It creates the grid for the given bounding box.
+	curve_grid( const double* min, const double* max, space_filling_curve curve)
+		: curve_( curve)
+		, max_cell_( double( (boost::uint64_t( 1) << curve_keys< D>::BITS) - 1))
+	{
+		for( unsigned i = 0; i < D; ++i)
+		{
+			min_[i] = min[i];
+			scale_[i] = max[i] > min[i] ? max_cell_ / (max[i] - min[i]) : 0;
+		}
+	}
+
+	template< typename V>
+	boost::uint64_t key( const V& v) const
+	{
+		double coords[D];
+		curve_keys< D>::coordinates( v, coords);
+		boost::uint32_t cell[D];
+		for( unsigned i = 0; i < D; ++i)
+		{
+			const double scaled = (coords[i] - min_[i]) * scale_[i] + 0.5;
+			cell[i] = static_cast< boost::uint32_t>( scaled < max_cell_ ? scaled : max_cell_);
+		}
+		return curve_ == MORTON_CURVE ? curve_keys< D>::morton( cell) : hilbert_key< D>( cell);
+	}
+
+	/// \brief It extends the bounding box with the given vertex.
+	template< typename V>
+	static void extend( const V& v, double* min, double* max)
+	{
+		double coords[D];
+		curve_keys< D>::coordinates( v, coords);
+		for( unsigned i = 0; i < D; ++i)
+		{
+			min[i] = std::min( min[i], coords[i]);
+			max[i] = std::max( max[i], coords[i]);
+		}
+	}
+
+private:
+	space_filling_curve curve_;
+	double max_cell_;
+	double min_[D];
+	double scale_[D];
+};
+
+/// \ingroup geometry
+/// \brief It calculates the curve keys of a random access sequence of vertices in chunks, as specified by an execution
+///		policy.
+/// \details The bounding box is calculated for each chunk, then merged, then the keys are calculated.
+template< typename RandomIt>
+class spatial_key_builder
+{
+	typedef typename std::iterator_traits< RandomIt>::value_type vertex_type_;
+	enum { DIMENSIONS = vertex_type_::coord_system::DIMENSIONS };
+public:
+	enum
+	{
+		/// \brief The minimum number of vertices processed by a task.
+		MIN_GRAIN = 4096
+	};
+
+	spatial_key_builder( RandomIt first, std::size_t count, space_filling_curve curve, boost::uint64_t* keys)
+		: first_( first)
+		, count_( count)
+		, curve_( curve)
+		, keys_( keys)
+		, grid_( NULL)
+	{
+	}
+
+	template< typename P>
+	void build( const P& policy)
+	{
+		if( count_ == 0)
+		{
+			return;
+		}
+		const std::size_t chunks = std::min( (count_ + MIN_GRAIN - 1) / MIN_GRAIN,
+			4 * std::size_t( parallel::concurrency( policy)));
+		chunks_ = chunks;
+		bounds_.resize( 2 * DIMENSIONS * chunks);
+		parallel::for_each_chunk( policy, 0, chunks, 1,
+			boost::bind( &spatial_key_builder::bound_chunks_, this, _1, _2));
+
+		double min[DIMENSIONS], max[DIMENSIONS];
+		std::copy( &bounds_[0], &bounds_[0] + DIMENSIONS, min);
+		std::copy( &bounds_[0] + DIMENSIONS, &bounds_[0] + 2*DIMENSIONS, max);
+		for( std::size_t c = 1; c < chunks; ++c)
+		{
+			for( unsigned i = 0; i < DIMENSIONS; ++i)
+			{
+				min[i] = std::min( min[i], bounds_[2*DIMENSIONS*c + i]);
+				max[i] = std::max( max[i], bounds_[2*DIMENSIONS*c + DIMENSIONS + i]);
+			}
+		}
+		const curve_grid< DIMENSIONS> grid( min, max, curve_);
+		grid_ = &grid;
+		parallel::for_each_chunk( policy, 0, count_, MIN_GRAIN,
+			boost::bind( &spatial_key_builder::calculate_keys_, this, _1, _2));
+		grid_ = NULL;
+	}
+
+private:
+	void bound_chunks_( std::size_t first_chunk, std::size_t last_chunk)
+	{
+		for( std::size_t c = first_chunk; c < last_chunk; ++c)
+		{
+			const std::size_t begin = count_ * c / chunks_, end = count_ * (c + 1) / chunks_;
+			double* min = &bounds_[2*DIMENSIONS*c];
+			double* max = min + DIMENSIONS;
+			curve_keys< DIMENSIONS>::coordinates( first_[begin], min);
+			std::copy( min, min + DIMENSIONS, max);
+			for( std::size_t i = begin + 1; i < end; ++i)
+			{
+				curve_grid< DIMENSIONS>::extend( first_[i], min, max);
+			}
+		}
+	}
+
+	void calculate_keys_( std::size_t begin, std::size_t end)
+	{
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			keys_[i] = grid_->key( first_[i]);
+		}
+	}
+
+	RandomIt first_;
+	std::size_t count_;
+	space_filling_curve curve_;
+	boost::uint64_t* keys_;
+	std::size_t chunks_;
+	/// \brief The minimum and the maximum corners of the bounding box of each chunk.
+	std::vector< double> bounds_;
+	const curve_grid< DIMENSIONS>* grid_;
+};
+
+/// \ingroup geometry
+/// \brief It sorts the keys with a stable least significant digit radix sort, moving the indices along.
+/// \details
+///		The keys are split in contiguous chunks. For each digit, the digits of each chunk are counted, then the offsets
+///		are calculated in the order (digit, chunk), and each chunk is scattered; the chunks are processed as specified
+///		by the execution policy. The sort is stable, so the result does not depend on the number of chunks. The passes
+///		where all the keys have the same digit are skipped.
+class radix_sorter
+{
+public:
+	enum
+	{
+		DIGIT_BITS = 8,
+		RADIX = 1 << DIGIT_BITS,
+		PASSES = 64 / DIGIT_BITS
+	};
+
+	radix_sorter( boost::uint64_t* keys, std::size_t* indices, std::size_t count, std::size_t chunks)
+		: keys_( keys)
+		, indices_( indices)
+		, tmp_keys_( count)
+		, tmp_indices_( count)
+		, count_( count)
+		, chunks_( chunks)
+		, counts_( chunks * RADIX)
+	{
+	}
+
+	template< typename P>
+	void sort( const P& policy)
+	{
+		src_keys_ = keys_;
+		dst_keys_ = tmp_keys_.empty() ? NULL : &tmp_keys_[0];
+		src_indices_ = indices_;
+		dst_indices_ = tmp_indices_.empty() ? NULL : &tmp_indices_[0];
+		for( unsigned pass = 0; pass < PASSES; ++pass)
+		{
+			shift_ = pass * DIGIT_BITS;
+			parallel::for_each_chunk( policy, 0, chunks_, 1, boost::bind( &radix_sorter::count_digits_, this, _1, _2));
+			if( !this->calculate_offsets_())
+			{
+				continue;
+			}
+			parallel::for_each_chunk( policy, 0, chunks_, 1, boost::bind( &radix_sorter::scatter_, this, _1, _2));
+			std::swap( src_keys_, dst_keys_);
+			std::swap( src_indices_, dst_indices_);
+		}
+		if( src_keys_ != keys_)
+		{
+			std::copy( src_keys_, src_keys_ + count_, keys_);
+			std::copy( src_indices_, src_indices_ + count_, indices_);
+		}
+	}
+
+private:
+	std::size_t chunk_begin_( std::size_t chunk) const { return count_ * chunk / chunks_; }
+
+	void count_digits_( std::size_t first_chunk, std::size_t last_chunk)
+	{
+		for( std::size_t c = first_chunk; c < last_chunk; ++c)
+		{
+			std::size_t* count = &counts_[c * RADIX];
+			std::fill( count, count + RADIX, std::size_t( 0));
+			for( std::size_t i = this->chunk_begin_( c), end = this->chunk_begin_( c + 1); i < end; ++i)
+			{
+				++count[(src_keys_[i] >> shift_) & (RADIX - 1)];
+			}
+		}
+	}
+
+	void scatter_( std::size_t first_chunk, std::size_t last_chunk)
+	{
+		for( std::size_t c = first_chunk; c < last_chunk; ++c)
+		{
+			std::size_t* count = &counts_[c * RADIX];
+			for( std::size_t i = this->chunk_begin_( c), end = this->chunk_begin_( c + 1); i < end; ++i)
+			{
+				const std::size_t pos = count[(src_keys_[i] >> shift_) & (RADIX - 1)]++;
+				dst_keys_[pos] = src_keys_[i];
+				dst_indices_[pos] = src_indices_[i];
+			}
+		}
+	}
+
+	/// \brief It replaces the digit counts of each chunk with the position of its first key having that digit.
+	/// \return false if all the keys have the same digit, so the pass can be skipped.
+	bool calculate_offsets_()
+	{
+		std::size_t sum = 0;
+		for( unsigned digit = 0; digit < RADIX; ++digit)
+		{
+			std::size_t digit_count = 0;
+			for( std::size_t c = 0; c < chunks_; ++c)
+			{
+				std::size_t& count = counts_[c * RADIX + digit];
+				const std::size_t chunk_count = count;
+				count = sum;
+				sum += chunk_count;
+				digit_count += chunk_count;
+			}
+			if( digit_count == count_)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	boost::uint64_t* keys_;
+	std::size_t* indices_;
+	std::vector< boost::uint64_t> tmp_keys_;
+	std::vector< std::size_t> tmp_indices_;
+	std::size_t count_;
+	std::size_t chunks_;
+	std::vector< std::size_t> counts_;
+	boost::uint64_t* src_keys_;
+	boost::uint64_t* dst_keys_;
+	std::size_t* src_indices_;
+	std::size_t* dst_indices_;
+	unsigned shift_;
+};
+
+} // namespace impl
+
+/// \ingroup geometry
+/// \brief It calculates the space filling curve keys of a sequence of 2D or 3D vertices.
+/// \tparam VIt the iterator type of the vertex sequence.
+/// \param first the beginning of the sequence.
+/// \param last the end of the sequence.
+/// \param curve the space filling curve.
+/// \param[out] keys the buffer receiving the keys. It must have place for all the vertices of the sequence.
+/// \details
+///		The bounding box of the vertices is divided in a regular grid (2^32 cells per axis in 2D, 2^21 cells per axis in
+///		3D) and each vertex gets the key of its cell along the curve.
+template< typename VIt>
+void spatial_keys( VIt first, VIt last, space_filling_curve curve, boost::uint64_t* keys)
+{
+	typedef typename std::iterator_traits< VIt>::value_type vertex_type;
+	BOOST_CONCEPT_ASSERT( (Vertex< vertex_type>));
+	enum { DIMENSIONS = vertex_type::coord_system::DIMENSIONS };
+	BOOST_STATIC_ASSERT( DIMENSIONS == 2 || DIMENSIONS == 3);
+	typedef impl::curve_grid< DIMENSIONS> curve_grid;
+
+	if( first == last)
+	{
+		return;
+	}
+	double min[DIMENSIONS], max[DIMENSIONS];
+	impl::curve_keys< DIMENSIONS>::coordinates( *first, min);
+	std::copy( min, min + DIMENSIONS, max);
+	for( VIt it = first; it != last; ++it)
+	{
+		curve_grid::extend( *it, min, max);
+	}
+	const curve_grid grid( min, max, curve);
+	for( ; first != last; ++first, ++keys)
+	{
+		*keys = grid.key( *first);
+	}
+}
+
+/// \ingroup geometry
+/// \brief It calculates the space filling curve keys of a random access sequence of 2D or 3D vertices, as specified by
+///		the execution policy.
+/// \copydetails spatial_keys( VIt, VIt, space_filling_curve, boost::uint64_t*)
+template< typename P, typename RandomIt>
+typename boost::enable_if< parallel::is_execution_policy< P> >::type spatial_keys( const P& policy, RandomIt first,
+	RandomIt last, space_filling_curve curve, boost::uint64_t* keys)
+{
+	typedef typename std::iterator_traits< RandomIt>::value_type vertex_type;
+	BOOST_CONCEPT_ASSERT( (Vertex< vertex_type>));
+	BOOST_STATIC_ASSERT( vertex_type::coord_system::DIMENSIONS == 2 || vertex_type::coord_system::DIMENSIONS == 3);
+	impl::spatial_key_builder< RandomIt>( first, std::size_t( last - first), curve, keys).build( policy);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the permutation that sorts the given keys.
+/// \param policy the execution policy used for sorting.
+/// \param keys the keys.
+/// \param count the number of keys.
+/// \param[out] permutation receives the index of the key placed at each position of the sorted order.
+/// \details The sort is stable, so the permutation does not depend on the policy.
+template< typename P>
+void sort_permutation( const P& policy, const boost::uint64_t* keys, std::size_t count,
+	std::vector< std::size_t>& permutation)
+{
+	enum { MIN_CHUNK_SIZE = 4096 };
+	permutation.resize( count);
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		permutation[i] = i;
+	}
+	if( count < 2)
+	{
+		return;
+	}
+	const std::size_t chunks = std::min( (count + MIN_CHUNK_SIZE - 1) / MIN_CHUNK_SIZE,
+		4 * std::size_t( parallel::concurrency( policy)));
+	std::vector< boost::uint64_t> sorted_keys( keys, keys + count);
+	impl::radix_sorter( &sorted_keys[0], &permutation[0], count, chunks).sort( policy);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the permutation that sorts the given keys, in the calling thread.
+inline void sort_permutation( const boost::uint64_t* keys, std::size_t count, std::vector< std::size_t>& permutation)
+{
+	sort_permutation( parallel::seq, keys, count, permutation);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the order of the vertices along a space filling curve.
+/// \tparam RandomIt the random access iterator type of the vertex sequence.
+/// \param policy the execution policy used for calculating the keys and sorting them.
+/// \param first the beginning of the sequence.
+/// \param last the end of the sequence.
+/// \param curve the space filling curve.
+/// \param[out] permutation receives the index of the vertex placed at each position along the curve.
+/// \details
+///		Use permute() for reordering the vertices and their attributes, and inverse_permutation() for remapping the
+///		vertex indices (e.g. of a triangle mesh).
+template< typename P, typename RandomIt>
+typename boost::enable_if< parallel::is_execution_policy< P> >::type spatial_order( const P& policy, RandomIt first,
+	RandomIt last, space_filling_curve curve, std::vector< std::size_t>& permutation)
+{
+	std::vector< boost::uint64_t> keys( last - first);
+	if( keys.empty())
+	{
+		permutation.clear();
+		return;
+	}
+	spatial_keys( policy, first, last, curve, &keys[0]);
+	sort_permutation( policy, &keys[0], keys.size(), permutation);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the order of the vertices along a space filling curve, in the calling thread.
+/// \tparam VIt the iterator type of the vertex sequence.
+template< typename VIt>
+void spatial_order( VIt first, VIt last, space_filling_curve curve, std::vector< std::size_t>& permutation)
+{
+	std::vector< boost::uint64_t> keys( std::distance( first, last));
+	if( keys.empty())
+	{
+		permutation.clear();
+		return;
+	}
+	spatial_keys( first, last, curve, &keys[0]);
+	sort_permutation( &keys[0], keys.size(), permutation);
+}
+
+/// \ingroup geometry
+/// \brief It reorders a sequence by the given permutation.
+/// \tparam RandomIt the random access iterator type of the sequence.
+/// \param first the beginning of the sequence. It must have as many elements as the permutation.
+/// \param permutation the index of the element placed at each position, as calculated by spatial_order().
+template< typename RandomIt>
+void permute( RandomIt first, const std::vector< std::size_t>& permutation)
+{
+	typedef typename std::iterator_traits< RandomIt>::value_type value_type;
+	std::vector< value_type> reordered;
+	reordered.reserve( permutation.size());
+	for( std::size_t i = 0; i < permutation.size(); ++i)
+	{
+		reordered.push_back( first[permutation[i]]);
+	}
+	std::copy( reordered.begin(), reordered.end(), first);
+}
+
+/// \ingroup geometry
+/// \brief It calculates the new position of each element after applying the permutation.
+/// \param permutation the index of the element placed at each position.
+/// \param[out] inverse receives the position of each element, so that old index \c i becomes <c>inverse[i]</c>.
+inline void inverse_permutation( const std::vector< std::size_t>& permutation, std::vector< std::size_t>& inverse)
+{
+	inverse.resize( permutation.size());
+	for( std::size_t i = 0; i < permutation.size(); ++i)
+	{
+		assert( permutation[i] < permutation.size());
+		inverse[permutation[i]] = i;
+	}
+}
+
+} // namespace geometry
+
+#endif // GEOMETRY_SPATIAL_ORDER_HPP
@@ -0,0 +1,116 @@
+#ifndef PARALLEL_BOUNDED_QUEUE_HPP
+#define PARALLEL_BOUNDED_QUEUE_HPP
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <deque>
+#include <cassert>
+#include <cstddef>
+
+namespace parallel
+{
+
+/// \ingroup parallel
+/// \brief A queue with a maximum size, used for passing items between threads.
+/// \tparam T the type of the items.
+/// \details
+///		The producers block while the queue is full and the consumers block while it is empty, so a fast producer is
+///		slowed down to the pace of its consumers (backpressure). The producer closes the queue after the last item; the
+///		consumers get the remaining items, then pop() fails. Cancelling the queue wakes up all the waiting threads and
+///		makes all the following operations fail.
+template< typename T>
+class bounded_queue
+{
+public:
+	/// \brief It creates an empty queue.
+	/// \param capacity the maximum number of items. It must be positive.
+	explicit bounded_queue( std::size_t capacity)
+		: capacity_( capacity)
+		, closed_( false)
+		, cancelled_( false)
+	{
+		assert( capacity > 0);
+	}
+
+	std::size_t capacity() const { return capacity_; }
+
+	/// \brief It gets the number of queued items.
+	std::size_t size() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return items_.size();
+	}
+
+	/// \brief It adds an item, waiting while the queue is full.
+	/// \return false if the queue was cancelled (the item is not added).
+	bool push( const T& item)
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		assert( !closed_);
+		while( items_.size() >= capacity_ && !cancelled_)
+		{
+			not_full_.wait( lock);
+		}
+		if( cancelled_)
+		{
+			return false;
+		}
+		items_.push_back( item);
+		not_empty_.notify_one();
+		return true;
+	}
+
+	/// \brief It removes the oldest item, waiting while the queue is empty.
+	/// \param[out] item receives the removed item.
+	/// \return false if the queue was closed and there are no items left, or if the queue was cancelled.
+	bool pop( T& item)
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		while( items_.empty() && !closed_ && !cancelled_)
+		{
+			not_empty_.wait( lock);
+		}
+		if( cancelled_ || items_.empty())
+		{
+			return false;
+		}
+		item = items_.front();
+		items_.pop_front();
+		not_full_.notify_one();
+		return true;
+	}
+
+	/// \brief It marks the end of the items. The consumers get the queued items, then pop() fails.
+	void close()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		closed_ = true;
+		not_empty_.notify_all();
+	}
+
+	/// \brief It drops the queued items and makes all the pending and following operations fail.
+	void cancel()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		cancelled_ = true;
+		items_.clear();
+		not_empty_.notify_all();
+		not_full_.notify_all();
+	}
+
+private:
+	mutable boost::mutex mutex_;
+	boost::condition_variable not_full_;
+	boost::condition_variable not_empty_;
+	std::deque< T> items_;
+	std::size_t capacity_;
+	bool closed_;
+	bool cancelled_;
+
+	bounded_queue( const bounded_queue&);
+	bounded_queue& operator=( const bounded_queue&);
+};
+
+} // namespace parallel
+
+#endif // PARALLEL_BOUNDED_QUEUE_HPP
@@ -0,0 +1,311 @@
+#ifndef PARALLEL_EXECUTION_HPP
+#define PARALLEL_EXECUTION_HPP
+
+#include "parallel/thread_pool.hpp"
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace parallel
+{
+
+/// \ingroup parallel
+/// \brief The execution policy running a batch operation in the calling thread.
+struct sequenced_policy
+{
+};
+
+/// \ingroup parallel
+/// \brief The execution policy splitting a batch operation in chunks, which run on a thread pool.
+/// \details
+///		By default, the default_thread_pool() is used and the size of the chunks is chosen by the operation, so that
+///		there are a few chunks for each thread of the pool; both can be changed:
+///		\code
+///		calculate_statistics( par.on( pool).grain( 10000), first, last);
+///		\endcode
+///
+///		The chunks are balanced between the threads by work stealing, so a chunk may run on any thread. The affine()
+///		policies give each worker of the pool the same part of the range at every call instead; on a NUMA machine, the
+///		arrays initialized with such a policy (see placed_array) are then processed on the nodes holding their pages.
+class parallel_policy
+{
+public:
+	parallel_policy()
+		: pool_( NULL)
+		, grain_( 0)
+		, affine_( false)
+	{
+	}
+
+	/// \brief It gets a policy using the given pool.
+	parallel_policy on( thread_pool& pool) const
+	{
+		parallel_policy result( *this);
+		result.pool_ = &pool;
+		return result;
+	}
+
+	/// \brief It gets a policy using chunks of the given number of elements.
+	parallel_policy grain( std::size_t size) const
+	{
+		parallel_policy result( *this);
+		result.grain_ = size;
+		return result;
+	}
+
+	/// \brief It gets a policy splitting the range in one contiguous part per worker, each always run by the same
+	///		worker. The calling thread only waits for them. The grain is ignored.
+	parallel_policy affine() const
+	{
+		parallel_policy result( *this);
+		result.affine_ = true;
+		return result;
+	}
+
+	bool is_affine() const { return affine_; }
+
+	thread_pool& pool() const { return pool_ != NULL ? *pool_ : default_thread_pool(); }
+
+	/// \brief It gets the size of the chunks for the given number of elements.
+	/// \param count the number of elements.
+	/// \param min_grain the minimum size of a chunk, for which the work of the chunk outweighs the cost of a task.
+	std::size_t grain_for( std::size_t count, std::size_t min_grain) const
+	{
+		if( grain_ != 0)
+		{
+			return grain_;
+		}
+		return std::max( min_grain, count / (4 * std::size_t( this->pool().size())) + 1);
+	}
+
+private:
+	thread_pool* pool_;
+	std::size_t grain_;
+	bool affine_;
+};
+
+/// \ingroup parallel
+/// \brief The execution policy splitting a batch operation in chunks running on a thread pool, aligned for vector
+///		instructions.
+/// \details
+///		The batch kernels are written as plain loops over arrays, which the compiler can vectorize; this policy keeps
+///		the boundaries of the chunks at multiples of VECTOR_WIDTH elements, so each chunk starts at the same alignment
+///		as the whole array and only the last chunk has a scalar remainder.
+class parallel_vector_policy: public parallel_policy
+{
+public:
+	enum { VECTOR_WIDTH = 8 };
+
+	parallel_vector_policy() {}
+
+	parallel_vector_policy on( thread_pool& pool) const
+	{
+		return parallel_vector_policy( parallel_policy::on( pool));
+	}
+
+	parallel_vector_policy grain( std::size_t size) const
+	{
+		return parallel_vector_policy( parallel_policy::grain( size));
+	}
+
+	parallel_vector_policy affine() const
+	{
+		return parallel_vector_policy( parallel_policy::affine());
+	}
+
+private:
+	explicit parallel_vector_policy( const parallel_policy& base)
+		: parallel_policy( base) {}
+};
+
+/// \ingroup parallel
+/// \brief The predefined execution policies.
+/// \{
+const sequenced_policy seq = sequenced_policy();
+const parallel_policy par = parallel_policy();
+const parallel_vector_policy par_vec = parallel_vector_policy();
+/// \}
+
+/// \ingroup parallel
+/// \brief It checks whether the given type is an execution policy.
+/// \{
+template< typename T>
+struct is_execution_policy: boost::false_type {};
+
+template<> struct is_execution_policy< sequenced_policy>: boost::true_type {};
+template<> struct is_execution_policy< parallel_policy>: boost::true_type {};
+template<> struct is_execution_policy< parallel_vector_policy>: boost::true_type {};
+/// \}
+
+namespace impl
+{
+
+/// \ingroup parallel
+/// \brief It splits a range in halves, queuing the upper halves as tasks, until it reaches the chunk size.
+/// \details
+///		The tasks are created in decreasing size, so the threads stealing them get the largest pieces first, and
+///		split them further in their turn.
+template< typename F>
+void split_range( task_group* group, std::size_t begin, std::size_t end, std::size_t grain, std::size_t align,
+	const F* f)
+{
+	while( end - begin > grain)
+	{
+		std::size_t middle = begin + (end - begin) / 2;
+		middle -= middle % align;
+		if( middle <= begin)
+		{
+			break;
+		}
+		group->run( boost::bind( &split_range< F>, group, middle, end, grain, align, f));
+		end = middle;
+	}
+	(*f)( begin, end);
+}
+
+template< typename F>
+void parallel_for( thread_pool& pool, std::size_t begin, std::size_t end, std::size_t grain, std::size_t align,
+	const F& f)
+{
+	if( begin >= end)
+	{
+		return;
+	}
+	if( end - begin <= grain)
+	{
+		f( begin, end);
+		return;
+	}
+	task_group group( pool);
+	split_range( &group, begin, end, grain, align, &f);
+	group.wait();
+}
+
+template< typename F>
+void call_range( const F* f, std::size_t begin, std::size_t end)
+{
+	(*f)( begin, end);
+}
+
+/// \ingroup parallel
+/// \brief It gets the beginning of the given part of a range split in equal parts, aligned to \c align elements.
+inline std::size_t part_begin( std::size_t begin, std::size_t end, std::size_t part, std::size_t parts,
+	std::size_t align)
+{
+	return part == parts ? end : begin + (end - begin) * part / parts / align * align;
+}
+
+/// \ingroup parallel
+/// \brief It splits a range in one part per worker of the pool, and runs the part \c k on the worker \c k.
+/// \details
+///		The calling thread only waits: it is not bound to a NUMA node, so the part it processed could be placed on one
+///		node and processed later from another. A pool without workers runs the whole range in the calling thread.
+///
+///		When called from a worker (nested parallelism), the workers may be busy with the outer operation, so the parts
+///		are balanced by work stealing instead.
+template< typename F>
+void parallel_for_affine( thread_pool& pool, std::size_t begin, std::size_t end, std::size_t align, const F& f)
+{
+	const std::size_t parts = pool.size() - 1;
+	if( begin >= end)
+	{
+		return;
+	}
+	if( parts == 0)
+	{
+		f( begin, end);
+		return;
+	}
+	if( pool.is_worker_thread())
+	{
+		parallel_for( pool, begin, end, std::max( (end - begin) / pool.size(), std::size_t( 1)), align, f);
+		return;
+	}
+	task_group group( pool);
+	for( std::size_t k = 0; k < parts; ++k)
+	{
+		const std::size_t part_end = part_begin( begin, end, k + 1, parts, align);
+		const std::size_t part_start = part_begin( begin, end, k, parts, align);
+		if( part_start < part_end)
+		{
+			group.run_on( static_cast< unsigned>( k), boost::bind( &call_range< F>, &f, part_start, part_end));
+		}
+	}
+	group.wait();
+}
+
+} // namespace impl
+
+/// \ingroup parallel
+/// \brief It calls the given function for chunks of the range <c>[begin, end)</c>, in parallel.
+/// \param pool the pool running the chunks.
+/// \param begin the beginning of the range.
+/// \param end the end of the range.
+/// \param grain the maximum size of a chunk.
+/// \param f the function, called as <c>f( chunk_begin, chunk_end)</c> from several threads at once.
+/// \details
+///		The function returns after all the chunks are processed. It may be called from a task of the same pool (nested
+///		parallelism): the waiting thread processes chunks as well. If \c f throws exceptions, the other chunks are
+///		still processed, then one of the exceptions is rethrown (see task_group::wait()).
+template< typename F>
+void parallel_for( thread_pool& pool, std::size_t begin, std::size_t end, std::size_t grain, const F& f)
+{
+	impl::parallel_for( pool, begin, end, std::max( grain, std::size_t( 1)), 1, f);
+}
+
+/// \ingroup parallel
+/// \brief It calls the given function for chunks of the range <c>[begin, end)</c>, as specified by the policy.
+/// \param policy the execution policy.
+/// \param begin the beginning of the range.
+/// \param end the end of the range.
+/// \param min_grain the minimum size of a chunk, chosen by the batch operation according to the work per element.
+/// \param f the function, called as <c>f( chunk_begin, chunk_end)</c>.
+/// \{
+template< typename F>
+void for_each_chunk( const sequenced_policy&, std::size_t begin, std::size_t end, std::size_t, const F& f)
+{
+	if( begin < end)
+	{
+		f( begin, end);
+	}
+}
+
+template< typename F>
+void for_each_chunk( const parallel_policy& policy, std::size_t begin, std::size_t end, std::size_t min_grain,
+	const F& f)
+{
+	if( policy.is_affine())
+	{
+		impl::parallel_for_affine( policy.pool(), begin, end, 1, f);
+		return;
+	}
+	impl::parallel_for( policy.pool(), begin, end, policy.grain_for( end - begin, min_grain), 1, f);
+}
+
+template< typename F>
+void for_each_chunk( const parallel_vector_policy& policy, std::size_t begin, std::size_t end, std::size_t min_grain,
+	const F& f)
+{
+	const std::size_t width = parallel_vector_policy::VECTOR_WIDTH;
+	if( policy.is_affine())
+	{
+		impl::parallel_for_affine( policy.pool(), begin, end, width, f);
+		return;
+	}
+	const std::size_t grain = policy.grain_for( end - begin, min_grain);
+	impl::parallel_for( policy.pool(), begin, end, (grain + width - 1) / width * width, width, f);
+}
+/// \}
+
+/// \ingroup parallel
+/// \brief It gets the number of threads a policy may use.
+/// \{
+inline unsigned concurrency( const sequenced_policy&) { return 1; }
+inline unsigned concurrency( const parallel_policy& policy) { return policy.pool().size(); }
+/// \}
+
+} // namespace parallel
+
+#endif // PARALLEL_EXECUTION_HPP
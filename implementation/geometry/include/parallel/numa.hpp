@@ -0,0 +1,52 @@
+#ifndef PARALLEL_NUMA_HPP
+#define PARALLEL_NUMA_HPP
+
+#if defined( PARALLEL_USE_NUMA)
+#	if defined( _WIN32)
+#		include <windows.h>
+#	else
+#		include <numa.h>
+#	endif
+#endif
+
+namespace parallel
+{
+
+/// \ingroup parallel
+/// \brief It gets the number of NUMA nodes of the machine.
+/// \details
+///		The topology is known only when the library is built with PARALLEL_USE_NUMA defined: on Windows it is read by
+///		the Win32 NUMA functions, elsewhere by libnuma (link with -lnuma). Otherwise the machine is seen as a single
+///		node.
+inline unsigned numa_node_count()
+{
+#if defined( PARALLEL_USE_NUMA) && defined( _WIN32)
+	ULONG highest = 0;
+	return GetNumaHighestNodeNumber( &highest) ? unsigned( highest) + 1 : 1;
+#elif defined( PARALLEL_USE_NUMA)
+	return numa_available() < 0 ? 1 : unsigned( numa_max_node()) + 1;
+#else
+	return 1;
+#endif
+}
+
+/// \ingroup parallel
+/// \brief It restricts the calling thread to the processors of the given NUMA node.
+/// \return false if the thread could not be bound, e.g. when the library is built without NUMA support.
+inline bool bind_thread_to_numa_node( unsigned node)
+{
+#if defined( PARALLEL_USE_NUMA) && defined( _WIN32)
+	ULONGLONG mask = 0;
+	return GetNumaNodeProcessorMask( UCHAR( node), &mask) && mask != 0
+		&& SetThreadAffinityMask( GetCurrentThread(), DWORD_PTR( mask)) != 0;
+#elif defined( PARALLEL_USE_NUMA)
+	return numa_available() >= 0 && numa_run_on_node( int( node)) == 0;
+#else
+	(void)node;
+	return false;
+#endif
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_NUMA_HPP
@@ -0,0 +1,341 @@
+#ifndef PARALLEL_PIPELINE_HPP
+#define PARALLEL_PIPELINE_HPP
+
+#include "parallel/bounded_queue.hpp"
+#include "parallel/thread_pool.hpp"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <exception>
+#include <new>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+namespace parallel
+{
+
+/// \ingroup parallel
+/// \brief It runs a chain of processing stages on a stream of batches, all the stages working at the same time.
+/// \tparam T the type of the batches (e.g. geometry::coordinate_arrays).
+/// \details
+///		The source produces the batches, each stage processes them in its turn, and the sink consumes them:
+///		\code
+///		pipeline< coordinate_arrays< float> > p( 4);
+///		p.source( read_batch).stage( transform_batch).stage( filter_batch, 2).sink( write_batch);
+///		bool ok = p.run();
+///		\endcode
+///		Each stage runs on its own threads, and consecutive stages are linked by bounded queues, so reading the next
+///		batch, transforming the previous one and writing the one before overlap. When a stage is slower than the
+///		previous one, the queue between them fills up and the previous stage waits, so the number of batches in flight
+///		(and the memory used) is bounded by the capacity of the queues.
+///
+///		The stage threads block on the queues, so they are not taken from the thread_pool; a stage may still use
+///		a parallel execution policy for processing its batch. The batches keep their order through the stages running
+///		on a single thread; a stage running on several threads may reorder them.
+///
+///		The batches are reused: after the sink, a batch goes back to the source, which has to overwrite it (e.g.
+///		clear it first). This keeps the buffers of the batches allocated between iterations.
+///
+///		An exception thrown by the source, a stage or the sink cancels the pipeline. run() waits for all the threads,
+///		then rethrows the first exception: the one of the sink as it is; the one of the source or of a stage as
+///		std::bad_alloc or as task_error with the same message, as task_group::wait() does.
+template< typename T>
+class pipeline
+{
+	typedef boost::shared_ptr< T> batch_pointer_;
+	typedef bounded_queue< batch_pointer_> queue_;
+
+public:
+	typedef T batch_type;
+	/// \brief It fills the given batch. It returns false when there are no more batches.
+	typedef boost::function< bool ( T&)> source_function;
+	/// \brief It processes the given batch. It returns false for dropping the batch.
+	typedef boost::function< bool ( T&)> stage_function;
+	/// \brief It consumes the given batch.
+	typedef boost::function< void ( T&)> sink_function;
+
+	/// \brief It creates an empty pipeline.
+	/// \param capacity the number of batches which may wait between two stages.
+	explicit pipeline( std::size_t capacity = 4)
+		: capacity_( capacity)
+		, cancelled_( false)
+		, failed_( false)
+		, out_of_memory_( false)
+	{
+	}
+
+	/// \brief It sets the function producing the batches. It runs on a single thread.
+	pipeline& source( const source_function& f)
+	{
+		source_ = f;
+		return *this;
+	}
+
+	/// \brief It adds a processing stage after the previous ones.
+	/// \param f the function processing the batches. If there are several threads, it is called concurrently.
+	/// \param threads the number of threads running the stage.
+	pipeline& stage( const stage_function& f, unsigned threads = 1)
+	{
+		assert( threads > 0);
+		stage_ s = { f, threads };
+		stages_.push_back( s);
+		return *this;
+	}
+
+	/// \brief It sets the function consuming the batches. It runs on a single thread, the one calling run().
+	pipeline& sink( const sink_function& f)
+	{
+		sink_ = f;
+		return *this;
+	}
+
+	/// \brief It runs the pipeline until the source has no more batches and all the batches reached the sink, or until
+	///		the pipeline is cancelled.
+	/// \return false if the pipeline was cancelled.
+	/// \details An exception thrown by the source, a stage or the sink is rethrown after all the threads stopped.
+	bool run()
+	{
+		assert( source_ && sink_);
+		queues_.clear();
+		for( std::size_t i = 0; i <= stages_.size(); ++i)
+		{
+			queues_.push_back( boost::shared_ptr< queue_>( new queue_( capacity_)));
+		}
+		running_.resize( stages_.size());
+		for( std::size_t i = 0; i < stages_.size(); ++i)
+		{
+			running_[i] = stages_[i].threads;
+		}
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			cancelled_ = false;
+			failed_ = false;
+		}
+
+		boost::thread_group threads;
+		try
+		{
+			threads.create_thread( boost::bind( &pipeline::run_source_, this));
+			for( std::size_t i = 0; i < stages_.size(); ++i)
+			{
+				for( unsigned t = 0; t < stages_[i].threads; ++t)
+				{
+					threads.create_thread( boost::bind( &pipeline::run_stage_, this, i));
+				}
+			}
+			this->run_sink_();
+		}
+		catch( ...)
+		{
+			// The started threads use the queues, so they are stopped before the exception leaves.
+			this->cancel();
+			threads.join_all();
+			queues_.clear();
+			throw;
+		}
+		threads.join_all();
+		queues_.clear();
+		this->rethrow_();
+		return !this->cancelled();
+	}
+
+	/// \brief It stops the running pipeline: the batches in flight are dropped and the stages return after their
+	///		current batch. It is meant to be called by a stage, e.g. when writing its batch failed.
+	void cancel()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		cancelled_ = true;
+		for( std::size_t i = 0; i < queues_.size(); ++i)
+		{
+			queues_[i]->cancel();
+		}
+	}
+
+	bool cancelled() const
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		return cancelled_;
+	}
+
+private:
+	struct stage_
+	{
+		stage_function function;
+		unsigned threads;
+	};
+
+	batch_pointer_ take_batch_()
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		if( free_.empty())
+		{
+			return batch_pointer_( new T());
+		}
+		batch_pointer_ batch = free_.back();
+		free_.pop_back();
+		return batch;
+	}
+
+	void recycle_( const batch_pointer_& batch)
+	{
+		boost::mutex::scoped_lock lock( mutex_);
+		free_.push_back( batch);
+	}
+
+	void run_source_()
+	{
+		try
+		{
+			for( ;;)
+			{
+				const batch_pointer_ batch = this->take_batch_();
+				if( !source_( *batch))
+				{
+					this->recycle_( batch);
+					break;
+				}
+				if( !queues_.front()->push( batch))
+				{
+					break;
+				}
+			}
+		}
+		catch( const std::bad_alloc&)
+		{
+			this->failed_stage_( NULL, true);
+		}
+		catch( const std::exception& e)
+		{
+			this->failed_stage_( e.what(), false);
+		}
+		catch( ...)
+		{
+			this->failed_stage_( "unknown exception thrown by the pipeline source", false);
+		}
+		queues_.front()->close();
+	}
+
+	void run_stage_( std::size_t index)
+	{
+		try
+		{
+			batch_pointer_ batch;
+			while( queues_[index]->pop( batch))
+			{
+				if( !stages_[index].function( *batch))
+				{
+					this->recycle_( batch);
+				}
+				else if( !queues_[index + 1]->push( batch))
+				{
+					break;
+				}
+			}
+		}
+		catch( const std::bad_alloc&)
+		{
+			this->failed_stage_( NULL, true);
+		}
+		catch( const std::exception& e)
+		{
+			this->failed_stage_( e.what(), false);
+		}
+		catch( ...)
+		{
+			this->failed_stage_( "unknown exception thrown by a pipeline stage", false);
+		}
+		// The last thread of the stage ends the stream of the next one.
+		boost::mutex::scoped_lock lock( mutex_);
+		if( --running_[index] == 0)
+		{
+			queues_[index + 1]->close();
+		}
+	}
+
+	void run_sink_()
+	{
+		batch_pointer_ batch;
+		while( queues_.back()->pop( batch))
+		{
+			sink_( *batch);
+			this->recycle_( batch);
+		}
+	}
+
+	/// \brief It records an exception thrown by the source or by a stage, if it is the first one, and cancels the
+	///		pipeline.
+	void failed_stage_( const char* error, bool out_of_memory)
+	{
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			if( !failed_)
+			{
+				failed_ = true;
+				out_of_memory_ = out_of_memory;
+				if( !out_of_memory)
+				{
+					try
+					{
+						error_ = error;
+					}
+					catch( const std::bad_alloc&)
+					{
+						out_of_memory_ = true;
+					}
+				}
+			}
+		}
+		this->cancel();
+	}
+
+	/// \brief It rethrows the first exception thrown by the source or by the stages, and forgets it.
+	void rethrow_()
+	{
+		std::string error;
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			if( !failed_)
+			{
+				return;
+			}
+			failed_ = false;
+			if( out_of_memory_)
+			{
+				throw std::bad_alloc();
+			}
+			error.swap( error_);
+		}
+		throw task_error( error);
+	}
+
+	std::size_t capacity_;
+	source_function source_;
+	std::vector< stage_> stages_;
+	sink_function sink_;
+
+	std::vector< boost::shared_ptr< queue_> > queues_;
+	/// \brief The number of threads of each stage which are still running.
+	std::vector< unsigned> running_;
+	/// \brief The batches which went through the sink, or were dropped.
+	std::vector< batch_pointer_> free_;
+	/// \brief It protects the free batches, the running threads, the cancellation flag and the first exception.
+	mutable boost::mutex mutex_;
+	bool cancelled_;
+	/// \brief The first exception thrown by the source or by the stages.
+	/// \{
+	bool failed_;
+	bool out_of_memory_;
+	std::string error_;
+	/// \}
+
+	pipeline( const pipeline&);
+	pipeline& operator=( const pipeline&);
+};
+
+} // namespace parallel
+
+#endif // PARALLEL_PIPELINE_HPP
@@ -0,0 +1,223 @@
+#ifndef PARALLEL_PLACEMENT_HPP
+#define PARALLEL_PLACEMENT_HPP
+
+#include "parallel/execution.hpp"
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+#if defined( PARALLEL_USE_HUGE_PAGES) && !defined( _WIN32)
+#	include <sys/mman.h>
+#endif
+
+namespace parallel
+{
+
+namespace impl
+{
+
+enum
+{
+	/// \brief The size of the huge pages backing the large arrays, when PARALLEL_USE_HUGE_PAGES is defined.
+	HUGE_PAGE_SIZE = 2 * 1024 * 1024,
+	/// \brief The smallest array backed by huge pages.
+	MIN_HUGE_ALLOCATION = 4 * 1024 * 1024
+};
+
+/// \ingroup parallel
+/// \brief It allocates memory whose pages are not touched yet, so each page is placed on the NUMA node of the thread
+///		writing it first.
+/// \details
+///		The large blocks are served directly by the system in both Windows and POSIX allocators, so they are not touched
+///		by the allocation. With PARALLEL_USE_HUGE_PAGES defined, the arrays of at least MIN_HUGE_ALLOCATION bytes are
+///		backed by transparent huge pages, which cut the TLB misses of the batch operations and are still placed by the
+///		first write. When huge pages are not available, the usual allocation is used.
+///
+///		The Windows large pages are not used: they must be committed when they are allocated, which places all of them
+///		on the node of the allocating thread, instead of the nodes of the threads writing them first.
+/// \param size the size of the memory, in bytes.
+/// \param huge it is set when the memory is backed by huge pages.
+inline void* allocate_pages( std::size_t size, bool& huge)
+{
+	huge = false;
+#if defined( PARALLEL_USE_HUGE_PAGES) && !defined( _WIN32)
+	if( size >= MIN_HUGE_ALLOCATION)
+	{
+		void* p = mmap( NULL, (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if( p != MAP_FAILED)
+		{
+#	if defined( MADV_HUGEPAGE)
+			madvise( p, (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+#	endif
+			huge = true;
+			return p;
+		}
+	}
+#endif
+	return ::operator new( size);
+}
+
+/// \ingroup parallel
+/// \brief It frees memory given by allocate_pages() for the same size.
+inline void free_pages( void* p, std::size_t size, bool huge)
+{
+#if defined( PARALLEL_USE_HUGE_PAGES) && !defined( _WIN32)
+	if( huge)
+	{
+		munmap( p, (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+		return;
+	}
+#endif
+	(void)size;
+	(void)huge;
+	::operator delete( p);
+}
+
+/// \ingroup parallel
+/// \brief It destroys the elements of a chunk of an array.
+template< typename T>
+void destroy_range( T* data, std::size_t begin, std::size_t end)
+{
+	for( std::size_t i = begin; i < end; ++i)
+	{
+		data[i].~T();
+	}
+}
+
+/// \ingroup parallel
+/// \brief The chunks of an array whose elements were constructed, so they can be destroyed when another chunk fails.
+struct filled_ranges
+{
+	boost::mutex mutex;
+	std::vector< std::pair< std::size_t, std::size_t> > ranges;
+};
+
+/// \ingroup parallel
+/// \brief It constructs the elements of a chunk of an array, and records the chunk.
+/// \details If a constructor throws, the elements already constructed by the chunk are destroyed.
+template< typename T>
+struct fill_range
+{
+	fill_range( T* data, const T* value, filled_ranges* filled): data_( data), value_( value), filled_( filled) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		std::size_t i = begin;
+		try
+		{
+			for( ; i < end; ++i)
+			{
+				new( data_ + i) T( *value_);
+			}
+			boost::mutex::scoped_lock lock( filled_->mutex);
+			filled_->ranges.push_back( std::make_pair( begin, end));
+		}
+		catch( ...)
+		{
+			destroy_range( data_, begin, i);
+			throw;
+		}
+	}
+
+	T* data_;
+	const T* value_;
+	filled_ranges* filled_;
+};
+
+} // namespace impl
+
+/// \ingroup parallel
+/// \brief An array of fixed size whose elements are initialized by the threads which will process them.
+/// \tparam T the type of the elements.
+/// \details
+///		The operating systems place a page on the NUMA node of the thread writing it first. The elements of the array
+///		are constructed with the given execution policy, so when the batch operations use the same affine() policy,
+///		each thread processes the pages on its own node, instead of fetching them over the interconnect:
+///		\code
+///		const parallel::parallel_policy policy = parallel::par.on( pool).affine();
+///		parallel::placed_array< float> x( policy, count), y( policy, count), z( policy, count);
+///		... fill the coordinates using the same policy ...
+///		const vertex_statistics< CS> stats = calculate_statistics< CS>( policy, x.data(), y.data(), z.data(), count);
+///		\endcode
+///		The memory comes from impl::allocate_pages(), so the large arrays may be backed by huge pages.
+template< typename T>
+class placed_array
+{
+public:
+	typedef T value_type;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+
+	/// \brief It creates the array.
+	/// \param policy the execution policy constructing the elements.
+	/// \param count the number of elements.
+	/// \param value the initial value of the elements.
+	/// \details If an element cannot be constructed, the elements already constructed are destroyed, the memory is
+	///		freed and the exception is rethrown, as for_each_chunk() rethrows it.
+	template< typename P>
+	placed_array( const P& policy, std::size_t count, const T& value = T())
+		: huge_( false)
+		, data_( NULL)
+		, size_( count)
+	{
+		if( count > std::numeric_limits< std::size_t>::max() / sizeof( T))
+		{
+			throw std::bad_alloc();
+		}
+		data_ = static_cast< T*>( impl::allocate_pages( std::max( count, std::size_t( 1)) * sizeof( T), huge_));
+		impl::filled_ranges filled;
+		try
+		{
+			for_each_chunk( policy, 0, count, MIN_GRAIN, impl::fill_range< T>( data_, &value, &filled));
+		}
+		catch( ...)
+		{
+			for( std::size_t i = 0; i < filled.ranges.size(); ++i)
+			{
+				impl::destroy_range( data_, filled.ranges[i].first, filled.ranges[i].second);
+			}
+			impl::free_pages( data_, std::max( count, std::size_t( 1)) * sizeof( T), huge_);
+			throw;
+		}
+	}
+
+	~placed_array()
+	{
+		impl::destroy_range( data_, 0, size_);
+		impl::free_pages( data_, std::max( size_, std::size_t( 1)) * sizeof( T), huge_);
+	}
+
+	std::size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	T* data() { return data_; }
+	const T* data() const { return data_; }
+
+	T& operator[]( std::size_t index) { return data_[index]; }
+	const T& operator[]( std::size_t index) const { return data_[index]; }
+
+	iterator begin() { return data_; }
+	iterator end() { return data_ + size_; }
+	const_iterator begin() const { return data_; }
+	const_iterator end() const { return data_ + size_; }
+
+private:
+	/// \brief The smallest chunk constructed by a task: a page of elements.
+	enum { MIN_GRAIN = 4096 / sizeof( T) + 1 };
+
+	bool huge_;
+	T* data_;
+	std::size_t size_;
+
+	placed_array( const placed_array&);
+	placed_array& operator=( const placed_array&);
+};
+
+} // namespace parallel
+
+#endif // PARALLEL_PLACEMENT_HPP
@@ -0,0 +1,476 @@
+#ifndef PARALLEL_THREAD_POOL_HPP
+#define PARALLEL_THREAD_POOL_HPP
+
+#include "parallel/numa.hpp"
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <cassert>
+#include <cstddef>
+
+namespace parallel
+{
+
+class thread_pool;
+class task_group;
+
+namespace impl
+{
+
+/// \ingroup parallel
+/// \brief A unit of work, belonging to a task group.
+struct task
+{
+	boost::function< void()> work;
+	task_group* group;
+};
+
+/// \ingroup parallel
+/// \brief The queue of tasks of a thread. The owner uses its back, the other threads steal from its front.
+struct task_queue
+{
+	boost::mutex mutex;
+	std::deque< task> tasks;
+	/// \brief The tasks pinned to the owner, which are never stolen.
+	std::deque< task> pinned;
+};
+
+} // namespace impl
+
+/// \ingroup parallel
+/// \brief The error rethrown by task_group::wait() when a task of the group threw an exception other than
+///		std::bad_alloc.
+/// \details The exceptions cannot be moved between threads without copying them, so only their message is kept.
+class task_error: public std::runtime_error
+{
+public:
+	explicit task_error( const std::string& message)
+		: std::runtime_error( message)
+	{
+	}
+};
+
+/// \ingroup parallel
+/// \brief It runs tasks on a fixed set of worker threads, balancing the load by work stealing.
+/// \details
+///		Each worker has its own queue of tasks. A worker runs the most recently created task of its own queue first
+///		(which keeps the data of the task it just split in its cache) and, when its queue is empty, steals the oldest
+///		task of another queue (which is usually the largest remaining piece of work). The tasks created by the other
+///		threads go to a shared queue.
+///
+///		The threads waiting for a task_group run the queued tasks meanwhile, so tasks may create and wait for other
+///		task groups (nested parallelism) without blocking the workers. The pool is meant to be created once per process
+///		and shared by all the parallel operations; see default_thread_pool().
+///
+///		On a NUMA machine (see numa_node_count()), the workers are spread evenly over the nodes and bound to them, so
+///		the tasks pinned to a worker (task_group::run_on()) always run on the same node.
+class thread_pool
+{
+public:
+	/// \brief It starts the worker threads.
+	/// \param workers the number of worker threads. The threads waiting for task groups work as well, so a pool with
+	///		no workers runs all the tasks in the waiting threads.
+	explicit thread_pool( unsigned workers)
+		: queues_( workers + 1)
+		, pinned_( workers + 1, 0)
+		, index_( &thread_pool::no_cleanup_)
+		, queued_( 0)
+		, stopping_( false)
+	{
+		for( std::size_t i = 0; i < queues_.size(); ++i)
+		{
+			queues_[i].reset( new impl::task_queue());
+		}
+		for( unsigned i = 0; i < workers; ++i)
+		{
+			threads_.create_thread( boost::bind( &thread_pool::run_worker_, this, i));
+		}
+	}
+
+	/// \brief It waits for the queued tasks to finish, then stops the workers.
+	~thread_pool()
+	{
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			stopping_ = true;
+		}
+		activity_.notify_all();
+		threads_.join_all();
+	}
+
+	/// \brief It gets the number of threads running tasks concurrently: the workers and the waiting thread.
+	unsigned size() const { return static_cast< unsigned>( queues_.size()); }
+
+	/// \brief It gets the NUMA node of the given worker. The threads outside the pool have the index size() - 1.
+	unsigned home_node( unsigned thread) const
+	{
+		return static_cast< unsigned>( std::size_t( thread) * numa_node_count() / queues_.size());
+	}
+
+	/// \brief It checks whether the calling thread is a worker of the pool.
+	bool is_worker_thread() const { return index_.get() != NULL; }
+
+private:
+	friend class task_group;
+
+	static void no_cleanup_( std::size_t*) {}
+
+	/// \brief It gets the queue of the current thread: its own queue for workers, the shared one for other threads.
+	std::size_t current_queue_() const
+	{
+		const std::size_t* index = index_.get();
+		return index != NULL ? *index : queues_.size() - 1;
+	}
+
+	void push_( const impl::task& t)
+	{
+		impl::task_queue& queue = *queues_[this->current_queue_()];
+		{
+			boost::mutex::scoped_lock lock( queue.mutex);
+			queue.tasks.push_back( t);
+		}
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			++queued_;
+		}
+		activity_.notify_one();
+	}
+
+	void push_pinned_( unsigned thread, const impl::task& t)
+	{
+		assert( thread + 1 < queues_.size());
+		impl::task_queue& queue = *queues_[thread];
+		{
+			boost::mutex::scoped_lock lock( queue.mutex);
+			queue.pinned.push_back( t);
+		}
+		{
+			boost::mutex::scoped_lock lock( mutex_);
+			++pinned_[thread];
+		}
+		// Only the owner may take the task, so all the threads are woken.
+		activity_.notify_all();
+	}
+
+	/// \brief It checks whether there is work for the current thread. The pool mutex must be locked.
+	bool has_work_() const
+	{
+		return queued_ > 0 || pinned_[this->current_queue_()] > 0;
+	}
+
+	/// \brief It takes a task pinned to the current thread, a task from its queue, or steals one from the other queues.
+	bool pop_( impl::task& t)
+	{
+		const std::size_t self = this->current_queue_(), count = queues_.size();
+		{
+			impl::task_queue& own = *queues_[self];
+			boost::mutex::scoped_lock lock( own.mutex);
+			if( !own.pinned.empty())
+			{
+				t = own.pinned.front();
+				own.pinned.pop_front();
+				lock.unlock();
+				boost::mutex::scoped_lock pool_lock( mutex_);
+				--pinned_[self];
+				return true;
+			}
+		}
+		for( std::size_t k = 0; k < count; ++k)
+		{
+			impl::task_queue& queue = *queues_[(self + k) % count];
+			boost::mutex::scoped_lock lock( queue.mutex);
+			if( queue.tasks.empty())
+			{
+				continue;
+			}
+			// The own queue, except for the shared one, is used as a stack; the others as queues.
+			if( k == 0 && self + 1 != count)
+			{
+				t = queue.tasks.back();
+				queue.tasks.pop_back();
+			}
+			else
+			{
+				t = queue.tasks.front();
+				queue.tasks.pop_front();
+			}
+			lock.unlock();
+			boost::mutex::scoped_lock pool_lock( mutex_);
+			--queued_;
+			return true;
+		}
+		return false;
+	}
+
+	/// \brief It runs one queued task, if there is any.
+	bool run_one_();
+
+	void run_worker_( unsigned index)
+	{
+		std::size_t queue = index;
+		index_.reset( &queue);
+		if( numa_node_count() > 1)
+		{
+			bind_thread_to_numa_node( this->home_node( index));
+		}
+		for( ;;)
+		{
+			if( this->run_one_())
+			{
+				continue;
+			}
+			boost::mutex::scoped_lock lock( mutex_);
+			while( !this->has_work_() && !stopping_)
+			{
+				activity_.wait( lock);
+			}
+			if( stopping_ && !this->has_work_())
+			{
+				break;
+			}
+		}
+		index_.reset();
+	}
+
+	std::vector< boost::shared_ptr< impl::task_queue> > queues_;
+	/// \brief The number of tasks pinned to each thread, protected by the pool mutex.
+	std::vector< long> pinned_;
+	boost::thread_specific_ptr< std::size_t> index_;
+	boost::thread_group threads_;
+	/// \brief It protects the number of queued tasks, the counters of the task groups and the stopping flag.
+	boost::mutex mutex_;
+	/// \brief It is notified when a task is queued and when a task group finishes.
+	boost::condition_variable activity_;
+	long queued_;
+	bool stopping_;
+
+	thread_pool( const thread_pool&);
+	thread_pool& operator=( const thread_pool&);
+};
+
+/// \ingroup parallel
+/// \brief A set of tasks running on a thread pool, which can be waited for.
+/// \details
+///		The tasks of a group may add other tasks to the same group; wait() returns when all of them finished. The
+///		destructor waits as well, so the data used by the tasks may live on the stack of the creating thread.
+///
+///		A task throwing an exception does not stop the other tasks. The first exception thrown by the tasks of the group
+///		is rethrown by wait(): std::bad_alloc as it is, the other exceptions as task_error with the same message.
+class task_group
+{
+public:
+	explicit task_group( thread_pool& pool)
+		: pool_( pool)
+		, pending_( 0)
+		, failed_( false)
+		, out_of_memory_( false)
+	{
+	}
+
+	/// \brief It waits for the tasks of the group. The exceptions thrown by them are not rethrown.
+	~task_group()
+	{
+		this->wait_();
+	}
+
+	/// \brief It queues a task.
+	/// \tparam F a function object callable without arguments.
+	template< typename F>
+	void run( const F& f)
+	{
+		pool_.push_( this->make_task_( f));
+	}
+
+	/// \brief It queues a task which runs only on the given worker, e.g. to process data placed on its NUMA node.
+	/// \param thread the index of the worker; it must be less than <c>size() - 1</c>.
+	/// \param f the task.
+	/// \details The task waits for the worker to finish its current work, so the pinned tasks should be large and few.
+	template< typename F>
+	void run_on( unsigned thread, const F& f)
+	{
+		pool_.push_pinned_( thread, this->make_task_( f));
+	}
+
+	/// \brief It waits for all the tasks of the group, running queued tasks meanwhile.
+	/// \details If a task threw an exception, the first one is rethrown, after all the tasks finished.
+	void wait()
+	{
+		this->wait_();
+		this->rethrow_();
+	}
+
+private:
+	friend class thread_pool;
+
+	void wait_()
+	{
+		for( ;;)
+		{
+			{
+				boost::mutex::scoped_lock lock( pool_.mutex_);
+				if( pending_ == 0)
+				{
+					return;
+				}
+			}
+			if( pool_.run_one_())
+			{
+				continue;
+			}
+			boost::mutex::scoped_lock lock( pool_.mutex_);
+			while( pending_ > 0 && !pool_.has_work_())
+			{
+				pool_.activity_.wait( lock);
+			}
+		}
+	}
+
+	/// \brief It rethrows the first exception thrown by the tasks, and forgets it.
+	void rethrow_()
+	{
+		std::string error;
+		{
+			boost::mutex::scoped_lock lock( pool_.mutex_);
+			if( !failed_)
+			{
+				return;
+			}
+			failed_ = false;
+			if( out_of_memory_)
+			{
+				throw std::bad_alloc();
+			}
+			error.swap( error_);
+		}
+		throw task_error( error);
+	}
+
+	template< typename F>
+	impl::task make_task_( const F& f)
+	{
+		{
+			boost::mutex::scoped_lock lock( pool_.mutex_);
+			++pending_;
+		}
+		impl::task t;
+		t.work = f;
+		t.group = this;
+		return t;
+	}
+
+	void finished_()
+	{
+		// The waiting thread may destroy the group as soon as the mutex is released, so the notification is sent before.
+		boost::mutex::scoped_lock lock( pool_.mutex_);
+		if( --pending_ == 0)
+		{
+			pool_.activity_.notify_all();
+		}
+	}
+
+	/// \brief It records an exception thrown by a task, if it is the first one.
+	void failed_task_( const char* error, bool out_of_memory)
+	{
+		boost::mutex::scoped_lock lock( pool_.mutex_);
+		if( !failed_)
+		{
+			failed_ = true;
+			out_of_memory_ = out_of_memory;
+			if( !out_of_memory)
+			{
+				try
+				{
+					error_ = error;
+				}
+				catch( const std::bad_alloc&)
+				{
+					out_of_memory_ = true;
+				}
+			}
+		}
+	}
+
+	thread_pool& pool_;
+	std::size_t pending_;
+	/// \brief The first exception thrown by the tasks, protected by the pool mutex.
+	/// \{
+	bool failed_;
+	bool out_of_memory_;
+	std::string error_;
+	/// \}
+
+	task_group( const task_group&);
+	task_group& operator=( const task_group&);
+};
+
+inline bool thread_pool::run_one_()
+{
+	impl::task t;
+	if( !this->pop_( t))
+	{
+		return false;
+	}
+	// The group is always notified, otherwise its waiting thread would never return.
+	try
+	{
+		t.work();
+	}
+	catch( const std::bad_alloc&)
+	{
+		t.group->failed_task_( NULL, true);
+	}
+	catch( const std::exception& e)
+	{
+		t.group->failed_task_( e.what(), false);
+	}
+	catch( ...)
+	{
+		t.group->failed_task_( "unknown exception thrown by a task", false);
+	}
+	t.group->finished_();
+	return true;
+}
+
+namespace impl
+{
+
+inline thread_pool*& default_pool_instance()
+{
+	static thread_pool* pool = NULL;
+	return pool;
+}
+
+inline void create_default_pool()
+{
+	const unsigned hardware = boost::thread::hardware_concurrency();
+	default_pool_instance() = new thread_pool( hardware > 1 ? hardware - 1 : 0);
+}
+
+} // namespace impl
+
+/// \ingroup parallel
+/// \brief It gets the thread pool shared by the parallel operations of the process.
+/// \details
+///		The pool is created at the first call, with one worker less than the number of hardware threads (the thread
+///		waiting for the parallel operation is the last one). It is never destroyed: the workers wait for tasks until the
+///		process ends.
+inline thread_pool& default_thread_pool()
+{
+	static boost::once_flag created = BOOST_ONCE_INIT;
+	boost::call_once( created, &impl::create_default_pool);
+	return *impl::default_pool_instance();
+}
+
+} // namespace parallel
+
+#endif // PARALLEL_THREAD_POOL_HPP
@@ -0,0 +1,216 @@
+#include "algebra/decompositions_3_3.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/cstdint.hpp>
+#include <limits>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+
+using namespace algebra;
+
+typedef boost::mpl::list< float, double> tested_types;
+
+/// \brief It generates pseudo random values in [-1, 1].
+class random_values
+{
+public:
+	random_values(): state_( 987654321) {}
+
+	double next()
+	{
+		state_ = state_ * 1664525 + 1013904223;
+		return double( state_ >> 8) / double( 1 << 23) - 1;
+	}
+
+private:
+	boost::uint32_t state_;
+};
+
+/// \brief It creates test matrices: random ones, plus the special cases of the decompositions.
+template< typename U>
+std::vector< matrix< 3, 3, U> > sample_matrices( bool symmetric)
+{
+	typedef matrix< 3, 3, U> matrix_type;
+	std::vector< matrix_type> result;
+	random_values random;
+	for( unsigned n = 0; n < 200; ++n)
+	{
+		// Different magnitudes of the elements.
+		const double scale = std::pow( 10.0, int( n % 7) - 3);
+		matrix_type m;
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				m( r, c) = U( random.next() * scale);
+			}
+		}
+		if( symmetric)
+		{
+			m = m + transposed( m);
+		}
+		result.push_back( m);
+	}
+	result.push_back( matrix_type::IDENTITY() * U( 3));
+	result.push_back( matrix_type( 1, 0, 0, 0, 5, 0, 0, 0, -2));
+	// Two equal eigenvalues: I + w * w^T.
+	result.push_back( matrix_type( 2, 1, 1, 1, 2, 1, 1, 1, 2));
+	// Nearly equal eigenvalues.
+	const U epsilon = std::numeric_limits< U>::epsilon();
+	result.push_back( matrix_type( 2, 1, 1, 1, 2 + 4*epsilon, 1, 1, 1, 2));
+	result.push_back( matrix_type( 1, epsilon, 0, epsilon, 1 + epsilon, 0, 0, 0, -3));
+	// Rank deficient.
+	result.push_back( matrix_type( 1, 2, 3, 2, 4, 6, 3, 6, 9));
+	result.push_back( matrix_type());
+	if( !symmetric)
+	{
+		// Reflection: negative determinant.
+		result.push_back( matrix_type( 0, 1, 0, 1, 0, 0, 0, 0, 1));
+		result.push_back( matrix_type( 1, 2, 0, 0, 1, 0, 0, 0, 1));
+	}
+	return result;
+}
+
+template< typename U>
+U max_abs( const matrix< 3, 3, U>& m)
+{
+	U result = 0;
+	for( unsigned r = 0; r < 3; ++r)
+	{
+		for( unsigned c = 0; c < 3; ++c)
+		{
+			result = std::max( result, std::abs( m( r, c)));
+		}
+	}
+	return result;
+}
+
+/// \brief It checks that the matrix is a rotation.
+template< typename U>
+void check_rotation( const matrix< 3, 3, U>& m)
+{
+	typedef U unit_type;
+	const matrix< 3, 3, U> product = transposed( m) * m;
+	for( unsigned r = 0; r < 3; ++r)
+	{
+		for( unsigned c = 0; c < 3; ++c)
+		{
+			ALGTEST_CHECK_SMALL( product( r, c) - (r == c ? U( 1) : U( 0)));
+		}
+	}
+	ALGTEST_CHECK_EQUAL_UNIT( 1, det( m));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_symmetric_eigen, U, tested_types)
+{
+	typedef U unit_type;
+	typedef matrix< 3, 3, U> matrix_type;
+	const std::vector< matrix_type> matrices = sample_matrices< U>( true);
+	std::vector< vector< 3, U> > eigenvalues( matrices.size());
+	std::vector< matrix_type> eigenvectors( matrices.size());
+	symmetric_eigen( &matrices[0], matrices.size(), &eigenvalues[0], &eigenvectors[0]);
+
+	for( std::size_t i = 0; i < matrices.size(); ++i)
+	{
+		const matrix_type& m = matrices[i];
+		const U scale = std::max( max_abs( m), U( 1e-30));
+		check_rotation( eigenvectors[i]);
+		BOOST_CHECK( eigenvalues[i]( 0) <= eigenvalues[i]( 1));
+		BOOST_CHECK( eigenvalues[i]( 1) <= eigenvalues[i]( 2));
+		for( unsigned k = 0; k < 3; ++k)
+		{
+			for( unsigned r = 0; r < 3; ++r)
+			{
+				// Residual of m * v = lambda * v, relative to the magnitude of the matrix.
+				const U mv = m( r, 0)*eigenvectors[i]( 0, k) + m( r, 1)*eigenvectors[i]( 1, k)
+					+ m( r, 2)*eigenvectors[i]( 2, k);
+				ALGTEST_CHECK_SMALL( (mv - eigenvalues[i]( k) * eigenvectors[i]( r, k)) / scale);
+			}
+		}
+
+		vector< 3, U> single_values;
+		matrix_type single_vectors;
+		symmetric_eigen( m, single_values, single_vectors);
+		BOOST_CHECK_EQUAL( eigenvalues[i]( 1), single_values( 1));
+		BOOST_CHECK_EQUAL( eigenvectors[i]( 2, 0), single_vectors( 2, 0));
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_symmetric_eigen_known_values, U, tested_types)
+{
+	typedef U unit_type;
+	vector< 3, U> values;
+	matrix< 3, 3, U> vectors;
+
+	symmetric_eigen( matrix< 3, 3, U>( 2, 1, 1, 1, 2, 1, 1, 1, 2), values, vectors);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, values( 0));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, values( 1));
+	ALGTEST_CHECK_EQUAL_UNIT( 4, values( 2));
+	ALGTEST_CHECK_EQUAL_UNIT( 1 / std::sqrt( U( 3)), std::abs( vectors( 0, 2)));
+
+	symmetric_eigen( matrix< 3, 3, U>( 1, 0, 0, 0, 5, 0, 0, 0, -2), values, vectors);
+	ALGTEST_CHECK_EQUAL_UNIT( -2, values( 0));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, values( 1));
+	ALGTEST_CHECK_EQUAL_UNIT( 5, values( 2));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, std::abs( vectors( 1, 2)));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_svd, U, tested_types)
+{
+	typedef U unit_type;
+	typedef matrix< 3, 3, U> matrix_type;
+	const std::vector< matrix_type> matrices = sample_matrices< U>( false);
+	std::vector< matrix_type> u( matrices.size()), v( matrices.size());
+	std::vector< vector< 3, U> > sigma( matrices.size());
+	svd( &matrices[0], matrices.size(), &u[0], &sigma[0], &v[0]);
+
+	for( std::size_t i = 0; i < matrices.size(); ++i)
+	{
+		const matrix_type& m = matrices[i];
+		const U scale = std::max( max_abs( m), U( 1e-30));
+		check_rotation( u[i]);
+		check_rotation( v[i]);
+		BOOST_CHECK( sigma[i]( 0) >= 0);
+		BOOST_CHECK( sigma[i]( 1) >= 0);
+		BOOST_CHECK( sigma[i]( 0) >= sigma[i]( 1) - scale * test_traits< U>::check_tolerance());
+		BOOST_CHECK( sigma[i]( 1) >= std::abs( sigma[i]( 2)) - scale * test_traits< U>::check_tolerance());
+		// The sign of the last singular value is the sign of the determinant.
+		if( std::abs( det( m)) > scale * scale * scale * U( 1e-2))
+		{
+			BOOST_CHECK_EQUAL( det( m) < 0, sigma[i]( 2) < 0);
+		}
+
+		const matrix_type diag( sigma[i]( 0), 0, 0, 0, sigma[i]( 1), 0, 0, 0, sigma[i]( 2));
+		const matrix_type product = u[i] * diag * transposed( v[i]);
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				ALGTEST_CHECK_SMALL( (product( r, c) - m( r, c)) / scale);
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_svd_known_values, U, tested_types)
+{
+	typedef U unit_type;
+	matrix< 3, 3, U> u, v;
+	vector< 3, U> sigma;
+
+	svd( matrix< 3, 3, U>( 0, 0, 3, 0, -2, 0, 1, 0, 0), u, sigma, v);
+	ALGTEST_CHECK_EQUAL_UNIT( 3, sigma( 0));
+	ALGTEST_CHECK_EQUAL_UNIT( 2, sigma( 1));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, sigma( 2));
+}
+
+} // namespace
@@ -55,4 +55,35 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( test_identity, M, tested_types)
 	BOOST_CHECK( check_equal_matrix( &f.identity_[0][0], &f.identity_[0][0] + M::ROWS*M::COLUMNS, m));
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_inversion, M, tested_types)
+{
+	DEF_TEST( M);
+	tested_matrix m( 
+		2, 1, 0, 3,
+		0, 1, 4, 1,
+		1, 0, 2, 0,
+		5, 1, 0, 1);
+	tested_matrix inv = inverted( m);
+	tested_matrix result = m * inv;
+	for( unsigned r = 0; r < M::ROWS; ++r)
+	{
+		for( unsigned c = 0; c < M::COLUMNS; ++c)
+		{
+			if( r == c)
+			{
+				ALGTEST_CHECK_EQUAL_UNIT( 1, result( r, c));
+			}
+			else
+			{
+				ALGTEST_CHECK_SMALL( result( r, c));
+			}
+		}
+	}
+
+	m.invert();
+	BOOST_CHECK( check_equal_matrix( &inv( 0, 0), &inv( 0, 0) + M::ROWS*M::COLUMNS, m));
+}
+
 } // namespace
@@ -0,0 +1,226 @@
+#include "algebra/solvers.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <vector>
+#include <cmath>
+
+namespace
+{
+
+using namespace algebra;
+
+typedef boost::mpl::list<
+	boost::mpl::pair< boost::mpl::int_< 2>, float>,
+	boost::mpl::pair< boost::mpl::int_< 2>, double>,
+	boost::mpl::pair< boost::mpl::int_< 3>, float>,
+	boost::mpl::pair< boost::mpl::int_< 3>, double>,
+	boost::mpl::pair< boost::mpl::int_< 4>, float>,
+	boost::mpl::pair< boost::mpl::int_< 4>, double> > tested_types;
+
+/// \brief It creates a non singular matrix, which needs pivoting (the first diagonal element is zero).
+template< unsigned N, typename U>
+matrix< N, N, U> general_matrix( unsigned seed)
+{
+	matrix< N, N, U> m;
+	for( unsigned r = 0; r < N; ++r)
+	{
+		for( unsigned c = 0; c < N; ++c)
+		{
+			m( r, c) = U( int( (seed + 7*r + 3*c*c) % 11) - 5) / 4;
+		}
+		m( r, (r + 1) % N) += U( 4);
+	}
+	m( 0, 0) = 0;
+	return m;
+}
+
+/// \brief It creates a symmetric positive definite matrix: <c>A^T * A + I</c>.
+template< unsigned N, typename U>
+matrix< N, N, U> positive_definite_matrix( unsigned seed)
+{
+	const matrix< N, N, U> a = general_matrix< N, U>( seed);
+	matrix< N, N, U> m;
+	for( unsigned r = 0; r < N; ++r)
+	{
+		for( unsigned c = 0; c < N; ++c)
+		{
+			U value = r == c ? U( 1) : U( 0);
+			for( unsigned k = 0; k < N; ++k)
+			{
+				value += a( k, r) * a( k, c);
+			}
+			m( r, c) = value;
+		}
+	}
+	return m;
+}
+
+template< unsigned N, typename U>
+vector< N, U> multiply( const matrix< N, N, U>& m, const vector< N, U>& x)
+{
+	vector< N, U> result;
+	for( unsigned r = 0; r < N; ++r)
+	{
+		for( unsigned c = 0; c < N; ++c)
+		{
+			result( r) += m( r, c) * x( c);
+		}
+	}
+	return result;
+}
+
+template< unsigned N, typename U>
+vector< N, U> expected_solution( unsigned seed)
+{
+	vector< N, U> x;
+	for( unsigned i = 0; i < N; ++i)
+	{
+		x( i) = U( int( (seed + 5*i) % 7) - 3);
+	}
+	return x;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_solve_general, P, tested_types)
+{
+	enum { N = P::first::value };
+	typedef typename P::second unit_type;
+	typedef matrix< N, N, unit_type> matrix_type;
+	typedef vector< N, unit_type> vector_type;
+
+	for( unsigned seed = 0; seed < 20; ++seed)
+	{
+		const matrix_type a = general_matrix< N, unit_type>( seed);
+		const vector_type expected = expected_solution< N, unit_type>( seed);
+		const vector_type b = multiply( a, expected);
+
+		vector_type x_lu, x_qr;
+		BOOST_CHECK( solve_lu( a, b, x_lu));
+		BOOST_CHECK( solve_qr( a, b, x_qr));
+		for( unsigned i = 0; i < N; ++i)
+		{
+			ALGTEST_CHECK_SMALL( x_lu( i) - expected( i));
+			ALGTEST_CHECK_SMALL( x_qr( i) - expected( i));
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_solve_positive_definite, P, tested_types)
+{
+	enum { N = P::first::value };
+	typedef typename P::second unit_type;
+	typedef matrix< N, N, unit_type> matrix_type;
+	typedef vector< N, unit_type> vector_type;
+
+	for( unsigned seed = 0; seed < 20; ++seed)
+	{
+		const matrix_type a = positive_definite_matrix< N, unit_type>( seed);
+		const vector_type expected = expected_solution< N, unit_type>( seed);
+		const vector_type b = multiply( a, expected);
+
+		vector_type x;
+		BOOST_CHECK( solve_cholesky( a, b, x));
+		for( unsigned i = 0; i < N; ++i)
+		{
+			ALGTEST_CHECK_SMALL( x( i) - expected( i));
+		}
+	}
+
+	// A symmetric matrix which is not positive definite.
+	matrix_type indefinite = matrix_type::IDENTITY();
+	indefinite( N - 1, N - 1) = -1;
+	vector_type x;
+	BOOST_CHECK( !solve_cholesky( indefinite, expected_solution< N, unit_type>( 0), x));
+	BOOST_CHECK( solve_lu( indefinite, expected_solution< N, unit_type>( 0), x));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_solve_singular, P, tested_types)
+{
+	enum { N = P::first::value };
+	typedef typename P::second unit_type;
+	typedef matrix< N, N, unit_type> matrix_type;
+	typedef vector< N, unit_type> vector_type;
+
+	// The last row is a multiple of the first one.
+	matrix_type a = general_matrix< N, unit_type>( 3);
+	for( unsigned c = 0; c < N; ++c)
+	{
+		a( N - 1, c) = 2 * a( 0, c);
+	}
+	const vector_type b = expected_solution< N, unit_type>( 1);
+	vector_type x;
+	BOOST_CHECK( !solve_lu( a, b, x));
+	BOOST_CHECK( !solve_qr( a, b, x));
+	for( unsigned i = 0; i < N; ++i)
+	{
+		BOOST_CHECK_EQUAL( unit_type( 0), x( i));
+	}
+	typedef lu_decomposition< N, unit_type> decomposition_type;
+	ALGTEST_CHECK_SMALL( decomposition_type( a).det());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_lu_determinant, P, tested_types)
+{
+	enum { N = P::first::value };
+	typedef typename P::second unit_type;
+	typedef matrix< N, N, unit_type> matrix_type;
+
+	typedef lu_decomposition< N, unit_type> decomposition_type;
+
+	const matrix_type a = general_matrix< N, unit_type>( 5);
+	ALGTEST_CHECK_EQUAL_UNIT( a.det(), decomposition_type( a).det());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_solve_batched, P, tested_types)
+{
+	enum { N = P::first::value };
+	typedef typename P::second unit_type;
+	typedef matrix< N, N, unit_type> matrix_type;
+	typedef vector< N, unit_type> vector_type;
+
+	std::vector< matrix_type> a;
+	std::vector< vector_type> b;
+	for( unsigned seed = 0; seed < 10; ++seed)
+	{
+		a.push_back( positive_definite_matrix< N, unit_type>( seed));
+		b.push_back( expected_solution< N, unit_type>( seed));
+	}
+	a[4] = matrix_type();
+
+	std::vector< vector_type> x_lu( a.size()), x_cholesky( a.size()), x_qr( a.size());
+	bool solved[10];
+	BOOST_CHECK_EQUAL( 9U, solve_lu( &a[0], &b[0], a.size(), &x_lu[0], solved));
+	BOOST_CHECK( !solved[4]);
+	BOOST_CHECK( solved[5]);
+	BOOST_CHECK_EQUAL( 9U, solve_cholesky( &a[0], &b[0], a.size(), &x_cholesky[0]));
+	BOOST_CHECK_EQUAL( 9U, solve_qr( &a[0], &b[0], a.size(), &x_qr[0]));
+
+	// Small chunks, so the systems are solved by several tasks.
+	parallel::thread_pool pool( 2);
+	std::vector< vector_type> x_parallel( a.size());
+	bool solved_parallel[10];
+	BOOST_CHECK_EQUAL( 9U,
+		solve_qr( parallel::par.on( pool).grain( 3), &a[0], &b[0], a.size(), &x_parallel[0], solved_parallel));
+	BOOST_CHECK( !solved_parallel[4]);
+	for( std::size_t k = 0; k < a.size(); ++k)
+	{
+		vector_type x;
+		BOOST_CHECK_EQUAL( k != 4, solve_lu( a[k], b[k], x));
+		for( unsigned i = 0; i < N; ++i)
+		{
+			BOOST_CHECK_EQUAL( x( i), x_lu[k]( i));
+			ALGTEST_CHECK_SMALL( x_cholesky[k]( i) - x_lu[k]( i));
+			ALGTEST_CHECK_SMALL( x_qr[k]( i) - x_lu[k]( i));
+			BOOST_CHECK_EQUAL( x_qr[k]( i), x_parallel[k]( i));
+		}
+	}
+}
+
+} // namespace
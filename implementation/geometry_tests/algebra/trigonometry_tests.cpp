@@ -0,0 +1,88 @@
+#include "algebra/trigonometry.hpp"
+#include "algebra/trigonometry_parallel.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+using namespace algebra;
+
+typedef boost::mpl::list< float, double> tested_types;
+
+/// \brief It checks the sine and cosine calculated with the given precision against std::sin and std::cos.
+template< typename U, typename P>
+void check_sincos( const U& tolerance, P precision)
+{
+	// Angles covering several periods, including the quadrant boundaries.
+	const U pi_over_4 = U( 0.785398163397448309616);
+	std::vector< U> angles;
+	for( int i = -400; i <= 400; ++i)
+	{
+		angles.push_back( i * pi_over_4);
+		angles.push_back( U( i) / 7);
+	}
+	angles.push_back( U( 1000.5));
+	angles.push_back( U( -2500.25));
+
+	std::vector< U> s( angles.size()), c( angles.size());
+	algebra::sincos( &angles[0], angles.size(), &s[0], &c[0], precision);
+	for( std::size_t i = 0; i < angles.size(); ++i)
+	{
+		BOOST_CHECK_SMALL( s[i] - std::sin( angles[i]), tolerance);
+		BOOST_CHECK_SMALL( c[i] - std::cos( angles[i]), tolerance);
+
+		U ss, cc;
+		algebra::sincos( angles[i], ss, cc, precision);
+		BOOST_CHECK_EQUAL( s[i], ss);
+		BOOST_CHECK_EQUAL( c[i], cc);
+	}
+
+	parallel::thread_pool pool( 3);
+	std::vector< U> ps( angles.size()), pc( angles.size());
+	algebra::sincos( parallel::par.on( pool), &angles[0], angles.size(), &ps[0], &pc[0], precision);
+	BOOST_CHECK( ps == s);
+	BOOST_CHECK( pc == c);
+}
+
+BOOST_AUTO_TEST_CASE( test_sincos_float)
+{
+	check_sincos< float>( 1e-6f, fast_trigonometry());
+	check_sincos< float>( 1e-6f, precise_trigonometry());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_sincos_double)
+{
+	check_sincos< double>( 1e-6, fast_trigonometry());
+	check_sincos< double>( 1e-13, precise_trigonometry());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_sincos_special_values, T, tested_types)
+{
+	T s, c;
+	algebra::sincos( T( 0), s, c);
+	BOOST_CHECK_EQUAL( T( 0), s);
+	BOOST_CHECK_EQUAL( T( 1), c);
+
+	// The default precision gives the same results as the precise one.
+	T ps, pc;
+	algebra::sincos( T( 2.5), s, c);
+	algebra::sincos( T( 2.5), ps, pc, precise_trigonometry());
+	BOOST_CHECK_EQUAL( ps, s);
+	BOOST_CHECK_EQUAL( pc, c);
+
+	// The identity sin^2 + cos^2 = 1.
+	for( int i = -50; i < 50; ++i)
+	{
+		algebra::sincos( T( i) / 3, s, c, fast_trigonometry());
+		BOOST_CHECK_SMALL( s*s + c*c - 1, T( 1e-6));
+	}
+}
+
+} // namespace
@@ -0,0 +1,174 @@
+#include "geometry/homogenous/affine_vertex.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/homogenous/distances.hpp"
+#include "geometry/homogenous/shortest_segment.hpp"
+#include "geometry/homogenous/transforms.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/homogenous/cached_transformation.hpp"
+#include "geometry/line.hpp"
+#include "geometry/plane.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+
+namespace
+{
+using namespace geometry;
+
+typedef hcoord_system< 3, float, algebra::unit_traits< float> > float_hcoord_system;
+typedef hcoord_system< 3, double, algebra::unit_traits< double> > double_hcoord_system;
+
+typedef boost::mpl::list< 
+		affine_vertex< float_hcoord_system>, 
+		affine_vertex< double_hcoord_system> > 
+	tested_vertices;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_initialization, V, tested_vertices)
+{
+	typedef V vertex_type;
+	typedef typename vertex_type::coord_system coord_system;
+	typedef typename vertex_type::unit_type unit_type;
+
+	BOOST_CONCEPT_ASSERT( (HomogenousVertex3D< vertex_type>));
+	BOOST_STATIC_ASSERT( (impl::is_vertex< vertex_type, 3, hcoord_system_tag>::value));
+
+	vertex_type v1;
+	ALGTEST_CHECK_EQUAL_UNIT( 0, v1.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, v1.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, v1.z());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v1.w());
+
+	vertex_type v2( 1, 2, 3);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v2.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v2.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v2.z());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v2.w());
+
+	// Homogenous coordinates are normalized at initialization.
+	vertex_type v3( 2, 4, 6, 2);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v3.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v3.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v3.z());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v3.w());
+
+	vertex_type v4( vertex< coord_system>( 3, 6, 9, 3));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v4.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v4.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v4.z());
+
+	// The normalized coordinates are the stored ones.
+	const typename coord_system::pos_rep& pos = v4.normalized();
+	BOOST_CHECK_EQUAL( &v4.x(), &pos( 0));
+
+	// Conversion to homogenous vertex
+	vertex< coord_system> v5( v4.normalized());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v5.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v5.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v5.z());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_affine_transform, V, tested_vertices)
+{
+	typedef V vertex_type;
+	typedef typename vertex_type::coord_system coord_system;
+	typedef typename vertex_type::unit_type unit_type;
+	typedef transformation< coord_system> transform_type;
+	const unit_type pi = unit_type( 3.14159265358979323846);
+
+	transform_type tr( 
+		transform_type::translation( 1, 2, 3).tr_matrix() 
+		* transform_type::template rotation<2>( pi/3).tr_matrix()
+		* transform_type::scaling( 2, 3, 4).tr_matrix());
+	BOOST_CHECK( tr.is_affine());
+
+	vertex_type v1( 5, 6, 7);
+	vertex< coord_system> expected = vertex< coord_system>( 5, 6, 7).transformed( tr);
+	vertex_type v2 = v1.transformed( tr);
+	ALGTEST_CHECK_EQUAL_UNIT( expected.x(), v2.x());
+	ALGTEST_CHECK_EQUAL_UNIT( expected.y(), v2.y());
+	ALGTEST_CHECK_EQUAL_UNIT( expected.z(), v2.z());
+
+	v1.transform( cached_transformation< coord_system>( tr));
+	ALGTEST_CHECK_EQUAL_UNIT( expected.x(), v1.x());
+	ALGTEST_CHECK_EQUAL_UNIT( expected.y(), v1.y());
+	ALGTEST_CHECK_EQUAL_UNIT( expected.z(), v1.z());
+
+	// The result of a projective transformation is normalized.
+	transform_type proj( transform_type::perspective( -1, 1, -1, 1, 1, 10));
+	BOOST_CHECK( !proj.is_affine());
+	const vertex< coord_system> projected = vertex< coord_system>( 5, 6, -7).transformed( proj);
+	vertex_type v3 = vertex_type( 5, 6, -7).transformed( proj);
+	ALGTEST_CHECK_EQUAL_UNIT( projected.x(), v3.x());
+	ALGTEST_CHECK_EQUAL_UNIT( projected.y(), v3.y());
+	ALGTEST_CHECK_EQUAL_UNIT( projected.z(), v3.z());
+	v3 = vertex_type( 5, 6, -7);
+	v3.transform( cached_transformation< coord_system>( proj));
+	ALGTEST_CHECK_EQUAL_UNIT( projected.z(), v3.z());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_affine_distances, V, tested_vertices)
+{
+	typedef V vertex_type;
+	typedef typename vertex_type::coord_system coord_system;
+	typedef line< coord_system> line_type;
+	typedef plane< coord_system> plane_type;
+	typedef direction< coord_system> direction_type;
+	typedef typename vertex_type::unit_type unit_type;
+
+	// The affine vertex is accepted by the algorithms on homogenous vertices.
+	line_type l( vertex< coord_system>( 1, 1, 1), direction_type( 0, 0, 1));
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( vertex_type( 4, 5, 10), l));
+
+	plane_type p( vertex< coord_system>( 1, 1, 1), direction_type( 0, 0, 1));
+	ALGTEST_CHECK_EQUAL_UNIT( 9, distance( vertex_type( 4, 5, 10), p));
+
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( vertex_type( 1, 2, 3), vertex_type( 4, 6, 3)));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_affine_lines, V, tested_vertices)
+{
+	typedef V vertex_type;
+	typedef typename vertex_type::coord_system coord_system;
+	typedef typename coord_system::pos_rep pos_rep;
+	typedef typename vertex_type::unit_type unit_type;
+	typedef line< coord_system, vertex_type> line_type;
+	typedef line< coord_system> hline_type;
+	typedef direction< coord_system> direction_type;
+	typedef transformation< coord_system> transform_type;
+
+	BOOST_CONCEPT_ASSERT( (Line3D< line_type>));
+	BOOST_STATIC_ASSERT( (impl::is_line< line_type, 3, hcoord_system_tag>::value));
+
+	// The algorithms read the base through normalized(), which returns the stored coordinates: taking the address of
+	// the result would not compile if it were calculated.
+	const line_type l( vertex_type( 1, 1, 1), direction_type( 0, 0, 1));
+	const pos_rep* base = &l.base().normalized();
+	BOOST_CHECK_EQUAL( base, &l.base().normalized());
+
+	const hline_type h( vertex< coord_system>( 2, 2, 2, 2), direction_type( 0, 0, 1));
+	const line_type other( vertex_type( 1, 4, 0), direction_type( 1, 0, 0));
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( vertex_type( 4, 5, 10), l));
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( vertex< coord_system>( 4, 5, 10), l));
+	ALGTEST_CHECK_EQUAL_UNIT( 3, distance( l, other));
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( vertex_type( 4, 5, 10), h));
+
+	const std::pair< vertex_type, vertex_type> segment = shortest_segment< vertex_type>( l, other);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, segment.first.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 4, segment.second.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, segment.second.z());
+
+	// The affine transformations keep the line based on an affine vertex.
+	const line_type moved = transformed( l, transform_type::translation( 1, 2, 3));
+	ALGTEST_CHECK_EQUAL_UNIT( 2, moved.base().x());
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( vertex_type( 5, 7, 10), moved));
+}
+
+} // namespace
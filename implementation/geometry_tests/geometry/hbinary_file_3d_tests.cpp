@@ -0,0 +1,110 @@
+#include "geometry/io/binary_file.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/distances.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <vector>
+#include <cstdio>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef boost::mpl::list< hcoord_system< 3, float>, hcoord_system< 3, double> > tested_types;
+
+const char TEST_FILE[] = "hbinary_file_3d_tests.bin";
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_write_and_map, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+	typedef direction< CS> direction_type;
+	typedef line< CS> line_type;
+	typedef plane< CS> plane_type;
+
+	std::vector< vertex_type> vertices;
+	std::vector< line_type> lines;
+	for( int i = 0; i < 100; ++i)
+	{
+		vertices.push_back( vertex_type( unit_type( i), unit_type( 2*i), unit_type( -i)));
+		lines.push_back( line_type( vertex_type( 0, unit_type( i), 0), direction_type( 1, 0, 0)));
+	}
+	std::vector< direction_type> directions( 3, direction_type( 0, 0, 1));
+	std::vector< plane_type> planes( 1, plane_type( 0, 0, 1, -5));
+
+	{
+		binary_file_writer writer( TEST_FILE);
+		BOOST_CHECK_EQUAL( 0U, writer.write( vertices));
+		BOOST_CHECK_EQUAL( 1U, writer.write( directions));
+		BOOST_CHECK_EQUAL( 2U, writer.write( lines));
+		BOOST_CHECK_EQUAL( 3U, writer.write( planes));
+		BOOST_CHECK_EQUAL( 4U, writer.write( &vertices[0], 0));
+		BOOST_CHECK( writer.close());
+	}
+
+	mapped_array< vertex_type> mapped_vertices;
+	mapped_array< line_type> mapped_lines;
+	mapped_array< plane_type> mapped_planes;
+	{
+		binary_file file( TEST_FILE);
+		BOOST_REQUIRE( file.is_open());
+		BOOST_CHECK_EQUAL( 5U, file.sections());
+		BOOST_CHECK_EQUAL( VERTEX_SECTION, file.kind( 0));
+		BOOST_CHECK_EQUAL( DIRECTION_SECTION, file.kind( 1));
+		BOOST_CHECK_EQUAL( LINE_SECTION, file.kind( 2));
+		BOOST_CHECK_EQUAL( PLANE_SECTION, file.kind( 3));
+		BOOST_CHECK_EQUAL( 100U, file.count( 2));
+
+		// The type of the objects should match the section.
+		BOOST_CHECK( file.view< vertex_type>( 2).empty());
+		BOOST_CHECK( file.view< line_type>( 7).empty());
+		BOOST_CHECK( file.view< vertex_type>( 4).empty());
+		BOOST_CHECK( file.holds< vertex_type>( 4));
+
+		mapped_vertices = file.view< vertex_type>( 0);
+		mapped_lines = file.view< line_type>( 2);
+		mapped_planes = file.view< plane_type>( 3);
+		const mapped_array< direction_type> mapped_directions = file.view< direction_type>( 1);
+		BOOST_CHECK_EQUAL( 3U, mapped_directions.size());
+		BOOST_CHECK_EQUAL( unit_type( 1), mapped_directions[2].dz());
+	}
+
+	// The views keep the file mapped after it is closed.
+	BOOST_REQUIRE_EQUAL( vertices.size(), mapped_vertices.size());
+	BOOST_REQUIRE_EQUAL( lines.size(), mapped_lines.size());
+	BOOST_REQUIRE_EQUAL( 1U, mapped_planes.size());
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( 0, std::size_t( &mapped_vertices[i]) % sizeof( unit_type));
+		BOOST_CHECK_EQUAL( vertices[i].x(), mapped_vertices[i].x());
+		BOOST_CHECK_EQUAL( vertices[i].y(), mapped_vertices[i].y());
+		BOOST_CHECK_EQUAL( vertices[i].z(), mapped_vertices[i].z());
+		// The mapped objects are used directly by the geometric algorithms.
+		ALGTEST_CHECK_EQUAL_UNIT( distance( vertices[i], planes[0]), distance( mapped_vertices[i], mapped_planes[0]));
+		ALGTEST_CHECK_EQUAL_UNIT( distance( vertices[i], lines[i]), distance( mapped_vertices[i], mapped_lines[i]));
+	}
+
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_invalid_files)
+{
+	binary_file file;
+	BOOST_CHECK( !file.open( "missing_hbinary_file_3d_tests.bin"));
+	BOOST_CHECK( !file.is_open());
+
+	{
+		std::ofstream stream( TEST_FILE, std::ios::out | std::ios::binary);
+		const std::vector< char> garbage( 200, 'x');
+		stream.write( &garbage[0], std::streamsize( garbage.size()));
+	}
+	BOOST_CHECK( !file.open( TEST_FILE));
+	BOOST_CHECK( !file.is_open());
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+} // namespace
@@ -0,0 +1,207 @@
+#include "geometry/homogenous/compact_direction.hpp"
+#include "geometry/homogenous/compact_direction_parallel.hpp"
+#include "geometry/homogenous/parallelism_3d.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/line.hpp"
+#include "algebra/epsilon_tolerance.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <boost/mpl/int.hpp>
+#include <vector>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef hcoord_system< 3, float> hcoord_system_float;
+typedef hcoord_system< 3, double> hcoord_system_double;
+
+typedef boost::mpl::list<
+	boost::mpl::pair< hcoord_system_float, boost::mpl::int_< 32> >,
+	boost::mpl::pair< hcoord_system_double, boost::mpl::int_< 32> >,
+	boost::mpl::pair< hcoord_system_float, boost::mpl::int_< 48> >,
+	boost::mpl::pair< hcoord_system_double, boost::mpl::int_< 48> > > tested_types;
+
+/// \brief It gets the maximum angle between the original and the decoded directions.
+template< unsigned Bits, typename U>
+U max_error() { return Bits == 32 ? U( 1e-4) : U( 1e-6); }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_compact_direction_size, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	BOOST_CHECK_EQUAL( 4U, sizeof( compact_direction< coord_system, 32>));
+	BOOST_CHECK_EQUAL( 6U, sizeof( compact_direction< coord_system, 48>));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_compact_direction_round_trip, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	enum { BITS = P::second::value };
+	typedef compact_direction< coord_system, BITS> compact_type;
+	typedef direction< coord_system> direction_type;
+
+	// Axes, diagonals, the folded lower half and the edges of the octahedron.
+	std::vector< direction_type> dirs;
+	for( int x = -2; x <= 2; ++x)
+	{
+		for( int y = -2; y <= 2; ++y)
+		{
+			for( int z = -2; z <= 2; ++z)
+			{
+				if( x != 0 || y != 0 || z != 0)
+				{
+					dirs.push_back( direction_type( unit_type( x), unit_type( y) + unit_type( 0.3)*x, unit_type( z)));
+				}
+			}
+		}
+	}
+
+	const unit_type tolerance = max_error< BITS, unit_type>();
+	for( std::size_t i = 0; i < dirs.size(); ++i)
+	{
+		compact_type compact( dirs[i]);
+		direction_type decoded = compact.decoded();
+		// The norm of the cross product is the sine of the angle between the directions.
+		const unit_type
+			cx = decoded.dy()*dirs[i].dz() - decoded.dz()*dirs[i].dy(),
+			cy = decoded.dz()*dirs[i].dx() - decoded.dx()*dirs[i].dz(),
+			cz = decoded.dx()*dirs[i].dy() - decoded.dy()*dirs[i].dx();
+		BOOST_CHECK_SMALL( std::sqrt( cx*cx + cy*cy + cz*cz), tolerance);
+		BOOST_CHECK( decoded.dx()*dirs[i].dx() + decoded.dy()*dirs[i].dy() + decoded.dz()*dirs[i].dz() > 0);
+		BOOST_CHECK_SMALL( decoded.dx() - compact.dx(), unit_type( 1e-6));
+		BOOST_CHECK_SMALL( decoded.dy() - compact.dy(), unit_type( 1e-6));
+		BOOST_CHECK_SMALL( decoded.dz() - compact.dz(), unit_type( 1e-6));
+		// The decoded direction is encoded in the same bits, if the unit type can represent all the codes.
+		if( BITS == 32 || sizeof( unit_type) == sizeof( double))
+		{
+			BOOST_CHECK( compact == compact_type( decoded));
+		}
+	}
+
+	compact_type z_axis;
+	BOOST_CHECK_SMALL( z_axis.dx(), tolerance);
+	BOOST_CHECK_SMALL( z_axis.dy(), tolerance);
+	BOOST_CHECK_CLOSE( unit_type( 1), z_axis.dz(), tolerance);
+	BOOST_CHECK( z_axis != compact_type( 0, 0, -1));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_compact_direction_axes, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	enum { BITS = P::second::value };
+	typedef compact_direction< coord_system, BITS> compact_type;
+
+	// The axes are decoded exactly, including the folded -Z axis.
+	for( int axis = 0; axis < 3; ++axis)
+	{
+		for( int sign = -1; sign <= 1; sign += 2)
+		{
+			unit_type c[3] = { 0, 0, 0 };
+			c[axis] = unit_type( sign);
+			const compact_type compact( c[0], c[1], c[2]);
+			BOOST_CHECK_EQUAL( c[0], compact.dx());
+			BOOST_CHECK_EQUAL( c[1], compact.dy());
+			BOOST_CHECK_EQUAL( c[2], compact.dz());
+			BOOST_CHECK( compact == compact_type( compact.decoded()));
+		}
+	}
+
+	// The directions without an octahedral code are encoded as the Z axis.
+	const unit_type infinity = std::numeric_limits< unit_type>::infinity();
+	const unit_type nan = std::numeric_limits< unit_type>::quiet_NaN();
+	BOOST_CHECK( compact_type() == compact_type( 0, 0, 0));
+	BOOST_CHECK( compact_type() == compact_type( nan, 1, 0));
+	BOOST_CHECK( compact_type() == compact_type( infinity, -infinity, 1));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_compact_direction_batch, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	enum { BITS = P::second::value };
+	typedef compact_direction< coord_system, BITS> compact_type;
+
+	// More directions than a block, to check the last incomplete block.
+	const std::size_t count = 100;
+	std::vector< unit_type> x( count), y( count), z( count);
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		x[i] = std::cos( unit_type( i));
+		y[i] = std::sin( unit_type( i)) * 2;
+		z[i] = unit_type( i % 7) - 3;
+	}
+	std::vector< compact_type> compact( count);
+	encode( &x[0], &y[0], &z[0], count, &compact[0]);
+
+	std::vector< unit_type> dx( count), dy( count), dz( count);
+	decode( &compact[0], &compact[0] + count, &dx[0], &dy[0], &dz[0]);
+	std::vector< unit_type> ix( count), iy( count), iz( count);
+	decode< coord_system, BITS>( compact.begin(), compact.end(), &ix[0], &iy[0], &iz[0]);
+
+	parallel::thread_pool pool( 3);
+	std::vector< compact_type> pcompact( count);
+	encode( parallel::par.on( pool), &x[0], &y[0], &z[0], count, &pcompact[0]);
+	BOOST_CHECK( pcompact == compact);
+	std::vector< unit_type> px( count), py( count), pz( count);
+	decode( parallel::par.on( pool), &compact[0], &compact[0] + count, &px[0], &py[0], &pz[0]);
+	BOOST_CHECK( px == dx && py == dy && pz == dz);
+
+	const unit_type tolerance = max_error< BITS, unit_type>();
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		const typename coord_system::dir_rep expected = compact[i].decoded_components();
+		BOOST_CHECK_EQUAL( expected.template at<0>(), dx[i]);
+		BOOST_CHECK_EQUAL( expected.template at<1>(), dy[i]);
+		BOOST_CHECK_EQUAL( expected.template at<2>(), dz[i]);
+		BOOST_CHECK_EQUAL( dx[i], ix[i]);
+		BOOST_CHECK_EQUAL( dy[i], iy[i]);
+		BOOST_CHECK_EQUAL( dz[i], iz[i]);
+
+		const unit_type norm = std::sqrt( x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+		BOOST_CHECK_SMALL( x[i]/norm - dx[i], 2*tolerance);
+		BOOST_CHECK_SMALL( y[i]/norm - dy[i], 2*tolerance);
+		BOOST_CHECK_SMALL( z[i]/norm - dz[i], 2*tolerance);
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_compact_direction_interoperability, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	enum { BITS = P::second::value };
+	typedef compact_direction< coord_system, BITS> compact_type;
+	typedef direction< coord_system> direction_type;
+	typedef line< coord_system> line_type;
+	typedef vertex< coord_system> vertex_type;
+
+	const algebra::epsilon_tolerance< unit_type> tolerance( max_error< BITS, unit_type>());
+	const compact_type c1( 1, 2, 3), c2( -2, -4, -6), c3( 1, 0, 0);
+	BOOST_CHECK( are_parallel( c1, c2, tolerance));
+	BOOST_CHECK( !are_parallel( c1, c3, tolerance));
+	BOOST_CHECK( are_parallel( c1, direction_type( 1, 2, 3), tolerance));
+	BOOST_CHECK( are_parallel( direction_type( 1, 0, 0), c3, tolerance));
+
+	// Lines built from compact directions.
+	const line_type l1( vertex_type( 0, 0, 0), c1);
+	const line_type l2( vertex_type( 1, 1, 1), c2);
+	BOOST_CHECK( are_parallel( l1, l2, tolerance));
+	BOOST_CHECK( are_parallel( compact_type( l1.dir()), c1, tolerance));
+}
+
+} // namespace
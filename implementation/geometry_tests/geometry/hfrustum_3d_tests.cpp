@@ -0,0 +1,205 @@
+#include "geometry/homogenous/frustum.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace
+{
+using namespace geometry;
+
+typedef hcoord_system< 3, float, algebra::unit_traits< float> > float_hcoord_system;
+typedef hcoord_system< 3, double, algebra::unit_traits< double> > double_hcoord_system;
+
+typedef boost::mpl::list< frustum< float_hcoord_system>, frustum< double_hcoord_system> > tested_frustums;
+
+// It creates the perspective projection with the near plane at distance 1, the far plane at distance 10 and the field 
+// of view of 90 degrees, both horizontal and vertical (OpenGL convention: the camera looks along -Z).
+template< typename F>
+F create_frustum()
+{
+	typedef typename F::transformation_type transformation;
+	typedef typename F::unit_type unit_type;
+	return F( transformation(
+		1, 0,                  0,                  0,
+		0, 1,                  0,                  0,
+		0, 0, unit_type(-11)/9, unit_type(-20)/9,
+		0, 0,                 -1,                  0));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_frustum_planes, F, tested_frustums)
+{
+	typedef typename F::plane_type plane;
+	typedef typename F::unit_type unit_type;
+	typedef typename F::unit_traits_type unit_traits_type;
+
+	F f = create_frustum< F>();
+
+	plane p = f.get_plane( F::NEAR_PLANE);
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.a());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.b());
+	ALGTEST_CHECK_EQUAL_UNIT( -1, p.c());
+	ALGTEST_CHECK_EQUAL_UNIT( -1, p.d());
+
+	p = f.get_plane( F::FAR_PLANE);
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.a());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.b());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, p.c());
+	ALGTEST_CHECK_EQUAL_UNIT( 10, p.d());
+
+	p = f.get_plane( F::LEFT_PLANE);
+	ALGTEST_CHECK_EQUAL_UNIT( std::sqrt( unit_type( 0.5)), p.a());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.b());
+	ALGTEST_CHECK_EQUAL_UNIT( -std::sqrt( unit_type( 0.5)), p.c());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.d());
+
+	p = f.get_plane( F::TOP_PLANE);
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.a());
+	ALGTEST_CHECK_EQUAL_UNIT( -std::sqrt( unit_type( 0.5)), p.b());
+	ALGTEST_CHECK_EQUAL_UNIT( -std::sqrt( unit_type( 0.5)), p.c());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, p.d());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_frustum_single_objects, F, tested_frustums)
+{
+	typedef typename F::vertex_type vertex;
+
+	F f = create_frustum< F>();
+
+	BOOST_CHECK( f.contains( vertex( 0, 0, -5)));
+	BOOST_CHECK( f.contains( vertex( 4, -4, -5)));
+	BOOST_CHECK( f.contains( vertex( 0, 0, -10, 2)));
+	BOOST_CHECK( !f.contains( vertex( 6, 0, -5)));
+	BOOST_CHECK( !f.contains( vertex( 0, 0, -0.5)));
+	BOOST_CHECK( !f.contains( vertex( 0, 0, -11)));
+
+	// Spheres
+	BOOST_CHECK_EQUAL( F::INSIDE, f.classify_sphere( vertex( 0, 0, -5), 1));
+	BOOST_CHECK_EQUAL( F::INTERSECTS, f.classify_sphere( vertex( 0, 0, -10), 1));
+	BOOST_CHECK_EQUAL( F::OUTSIDE, f.classify_sphere( vertex( 0, 20, -5), 1));
+
+	unsigned mask = F::ALL_PLANES, first = 0;
+	BOOST_CHECK_EQUAL( F::INTERSECTS, f.classify_sphere( vertex( 0, 0, -1.5), 1, mask, first));
+	BOOST_CHECK_EQUAL( unsigned( 1 << F::NEAR_PLANE), mask);
+
+	// Plane coherency: the rejecting plane is remembered.
+	mask = F::ALL_PLANES;
+	BOOST_CHECK_EQUAL( F::OUTSIDE, f.classify_sphere( vertex( 20, 0, -5), 1, mask, first));
+	BOOST_CHECK_EQUAL( unsigned( F::RIGHT_PLANE), first);
+
+	// Plane masking: the planes not in the mask are not tested.
+	mask = 1 << F::NEAR_PLANE;
+	BOOST_CHECK_EQUAL( F::INSIDE, f.classify_sphere( vertex( 20, 0, -5), 1, mask, first));
+	BOOST_CHECK_EQUAL( 0u, mask);
+
+	// Boxes
+	BOOST_CHECK_EQUAL( F::INSIDE, f.classify_box( vertex( -1, -1, -6), vertex( 1, 1, -4)));
+	BOOST_CHECK_EQUAL( F::INTERSECTS, f.classify_box( vertex( 4, -1, -6), vertex( 7, 1, -4)));
+	BOOST_CHECK_EQUAL( F::OUTSIDE, f.classify_box( vertex( -1, -1, -13), vertex( 1, 1, -11)));
+	BOOST_CHECK_EQUAL( F::INTERSECTS, f.classify_box( vertex( -100, -100, -100), vertex( 100, 100, 100)));
+
+	mask = F::ALL_PLANES;
+	first = 0;
+	BOOST_CHECK_EQUAL( F::OUTSIDE, f.classify_box( vertex( -1, 10, -6), vertex( 1, 12, -4), mask, first));
+	BOOST_CHECK_EQUAL( unsigned( F::TOP_PLANE), first);
+	mask = F::ALL_PLANES;
+	BOOST_CHECK_EQUAL( F::INTERSECTS, f.classify_box( vertex( -1, -1, -12), vertex( 1, 1, -9), mask, first));
+	BOOST_CHECK_EQUAL( unsigned( 1 << F::FAR_PLANE), mask);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_frustum_batched_culling, F, tested_frustums)
+{
+	typedef typename F::vertex_type vertex;
+	typedef typename F::unit_type unit_type;
+
+	F f = create_frustum< F>();
+
+	// 40 points along X axis, from -20 to 19, at the distance 5 from the camera. 
+	std::vector< vertex> points, max_corners;
+	std::vector< unit_type> radii;
+	for( int i = -20; i < 20; ++i)
+	{
+		points.push_back( vertex( i, 0, -5));
+		max_corners.push_back( vertex( i + 0.5, 0.5, -4.5));
+		radii.push_back( unit_type( 0.5));
+	}
+
+	boost::uint32_t visibility[2];
+	BOOST_CHECK_EQUAL( 11u, f.cull_points( points.begin(), points.end(), visibility));
+	for( unsigned i = 0; i < points.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( f.contains( points[i]), ((visibility[i / 32] >> (i % 32)) & 1) != 0);
+	}
+
+	// The spheres touching the side planes are visible too.
+	BOOST_CHECK_EQUAL( 11u, f.cull_spheres( points.begin(), points.end(), radii.begin(), visibility));
+	for( unsigned i = 0; i < points.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( 
+			f.classify_sphere( points[i], radii[i]) != F::OUTSIDE, 
+			((visibility[i / 32] >> (i % 32)) & 1) != 0);
+	}
+
+	BOOST_CHECK_EQUAL( 11u, f.cull_boxes( points.begin(), points.end(), max_corners.begin(), visibility));
+	for( unsigned i = 0; i < points.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( 
+			f.classify_box( points[i], max_corners[i]) != F::OUTSIDE, 
+			((visibility[i / 32] >> (i % 32)) & 1) != 0);
+	}
+
+	// Only the near and far planes are tested: all points are visible.
+	BOOST_CHECK_EQUAL( 40u, f.cull_points( points.begin(), points.end(), visibility, 
+		(1 << F::NEAR_PLANE) | (1 << F::FAR_PLANE)));
+	BOOST_CHECK_EQUAL( 0xFFFFFFFFu, visibility[0]);
+	BOOST_CHECK_EQUAL( 0xFFu, visibility[1]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_frustum_parallel_culling, F, tested_frustums)
+{
+	typedef typename F::vertex_type vertex;
+	typedef typename F::unit_type unit_type;
+
+	const F f = create_frustum< F>();
+	std::vector< vertex> points, max_corners;
+	std::vector< unit_type> radii;
+	for( int i = 0; i < 1000; ++i)
+	{
+		const unit_type x = unit_type( i % 41 - 20), y = unit_type( i % 13 - 6), z = unit_type( -(i % 15));
+		points.push_back( vertex( x, y, z));
+		max_corners.push_back( vertex( x + unit_type( 0.5), y + unit_type( 0.5), z + unit_type( 0.5)));
+		radii.push_back( unit_type( 0.5));
+	}
+
+	// The policies split the sequences in whole blocks, so the visibility words are the sequential ones.
+	parallel::thread_pool pool( 3);
+	const parallel::parallel_policy policy = parallel::par.on( pool).grain( 3);
+	std::vector< boost::uint32_t> expected( 32), obtained( 32);
+	const unsigned visible = f.cull_points( points.begin(), points.end(), &expected[0]);
+	BOOST_CHECK( visible > 0 && visible < points.size());
+	BOOST_CHECK_EQUAL( visible, f.cull_points( policy, points.begin(), points.end(), &obtained[0]));
+	BOOST_CHECK( expected == obtained);
+	BOOST_CHECK_EQUAL( visible, f.cull_points( parallel::seq, points.begin(), points.end(), &obtained[0]));
+
+	BOOST_CHECK_EQUAL( f.cull_spheres( points.begin(), points.end(), radii.begin(), &expected[0]),
+		f.cull_spheres( policy, points.begin(), points.end(), radii.begin(), &obtained[0]));
+	BOOST_CHECK( expected == obtained);
+
+	const unsigned mask = (1 << F::LEFT_PLANE) | (1 << F::NEAR_PLANE);
+	BOOST_CHECK_EQUAL( f.cull_boxes( points.begin(), points.end(), max_corners.begin(), &expected[0], mask),
+		f.cull_boxes( parallel::par_vec.on( pool).grain( 1), points.begin(), points.end(), max_corners.begin(),
+			&obtained[0], mask));
+	BOOST_CHECK( expected == obtained);
+}
+
+} // namespace
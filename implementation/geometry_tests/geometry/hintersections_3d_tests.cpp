@@ -1,13 +1,19 @@
 #include "geometry/homogenous/intersections.hpp"
+#include "geometry/homogenous/intersections_parallel.hpp"
 #include "geometry/homogenous/vertex.hpp"
 #include "geometry/homogenous/hcoord_system.hpp"
 #include "geometry/homogenous/direction.hpp"
 #include "geometry/homogenous/distances.hpp"
 #include "geometry/plane.hpp"
 #include "geometry/line.hpp"
+#include "geometry/ray.hpp"
+#include "geometry/segment.hpp"
 #include "../tests_common.hpp"
 #include "../test_traits.hpp"
+#include "algebra/epsilon_tolerance.hpp"
 #include <boost/mpl/list.hpp>
+#include <iterator>
+#include <vector>
 
 namespace
 {
@@ -32,6 +38,16 @@ typedef boost::mpl::list<
 		boost::mpl::pair< double_line, double_plane> > 
 	tested_planes;
 
+typedef boost::mpl::list<
+		boost::mpl::pair< ray< float_hcoord_system>, float_plane>,
+		boost::mpl::pair< ray< double_hcoord_system>, double_plane> > 
+	tested_rays;
+
+typedef boost::mpl::list<
+		boost::mpl::pair< segment< float_hcoord_system>, float_plane>,
+		boost::mpl::pair< segment< double_hcoord_system>, double_plane> > 
+	tested_segments;
+
 
 BOOST_AUTO_TEST_CASE_TEMPLATE( test_line_intersection, P, tested_lines)
 {
@@ -151,4 +167,256 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( test_plane_intersection, P, tested_planes)
 	ALGTEST_CHECK_INVALID_UNIT( dir.dz());
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_ray_plane_intersection, P, tested_rays)
+{
+	typedef typename P::first ray;
+	typedef typename P::second plane;
+	typedef typename ray::vertex_type vertex;
+	typedef typename ray::direction_type direction;
+	typedef typename ray::unit_type unit_type;
+	typedef typename ray::unit_traits_type unit_traits_type;
+
+	plane p( vertex( 1, 2, 3), direction( 0, 0, 1)); // plane parallel with XY
+
+	// Ray hitting the plane
+	ray r( vertex( 1, 1, 10, 2), direction( 0, 0, -1));
+	unit_type t = 0;
+	BOOST_CHECK( intersect( r, p, t));
+	ALGTEST_CHECK_EQUAL_UNIT( 2, t);
+	vertex v = intersect<vertex>( r, p);
+	ALGTEST_CHECK_EQUAL_UNIT( 0.5, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 0.5, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+
+	// Oblique ray
+	r = ray( vertex( 0, 0, 0), direction( 1, 0, 1));
+	v = intersect<vertex>( r, p);
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+
+	// Ray pointing away from the plane
+	r = ray( vertex( 1, 1, 10), direction( 0, 0, 1));
+	t = 100;
+	BOOST_CHECK( !intersect( r, p, t));
+	ALGTEST_CHECK_EQUAL_UNIT( 100, t);
+	v = intersect<vertex>( r, p);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+	ALGTEST_CHECK_INVALID_UNIT( v.y());
+	ALGTEST_CHECK_INVALID_UNIT( v.z());
+
+	// Ray parallel with the plane
+	r = ray( vertex( 1, 1, 10), direction( 1, 1, 0));
+	BOOST_CHECK( !intersect( r, p, t));
+	v = intersect<vertex>( r, p);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_ray_triangle_intersection, P, tested_rays)
+{
+	typedef typename P::first ray;
+	typedef typename ray::vertex_type vertex;
+	typedef typename ray::direction_type direction;
+	typedef typename ray::unit_type unit_type;
+	typedef typename ray::unit_traits_type unit_traits_type;
+
+	vertex v0( 0, 0, 5), v1( 4, 0, 5), v2( 0, 4, 5);
+
+	// Ray hitting the triangle inside
+	ray r( vertex( 1, 1, 0), direction( 0, 0, 1));
+	unit_type t = 0;
+	BOOST_CHECK( intersect( r, v0, v1, v2, t));
+	ALGTEST_CHECK_EQUAL_UNIT( 5, t);
+	vertex v = intersect( r, v0, v1, v2);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 5, v.z());
+
+	// The triangle is hit from the back side as well
+	r = ray( vertex( 1, 2, 10), direction( 0, 0, -1));
+	v = intersect( r, v0, v1, v2);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 5, v.z());
+
+	// Ray hitting the triangle plane outside the triangle
+	r = ray( vertex( 3, 3, 0), direction( 0, 0, 1));
+	BOOST_CHECK( !intersect( r, v0, v1, v2, t));
+	v = intersect( r, v0, v1, v2);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+
+	// Triangle behind the ray
+	r = ray( vertex( 1, 1, 0), direction( 0, 0, -1));
+	BOOST_CHECK( !intersect( r, v0, v1, v2, t));
+
+	// Ray parallel with the triangle
+	r = ray( vertex( 1, 1, 0), direction( 1, 0, 0));
+	BOOST_CHECK( !intersect( r, v0, v1, v2, t));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_segment_intersection, P, tested_segments)
+{
+	typedef typename P::first segment;
+	typedef typename P::second plane;
+	typedef typename segment::vertex_type vertex;
+	typedef geometry::direction< typename segment::coord_system> direction;
+	typedef typename segment::unit_type unit_type;
+	typedef typename segment::unit_traits_type unit_traits_type;
+
+	plane p( vertex( 1, 2, 3), direction( 0, 0, 1)); // plane parallel with XY
+
+	// Segment crossing the plane
+	segment s( vertex( 2, 2, 2), vertex( 2, 2, 6));
+	unit_type t = 0;
+	BOOST_CHECK( intersect( s, p, t));
+	ALGTEST_CHECK_EQUAL_UNIT( 0.25, t);
+	vertex v = intersect<vertex>( s, p);
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+
+	// Segment ending before the plane
+	s = segment( vertex( 2, 2, -2), vertex( 2, 2, 2));
+	BOOST_CHECK( !intersect( s, p, t));
+	v = intersect<vertex>( s, p);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+
+	// Segment crossing the triangle
+	vertex v0( 0, 0, 3), v1( 4, 0, 3), v2( 0, 4, 3);
+	s = segment( vertex( 1, 1, 4), vertex( 1, 1, 0));
+	BOOST_CHECK( intersect( s, v0, v1, v2, t));
+	ALGTEST_CHECK_EQUAL_UNIT( 0.25, t);
+	v = intersect( s, v0, v1, v2);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+
+	// Segment too short for reaching the triangle
+	s = segment( vertex( 1, 1, 10), vertex( 1, 1, 4));
+	BOOST_CHECK( !intersect( s, v0, v1, v2, t));
+	v = intersect( s, v0, v1, v2);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_three_planes_intersection, P, tested_planes)
+{
+	typedef typename P::second plane;
+	typedef typename P::first::vertex_type vertex;
+	typedef typename P::first::direction_type direction;
+	typedef typename plane::unit_type unit_type;
+	typedef typename plane::unit_traits_type unit_traits_type;
+
+	// Planes meeting in a single vertex
+	plane 
+		p1( vertex( 1, 2, 3), direction( 1, 0, 0)),
+		p2( vertex( 1, 2, 3), direction( 0, 1, 1)),
+		p3( vertex( 1, 2, 3), direction( 1, -2, 1));
+	vertex v = intersect<vertex>( p1, p2, p3);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+
+	// Same result when the plane coefficients are scaled
+	p2 = plane( 0, 1000, 1000, -5000);
+	v = intersect<vertex>( p1, p2, p3, algebra::epsilon_tolerance< unit_type>( unit_type( 1e-4)));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+
+	// Two parallel planes
+	p3 = plane( vertex( 4, 5, 6), direction( 1, 0, 0));
+	v = intersect<vertex>( p1, p2, p3);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+	ALGTEST_CHECK_INVALID_UNIT( v.y());
+	ALGTEST_CHECK_INVALID_UNIT( v.z());
+
+	// Planes sharing a common line (the normals are coplanar)
+	p3 = plane( vertex( 1, 2, 3), direction( 1, 1, 1));
+	v = intersect<vertex>( p1, p2, p3);
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+
+	// Almost degenerate planes, accepted by the default check and rejected by a large tolerance.
+	p3 = plane( vertex( 1, 2, 3), direction( 1, unit_type( 1.1), 1));
+	v = intersect<vertex>( p1, p2, p3);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v.z());
+	v = intersect<vertex>( p1, p2, p3, algebra::epsilon_tolerance< unit_type>( unit_type( 0.1)));
+	ALGTEST_CHECK_INVALID_UNIT( v.x());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_batched_three_planes_intersection, P, tested_planes)
+{
+	typedef typename P::second plane;
+	typedef typename P::first::vertex_type vertex;
+	typedef typename P::first::direction_type direction;
+	typedef typename plane::unit_type unit_type;
+	typedef typename plane::unit_traits_type unit_traits_type;
+
+	std::vector< plane> p1, p2, p3;
+	for( int i = 0; i < 5; ++i)
+	{
+		vertex common( i, 2*i, -i);
+		p1.push_back( plane( common, direction( 1, 0, 0)));
+		p2.push_back( plane( common, direction( 0, 1, 0)));
+		// The last triple has parallel planes.
+		p3.push_back( plane( common, i < 4 ? direction( 0, 0, 1) : direction( 1, 0, 0)));
+	}
+
+	std::vector< vertex> result( p1.size());
+	typename std::vector< vertex>::iterator end = intersect<vertex>( 
+		p1.begin(), p1.end(), p2.begin(), p3.begin(), result.begin(), 
+		algebra::epsilon_tolerance< unit_type>( unit_type( 1e-4)));
+	BOOST_CHECK( end == result.end());
+	for( int i = 0; i < 4; ++i)
+	{
+		ALGTEST_CHECK_EQUAL_UNIT( i, result[i].x());
+		ALGTEST_CHECK_EQUAL_UNIT( 2*i, result[i].y());
+		ALGTEST_CHECK_EQUAL_UNIT( -i, result[i].z());
+	}
+	ALGTEST_CHECK_INVALID_UNIT( result[4].x());
+
+	std::vector< vertex> defaults;
+	intersect<vertex>( p1.begin(), p1.end(), p2.begin(), p3.begin(), std::back_inserter( defaults));
+	BOOST_CHECK_EQUAL( result.size(), defaults.size());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, defaults[3].x());
+	ALGTEST_CHECK_INVALID_UNIT( defaults[4].x());
+
+	// Parallel intersection.
+	for( int i = 5; i < 1000; ++i)
+	{
+		vertex common( i % 10, 2, -(i % 7));
+		p1.push_back( plane( common, direction( 1, 0, 0)));
+		p2.push_back( plane( common, direction( 0, 1, 0)));
+		p3.push_back( plane( common, direction( 0, 1, i % 3)));
+	}
+	parallel::thread_pool pool( 3);
+	const parallel::parallel_policy policy = parallel::par.on( pool).grain( 10);
+	std::vector< vertex> sequential( p1.size()), tolerant( p1.size()), exact( p1.size());
+	intersect<vertex>( p1.begin(), p1.end(), p2.begin(), p3.begin(), sequential.begin());
+	BOOST_CHECK( intersect<vertex>( policy, p1.begin(), p1.end(), p2.begin(), p3.begin(), tolerant.begin(),
+		algebra::epsilon_tolerance< unit_type>( unit_type( 1e-4))) == tolerant.end());
+	BOOST_CHECK( intersect<vertex>( policy, p1.begin(), p1.end(), p2.begin(), p3.begin(), exact.begin()) == exact.end());
+	for( std::size_t i = 0; i < p1.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( sequential[i].is_valid(), exact[i].is_valid());
+		BOOST_CHECK_EQUAL( sequential[i].is_valid(), tolerant[i].is_valid());
+		if( sequential[i].is_valid())
+		{
+			BOOST_CHECK_EQUAL( sequential[i].x(), exact[i].x());
+			BOOST_CHECK_EQUAL( sequential[i].z(), tolerant[i].z());
+		}
+	}
+}
+
 } // namespace
@@ -0,0 +1,94 @@
+#include "geometry/homogenous/projection.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <boost/cstdint.hpp>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+using namespace geometry;
+
+typedef hcoord_system< 3, float, algebra::unit_traits< float> > float_hcoord_system;
+typedef hcoord_system< 3, double, algebra::unit_traits< double> > double_hcoord_system;
+
+typedef boost::mpl::list< 
+		transformation< float_hcoord_system>, 
+		transformation< double_hcoord_system> > 
+	tested_transforms;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_batched_projection, T, tested_transforms)
+{
+	typedef T transform_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef typename transform_type::unit_traits_type unit_traits_type;
+	typedef vertex< coord_system> vertex_type;
+
+	transform_type proj( transform_type::perspective( -1, 1, -1, 1, 1, 10));
+
+	// 50 vertices on the line x = y, at the distance 2 from the camera; the visible ones are in range [-2, 2].
+	std::vector< vertex_type> vertices;
+	for( int i = 0; i < 50; ++i)
+	{
+		unit_type coord = unit_type( i - 25) / 4;
+		vertices.push_back( vertex_type( coord, coord, -2));
+	}
+	// A vertex behind the camera, which would have the screen coordinates inside the screen.
+	vertices.push_back( vertex_type( 0, 0, 2));
+
+	std::vector< unit_type> screen( 3 * vertices.size());
+	boost::uint32_t visibility[2];
+	unsigned visible = project( proj, vertices.begin(), vertices.end(), unit_type( 800), unit_type( 600), 
+		&screen[0], visibility);
+	BOOST_CHECK_EQUAL( 17u, visible);
+
+	for( unsigned i = 0; i < vertices.size(); ++i)
+	{
+		vertex_type v = vertices[i];
+		v.transform( proj);
+		bool expected_visible = 
+			std::abs( v.x()) <= 1 && std::abs( v.y()) <= 1 && std::abs( v.z()) <= 1 && v.w() > 0;
+		BOOST_CHECK_EQUAL( expected_visible, ((visibility[i / 32] >> (i % 32)) & 1) != 0);
+		if( expected_visible)
+		{
+			ALGTEST_CHECK_EQUAL_UNIT( (v.x() + 1) * 400, screen[3*i]);
+			ALGTEST_CHECK_EQUAL_UNIT( (v.y() + 1) * 300, screen[3*i + 1]);
+			ALGTEST_CHECK_EQUAL_UNIT( (v.z() + 1) / 2, screen[3*i + 2]);
+		}
+	}
+
+	// The center of the view is projected in the center of the screen.
+	ALGTEST_CHECK_EQUAL_UNIT( 400, screen[3*25]);
+	ALGTEST_CHECK_EQUAL_UNIT( 300, screen[3*25 + 1]);
+	BOOST_CHECK( ((visibility[1] >> 18) & 1) == 0);
+
+	// The parallel projection gives the same results.
+	for( int i = 0; i < 2000; ++i)
+	{
+		vertices.push_back( vertex_type( unit_type( i % 9 - 4), unit_type( i % 7 - 3), -unit_type( i % 12)));
+	}
+	parallel::thread_pool pool( 3);
+	std::vector< unit_type> expected_screen( 3 * vertices.size()), parallel_screen( 3 * vertices.size());
+	std::vector< boost::uint32_t> expected_visibility( 64), parallel_visibility( 64);
+	BOOST_CHECK_EQUAL(
+		project( proj, vertices.begin(), vertices.end(), unit_type( 800), unit_type( 600), &expected_screen[0],
+			&expected_visibility[0]),
+		project( parallel::par.on( pool).grain( 3), proj, vertices.begin(), vertices.end(), unit_type( 800),
+			unit_type( 600), &parallel_screen[0], &parallel_visibility[0]));
+	BOOST_CHECK( expected_visibility == parallel_visibility);
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		if( ((expected_visibility[i / 32] >> (i % 32)) & 1) != 0)
+		{
+			BOOST_CHECK_EQUAL( expected_screen[3*i], parallel_screen[3*i]);
+			BOOST_CHECK_EQUAL( expected_screen[3*i + 2], parallel_screen[3*i + 2]);
+		}
+	}
+}
+
+} // namespace
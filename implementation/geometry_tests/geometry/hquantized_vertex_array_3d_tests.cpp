@@ -0,0 +1,124 @@
+#include "geometry/homogenous/quantized_vertex_array.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <boost/mpl/int.hpp>
+#include <vector>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef hcoord_system< 3, float> hcoord_system_float;
+typedef hcoord_system< 3, double> hcoord_system_double;
+
+typedef boost::mpl::list<
+	boost::mpl::pair< hcoord_system_float, boost::mpl::int_< 16> >,
+	boost::mpl::pair< hcoord_system_double, boost::mpl::int_< 16> >,
+	boost::mpl::pair< hcoord_system_double, boost::mpl::int_< 21> > > tested_types;
+
+BOOST_AUTO_TEST_CASE( test_quantized_size)
+{
+	BOOST_CHECK_EQUAL( 6, (quantized_vertex_array< hcoord_system_double, 16>::BYTES_PER_VERTEX));
+	BOOST_CHECK_EQUAL( 8, (quantized_vertex_array< hcoord_system_double, 21>::BYTES_PER_VERTEX));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_quantized_round_trip, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	typedef quantized_vertex_array< coord_system, P::second::value> array_type;
+	typedef vertex< coord_system> vertex_type;
+
+	const std::vector< vertex_type> vertices = sample_vertices< vertex_type>( 500, 10, 20);
+	const array_type array = array_type::bounding( vertices.begin(), vertices.end());
+	BOOST_REQUIRE_EQUAL( vertices.size(), array.size());
+	// Half of the step, plus the rounding errors of the unit type.
+	const unit_type rounding = 64 * std::numeric_limits< unit_type>::epsilon();
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		const vertex_type v = array[i];
+		BOOST_CHECK( std::abs( v.x() - vertices[i].x()) <= array.step( 0) / 2 + rounding);
+		BOOST_CHECK( std::abs( v.y() - vertices[i].y()) <= array.step( 1) / 2 + rounding);
+		BOOST_CHECK( std::abs( v.z() - vertices[i].z()) <= array.step( 2) / 2 + rounding);
+	}
+
+	// The vertices outside the box are clamped.
+	array_type box( vertex_type( 0, 0, 0), vertex_type( 1, 2, 4));
+	box.push_back( vertex_type( -1, 3, 2));
+	box.push_back( 1, 2, 4);
+	BOOST_CHECK_EQUAL( unit_type( 0), box[0].x());
+	BOOST_CHECK_CLOSE( unit_type( 2), box[0].y(), unit_type( 1e-4));
+	BOOST_CHECK_CLOSE( unit_type( 2), box[0].z(), unit_type( 1e-2));
+	BOOST_CHECK_CLOSE( unit_type( 1), box[1].x(), unit_type( 1e-4));
+	BOOST_CHECK_CLOSE( unit_type( 4), box[1].z(), unit_type( 1e-4));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_quantized_decode, P, tested_types)
+{
+	typedef typename P::first coord_system;
+	typedef typename coord_system::unit_type unit_type;
+	typedef quantized_vertex_array< coord_system, P::second::value> array_type;
+	typedef vertex< coord_system> vertex_type;
+	typedef transformation< coord_system> transform_type;
+
+	const std::vector< vertex_type> vertices = sample_vertices< vertex_type>( 100, 10, 20);
+	const array_type array = array_type::bounding( vertices.begin(), vertices.end());
+
+	// Decoding a range which doesn't start at a block boundary.
+	const std::size_t first = 3, count = 90;
+	std::vector< float> fx( count), fy( count), fz( count);
+	std::vector< double> dx( count), dy( count), dz( count);
+	array.decode( first, count, &fx[0], &fy[0], &fz[0]);
+	array.decode( first, count, &dx[0], &dy[0], &dz[0]);
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		const vertex_type v = array[first + i];
+		BOOST_CHECK_CLOSE( double( v.x()), dx[i], 1e-4);
+		BOOST_CHECK_CLOSE( double( v.y()), dy[i], 1e-4);
+		BOOST_CHECK_CLOSE( double( v.z()), dz[i], 1e-4);
+		BOOST_CHECK_SMALL( float( v.x()) - fx[i], 1e-4f);
+		BOOST_CHECK_SMALL( float( v.y()) - fy[i], 1e-4f);
+		BOOST_CHECK_SMALL( float( v.z()) - fz[i], 1e-4f);
+	}
+
+	// Affine transformation folded in the dequantization.
+	const transform_type affine( 
+		transform_type::translation( 1, 2, 3).tr_matrix() 
+			* transform_type::template rotation< 2>( unit_type( 0.7)).tr_matrix()
+			* transform_type::scaling( 2).tr_matrix());
+	std::vector< double> tx( count), ty( count), tz( count);
+	array.decode( affine, first, count, &tx[0], &ty[0], &tz[0]);
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		const vertex_type v = array[first + i].transformed( affine);
+		BOOST_CHECK_SMALL( double( v.x()) - tx[i], 1e-3);
+		BOOST_CHECK_SMALL( double( v.y()) - ty[i], 1e-3);
+		BOOST_CHECK_SMALL( double( v.z()) - tz[i], 1e-3);
+	}
+
+	// Perspective transformation: the coordinates are divided by the weight coordinate.
+	const transform_type projection( 
+		transform_type::perspective( -1, 1, -1, 1, 1, 100).tr_matrix() 
+			* transform_type::translation( 0, 0, -50).tr_matrix());
+	array.decode( projection, first, count, &tx[0], &ty[0], &tz[0]);
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		const vertex_type v = array[first + i].transformed( projection);
+		BOOST_CHECK_SMALL( double( v.x()) - tx[i], 1e-4);
+		BOOST_CHECK_SMALL( double( v.y()) - ty[i], 1e-4);
+		BOOST_CHECK_SMALL( double( v.z()) - tz[i], 1e-4);
+	}
+}
+
+} // namespace
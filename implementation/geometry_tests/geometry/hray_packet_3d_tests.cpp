@@ -0,0 +1,144 @@
+#include "geometry/homogenous/intersections.hpp"
+#include "geometry/homogenous/ray_packet.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/plane.hpp"
+#include "geometry/ray.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <vector>
+
+namespace
+{
+using namespace geometry;
+
+typedef hcoord_system< 3, float, algebra::unit_traits< float> > float_hcoord_system;
+typedef hcoord_system< 3, double, algebra::unit_traits< double> > double_hcoord_system;
+
+typedef boost::mpl::list< 
+		ray_packet< float_hcoord_system, 4>, 
+		ray_packet< float_hcoord_system, 8>, 
+		ray_packet< double_hcoord_system, 4>,
+		ray_packet< double_hcoord_system, 8> >
+	tested_packets;
+
+// It creates N rays, starting from (i, i, 0). The odd rays go up along Z axis, the even ones go down.
+template< typename R>
+std::vector< R> create_rays( unsigned n)
+{
+	typedef typename R::vertex_type vertex;
+	typedef typename R::direction_type direction;
+	std::vector< R> rays;
+	for( unsigned i = 0; i < n; ++i)
+	{
+		rays.push_back( R( vertex( 0.25 * i, 0.25 * i, 0), direction( 0, 0, (i % 2) ? 1 : -1)));
+	}
+	return rays;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_packet_initialization, P, tested_packets)
+{
+	typedef P packet;
+	typedef typename packet::ray_type ray;
+	typedef typename packet::unit_type unit_type;
+	typedef typename packet::unit_traits_type unit_traits_type;
+
+	std::vector< ray> rays = create_rays< ray>( packet::SIZE);
+	packet rp( rays.begin());
+	for( unsigned i = 0; i < packet::SIZE; ++i)
+	{
+		ALGTEST_CHECK_EQUAL_UNIT( rays[i].origin().x(), rp.x()[i]);
+		ALGTEST_CHECK_EQUAL_UNIT( rays[i].origin().y(), rp.y()[i]);
+		ALGTEST_CHECK_EQUAL_UNIT( rays[i].origin().z(), rp.z()[i]);
+		ALGTEST_CHECK_EQUAL_UNIT( rays[i].dir().dz(), rp.dz()[i]);
+		ray r = rp.get( i);
+		ALGTEST_CHECK_EQUAL_UNIT( rays[i].origin().x(), r.origin().x());
+		ALGTEST_CHECK_EQUAL_UNIT( rays[i].dir().dz(), r.dir().dz());
+	}
+
+	// Origins with weight coordinate are stored normalized.
+	rp.set( 0, ray( typename ray::vertex_type( 2, 4, 6, 2), typename ray::direction_type( 1, 0, 0)));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, rp.x()[0]);
+	ALGTEST_CHECK_EQUAL_UNIT( 2, rp.y()[0]);
+	ALGTEST_CHECK_EQUAL_UNIT( 3, rp.z()[0]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_packet_plane_intersection, P, tested_packets)
+{
+	typedef P packet;
+	typedef typename packet::ray_type ray;
+	typedef typename packet::coord_system coord_system;
+	typedef typename packet::unit_type unit_type;
+	typedef typename packet::unit_traits_type unit_traits_type;
+	typedef typename ray::vertex_type vertex;
+	typedef typename ray::direction_type direction;
+	typedef plane< coord_system> plane;
+
+	std::vector< ray> rays = create_rays< ray>( packet::SIZE);
+	packet rp( rays.begin());
+	plane p( vertex( 0, 0, 2), direction( 0, 0, 1));
+
+	unit_type t[ packet::SIZE];
+	unsigned mask = intersect( rp, p, t);
+	for( unsigned i = 0; i < packet::SIZE; ++i)
+	{
+		// The packet result must be the same as the single ray result.
+		unit_type expected_t = 0;
+		bool expected_hit = intersect( rays[i], p, expected_t);
+		BOOST_CHECK_EQUAL( expected_hit, ((mask >> i) & 1) != 0);
+		BOOST_CHECK_EQUAL( (i % 2) != 0, expected_hit);
+		if( expected_hit)
+		{
+			ALGTEST_CHECK_EQUAL_UNIT( expected_t, t[i]);
+		}
+		else
+		{
+			ALGTEST_CHECK_INVALID_UNIT( t[i]);
+		}
+	}
+
+	// Plane parallel with all rays.
+	p = plane( vertex( 0, 0, 0), direction( 1, -1, 0));
+	BOOST_CHECK_EQUAL( 0u, intersect( rp, p, t));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_packet_triangle_intersection, P, tested_packets)
+{
+	typedef P packet;
+	typedef typename packet::ray_type ray;
+	typedef typename packet::unit_type unit_type;
+	typedef typename packet::unit_traits_type unit_traits_type;
+	typedef typename ray::vertex_type vertex;
+
+	std::vector< ray> rays = create_rays< ray>( packet::SIZE);
+	packet rp( rays.begin());
+	vertex v0( -1, -1, 3), v1( 1.6, -1, 3), v2( -1, 1.6, 3);
+
+	unit_type t[ packet::SIZE];
+	unsigned mask = intersect( rp, v0, v1, v2, t);
+	for( unsigned i = 0; i < packet::SIZE; ++i)
+	{
+		// The packet result must be the same as the single ray result.
+		unit_type expected_t = 0;
+		bool expected_hit = intersect( rays[i], v0, v1, v2, expected_t);
+		BOOST_CHECK_EQUAL( expected_hit, ((mask >> i) & 1) != 0);
+		if( expected_hit)
+		{
+			ALGTEST_CHECK_EQUAL_UNIT( expected_t, t[i]);
+		}
+		else
+		{
+			ALGTEST_CHECK_INVALID_UNIT( t[i]);
+		}
+	}
+	// Only the rays going up, with the origin inside the triangle projection (x + y <= 0.6) hit the triangle.
+	BOOST_CHECK_EQUAL( 2u, mask);
+}
+
+} // namespace
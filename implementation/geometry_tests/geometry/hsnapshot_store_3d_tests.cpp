@@ -0,0 +1,136 @@
+#include "geometry/homogenous/snapshot_store.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef boost::mpl::list< hcoord_system< 3, float>, hcoord_system< 3, double> > tested_types;
+
+/// \brief It reads snapshots while the writer publishes new versions, checking that each snapshot is consistent.
+/// \details In the version \c k there are <c>100 k</c> vertices; the vertex \c i has the X coordinate \c i and the Y
+///		coordinate \c k, and the first plane has the D coefficient \c k.
+template< typename CS>
+void read_snapshots( const snapshot_store< CS>* store, std::size_t last_version, bool* consistent)
+{
+	typedef typename CS::unit_type unit_type;
+	std::size_t version = 0;
+	while( version < last_version)
+	{
+		const typename snapshot_store< CS>::snapshot_pointer snapshot = store->snapshot();
+		if( snapshot->version < version || snapshot->vertices.size() != 100 * snapshot->version)
+		{
+			*consistent = false;
+			return;
+		}
+		version = snapshot->version;
+		for( std::size_t i = 0; i < snapshot->vertices.size(); i += 37)
+		{
+			if( snapshot->vertices[i].x() != unit_type( i) || snapshot->vertices[i].y() != unit_type( version))
+			{
+				*consistent = false;
+				return;
+			}
+		}
+		if( version > 0 && snapshot->planes[0].d() != unit_type( version))
+		{
+			*consistent = false;
+			return;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_structural_sharing, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef snapshot_store< CS> store_type;
+	typedef typename store_type::snapshot_type snapshot_type;
+
+	store_type store;
+	BOOST_CHECK_EQUAL( std::size_t( 0), store.snapshot()->version);
+	for( unsigned i = 0; i < 3000; ++i)
+	{
+		store.next().vertices.push_back( vertex< CS>( unit_type( i), 0, 0));
+	}
+	store.next().lines.push_back( line< CS>( vertex< CS>( 0, 0, 0), direction< CS>( 1, 0, 0)));
+	store.next().planes.push_back( plane< CS>( 0, 0, 1, -2));
+	const typename store_type::snapshot_pointer first = store.publish();
+	BOOST_CHECK_EQUAL( std::size_t( 1), first->version);
+	BOOST_CHECK_EQUAL( first, store.snapshot());
+	BOOST_CHECK_EQUAL( std::size_t( 3), first->vertices.chunk_count());
+
+	// Changing a vertex copies only its chunk.
+	store.next().vertices.set( 1500, vertex< CS>( -1, -1, -1));
+	const snapshot_type& next = store.next();
+	BOOST_CHECK( next.vertices.shares_chunk( first->vertices, 0));
+	BOOST_CHECK( !next.vertices.shares_chunk( first->vertices, 1));
+	BOOST_CHECK( next.vertices.shares_chunk( first->vertices, 2));
+	BOOST_CHECK( next.planes.shares_chunk( first->planes, 0));
+	BOOST_CHECK_EQUAL( unit_type( 1500), first->vertices[1500].x());
+	BOOST_CHECK_EQUAL( unit_type( -1), next.vertices[1500].x());
+
+	// The published version doesn't see the changes.
+	store.next().vertices.push_back( vertex< CS>( 5, 5, 5));
+	BOOST_CHECK_EQUAL( std::size_t( 3000), store.snapshot()->vertices.size());
+	const typename store_type::snapshot_pointer second = store.publish();
+	BOOST_CHECK_EQUAL( std::size_t( 2), second->version);
+	BOOST_CHECK_EQUAL( std::size_t( 3001), second->vertices.size());
+	BOOST_CHECK_EQUAL( std::size_t( 3000), first->vertices.size());
+	BOOST_CHECK_EQUAL( unit_type( 1500), first->vertices[1500].x());
+
+	store.next().vertices.clear();
+	store.discard();
+	BOOST_CHECK_EQUAL( std::size_t( 3001), store.next().vertices.size());
+	store.next().vertices.pop_back();
+	BOOST_CHECK_EQUAL( std::size_t( 3000), store.next().vertices.size());
+	BOOST_CHECK_EQUAL( std::size_t( 3001), store.snapshot()->vertices.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_concurrent_readers, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+
+	const std::size_t LAST_VERSION = 60;
+	snapshot_store< CS> store;
+	bool consistent[3] = { true, true, true };
+	boost::thread_group readers;
+	for( int r = 0; r < 3; ++r)
+	{
+		readers.create_thread( boost::bind( &read_snapshots< CS>, &store, LAST_VERSION, &consistent[r]));
+	}
+
+	for( std::size_t version = 1; version <= LAST_VERSION; ++version)
+	{
+		typename snapshot_store< CS>::snapshot_type& next = store.next();
+		for( std::size_t i = 0; i < next.vertices.size(); ++i)
+		{
+			next.vertices.set( i, vertex< CS>( unit_type( i), unit_type( version), 0));
+		}
+		for( std::size_t i = 0; i < 100; ++i)
+		{
+			next.vertices.push_back( vertex< CS>( unit_type( next.vertices.size()), unit_type( version), 0));
+		}
+		if( next.planes.empty())
+		{
+			next.planes.push_back( plane< CS>());
+		}
+		next.planes.set( 0, plane< CS>( 0, 0, 1, unit_type( version)));
+		store.publish();
+	}
+	readers.join_all();
+	for( int r = 0; r < 3; ++r)
+	{
+		BOOST_CHECK( consistent[r]);
+	}
+}
+
+} // namespace
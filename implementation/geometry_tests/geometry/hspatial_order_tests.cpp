@@ -0,0 +1,172 @@
+#include "geometry/spatial_order.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef boost::mpl::list<
+	vertex< hcoord_system< 2, float> >,
+	vertex< hcoord_system< 2, double> >,
+	vertex< hcoord_system< 3, float> >,
+	vertex< hcoord_system< 3, double> > > tested_types;
+
+/// \brief It checks that the cells of a grid of side 2^level are visited along the Hilbert curve one after the other,
+///		moving each time to an adjacent cell.
+template< unsigned D>
+void check_hilbert_adjacency( unsigned level)
+{
+	const boost::uint32_t side = 1U << level;
+	std::size_t cells = 1;
+	for( unsigned i = 0; i < D; ++i)
+	{
+		cells *= side;
+	}
+	std::vector< std::pair< boost::uint64_t, std::vector< boost::uint32_t> > > keyed;
+	for( std::size_t c = 0; c < cells; ++c)
+	{
+		std::vector< boost::uint32_t> cell( D);
+		std::size_t rest = c;
+		for( unsigned i = 0; i < D; ++i, rest /= side)
+		{
+			cell[i] = static_cast< boost::uint32_t>( rest % side);
+		}
+		keyed.push_back( std::make_pair( impl::hilbert_key< D>( &cell[0]), cell));
+	}
+	std::sort( keyed.begin(), keyed.end());
+	for( std::size_t c = 0; c < cells; ++c)
+	{
+		// The curve starts at origin, so the cells of the grid are the first ones along the curve.
+		BOOST_CHECK_EQUAL( c, keyed[c].first);
+		if( c == 0)
+		{
+			continue;
+		}
+		unsigned distance = 0;
+		for( unsigned i = 0; i < D; ++i)
+		{
+			distance += std::abs( int( keyed[c].second[i]) - int( keyed[c-1].second[i]));
+		}
+		BOOST_CHECK_EQUAL( 1U, distance);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( test_morton_keys)
+{
+	const boost::uint32_t x2[2] = { 1, 0 }, y2[2] = { 0, 1 }, xy2[2] = { 3, 3 };
+	BOOST_CHECK_EQUAL( 1U, impl::curve_keys< 2>::morton( x2));
+	BOOST_CHECK_EQUAL( 2U, impl::curve_keys< 2>::morton( y2));
+	BOOST_CHECK_EQUAL( 15U, impl::curve_keys< 2>::morton( xy2));
+
+	const boost::uint32_t x3[3] = { 2, 0, 0 }, z3[3] = { 0, 0, 1 }, xyz3[3] = { 1, 1, 1 };
+	BOOST_CHECK_EQUAL( 8U, impl::curve_keys< 3>::morton( x3));
+	BOOST_CHECK_EQUAL( 4U, impl::curve_keys< 3>::morton( z3));
+	BOOST_CHECK_EQUAL( 7U, impl::curve_keys< 3>::morton( xyz3));
+
+	const boost::uint32_t max3[3] = { 0x1FFFFF, 0x1FFFFF, 0x1FFFFF };
+	BOOST_CHECK( impl::curve_keys< 3>::morton( max3) == 0x7FFFFFFFFFFFFFFFULL);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_hilbert_keys)
+{
+	check_hilbert_adjacency< 2>( 4);
+	check_hilbert_adjacency< 3>( 3);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_sort_permutation)
+{
+	const std::size_t count = 20000;
+	std::vector< boost::uint64_t> keys( count);
+	boost::uint64_t seed = 12345;
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+		// Few distinct high values, so that the stability is checked too.
+		keys[i] = (seed >> 40) & 0xFF0000FFULL;
+	}
+	std::vector< std::pair< boost::uint64_t, std::size_t> > expected;
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		expected.push_back( std::make_pair( keys[i], i));
+	}
+	std::sort( expected.begin(), expected.end());
+
+	parallel::thread_pool pool( 3);
+	std::vector< std::size_t> permutations[2];
+	sort_permutation( &keys[0], count, permutations[0]);
+	sort_permutation( parallel::par.on( pool), &keys[0], count, permutations[1]);
+	for( unsigned t = 0; t < 2; ++t)
+	{
+		BOOST_REQUIRE_EQUAL( count, permutations[t].size());
+		for( std::size_t i = 0; i < count; ++i)
+		{
+			BOOST_CHECK_EQUAL( expected[i].second, permutations[t][i]);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_spatial_order, V, tested_types)
+{
+	typedef V vertex_type;
+	typedef typename vertex_type::unit_type unit_type;
+
+	const std::size_t count = 1000;
+	const std::vector< vertex_type> vertices = sample_vertices< vertex_type>( count, 0, 50);
+	std::vector< int> attributes;
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		attributes.push_back( int( i));
+	}
+
+	parallel::thread_pool pool( 2);
+	const space_filling_curve curves[] = { MORTON_CURVE, HILBERT_CURVE };
+	for( unsigned c = 0; c < 2; ++c)
+	{
+		std::vector< std::size_t> permutation;
+		spatial_order( parallel::par.on( pool), vertices.begin(), vertices.end(), curves[c], permutation);
+		BOOST_REQUIRE_EQUAL( count, permutation.size());
+		std::vector< std::size_t> sequential_permutation;
+		spatial_order( vertices.begin(), vertices.end(), curves[c], sequential_permutation);
+		BOOST_CHECK( permutation == sequential_permutation);
+
+		std::vector< vertex_type> ordered( vertices);
+		std::vector< int> ordered_attributes( attributes);
+		permute( ordered.begin(), permutation);
+		permute( ordered_attributes.begin(), permutation);
+
+		std::vector< boost::uint64_t> keys( count);
+		spatial_keys( ordered.begin(), ordered.end(), curves[c], &keys[0]);
+		std::vector< std::size_t> inverse;
+		inverse_permutation( permutation, inverse);
+		for( std::size_t i = 0; i < count; ++i)
+		{
+			if( i > 0)
+			{
+				BOOST_CHECK( keys[i-1] <= keys[i]);
+			}
+			BOOST_CHECK_EQUAL( int( permutation[i]), ordered_attributes[i]);
+			ALGTEST_CHECK_EQUAL_UNIT( vertices[permutation[i]].x(), ordered[i].x());
+			ALGTEST_CHECK_EQUAL_UNIT( vertices[permutation[i]].y(), ordered[i].y());
+			// The remapped index of a vertex gives its new position.
+			BOOST_CHECK_EQUAL( i, inverse[permutation[i]]);
+		}
+	}
+}
+
+} // namespace
@@ -3,9 +3,15 @@
 #include "geometry/homogenous/vertex.hpp"
 #include "geometry/line.hpp"
 #include "geometry/homogenous/direction.hpp"
+#include "geometry/homogenous/transforms.hpp"
+#include "geometry/homogenous/cached_transformation.hpp"
+#include "geometry/homogenous/distances.hpp"
+#include "geometry/plane.hpp"
 #include "../tests_common.hpp"
 #include "../test_traits.hpp"
 #include <boost/mpl/list.hpp>
+#include <iterator>
+#include <vector>
 
 namespace
 {
@@ -70,4 +76,303 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( test_scaling, P, tested_types)
 	ALGTEST_CHECK_EQUAL_UNIT( 130, v4.z());
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_projections, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename P::second vertex_type;
+	typedef typename transform_type::unit_type unit_type;
+	const unit_type pi = unit_type( 3.14159265358979323846);
+
+	// The corners of the view volume are mapped to the corners of the normalized device coordinates cube.
+	transform_type t1( transform_type::perspective( -2, 2, -1, 1, 1, 10));
+	vertex_type v1( -2, -1, -1);
+	v1.transform( t1);
+	ALGTEST_CHECK_EQUAL_UNIT( -1, v1.x());
+	ALGTEST_CHECK_EQUAL_UNIT( -1, v1.y());
+	ALGTEST_CHECK_EQUAL_UNIT( -1, v1.z());
+	vertex_type v2( 20, 10, -10);
+	v2.transform( t1);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v2.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v2.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v2.z());
+
+	// Symmetric perspective: 90 degrees vertical field of view, twice wider than higher.
+	transform_type t2( transform_type::perspective( pi/2, 2, 1, 10));
+	vertex_type v3( 10, -5, -5);
+	v3.transform( t2);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v3.x());
+	ALGTEST_CHECK_EQUAL_UNIT( -1, v3.y());
+	ALGTEST_CHECK_EQUAL_UNIT( unit_type( 7)/9, v3.z());
+
+	// Orthographic projection
+	transform_type t3( transform_type::orthographic( 0, 10, 0, 20, 1, 5));
+	vertex_type v4( 0, 20, -1);
+	v4.transform( t3);
+	ALGTEST_CHECK_EQUAL_UNIT( -1, v4.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v4.y());
+	ALGTEST_CHECK_EQUAL_UNIT( -1, v4.z());
+	vertex_type v5( 5, 5, -4);
+	v5.transform( t3);
+	ALGTEST_CHECK_EQUAL_UNIT( 0, v5.x());
+	ALGTEST_CHECK_EQUAL_UNIT( -0.5, v5.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 0.5, v5.z());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_direction_transform, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef direction< coord_system> direction_type;
+	const unit_type pi = unit_type( 3.14159265358979323846);
+
+	// The translation doesn't change the directions.
+	transform_type t1( transform_type::translation( 10, 20, 30));
+	direction_type d1( 1, 2, 3);
+	direction_type d2 = d1.transformed( t1);
+	ALGTEST_CHECK_EQUAL_UNIT( d1.dx(), d2.dx());
+	ALGTEST_CHECK_EQUAL_UNIT( d1.dy(), d2.dy());
+	ALGTEST_CHECK_EQUAL_UNIT( d1.dz(), d2.dz());
+
+	// Rotation around Z with 90 degrees, combined with translation
+	transform_type t2( t1.tr_matrix() * transform_type::template rotation<3>( pi/2).tr_matrix());
+	direction_type d3( 1, 0, 0);
+	d3.transform( t2);
+	ALGTEST_CHECK_SMALL( d3.dx());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, d3.dy());
+	ALGTEST_CHECK_SMALL( d3.dz());
+
+	// Non-uniform scaling: the result is normalized.
+	transform_type t3( transform_type::scaling( 1, 2, 1));
+	direction_type d4 = direction_type( 1, 1, 0).transformed( t3);
+	ALGTEST_CHECK_EQUAL_UNIT( 1/std::sqrt( unit_type( 5)), d4.dx());
+	ALGTEST_CHECK_EQUAL_UNIT( 2/std::sqrt( unit_type( 5)), d4.dy());
+	ALGTEST_CHECK_SMALL( d4.dz());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_direction_rotation, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename P::second vertex_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef direction< coord_system> direction_type;
+	const unit_type pi = unit_type( 3.14159265358979323846);
+
+	// Rotation with 120 degrees around the diagonal permutes the axes.
+	transform_type rot = transform_type::rotation( direction_type( 1, 1, 1), 2*pi/3);
+	vertex_type v1 = vertex_type( 1, 0, 0).transformed( rot);
+	ALGTEST_CHECK_SMALL( v1.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v1.y());
+	ALGTEST_CHECK_SMALL( v1.z());
+	vertex_type v2 = vertex_type( 0, 0, 1).transformed( rot);
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v2.x());
+	ALGTEST_CHECK_SMALL( v2.y());
+	ALGTEST_CHECK_SMALL( v2.z());
+
+	// The points on the rotation axis are not moved.
+	vertex_type v3 = vertex_type( 1, 2, 3).transformed( transform_type::rotation( direction_type( 1, 2, 3), pi/5));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v3.x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, v3.y());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, v3.z());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_line_transform, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename P::second vertex_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef line< coord_system> line_type;
+	typedef typename line_type::direction_type direction_type;
+
+	transform_type tr( transform_type::scaling( vertex_type( 1, 1, 1), 1, 2, 3));
+	line_type l( vertex_type( 2, 2, 2), direction_type( 1, 1, 0));
+	line_type l2 = transformed( l, tr);
+	ALGTEST_CHECK_EQUAL_UNIT( 2, l2.base().x());
+	ALGTEST_CHECK_EQUAL_UNIT( 3, l2.base().y());
+	ALGTEST_CHECK_EQUAL_UNIT( 4, l2.base().z());
+	ALGTEST_CHECK_EQUAL_UNIT( 1/std::sqrt( unit_type( 5)), l2.dir().dx());
+	ALGTEST_CHECK_EQUAL_UNIT( 2/std::sqrt( unit_type( 5)), l2.dir().dy());
+	ALGTEST_CHECK_SMALL( l2.dir().dz());
+
+	// The transformed line contains the transformed vertices of the original line.
+	vertex_type v( 5, 5, 2);
+	ALGTEST_CHECK_SMALL( distance( v.transformed( tr), l2));
+
+	transform( l, transform_type::translation( 1, 0, 0));
+	ALGTEST_CHECK_EQUAL_UNIT( 3, l.base().x());
+	ALGTEST_CHECK_EQUAL_UNIT( 1/std::sqrt( unit_type( 2)), l.dir().dx());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_plane_transform, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename P::second vertex_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef plane< coord_system> plane_type;
+	typedef direction< coord_system> direction_type;
+	const unit_type pi = unit_type( 3.14159265358979323846);
+
+	transform_type tr( 
+		transform_type::translation( 1, 2, 3).tr_matrix() 
+		* transform_type::template rotation<1>( pi/6).tr_matrix()
+		* transform_type::scaling( 2, 3, 4).tr_matrix());
+
+	// The vertices of the plane are transformed in vertices of the transformed plane.
+	vertex_type v1( 1, 0, 0), v2( 0, 1, 0), v3( 0, 0, 1);
+	plane_type p( v1, v2, v3);
+	plane_type p2 = transformed( p, tr);
+	ALGTEST_CHECK_SMALL( distance( v1.transformed( tr), p2));
+	ALGTEST_CHECK_SMALL( distance( v2.transformed( tr), p2));
+	ALGTEST_CHECK_SMALL( distance( v3.transformed( tr), p2));
+
+	// The same result with the cached transformation.
+	cached_transformation< coord_system> cached( tr);
+	plane_type p3 = transformed( p, cached);
+	ALGTEST_CHECK_EQUAL_UNIT( p2.a(), p3.a());
+	ALGTEST_CHECK_EQUAL_UNIT( p2.b(), p3.b());
+	ALGTEST_CHECK_EQUAL_UNIT( p2.c(), p3.c());
+	ALGTEST_CHECK_EQUAL_UNIT( p2.d(), p3.d());
+
+	// The cached transformation is used for vertices too.
+	vertex_type v4 = v1.transformed( cached);
+	vertex_type v5 = v1.transformed( tr);
+	ALGTEST_CHECK_EQUAL_UNIT( v5.x(), v4.x());
+	ALGTEST_CHECK_EQUAL_UNIT( v5.y(), v4.y());
+	ALGTEST_CHECK_EQUAL_UNIT( v5.z(), v4.z());
+
+	// Resetting the transformation invalidates the cache.
+	cached.reset( transform_type::translation( 0, 0, 5));
+	transform( p, cached);
+	ALGTEST_CHECK_SMALL( distance( vertex_type( 1, 0, 5), p));
+	ALGTEST_CHECK_SMALL( distance( vertex_type( 0, 0, 6), p));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_batched_plane_transform, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename P::second vertex_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef plane< coord_system> plane_type;
+	typedef direction< coord_system> direction_type;
+
+	transform_type tr( 
+		transform_type::translation( 1, 2, 3).tr_matrix() * transform_type::scaling( 2, 1, 1).tr_matrix());
+	std::vector< plane_type> planes;
+	for( int i = 0; i < 10; ++i)
+	{
+		planes.push_back( plane_type( vertex_type( i, 0, 0), direction_type( 1, 1, i)));
+	}
+
+	std::vector< plane_type> result( planes.size());
+	BOOST_CHECK( transformed( planes.begin(), planes.end(), result.begin(), tr) == result.end());
+	// In place transformation
+	transformed( planes.begin(), planes.end(), planes.begin(), tr);
+	for( int i = 0; i < 10; ++i)
+	{
+		plane_type expected = transformed( plane_type( vertex_type( i, 0, 0), direction_type( 1, 1, i)), tr);
+		ALGTEST_CHECK_EQUAL_UNIT( expected.a(), result[i].a());
+		ALGTEST_CHECK_EQUAL_UNIT( expected.b(), result[i].b());
+		ALGTEST_CHECK_EQUAL_UNIT( expected.c(), result[i].c());
+		ALGTEST_CHECK_EQUAL_UNIT( expected.d(), result[i].d());
+		ALGTEST_CHECK_EQUAL_UNIT( expected.d(), planes[i].d());
+		ALGTEST_CHECK_SMALL( distance( vertex_type( 2*i + 1, 2, 3), result[i]));
+	}
+
+	// Parallel transformation.
+	std::vector< plane_type> many;
+	for( int i = 0; i < 1000; ++i)
+	{
+		many.push_back( plane_type( vertex_type( i, 0, 0), direction_type( 1, 1, i % 10)));
+	}
+	std::vector< plane_type> sequential( many.size()), parallel_result( many.size());
+	transformed( many.begin(), many.end(), sequential.begin(), tr);
+	parallel::thread_pool pool( 3);
+	BOOST_CHECK( transformed( parallel::par.on( pool).grain( 16), many.begin(), many.end(), parallel_result.begin(), tr)
+		== parallel_result.end());
+	for( std::size_t i = 0; i < many.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( sequential[i].a(), parallel_result[i].a());
+		BOOST_CHECK_EQUAL( sequential[i].d(), parallel_result[i].d());
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_batched_rotations, P, tested_types)
+{
+	typedef typename P::first transform_type;
+	typedef typename transform_type::coord_system coord_system;
+	typedef typename transform_type::unit_type unit_type;
+	typedef typename transform_type::transform_matrix transform_matrix;
+	typedef direction< coord_system> direction_type;
+
+	// More angles than a block, to check the processing of the last incomplete block.
+	std::vector< unit_type> angles;
+	for( int i = 0; i < 75; ++i)
+	{
+		angles.push_back( unit_type( i - 37) / 5);
+	}
+	std::vector< transform_type> rx, ry, rz, rd, rd_fast;
+	transform_type::template rotations< 1>( &angles[0], angles.size(), std::back_inserter( rx));
+	transform_type::template rotations< 2>( &angles[0], angles.size(), std::back_inserter( ry));
+	transform_type::template rotations< 3>( &angles[0], angles.size(), std::back_inserter( rz));
+	direction_type dir( 1, 2, 3);
+	transform_type::rotations( dir, &angles[0], angles.size(), std::back_inserter( rd));
+	transform_type::rotations( 
+		dir, &angles[0], angles.size(), std::back_inserter( rd_fast), algebra::fast_trigonometry());
+	BOOST_REQUIRE_EQUAL( angles.size(), rx.size());
+	BOOST_REQUIRE_EQUAL( angles.size(), ry.size());
+	BOOST_REQUIRE_EQUAL( angles.size(), rz.size());
+	BOOST_REQUIRE_EQUAL( angles.size(), rd.size());
+	BOOST_REQUIRE_EQUAL( angles.size(), rd_fast.size());
+
+	for( std::size_t i = 0; i < angles.size(); ++i)
+	{
+		const transform_matrix 
+			ex = transform_type::template rotation< 1>( angles[i]).tr_matrix(),
+			ey = transform_type::template rotation< 2>( angles[i]).tr_matrix(),
+			ez = transform_type::template rotation< 3>( angles[i]).tr_matrix(),
+			ed = transform_type::rotation( dir, angles[i]).tr_matrix(),
+			ed_fast = transform_type::rotation( dir, angles[i], algebra::fast_trigonometry()).tr_matrix();
+		for( unsigned r = 0; r < 4; ++r)
+		{
+			for( unsigned c = 0; c < 4; ++c)
+			{
+				ALGTEST_CHECK_SMALL( ex( r, c) - rx[i].tr_matrix()( r, c));
+				ALGTEST_CHECK_SMALL( ey( r, c) - ry[i].tr_matrix()( r, c));
+				ALGTEST_CHECK_SMALL( ez( r, c) - rz[i].tr_matrix()( r, c));
+				ALGTEST_CHECK_SMALL( ed( r, c) - rd[i].tr_matrix()( r, c));
+				ALGTEST_CHECK_SMALL( ed( r, c) - rd_fast[i].tr_matrix()( r, c));
+				// The single rotations use the same sine and cosine calculation as the arrays.
+				BOOST_CHECK_EQUAL( ex( r, c), rx[i].tr_matrix()( r, c));
+				BOOST_CHECK_EQUAL( ey( r, c), ry[i].tr_matrix()( r, c));
+				BOOST_CHECK_EQUAL( ed( r, c), rd[i].tr_matrix()( r, c));
+				BOOST_CHECK_EQUAL( ed_fast( r, c), rd_fast[i].tr_matrix()( r, c));
+			}
+		}
+	}
+
+	// The angles out of the range of the polynomial reduction use the standard functions.
+	const unit_type large = unit_type( 1e9);
+	const transform_matrix m = transform_type::template rotation< 3>( large).tr_matrix();
+	BOOST_CHECK_EQUAL( std::cos( large), m( 0, 0));
+	BOOST_CHECK_EQUAL( std::sin( large), m( 1, 0));
+}
+
 } // namespace
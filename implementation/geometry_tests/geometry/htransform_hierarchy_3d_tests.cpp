@@ -0,0 +1,133 @@
+#include "geometry/homogenous/transform_hierarchy.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <vector>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef hcoord_system< 3, float, algebra::unit_traits< float> > float_hcoord_system;
+typedef hcoord_system< 3, double, algebra::unit_traits< double> > double_hcoord_system;
+
+typedef boost::mpl::list< float_hcoord_system, double_hcoord_system> tested_types;
+
+/// \brief It calculates the world transformation of a node by multiplying the local transformations up to the root.
+template< typename H>
+typename H::transformation_type::transform_matrix expected_world( const H& hierarchy, typename H::node_id node)
+{
+	typename H::transformation_type::transform_matrix result = hierarchy.local( node).tr_matrix();
+	for( node = hierarchy.parent( node); node != H::NO_PARENT; node = hierarchy.parent( node))
+	{
+		result = hierarchy.local( node).tr_matrix() * result;
+	}
+	return result;
+}
+
+/// \brief It checks the world transformations of all the nodes.
+template< typename H>
+void check_world( const H& hierarchy)
+{
+	typedef typename H::transformation_type::unit_type unit_type;
+	for( typename H::node_id node = 0; node < hierarchy.size(); ++node)
+	{
+		typename H::transformation_type::transform_matrix expected = expected_world( hierarchy, node);
+		for( unsigned r = 0; r < 4; ++r)
+		{
+			for( unsigned c = 0; c < 4; ++c)
+			{
+				ALGTEST_CHECK_SMALL( expected( r, c) - hierarchy.world( node).tr_matrix()( r, c));
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_hierarchy_update, CS, tested_types)
+{
+	typedef transform_hierarchy< CS> hierarchy_type;
+	typedef typename hierarchy_type::transformation_type transform_type;
+	typedef typename hierarchy_type::node_id node_id;
+	typedef typename transform_type::unit_type unit_type;
+
+	hierarchy_type hierarchy;
+	BOOST_CHECK_EQUAL( 0U, hierarchy.update());
+
+	node_id root = hierarchy.add_node( transform_type::translation( 1, 0, 0));
+	node_id arm = hierarchy.add_node( transform_type::template rotation< 3>( unit_type( 0.5)), root);
+	node_id other_root = hierarchy.add_node( transform_type::scaling( 2));
+	node_id hand = hierarchy.add_node( transform_type::translation( 0, 2, 0), arm);
+	node_id finger = hierarchy.add_node( transform_type::template rotation< 1>( unit_type( 0.25)), hand);
+	node_id leg = hierarchy.add_node( transform_type::translation( 0, -1, 0), root);
+	node_id foot = hierarchy.add_node( transform_type::translation( 0, 0, 1), leg);
+	BOOST_CHECK_EQUAL( 7U, hierarchy.size());
+	BOOST_CHECK_EQUAL( arm, hierarchy.parent( hand));
+	BOOST_CHECK( hierarchy.is_dirty());
+
+	BOOST_CHECK_EQUAL( 7U, hierarchy.update());
+	BOOST_CHECK( !hierarchy.is_dirty());
+	check_world( hierarchy);
+
+	// Only the subtree of the changed node is recalculated.
+	hierarchy.set_local( hand, transform_type::translation( 0, 3, 0));
+	BOOST_CHECK_EQUAL( 2U, hierarchy.update());
+	check_world( hierarchy);
+
+	// Nested dirty subtrees are recalculated once.
+	hierarchy.set_local( finger, transform_type::template rotation< 2>( unit_type( 0.1)));
+	hierarchy.set_local( arm, transform_type::template rotation< 3>( unit_type( -0.5)));
+	hierarchy.set_local( foot, transform_type::scaling( 3));
+	hierarchy.set_local( other_root, transform_type::scaling( 4));
+	BOOST_CHECK_EQUAL( 5U, hierarchy.update());
+	check_world( hierarchy);
+	BOOST_CHECK_EQUAL( 0U, hierarchy.update());
+
+	// Adding a node rebuilds the order.
+	hierarchy.add_node( transform_type::translation( 5, 5, 5), other_root);
+	BOOST_CHECK_EQUAL( 8U, hierarchy.update());
+	check_world( hierarchy);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_hierarchy_parallel_update, CS, tested_types)
+{
+	typedef transform_hierarchy< CS> hierarchy_type;
+	typedef typename hierarchy_type::transformation_type transform_type;
+	typedef typename hierarchy_type::node_id node_id;
+	typedef typename transform_type::unit_type unit_type;
+
+	// A few deep chains and many shallow subtrees.
+	hierarchy_type hierarchy;
+	node_id root = hierarchy.add_node( transform_type::translation( 0, 0, 1));
+	for( unsigned i = 0; i < 5000; ++i)
+	{
+		node_id parent = i < 10 ? root : node_id( (i * 7919) % (i + 1));
+		hierarchy.add_node( 
+			transform_type::template rotation< 3>( unit_type( i % 13) / 100).tr_matrix() 
+				* transform_type::translation( unit_type( i % 3) / 10, 0, 0).tr_matrix(), 
+			parent);
+	}
+	parallel::thread_pool pool( 3);
+	BOOST_CHECK_EQUAL( hierarchy.size(), hierarchy.update( parallel::par.on( pool)));
+	check_world( hierarchy);
+
+	// Change near the root, so the subtree has to be split in tasks.
+	hierarchy.set_local( root, transform_type::translation( 1, 2, 3));
+	hierarchy.set_local( 4000, transform_type::scaling( 2));
+	BOOST_CHECK_EQUAL( hierarchy.size(), hierarchy.update( parallel::par.on( pool)));
+	check_world( hierarchy);
+
+	// Several independent subtrees.
+	for( node_id node = 1; node < 10; node += 2)
+	{
+		hierarchy.set_local( node, transform_type::translation( 0, unit_type( node), 0));
+	}
+	BOOST_CHECK( hierarchy.update( parallel::par_vec.on( pool)) > 0U);
+	check_world( hierarchy);
+}
+
+} // namespace
@@ -0,0 +1,193 @@
+#include "geometry/homogenous/transformation_chain.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/homogenous/transforms.hpp"
+#include "geometry/homogenous/distances.hpp"
+#include "geometry/plane.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef hcoord_system< 3, float, algebra::unit_traits< float> > float_hcoord_system;
+typedef hcoord_system< 3, double, algebra::unit_traits< double> > double_hcoord_system;
+
+typedef boost::mpl::list< float_hcoord_system, double_hcoord_system> tested_types;
+
+/// \brief It checks that two transformation matrices are equal, element by element.
+template< typename M>
+void check_equal_matrix( const M& expected, const M& obtained)
+{
+	typedef typename M::unit_type unit_type;
+	for( unsigned r = 0; r < 4; ++r)
+	{
+		for( unsigned c = 0; c < 4; ++c)
+		{
+			ALGTEST_CHECK_SMALL( expected( r, c) - obtained( r, c));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_chain_merging, CS, tested_types)
+{
+	typedef transformation_chain< CS> chain_type;
+	typedef typename chain_type::transformation_type transform_type;
+	typedef typename chain_type::unit_type unit_type;
+	typedef direction< CS> direction_type;
+
+	chain_type identity;
+	BOOST_CHECK_EQUAL( 0U, identity.steps_count());
+	check_equal_matrix( transform_type::transform_matrix::IDENTITY(), identity.tr_matrix());
+
+	chain_type chain;
+	chain.translate( 1, 2, 3).translate( 4, 5, 6);
+	BOOST_CHECK_EQUAL( 1U, chain.steps_count());
+	check_equal_matrix( transform_type::translation( 5, 7, 9).tr_matrix(), chain.tr_matrix());
+
+	chain.scale( 2, 3, 4).scale( 2);
+	BOOST_CHECK_EQUAL( 2U, chain.steps_count());
+	check_equal_matrix( 
+		transform_type::scaling( 4, 6, 8).tr_matrix() * transform_type::translation( 5, 7, 9).tr_matrix(),
+		chain.tr_matrix());
+
+	chain_type rotations;
+	rotations.template rotate< 2>( unit_type( 0.25)).template rotate< 2>( unit_type( 0.5));
+	direction_type dir( 1, 1, 1);
+	rotations.rotate( dir, unit_type( 0.125)).rotate( dir, unit_type( 0.375));
+	BOOST_CHECK_EQUAL( 2U, rotations.steps_count());
+	check_equal_matrix( 
+		transform_type::rotation( dir, unit_type( 0.5)).tr_matrix() 
+			* transform_type::template rotation< 2>( unit_type( 0.75)).tr_matrix(),
+		rotations.tr_matrix());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_chain_composition, CS, tested_types)
+{
+	typedef transformation_chain< CS> chain_type;
+	typedef typename chain_type::transformation_type transform_type;
+	typedef typename chain_type::transform_matrix transform_matrix;
+	typedef typename chain_type::unit_type unit_type;
+	typedef direction< CS> direction_type;
+
+	const direction_type dir( 1, -2, 3);
+	chain_type chain;
+	chain.translate( 1, 2, 3)
+		.template rotate< 1>( unit_type( 0.3))
+		.scale( 2, 1, unit_type( 0.5))
+		.rotate( dir, unit_type( -1.2))
+		.template rotate< 3>( unit_type( 2.1))
+		.template rotate< 2>( unit_type( -0.7))
+		.translate( -4, 0, 1);
+	BOOST_CHECK_EQUAL( 7U, chain.steps_count());
+
+	const transform_matrix expected =
+		transform_type::translation( -4, 0, 1).tr_matrix()
+		* transform_type::template rotation< 2>( unit_type( -0.7)).tr_matrix()
+		* transform_type::template rotation< 3>( unit_type( 2.1)).tr_matrix()
+		* transform_type::rotation( dir, unit_type( -1.2)).tr_matrix()
+		* transform_type::scaling( 2, 1, unit_type( 0.5)).tr_matrix()
+		* transform_type::template rotation< 1>( unit_type( 0.3)).tr_matrix()
+		* transform_type::translation( 1, 2, 3).tr_matrix();
+	check_equal_matrix( expected, chain.tr_matrix());
+	BOOST_CHECK( chain.is_affine());
+
+	// General transformation, folding the previous steps.
+	const transform_type projection = transform_type::perspective( -1, 1, -1, 1, 1, 10);
+	chain.then( projection).translate( 0, 0, 1);
+	BOOST_CHECK_EQUAL( 1U, chain.steps_count());
+	BOOST_CHECK( !chain.is_affine());
+	check_equal_matrix( 
+		transform_type::translation( 0, 0, 1).tr_matrix() * projection.tr_matrix() * expected, 
+		chain.tr_matrix());
+
+	// Appending another chain.
+	chain_type first, second;
+	first.scale( 3).template rotate< 3>( unit_type( 0.5));
+	second.template rotate< 3>( unit_type( 0.25)).translate( 1, 1, 1);
+	first.then( second);
+	BOOST_CHECK_EQUAL( 3U, first.steps_count());
+	check_equal_matrix( 
+		transform_type::translation( 1, 1, 1).tr_matrix() 
+			* transform_type::template rotation< 3>( unit_type( 0.75)).tr_matrix()
+			* transform_type::scaling( 3).tr_matrix(),
+		first.tr_matrix());
+
+	// Appending a chain to itself.
+	const transform_matrix once = first.tr_matrix();
+	first.then( first);
+	BOOST_CHECK_EQUAL( 6U, first.steps_count());
+	check_equal_matrix( once * once, first.tr_matrix());
+
+	chain_type prefixed( projection);
+	prefixed.translate( 1, 2, 3);
+	const transform_matrix prefixed_once = prefixed.tr_matrix();
+	prefixed.then( prefixed);
+	BOOST_CHECK_EQUAL( 1U, prefixed.steps_count());
+	check_equal_matrix( prefixed_once * prefixed_once, prefixed.tr_matrix());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_chain_capacity, CS, tested_types)
+{
+	typedef transformation_chain< CS, 2> chain_type;
+	typedef typename chain_type::transformation_type transform_type;
+	typedef typename chain_type::unit_type unit_type;
+
+	chain_type chain( transform_type::translation( 1, 0, 0));
+	chain.scale( 2).translate( 0, 1, 0);
+	BOOST_CHECK_EQUAL( 2U, chain.steps_count());
+	// The chain is full: the steps are folded before adding the new one.
+	chain.template rotate< 3>( unit_type( 1.5));
+	BOOST_CHECK_EQUAL( 1U, chain.steps_count());
+	check_equal_matrix(
+		transform_type::template rotation< 3>( unit_type( 1.5)).tr_matrix()
+			* transform_type::translation( 0, 1, 0).tr_matrix()
+			* transform_type::scaling( 2).tr_matrix()
+			* transform_type::translation( 1, 0, 0).tr_matrix(),
+		chain.tr_matrix());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_chain_apply, CS, tested_types)
+{
+	typedef transformation_chain< CS> chain_type;
+	typedef typename chain_type::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+	typedef direction< CS> direction_type;
+	typedef plane< CS> plane_type;
+	const unit_type pi = unit_type( 3.14159265358979323846);
+
+	chain_type chain;
+	chain.template rotate< 3>( pi/2).translate( 10, 0, 0);
+
+	vertex_type v = vertex_type( 1, 0, 0).transformed( chain);
+	ALGTEST_CHECK_EQUAL_UNIT( 10, v.x()/v.w());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, v.y()/v.w());
+	ALGTEST_CHECK_SMALL( v.z()/v.w());
+
+	direction_type d = direction_type( 1, 0, 0).transformed( chain);
+	ALGTEST_CHECK_SMALL( d.dx());
+	ALGTEST_CHECK_EQUAL_UNIT( 1, d.dy());
+
+	// The plane x = 1 becomes y = 1.
+	plane_type p = transformed( plane_type( vertex_type( 1, 0, 0), direction_type( 1, 0, 0)), chain);
+	ALGTEST_CHECK_SMALL( distance( vertex_type( 3, 1, 2), p));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, distance( vertex_type( 3, 2, 2), p));
+
+	// The folded matrix is recalculated after a change.
+	chain.translate( 0, 0, 5);
+	v = vertex_type( 1, 0, 0).transformed( chain);
+	ALGTEST_CHECK_EQUAL_UNIT( 5, v.z()/v.w());
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+#include "geometry/homogenous/vertex_statistics.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <vector>
+#include <cmath>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef boost::mpl::list< hcoord_system< 3, float>, hcoord_system< 3, double> > tested_types;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_statistics_small_set, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+
+	std::vector< vertex_type> vertices;
+	vertices.push_back( vertex_type( 0, 0, 0));
+	vertices.push_back( vertex_type( 2, 0, 0));
+	vertices.push_back( vertex_type( 0, 2, 0));
+	vertices.push_back( vertex_type( 0, 0, 2));
+
+	const vertex_statistics< CS> stats = calculate_statistics( vertices.begin(), vertices.end());
+	BOOST_CHECK_EQUAL( 4U, stats.count());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, stats.min_corner().x());
+	ALGTEST_CHECK_EQUAL_UNIT( 2, stats.max_corner().z());
+	ALGTEST_CHECK_EQUAL_UNIT( 0.5, stats.centroid().x());
+	ALGTEST_CHECK_EQUAL_UNIT( 0.5, stats.centroid().y());
+	ALGTEST_CHECK_EQUAL_UNIT( 0.5, stats.centroid().z());
+
+	const typename vertex_statistics< CS>::covariance_matrix cov = stats.covariance();
+	ALGTEST_CHECK_EQUAL_UNIT( 0.75, cov( 0, 0));
+	ALGTEST_CHECK_EQUAL_UNIT( 0.75, cov( 2, 2));
+	ALGTEST_CHECK_EQUAL_UNIT( -0.25, cov( 0, 1));
+	ALGTEST_CHECK_EQUAL_UNIT( -0.25, cov( 2, 1));
+	ALGTEST_CHECK_EQUAL_UNIT( 1, stats.covariance( true)( 1, 1));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_statistics_far_from_origin, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+
+	// The float unit type cannot represent the small deviations around a large center.
+	const double center = sizeof( unit_type) == sizeof( double) ? 1e6 : 100;
+	const std::vector< vertex_type> vertices = sample_vertices< vertex_type>( 20000, center, 5);
+
+	// Two passes reference, in double precision.
+	double mean[3] = { 0, 0, 0 };
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		mean[0] += vertices[i].x(); mean[1] += vertices[i].y(); mean[2] += vertices[i].z();
+	}
+	for( unsigned i = 0; i < 3; ++i)
+	{
+		mean[i] /= double( vertices.size());
+	}
+	double expected[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		const double d[3] = { vertices[i].x() - mean[0], vertices[i].y() - mean[1], vertices[i].z() - mean[2] };
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				expected[r][c] += d[r] * d[c] / double( vertices.size());
+			}
+		}
+	}
+
+	const vertex_statistics< CS> stats = calculate_statistics( vertices.begin(), vertices.end());
+	BOOST_CHECK_EQUAL( vertices.size(), stats.count());
+	const typename vertex_statistics< CS>::covariance_matrix cov = stats.covariance();
+	for( unsigned r = 0; r < 3; ++r)
+	{
+		for( unsigned c = 0; c < 3; ++c)
+		{
+			BOOST_CHECK_SMALL( double( cov( r, c)) - expected[r][c], 1e-6);
+		}
+	}
+	BOOST_CHECK_SMALL( double( stats.centroid().y()) - mean[1], 1e-6 * center);
+
+	// Incremental accumulation gives the same statistics, up to the rounding errors.
+	vertex_statistics< CS> first_half, second_half;
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		(i < vertices.size() / 2 ? first_half : second_half).add( vertices[i]);
+	}
+	first_half.merge( second_half);
+	BOOST_CHECK_EQUAL( stats.count(), first_half.count());
+	BOOST_CHECK_SMALL( double( first_half.covariance()( 0, 2)) - expected[0][2], 1e-6);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_statistics_deterministic, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex< CS> vertex_type;
+
+	const std::vector< vertex_type> vertices = sample_vertices< vertex_type>( 50000, 10, 5);
+	std::vector< unit_type> x, y, z;
+	for( std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		x.push_back( vertices[i].x());
+		y.push_back( vertices[i].y());
+		z.push_back( vertices[i].z());
+	}
+
+	const vertex_statistics< CS> single = calculate_statistics( vertices.begin(), vertices.end());
+	parallel::thread_pool pool( 3);
+	const parallel::parallel_policy policies[] = { parallel::par.on( pool), parallel::par.on( pool).grain( 2) };
+	for( unsigned t = 0; t < 2; ++t)
+	{
+		const vertex_statistics< CS> range_stats = calculate_statistics( policies[t], vertices.begin(), vertices.end());
+		const vertex_statistics< CS> array_stats =
+			calculate_statistics< CS>( policies[t], &x[0], &y[0], &z[0], x.size());
+		for( unsigned r = 0; r < 3; ++r)
+		{
+			for( unsigned c = 0; c < 3; ++c)
+			{
+				BOOST_CHECK_EQUAL( single.covariance()( r, c), range_stats.covariance()( r, c));
+				BOOST_CHECK_EQUAL( single.covariance()( r, c), array_stats.covariance()( r, c));
+			}
+		}
+		BOOST_CHECK_EQUAL( single.centroid().x(), range_stats.centroid().x());
+		BOOST_CHECK_EQUAL( single.centroid().z(), array_stats.centroid().z());
+		BOOST_CHECK_EQUAL( single.max_corner().y(), array_stats.max_corner().y());
+	}
+}
+
+} // namespace
@@ -0,0 +1,271 @@
+#include "geometry/homogenous/vertex_view.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/direction.hpp"
+#include "geometry/homogenous/distances.hpp"
+#include "geometry/homogenous/shortest_segment.hpp"
+#include "geometry/homogenous/transformation.hpp"
+#include "geometry/spatial_order.hpp"
+#include "geometry/line.hpp"
+#include "geometry/plane.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+using namespace geometry;
+
+typedef boost::mpl::list< hcoord_system< 3, float>, hcoord_system< 3, double> > tested_types;
+
+/// \brief An interleaved vertex of a graphics buffer: position and color.
+template< typename U>
+struct colored_point
+{
+	U position[3];
+	unsigned char color[4];
+};
+
+/// \brief It orders the vertices, or the vertex views, by their x coordinate.
+struct less_x
+{
+	template< typename V1, typename V2>
+	bool operator()( const V1& a, const V2& b) const { return a.x() < b.x(); }
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_concepts, CS, tested_types)
+{
+	typedef vertex_view< CS, 3> carthesian_view;
+	typedef vertex_view< CS, 4> homogenous_view;
+	BOOST_CONCEPT_ASSERT( (HomogenousVertex3D< carthesian_view>));
+	BOOST_CONCEPT_ASSERT( (HomogenousVertex3D< homogenous_view>));
+	BOOST_STATIC_ASSERT( (impl::is_vertex< carthesian_view, 3, hcoord_system_tag>::value));
+	BOOST_STATIC_ASSERT( (impl::is_vertex< homogenous_view, 3, hcoord_system_tag>::value));
+	BOOST_CONCEPT_ASSERT( (HomogenousVertex3D< const_vertex_view< CS, 3> >));
+	BOOST_CONCEPT_ASSERT( (HomogenousVertex3D< const_vertex_view< CS, 4> >));
+	BOOST_STATIC_ASSERT( (impl::is_vertex< const_vertex_view< CS, 4>, 3, hcoord_system_tag>::value));
+
+	// The strided ranges hold vertices and give views of them.
+	typedef std::iterator_traits< typename strided_range< carthesian_view>::iterator> iterator_traits;
+	BOOST_STATIC_ASSERT( (boost::is_same< vertex< CS>, typename iterator_traits::value_type>::value));
+	BOOST_STATIC_ASSERT( (boost::is_same< carthesian_view, typename iterator_traits::reference>::value));
+	BOOST_STATIC_ASSERT( (boost::is_same< const_vertex_view< CS, 3>,
+		typename strided_range< const carthesian_view>::reference>::value));
+	BOOST_STATIC_ASSERT( (boost::is_same< const typename CS::unit_type*,
+		typename strided_range< const_vertex_view< CS, 3> >::unit_pointer>::value));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_strided_access, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex_view< CS, 3> view_type;
+
+	std::vector< colored_point< unit_type> > buffer( 10);
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		buffer[i].position[0] = unit_type( i);
+		buffer[i].position[1] = unit_type( 2*i);
+		buffer[i].position[2] = unit_type( 3*i);
+	}
+
+	const strided_range< const view_type> points( buffer[0].position, buffer.size(), sizeof( buffer[0]));
+	BOOST_REQUIRE_EQUAL( buffer.size(), points.size());
+	BOOST_CHECK_EQUAL( std::ptrdiff_t( buffer.size()), points.end() - points.begin());
+	BOOST_CHECK_EQUAL( unit_type( 7), points[7].x());
+	BOOST_CHECK_EQUAL( unit_type( 14), points[7].y());
+	BOOST_CHECK_EQUAL( unit_type( 21), points[7].z());
+	BOOST_CHECK_EQUAL( unit_type( 1), points[7].w());
+	BOOST_CHECK( !points[7].owns_coordinates());
+	BOOST_CHECK_EQUAL( buffer[7].position, points[7].data());
+
+	typename strided_range< const view_type>::iterator it = points.begin();
+	++it;
+	it += 2;
+	BOOST_CHECK_EQUAL( unit_type( 3), (*it).x());
+	BOOST_CHECK_EQUAL( unit_type( 2), it[-1].x());
+
+	// The views are used directly by the algorithms.
+	ALGTEST_CHECK_EQUAL_UNIT( std::sqrt( unit_type( 14)), distance( points[0], points[1]));
+	const plane< CS> p( 0, 0, 1, -3);
+	ALGTEST_CHECK_EQUAL_UNIT( 18, distance( points[7], p));
+	const line< CS> l( vertex< CS>( 0, 0, 0), direction< CS>( 1, 0, 0));
+	ALGTEST_CHECK_EQUAL_UNIT( std::sqrt( unit_type( 4 + 9)), distance( points[1], l));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_homogenous_buffer, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex_view< CS, 4> view_type;
+
+	unit_type buffer[] = { 2, 4, 6, 2, 1, 1, 1, 1 };
+	strided_range< view_type> points( buffer, 2);
+	BOOST_CHECK_EQUAL( unit_type( 1), points[0].x());
+	BOOST_CHECK_EQUAL( unit_type( 3), points[0].z());
+	BOOST_CHECK_EQUAL( unit_type( 2), points[0].w());
+	ALGTEST_CHECK_EQUAL_UNIT( std::sqrt( unit_type( 5)), distance( points[0], points[1]));
+
+	// The assignment writes in the buffer.
+	points[1] = view_type( 5, 6, 7, 1);
+	BOOST_CHECK_EQUAL( unit_type( 5), buffer[4]);
+	BOOST_CHECK_EQUAL( unit_type( 7), buffer[6]);
+	std::copy( points.begin() + 1, points.end(), points.begin());
+	BOOST_CHECK_EQUAL( unit_type( 6), buffer[1]);
+	BOOST_CHECK_EQUAL( unit_type( 1), buffer[3]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_views_copies, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex_view< CS, 3> view_type;
+
+	unit_type buffer[] = { 1, 2, 3, 4, 5, 6 };
+	const strided_range< view_type> points( buffer, 2);
+
+	// The values of the range are copies of the coordinates.
+	const vertex< CS> value = points[0];
+	points[0] = points[1];
+	BOOST_CHECK_EQUAL( unit_type( 1), value.x());
+	BOOST_CHECK_EQUAL( unit_type( 4), buffer[0]);
+	points[1] = value;
+	BOOST_CHECK_EQUAL( unit_type( 1), buffer[3]);
+	BOOST_CHECK_EQUAL( unit_type( 3), buffer[5]);
+
+	// Swapping the views swaps the coordinates.
+	view_type first = points[0], second = points[1];
+	using std::swap;
+	swap( first, second);
+	BOOST_CHECK_EQUAL( unit_type( 1), buffer[0]);
+	BOOST_CHECK_EQUAL( unit_type( 6), buffer[5]);
+	BOOST_CHECK_EQUAL( buffer, first.data());
+	swap( points[0], points[1]);
+	std::iter_swap( points.begin(), points.begin() + 1);
+	BOOST_CHECK_EQUAL( unit_type( 1), buffer[0]);
+	BOOST_CHECK_EQUAL( unit_type( 4), buffer[3]);
+
+	// The read only views are assigned like pointers.
+	const strided_range< const_vertex_view< CS, 3> > constant( buffer, 2);
+	const_vertex_view< CS, 3> view = constant[0];
+	view = constant[1];
+	BOOST_CHECK_EQUAL( unit_type( 1), buffer[0]);
+	BOOST_CHECK_EQUAL( buffer + 3, view.data());
+	view = const_vertex_view< CS, 3>( points[0]);
+	BOOST_CHECK_EQUAL( unit_type( 2), view.y());
+	BOOST_CHECK( !view.owns_coordinates());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_reorder_buffer, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+
+	const int ORDER[] = { 5, 2, 7, 0, 3, 6, 1, 4 };
+	std::vector< colored_point< unit_type> > buffer( 8);
+	unit_type homogenous[8 * 4];
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		buffer[i].position[0] = unit_type( ORDER[i]);
+		buffer[i].position[1] = unit_type( 10 * ORDER[i]);
+		buffer[i].position[2] = unit_type( -ORDER[i]);
+		buffer[i].color[0] = static_cast< unsigned char>( i);
+		homogenous[4*i] = unit_type( 2 * ORDER[i]);
+		homogenous[4*i + 1] = 0;
+		homogenous[4*i + 2] = 0;
+		homogenous[4*i + 3] = 2;
+	}
+
+	const strided_range< vertex_view< CS, 3> > points( buffer[0].position, buffer.size(), sizeof( buffer[0]));
+	std::sort( points.begin(), points.end(), less_x());
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( unit_type( i), buffer[i].position[0]);
+		BOOST_CHECK_EQUAL( unit_type( 10 * i), buffer[i].position[1]);
+		BOOST_CHECK_EQUAL( -unit_type( i), buffer[i].position[2]);
+	}
+
+	const strided_range< vertex_view< CS, 4> > weighted( homogenous, 8);
+	std::sort( weighted.begin(), weighted.end(), less_x());
+	for( std::size_t i = 0; i < 8; ++i)
+	{
+		BOOST_CHECK_EQUAL( unit_type( i), weighted[i].x());
+	}
+
+	// Reversing by a permutation.
+	std::vector< std::size_t> permutation;
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		permutation.push_back( buffer.size() - 1 - i);
+	}
+	permute( points.begin(), permutation);
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( unit_type( 7 - i), points[i].x());
+		BOOST_CHECK_EQUAL( unit_type( 10 * (7 - i)), points[i].y());
+		BOOST_CHECK_EQUAL( static_cast< unsigned char>( i), buffer[i].color[0]);
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_transform_in_place, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex_view< CS, 3> view_type;
+	typedef transformation< CS> transform_type;
+
+	const transform_type tr( transform_type::translation( 1, 2, 3).tr_matrix()
+		* transform_type::template rotation<2>( unit_type( 0.5)).tr_matrix());
+
+	std::vector< colored_point< unit_type> > buffer( 5);
+	std::vector< vertex< CS> > expected;
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		buffer[i].position[0] = unit_type( i);
+		buffer[i].position[1] = unit_type( 1);
+		buffer[i].position[2] = unit_type( -i);
+		buffer[i].color[0] = 200;
+		expected.push_back( vertex< CS>( unit_type( i), 1, unit_type( -i)).transformed( tr));
+	}
+
+	const strided_range< view_type> points( buffer[0].position, buffer.size(), sizeof( buffer[0]));
+	const view_type transformed = points[2].transformed( tr);
+	BOOST_CHECK( transformed.owns_coordinates());
+	for( typename strided_range< view_type>::iterator it = points.begin(); it != points.end(); ++it)
+	{
+		(*it).transform( tr);
+	}
+	for( std::size_t i = 0; i < buffer.size(); ++i)
+	{
+		ALGTEST_CHECK_EQUAL_UNIT( expected[i].x(), buffer[i].position[0]);
+		ALGTEST_CHECK_EQUAL_UNIT( expected[i].y(), buffer[i].position[1]);
+		ALGTEST_CHECK_EQUAL_UNIT( expected[i].z(), buffer[i].position[2]);
+		BOOST_CHECK_EQUAL( 200, buffer[i].color[0]);
+	}
+	ALGTEST_CHECK_EQUAL_UNIT( expected[2].x(), transformed.x());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_shortest_segment, CS, tested_types)
+{
+	typedef typename CS::unit_type unit_type;
+	typedef vertex_view< CS, 3> view_type;
+
+	const line< CS> lx( vertex< CS>( 0, 0, 0), direction< CS>( 1, 0, 0));
+	const line< CS> ly( vertex< CS>( 0, 0, 5), direction< CS>( 0, 1, 0));
+	const std::pair< view_type, view_type> segment = shortest_segment< view_type>( lx, ly);
+	BOOST_CHECK( segment.first.owns_coordinates());
+	ALGTEST_CHECK_EQUAL_UNIT( 0, segment.first.z());
+	ALGTEST_CHECK_EQUAL_UNIT( 5, segment.second.z());
+	ALGTEST_CHECK_EQUAL_UNIT( 5, distance( segment.first, segment.second));
+}
+
+} // namespace
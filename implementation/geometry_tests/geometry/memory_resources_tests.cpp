@@ -0,0 +1,191 @@
+#include "geometry/memory/resource_allocator.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "parallel/execution.hpp"
+#include "../tests_common.hpp"
+#include <functional>
+#include <list>
+#include <set>
+#include <vector>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef hcoord_system< 3, double> coord_system;
+
+/// \brief A node of a singly linked list, as used by the node based spatial indices.
+struct index_node
+{
+	std::size_t value;
+	index_node* next;
+};
+
+/// \brief It builds, for each chunk, a list of nodes allocated from the arena of the calling thread.
+struct build_chunk_lists
+{
+	build_chunk_lists( thread_local_arenas* arenas, std::vector< index_node*>* heads)
+		: arenas_( arenas), heads_( heads) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		monotonic_arena& arena = arenas_->local();
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			index_node* node = static_cast< index_node*>( arena.allocate( sizeof( index_node)));
+			node->value = i;
+			node->next = (*heads_)[i];
+			(*heads_)[i] = node;
+		}
+	}
+
+	thread_local_arenas* arenas_;
+	std::vector< index_node*>* heads_;
+};
+
+BOOST_AUTO_TEST_CASE( test_monotonic_arena)
+{
+	monotonic_arena arena( 1024);
+	BOOST_CHECK_EQUAL( std::size_t( 0), arena.allocated());
+	char* first = static_cast< char*>( arena.allocate( 3, 1));
+	char* second = static_cast< char*>( arena.allocate( 8, 8));
+	BOOST_CHECK_EQUAL( std::size_t( 0), reinterpret_cast< std::size_t>( second) % 8);
+	BOOST_CHECK( second >= first + 3 && second < first + 16);
+	BOOST_CHECK_EQUAL( std::size_t( 1024), arena.allocated());
+
+	// Filling the block requests a new one; a large allocation gets its own block.
+	for( int i = 0; i < 100; ++i)
+	{
+		BOOST_CHECK_EQUAL( std::size_t( 0), reinterpret_cast< std::size_t>( arena.allocate( 24)) % 16);
+	}
+	BOOST_CHECK_EQUAL( std::size_t( 4 * 1024), arena.allocated());
+	arena.allocate( 2000);
+	BOOST_CHECK_EQUAL( std::size_t( 4 * 1024 + 2016), arena.allocated());
+
+	arena.release();
+	BOOST_CHECK_EQUAL( std::size_t( 0), arena.allocated());
+	arena.allocate( 10);
+	BOOST_CHECK_EQUAL( std::size_t( 1024), arena.allocated());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_pool_resource)
+{
+	fixed_pool pool( 20, 1024);
+	BOOST_CHECK_EQUAL( std::size_t( 32), pool.block_size());
+	void* a = pool.allocate();
+	void* b = pool.allocate();
+	BOOST_CHECK_EQUAL( static_cast< char*>( a) + 32, static_cast< char*>( b));
+	pool.deallocate( a);
+	BOOST_CHECK_EQUAL( a, pool.allocate());
+
+	pool_resource resource( 1024);
+	void* small = resource.allocate( 10);
+	void* other = resource.allocate( 16);
+	BOOST_CHECK_EQUAL( static_cast< char*>( small) + 16, static_cast< char*>( other));
+	resource.deallocate( small, 10);
+	BOOST_CHECK_EQUAL( small, resource.allocate( 12));
+	void* large = resource.allocate( 1000);
+	BOOST_CHECK_EQUAL( std::size_t( 1024), resource.allocated());
+	resource.deallocate( large, 1000);
+	resource.release();
+	BOOST_CHECK_EQUAL( std::size_t( 0), resource.allocated());
+
+	// The blocks are aligned whatever the alignment of the pages given by the system, and the large or over-aligned
+	// allocations get the requested alignment.
+	for( int i = 0; i < 200; ++i)
+	{
+		BOOST_CHECK_EQUAL( std::size_t( 0), reinterpret_cast< std::size_t>( pool.allocate()) % fixed_pool::ALIGNMENT);
+	}
+	for( std::size_t alignment = 1; alignment <= 256; alignment *= 2)
+	{
+		void* aligned_large = resource.allocate( 1000 + alignment, alignment);
+		void* aligned_small = resource.allocate( 24, alignment);
+		BOOST_CHECK_EQUAL( std::size_t( 0), reinterpret_cast< std::size_t>( aligned_large) % alignment);
+		BOOST_CHECK_EQUAL( std::size_t( 0), reinterpret_cast< std::size_t>( aligned_small) % alignment);
+		resource.deallocate( aligned_large, 1000 + alignment, alignment);
+		resource.deallocate( aligned_small, 24, alignment);
+	}
+	BOOST_CHECK_EQUAL( std::size_t( 1024), resource.allocated());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_allocator_containers)
+{
+	typedef vertex< coord_system> vertex_type;
+	typedef resource_allocator< vertex_type, monotonic_arena> vertex_allocator;
+	typedef resource_allocator< int, pool_resource> int_allocator;
+
+	monotonic_arena arena;
+	{
+		std::vector< vertex_type, vertex_allocator> vertices( ( vertex_allocator( arena)));
+		for( int i = 0; i < 1000; ++i)
+		{
+			vertices.push_back( vertex_type( i, 2 * i, 3 * i));
+		}
+		BOOST_CHECK_EQUAL( 999.0, vertices[999].x());
+		BOOST_CHECK_EQUAL( 1998.0, vertices[999].y());
+		BOOST_CHECK( arena.allocated() > 0);
+	}
+	arena.release();
+
+	pool_resource pool;
+	const std::less< int> less;
+	std::set< int, std::less< int>, int_allocator> indices( less, int_allocator( pool));
+	for( int i = 0; i < 1000; ++i)
+	{
+		indices.insert( (i * 37) % 1000);
+	}
+	BOOST_CHECK_EQUAL( std::size_t( 1000), indices.size());
+	BOOST_CHECK_EQUAL( 0, *indices.begin());
+	BOOST_CHECK_EQUAL( 999, *indices.rbegin());
+	const std::size_t allocated = pool.allocated();
+
+	// The freed nodes are reused.
+	for( int round = 0; round < 10; ++round)
+	{
+		indices.clear();
+		for( int i = 0; i < 1000; ++i)
+		{
+			indices.insert( i);
+		}
+	}
+	BOOST_CHECK_EQUAL( allocated, pool.allocated());
+
+	// The rebound copies use the same resource.
+	std::list< int, int_allocator> values( indices.begin(), indices.end(), indices.get_allocator());
+	BOOST_CHECK( values.get_allocator() == indices.get_allocator());
+	BOOST_CHECK_EQUAL( &pool, values.get_allocator().resource());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_thread_local_arenas)
+{
+	const std::size_t COUNT = 20000;
+	thread_local_arenas arenas( 4096);
+	std::vector< index_node*> heads( COUNT, static_cast< index_node*>( NULL));
+	parallel::thread_pool pool( 3);
+	for( int round = 0; round < 2; ++round)
+	{
+		parallel::for_each_chunk( parallel::par.on( pool).grain( 500), 0, COUNT, 1,
+			build_chunk_lists( &arenas, &heads));
+	}
+	BOOST_CHECK( arenas.size() >= 1 && arenas.size() <= 4);
+	BOOST_CHECK( arenas.allocated() >= 2 * COUNT * sizeof( index_node));
+	for( std::size_t i = 0; i < COUNT; ++i)
+	{
+		BOOST_REQUIRE( heads[i] != NULL && heads[i]->next != NULL);
+		BOOST_CHECK_EQUAL( i, heads[i]->value);
+		BOOST_CHECK_EQUAL( i, heads[i]->next->value);
+		BOOST_CHECK( heads[i]->next->next == NULL);
+	}
+
+	arenas.release();
+	BOOST_CHECK_EQUAL( std::size_t( 0), arenas.allocated());
+}
+
+} // namespace
@@ -0,0 +1,318 @@
+#include "geometry/io/xyz_reader.hpp"
+#include "geometry/io/obj_reader.hpp"
+#include "geometry/io/ply_reader.hpp"
+#include "geometry/io/point_batch_source.hpp"
+#include "parallel/pipeline.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <boost/cstdint.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef boost::mpl::list< float, double> tested_types;
+
+const char TEST_FILE[] = "point_readers_tests.tmp";
+
+/// \brief It translates the points of a batch along the X axis.
+struct translate_batch
+{
+	bool operator()( coordinate_arrays< double>& batch) const
+	{
+		for( std::size_t i = 0; i < batch.size(); ++i)
+		{
+			batch.x[i] -= 0.5;
+		}
+		return true;
+	}
+};
+
+/// \brief It checks that the batches hold consecutive points.
+struct check_batch
+{
+	check_batch( std::size_t* count, std::size_t* batches): count_( count), batches_( batches) {}
+
+	void operator()( coordinate_arrays< double>& batch) const
+	{
+		for( std::size_t i = 0; i < batch.size(); ++i, ++*count_)
+		{
+			if( batch.x[i] != double( *count_) || batch.y[i] != -double( *count_))
+			{
+				BOOST_ERROR( "wrong point " << *count_);
+				break;
+			}
+		}
+		++*batches_;
+	}
+
+	std::size_t* count_;
+	std::size_t* batches_;
+};
+
+void write_file( const std::string& content)
+{
+	std::ofstream stream( TEST_FILE, std::ios::out | std::ios::binary);
+	stream.write( content.data(), std::streamsize( content.size()));
+}
+
+/// \brief It appends a binary value to the given text, in the given byte order.
+template< typename T>
+void append_binary( std::string& text, T value, bool big_endian)
+{
+	char bytes[sizeof( T)];
+	std::memcpy( bytes, &value, sizeof( T));
+	const boost::uint32_t one = 1;
+	if( big_endian == (*reinterpret_cast< const unsigned char*>( &one) == 1))
+	{
+		std::reverse( bytes, bytes + sizeof( T));
+	}
+	text.append( bytes, sizeof( T));
+}
+
+BOOST_AUTO_TEST_CASE( test_parse_number)
+{
+	const char* const texts[] = { "0", "-12.5", "+3", ".25", "1e3", "-1.5E-2", "123456789012345678901234",
+		"0.1", "2.2250738585072014e-308", "1.2345678901234567e300", "  ,\t7" };
+	const double values[] = { 0, -12.5, 3, 0.25, 1000, -0.015, 123456789012345678901234.0, 0.1,
+		2.2250738585072014e-308, 1.2345678901234567e300, 7 };
+	for( int i = 0; i < 11; ++i)
+	{
+		const char* current = texts[i];
+		const char* end = current + std::strlen( current);
+		double value;
+		BOOST_CHECK( impl::parse_number( current, end, value));
+		BOOST_CHECK_EQUAL( end, current);
+		BOOST_CHECK_CLOSE( values[i], value, 1e-13);
+	}
+
+	// The values with few digits are correctly rounded.
+	const char exact[] = "-0.3 17.25e-3";
+	const char* current = exact;
+	double value;
+	BOOST_CHECK( impl::parse_number( current, exact + sizeof( exact) - 1, value));
+	BOOST_CHECK_EQUAL( -0.3, value);
+	BOOST_CHECK( impl::parse_number( current, exact + sizeof( exact) - 1, value));
+	BOOST_CHECK_EQUAL( 17.25e-3, value);
+	BOOST_CHECK( !impl::parse_number( current, exact + sizeof( exact) - 1, value));
+
+	const char invalid[] = "-.e5";
+	current = invalid;
+	BOOST_CHECK( !impl::parse_number( current, invalid + sizeof( invalid) - 1, value));
+	BOOST_CHECK_EQUAL( invalid, current);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_xyz_reader, U, tested_types)
+{
+	write_file( "# comment\r\n1 2 3\r\n\r\n-4.5,5e1,6 255 0 0\r\n  7\t8\t9");
+	xyz_reader reader( TEST_FILE);
+	BOOST_REQUIRE( reader.is_open());
+	coordinate_arrays< U> points;
+	BOOST_CHECK_EQUAL( 2U, reader.read( points, 2));
+	BOOST_CHECK_EQUAL( 1U, reader.read( points, 2));
+	BOOST_CHECK_EQUAL( 0U, reader.read( points, 2));
+	BOOST_CHECK( !reader.failed());
+	BOOST_REQUIRE_EQUAL( 3U, points.size());
+	BOOST_CHECK_EQUAL( U( -4.5), points.x[1]);
+	BOOST_CHECK_EQUAL( U( 50), points.y[1]);
+	BOOST_CHECK_EQUAL( U( 6), points.z[1]);
+	BOOST_CHECK_EQUAL( U( 9), points.z[2]);
+
+	write_file( "1 2 3\n1 2\n");
+	reader.open( TEST_FILE);
+	points.clear();
+	BOOST_CHECK_EQUAL( 1U, reader.read( points, 10));
+	BOOST_CHECK( reader.failed());
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_xyz_reader_large_file)
+{
+	// The file is larger than the input buffer, so the lines cross the buffer boundaries.
+	const int COUNT = 200000;
+	{
+		std::ofstream stream( TEST_FILE, std::ios::out | std::ios::binary);
+		for( int i = 0; i < COUNT; ++i)
+		{
+			stream << i << ".5 " << -i << " " << (i % 1000) << ".125\n";
+		}
+	}
+	xyz_reader reader( TEST_FILE);
+	coordinate_arrays< double> points;
+	while( reader.read( points, 30000) > 0)
+	{
+	}
+	BOOST_CHECK( !reader.failed());
+	BOOST_REQUIRE_EQUAL( std::size_t( COUNT), points.size());
+	for( int i = 0; i < COUNT; ++i)
+	{
+		if( points.x[i] != i + 0.5 || points.y[i] != -i || points.z[i] != (i % 1000) + 0.125)
+		{
+			BOOST_ERROR( "wrong point " << i);
+			break;
+		}
+	}
+	reader.close();
+
+	// The batches are read by the pipeline while the previous ones are processed.
+	BOOST_REQUIRE( reader.open( TEST_FILE));
+	std::size_t count = 0, batches = 0;
+	parallel::pipeline< coordinate_arrays< double> > p( 2);
+	p.source( point_batches< double>( reader, 7000)).stage( translate_batch()).sink( check_batch( &count, &batches));
+	BOOST_CHECK( p.run());
+	BOOST_CHECK( !reader.failed());
+	BOOST_CHECK_EQUAL( std::size_t( COUNT), count);
+	BOOST_CHECK_EQUAL( std::size_t( (COUNT + 6999) / 7000), batches);
+	reader.close();
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_obj_reader, U, tested_types)
+{
+	write_file( "# cube\nmtllib a.mtl\nv 1 2 3\nvn 0 0 1\nvt 0.5 0.5\n v -1 -2 -3 1.0\nf 1 2 3\nv 4 5 6\n");
+	obj_reader reader( TEST_FILE);
+	coordinate_arrays< U> points;
+	BOOST_CHECK_EQUAL( 3U, reader.read( points, 10));
+	BOOST_CHECK_EQUAL( 0U, reader.read( points, 10));
+	BOOST_CHECK( !reader.failed());
+	BOOST_REQUIRE_EQUAL( 3U, points.size());
+	BOOST_CHECK_EQUAL( U( -2), points.y[1]);
+	BOOST_CHECK_EQUAL( U( 6), points.z[2]);
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_ply_reader_ascii, U, tested_types)
+{
+	write_file(
+		"ply\nformat ascii 1.0\ncomment test\n"
+		"element camera 1\nproperty float px\nproperty list uchar int ids\n"
+		"element vertex 3\nproperty float z\nproperty list uchar float extra\nproperty double x\nproperty float y\n"
+		"element face 1\nproperty list uchar int vertex_indices\nend_header\n"
+		"0.5 2 7 8\n"
+		"3 0 0 1\n6 2 9 9 5 4\n9 1 1 7 8\n"
+		"3 0 1 2\n");
+	ply_reader reader( TEST_FILE);
+	BOOST_REQUIRE( !reader.failed());
+	BOOST_CHECK_EQUAL( 3U, reader.vertex_count());
+	coordinate_arrays< U> points;
+	BOOST_CHECK_EQUAL( 3U, reader.read( points, 10));
+	BOOST_CHECK_EQUAL( 0U, reader.read( points, 10));
+	BOOST_CHECK( !reader.failed());
+	BOOST_REQUIRE_EQUAL( 3U, points.size());
+	BOOST_CHECK_EQUAL( U( 0), points.x[0]);
+	BOOST_CHECK_EQUAL( U( 1), points.y[0]);
+	BOOST_CHECK_EQUAL( U( 3), points.z[0]);
+	BOOST_CHECK_EQUAL( U( 5), points.x[1]);
+	BOOST_CHECK_EQUAL( U( 4), points.y[1]);
+	BOOST_CHECK_EQUAL( U( 6), points.z[1]);
+	BOOST_CHECK_EQUAL( U( 8), points.y[2]);
+
+	// Closing forgets the header.
+	reader.close();
+	BOOST_CHECK( !reader.is_open());
+	BOOST_CHECK( !reader.failed());
+	BOOST_CHECK_EQUAL( 0U, reader.vertex_count());
+	BOOST_CHECK_EQUAL( 0U, reader.read( points, 10));
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+
+	const ply_reader unopened;
+	BOOST_CHECK( !unopened.is_open());
+	BOOST_CHECK( !unopened.failed());
+	BOOST_CHECK_EQUAL( 0U, unopened.vertex_count());
+
+	// The list counts which are not non-negative integers, or exceed the values of the line, fail the record.
+	static const char* const COUNTS[] = { "-1", "1.5", "1e30", "4" };
+	for( int i = 0; i < 4; ++i)
+	{
+		write_file( std::string( "ply\nformat ascii 1.0\nelement vertex 1\nproperty list uchar float extra\n"
+			"property float x\nproperty float y\nproperty float z\nend_header\n") + COUNTS[i] + " 7 1 2 3\n");
+		ply_reader invalid( TEST_FILE);
+		BOOST_CHECK_EQUAL( 0U, invalid.read( points, 10));
+		BOOST_CHECK( invalid.failed());
+	}
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_ply_reader_binary, U, tested_types)
+{
+	for( int big_endian = 0; big_endian < 2; ++big_endian)
+	{
+		std::string content = "ply\n";
+		content += big_endian ? "format binary_big_endian 1.0\n" : "format binary_little_endian 1.0\n";
+		content += "element material 1\nproperty list uchar ushort ids\n"
+			"element vertex 1000\nproperty float x\nproperty short y\nproperty double z\nproperty uchar red\n"
+			"end_header\n";
+		append_binary( content, boost::uint8_t( 2), big_endian != 0);
+		append_binary( content, boost::uint16_t( 1), big_endian != 0);
+		append_binary( content, boost::uint16_t( 2), big_endian != 0);
+		for( int i = 0; i < 1000; ++i)
+		{
+			append_binary( content, float( i) / 4, big_endian != 0);
+			append_binary( content, boost::int16_t( -i), big_endian != 0);
+			append_binary( content, double( i) * 1e-3, big_endian != 0);
+			append_binary( content, boost::uint8_t( 255), big_endian != 0);
+		}
+		write_file( content);
+
+		ply_reader reader( TEST_FILE);
+		BOOST_REQUIRE( !reader.failed());
+		coordinate_arrays< U> points;
+		while( reader.read( points, 300) > 0)
+		{
+		}
+		BOOST_CHECK( !reader.failed());
+		BOOST_REQUIRE_EQUAL( 1000U, points.size());
+		for( int i = 0; i < 1000; ++i)
+		{
+			BOOST_CHECK_EQUAL( U( float( i) / 4), points.x[i]);
+			BOOST_CHECK_EQUAL( U( -i), points.y[i]);
+			BOOST_CHECK_EQUAL( U( double( i) * 1e-3), points.z[i]);
+		}
+	}
+
+	// Truncated file.
+	write_file( "ply\nformat binary_little_endian 1.0\nelement vertex 2\nproperty float x\nproperty float y\n"
+		"property float z\nend_header\n0123456789ab0123");
+	ply_reader reader( TEST_FILE);
+	coordinate_arrays< U> points;
+	BOOST_CHECK_EQUAL( 1U, reader.read( points, 10));
+	BOOST_CHECK( reader.failed());
+
+	// Negative list count.
+	std::string negative( "ply\nformat binary_little_endian 1.0\nelement vertex 1\nproperty list char float extra\n"
+		"property float x\nproperty float y\nproperty float z\nend_header\n");
+	append_binary( negative, boost::int8_t( -1), false);
+	for( int i = 0; i < 4; ++i)
+	{
+		append_binary( negative, float( i), false);
+	}
+	write_file( negative);
+	BOOST_CHECK( reader.open( TEST_FILE));
+	BOOST_CHECK_EQUAL( 0U, reader.read( points, 10));
+	BOOST_CHECK( reader.failed());
+
+	// Missing coordinate property.
+	write_file( "ply\nformat ascii 1.0\nelement vertex 2\nproperty float x\nproperty float y\nend_header\n");
+	BOOST_CHECK( !reader.open( TEST_FILE));
+	BOOST_CHECK_EQUAL( 0, std::remove( TEST_FILE));
+}
+
+} // namespace
@@ -0,0 +1,197 @@
+#include "geometry/io/tiled_point_store.hpp"
+#include "geometry/homogenous/vertex_statistics.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "../tests_common.hpp"
+#include "../test_traits.hpp"
+#include <boost/mpl/list.hpp>
+#include <limits>
+#include <cstdio>
+#include <cmath>
+
+namespace
+{
+
+using namespace geometry;
+
+typedef boost::mpl::list< float, double> tested_types;
+
+const char STORE_PREFIX[] = "tiled_point_store_tests";
+
+/// \brief It accumulates the number of points and the sum of their coordinates.
+template< typename U>
+struct sum_points
+{
+	sum_points( std::size_t* count, double* sum): count_( count), sum_( sum) {}
+
+	void operator()( const coordinate_arrays< U>& points, std::size_t) const
+	{
+		*count_ += points.size();
+		for( std::size_t i = 0; i < points.size(); ++i)
+		{
+			sum_[0] += points.x[i];
+			sum_[1] += points.y[i];
+			sum_[2] += points.z[i];
+		}
+	}
+
+	std::size_t* count_;
+	double* sum_;
+};
+
+/// \brief It merges the statistics of the tiles.
+template< typename U>
+struct merge_statistics
+{
+	typedef hcoord_system< 3, U> coord_system;
+
+	explicit merge_statistics( vertex_statistics< coord_system>* result): result_( result) {}
+
+	void operator()( const coordinate_arrays< U>& points, std::size_t) const
+	{
+		result_->merge( calculate_statistics< coord_system>( &points.x[0], &points.y[0], &points.z[0], points.size()));
+	}
+
+	vertex_statistics< coord_system>* result_;
+};
+
+/// \brief It translates the points of a tile.
+template< typename U>
+struct translate_points
+{
+	void operator()( coordinate_arrays< U>& points, std::size_t) const
+	{
+		for( std::size_t i = 0; i < points.size(); ++i)
+		{
+			points.x[i] += 1;
+		}
+	}
+};
+
+template< typename U>
+std::size_t build_store( double* sum)
+{
+	const U min[3] = { 0, 0, 0 }, max[3] = { 100, 100, 10 };
+	const unsigned cells[3] = { 4, 4, 1 };
+	// A small buffer, so the tile files are written in several steps.
+	tiled_point_store_builder< U> builder( STORE_PREFIX, min, max, cells, 1000);
+	std::size_t count = 0;
+	sum[0] = sum[1] = sum[2] = 0;
+	for( int i = 0; i < 100; ++i)
+	{
+		for( int j = 0; j < 100; ++j)
+		{
+			const U x = U( i) + U( 0.5), y = U( (j * 37) % 100), z = U( (i + j) % 10);
+			builder.add( x, y, z);
+			sum[0] += x; sum[1] += y; sum[2] += z;
+			++count;
+		}
+	}
+	// Outside the grid: stored in the border tile.
+	builder.add( -5, 200, 3);
+	sum[0] += -5; sum[1] += 200; sum[2] += 3;
+	// Not finite: ignored.
+	builder.add( std::numeric_limits< U>::quiet_NaN(), 1, 1);
+	builder.add( 1, -std::numeric_limits< U>::infinity(), 1);
+	BOOST_CHECK_EQUAL( std::size_t( 2), builder.ignored());
+	BOOST_CHECK( builder.close());
+	return count + 1;
+}
+
+void remove_store()
+{
+	for( int cell = 0; cell < 16; ++cell)
+	{
+		std::remove( impl::tiled_store_format::tile_path( STORE_PREFIX, cell).c_str());
+	}
+	BOOST_CHECK_EQUAL( 0, std::remove( impl::tiled_store_format::index_path( STORE_PREFIX).c_str()));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_stream_tiles, U, tested_types)
+{
+	double expected_sum[3];
+	const std::size_t expected_count = build_store< U>( expected_sum);
+
+	// The budget keeps about two tiles.
+	const std::size_t tile_bytes = expected_count / 16 * 3 * sizeof( U);
+	tiled_point_store< U> store( STORE_PREFIX, 2 * tile_bytes + tile_bytes / 2);
+	BOOST_REQUIRE( store.is_open());
+	BOOST_CHECK_EQUAL( 16U, store.tile_count());
+
+	std::size_t count = 0;
+	double sum[3] = { 0, 0, 0 };
+	BOOST_CHECK( store.for_each_tile( sum_points< U>( &count, sum)));
+	BOOST_CHECK( !store.failed());
+	BOOST_CHECK_EQUAL( expected_count, count);
+	// The prefetched tiles are not dropped before they are used, so each tile is read once.
+	BOOST_CHECK_EQUAL( std::size_t( 16), store.tile_reads());
+	for( int i = 0; i < 3; ++i)
+	{
+		BOOST_CHECK_CLOSE( expected_sum[i], sum[i], 1e-6);
+	}
+	BOOST_CHECK( store.cached_size() <= 2 * tile_bytes + tile_bytes / 2 + 3 * sizeof( U));
+
+	// The tiles hold the points of their cells.
+	for( std::size_t t = 0; t < store.tile_count(); ++t)
+	{
+		U min[3], max[3];
+		store.tile_bounds( t, min, max);
+		const typename tiled_point_store< U>::tile_pointer points = store.tile( t);
+		BOOST_REQUIRE( points);
+		BOOST_CHECK_EQUAL( store.point_count( t), points->size());
+		for( std::size_t i = 0; i < points->size(); ++i)
+		{
+			BOOST_CHECK( min[0] <= points->x[i] && points->x[i] <= max[0]);
+			BOOST_CHECK( min[1] <= points->y[i] && points->y[i] <= max[1]);
+		}
+		BOOST_CHECK( max[0] - min[0] <= 25 || min[0] < 0);
+	}
+
+	// Only the tiles intersecting the box are visited.
+	const U box_min[3] = { 10, 10, 0 }, box_max[3] = { 20, 20, 10 };
+	count = 0;
+	BOOST_CHECK( store.query( box_min, box_max, sum_points< U>( &count, sum)));
+	BOOST_CHECK( count > 0);
+	BOOST_CHECK( count <= expected_count / 16 + 1);
+
+	// Reduction over the tiles.
+	vertex_statistics< hcoord_system< 3, U> > statistics;
+	BOOST_CHECK( store.for_each_tile( merge_statistics< U>( &statistics)));
+	BOOST_CHECK_EQUAL( expected_count, statistics.count());
+	BOOST_CHECK_CLOSE( expected_sum[0] / expected_count, double( statistics.centroid().x()), 1e-3);
+
+	store.close();
+	remove_store();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE_TEMPLATE( test_update_tiles, U, tested_types)
+{
+	double expected_sum[3];
+	const std::size_t expected_count = build_store< U>( expected_sum);
+	{
+		tiled_point_store< U> store( STORE_PREFIX, 1);
+		BOOST_REQUIRE( store.is_open());
+		BOOST_CHECK( store.update_tiles( translate_points< U>()));
+		// No tile fits in the budget, so nothing is prefetched and read twice.
+		BOOST_CHECK_EQUAL( std::size_t( 16), store.tile_reads());
+	}
+
+	tiled_point_store< U> store( STORE_PREFIX, 1 << 30);
+	BOOST_REQUIRE( store.is_open());
+	std::size_t count = 0;
+	double sum[3] = { 0, 0, 0 };
+	BOOST_CHECK( store.for_each_tile( sum_points< U>( &count, sum)));
+	BOOST_CHECK_EQUAL( expected_count, count);
+	BOOST_CHECK_CLOSE( expected_sum[0] + expected_count, sum[0], 1e-6);
+	U min[3], max[3];
+	store.tile_bounds( 0, min, max);
+	BOOST_CHECK_EQUAL( U( 1.5), min[0]);
+
+	store.close();
+	remove_store();
+
+	BOOST_CHECK( !store.open( STORE_PREFIX, 1));
+}
+
+} // namespace
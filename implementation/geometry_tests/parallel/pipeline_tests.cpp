@@ -0,0 +1,311 @@
+#include "parallel/pipeline.hpp"
+#include "geometry/io/coordinate_arrays.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "geometry/homogenous/vertex.hpp"
+#include "geometry/homogenous/distances.hpp"
+#include "geometry/plane.hpp"
+#include "../tests_common.hpp"
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+using namespace geometry;
+using namespace parallel;
+
+typedef hcoord_system< 3, double> coord_system;
+
+/// \brief A batch of points, with its position in the stream.
+struct point_batch
+{
+	std::size_t index;
+	coordinate_arrays< double> points;
+};
+
+/// \brief It keeps the statistics of the batches in flight.
+struct flow_statistics
+{
+	flow_statistics(): produced( 0), consumed( 0), in_flight( 0), max_in_flight( 0) {}
+
+	void produce()
+	{
+		boost::mutex::scoped_lock lock( mutex);
+		++produced;
+		max_in_flight = std::max( max_in_flight, ++in_flight);
+	}
+
+	void release()
+	{
+		boost::mutex::scoped_lock lock( mutex);
+		--in_flight;
+	}
+
+	boost::mutex mutex;
+	std::size_t produced;
+	std::size_t consumed;
+	std::size_t in_flight;
+	std::size_t max_in_flight;
+};
+
+/// \brief It produces the given number of batches, each having points at heights -1, 0 and 1.
+struct generate_batches
+{
+	generate_batches( std::size_t count, flow_statistics* stats): count_( count), stats_( stats) {}
+
+	bool operator()( point_batch& batch) const
+	{
+		if( stats_->produced == count_)
+		{
+			return false;
+		}
+		stats_->produce();
+		batch.index = stats_->produced - 1;
+		batch.points.clear();
+		for( int i = 0; i < 300; ++i)
+		{
+			batch.points.push_back( double( batch.index), double( i), double( i % 3 - 1));
+		}
+		return true;
+	}
+
+	std::size_t count_;
+	flow_statistics* stats_;
+};
+
+/// \brief It translates the points of a batch.
+struct translate_batch
+{
+	bool operator()( point_batch& batch) const
+	{
+		for( std::size_t i = 0; i < batch.points.size(); ++i)
+		{
+			batch.points.x[i] += 1;
+		}
+		return true;
+	}
+};
+
+/// \brief It keeps the points above the plane, and drops the batches having the given index.
+struct filter_batch
+{
+	filter_batch( const plane< coord_system>& p, std::size_t dropped, flow_statistics* stats)
+		: plane_( p), dropped_( dropped), stats_( stats) {}
+
+	bool operator()( point_batch& batch) const
+	{
+		if( batch.index == dropped_)
+		{
+			stats_->release();
+			return false;
+		}
+		coordinate_arrays< double> kept;
+		for( std::size_t i = 0; i < batch.points.size(); ++i)
+		{
+			const vertex< coord_system> v( batch.points.x[i], batch.points.y[i], batch.points.z[i]);
+			if( distance( v, plane_) > 0.5)
+			{
+				kept.push_back( v.x(), v.y(), v.z());
+			}
+		}
+		std::swap( kept.x, batch.points.x);
+		std::swap( kept.y, batch.points.y);
+		std::swap( kept.z, batch.points.z);
+		return true;
+	}
+
+	plane< coord_system> plane_;
+	std::size_t dropped_;
+	flow_statistics* stats_;
+};
+
+/// \brief It checks and counts the batches reaching the end of the pipeline.
+struct collect_batches
+{
+	collect_batches( flow_statistics* stats, std::vector< std::size_t>* order, pipeline< point_batch>* cancelled,
+		std::size_t cancel_at)
+		: stats_( stats), order_( order), cancelled_( cancelled), cancel_at_( cancel_at) {}
+
+	void operator()( point_batch& batch) const
+	{
+		stats_->release();
+		++stats_->consumed;
+		order_->push_back( batch.index);
+		BOOST_CHECK_EQUAL( double( batch.index + 1), batch.points.x[0]);
+		if( stats_->consumed == cancel_at_)
+		{
+			cancelled_->cancel();
+		}
+	}
+
+	flow_statistics* stats_;
+	std::vector< std::size_t>* order_;
+	pipeline< point_batch>* cancelled_;
+	std::size_t cancel_at_;
+};
+
+/// \brief It throws the given exception when it reaches the batch having the given index.
+template< typename E>
+struct throw_at_batch
+{
+	throw_at_batch( std::size_t index, const E& error): index_( index), error_( error) {}
+
+	bool operator()( point_batch& batch) const
+	{
+		if( batch.index == index_)
+		{
+			throw error_;
+		}
+		return true;
+	}
+
+	std::size_t index_;
+	E error_;
+};
+
+/// \brief The exception thrown by the sink of the tests.
+struct sink_error {};
+
+/// \brief It consumes the batches, throwing sink_error when it reaches the batch having the given index.
+struct failing_sink
+{
+	explicit failing_sink( std::size_t index): index_( index) {}
+
+	void operator()( point_batch& batch) const
+	{
+		if( batch.index == index_)
+		{
+			throw sink_error();
+		}
+	}
+
+	std::size_t index_;
+};
+
+BOOST_AUTO_TEST_CASE( test_bounded_queue)
+{
+	bounded_queue< int> queue( 2);
+	BOOST_CHECK( queue.push( 1));
+	BOOST_CHECK( queue.push( 2));
+	BOOST_CHECK_EQUAL( std::size_t( 2), queue.size());
+	int item = 0;
+	BOOST_CHECK( queue.pop( item));
+	BOOST_CHECK_EQUAL( 1, item);
+	queue.close();
+	BOOST_CHECK( queue.pop( item));
+	BOOST_CHECK_EQUAL( 2, item);
+	BOOST_CHECK( !queue.pop( item));
+
+	bounded_queue< int> cancelled( 1);
+	cancelled.push( 1);
+	cancelled.cancel();
+	BOOST_CHECK( !cancelled.push( 2));
+	BOOST_CHECK( !cancelled.pop( item));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_pipeline_order)
+{
+	flow_statistics stats;
+	std::vector< std::size_t> order;
+	pipeline< point_batch> p( 2);
+	const plane< coord_system> floor( 0, 0, 1, 0);
+	p.source( generate_batches( 200, &stats))
+		.stage( translate_batch())
+		.stage( filter_batch( floor, 7, &stats))
+		.sink( collect_batches( &stats, &order, &p, 0));
+	BOOST_CHECK( p.run());
+	BOOST_CHECK_EQUAL( std::size_t( 200), stats.produced);
+	BOOST_REQUIRE_EQUAL( std::size_t( 199), order.size());
+	for( std::size_t i = 0; i < order.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( i < 7 ? i : i + 1, order[i]);
+	}
+	// The queues limit the batches in flight: two per queue, and one per thread.
+	BOOST_CHECK_EQUAL( std::size_t( 0), stats.in_flight);
+	BOOST_CHECK( stats.max_in_flight <= 3 * 2 + 4);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_pipeline_threads)
+{
+	flow_statistics stats;
+	std::vector< std::size_t> order;
+	pipeline< point_batch> p( 3);
+	const plane< coord_system> floor( 0, 0, 1, 0);
+	p.source( generate_batches( 300, &stats))
+		.stage( translate_batch(), 3)
+		.stage( filter_batch( floor, 1000, &stats), 2)
+		.sink( collect_batches( &stats, &order, &p, 0));
+	BOOST_CHECK( p.run());
+	BOOST_REQUIRE_EQUAL( std::size_t( 300), order.size());
+	std::sort( order.begin(), order.end());
+	for( std::size_t i = 0; i < order.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( i, order[i]);
+	}
+
+	// The pipeline can be run again.
+	stats.produced = 290;
+	BOOST_CHECK( p.run());
+	BOOST_CHECK_EQUAL( std::size_t( 310), order.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_pipeline_cancel)
+{
+	flow_statistics stats;
+	std::vector< std::size_t> order;
+	pipeline< point_batch> p( 2);
+	const plane< coord_system> floor( 0, 0, 1, 0);
+	p.source( generate_batches( 100000, &stats))
+		.stage( translate_batch(), 2)
+		.stage( filter_batch( floor, 100000, &stats))
+		.sink( collect_batches( &stats, &order, &p, 10));
+	BOOST_CHECK( !p.run());
+	BOOST_CHECK( p.cancelled());
+	BOOST_CHECK_EQUAL( std::size_t( 10), order.size());
+	BOOST_CHECK( stats.produced < 100);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_pipeline_exceptions)
+{
+	flow_statistics stats;
+	std::vector< std::size_t> order;
+	pipeline< point_batch> p( 2);
+	p.source( generate_batches( 100000, &stats))
+		.stage( translate_batch())
+		.stage( throw_at_batch< std::runtime_error>( 20, std::runtime_error( "stage failed")), 2)
+		.sink( collect_batches( &stats, &order, &p, 0));
+	// The exception of a stage cancels the pipeline, and it is rethrown after all the threads stopped.
+	BOOST_CHECK_THROW( p.run(), task_error);
+	BOOST_CHECK( p.cancelled());
+	BOOST_CHECK( stats.produced < 100);
+
+	pipeline< point_batch> q( 2);
+	stats.produced = 0;
+	q.source( generate_batches( 100000, &stats))
+		.stage( translate_batch())
+		.stage( throw_at_batch< std::bad_alloc>( 5, std::bad_alloc()))
+		.sink( collect_batches( &stats, &order, &q, 0));
+	BOOST_CHECK_THROW( q.run(), std::bad_alloc);
+
+	// The exception of the sink is rethrown as it is.
+	pipeline< point_batch> r( 2);
+	stats.produced = 0;
+	r.source( generate_batches( 100000, &stats))
+		.stage( translate_batch(), 2)
+		.sink( failing_sink( 3));
+	BOOST_CHECK_THROW( r.run(), sink_error);
+	BOOST_CHECK( stats.produced < 100);
+}
+
+} // namespace
@@ -0,0 +1,231 @@
+#include "parallel/placement.hpp"
+#include "geometry/homogenous/vertex_statistics.hpp"
+#include "geometry/homogenous/hcoord_system.hpp"
+#include "../tests_common.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+using namespace parallel;
+
+/// \brief It records the thread running a task.
+void record_thread( std::vector< boost::thread::id>* threads, std::size_t index)
+{
+	(*threads)[index] = boost::this_thread::get_id();
+}
+
+/// \brief It records the thread processing each chunk, and counts the visits of each element.
+struct record_owners
+{
+	record_owners( boost::mutex* mutex, std::map< std::size_t, boost::thread::id>* owners, std::vector< int>* visits)
+		: mutex_( mutex), owners_( owners), visits_( visits) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			++(*visits_)[i];
+		}
+		boost::mutex::scoped_lock lock( *mutex_);
+		(*owners_)[begin] = boost::this_thread::get_id();
+	}
+
+	boost::mutex* mutex_;
+	std::map< std::size_t, boost::thread::id>* owners_;
+	std::vector< int>* visits_;
+};
+
+/// \brief It runs an affine loop from inside a task.
+struct nested_affine
+{
+	nested_affine( thread_pool* pool, std::vector< int>* visits): pool_( pool), visits_( visits) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		boost::mutex mutex;
+		std::map< std::size_t, boost::thread::id> owners;
+		std::vector< int> inner( 1000);
+		for_each_chunk( par.on( *pool_).affine(), 0, inner.size(), 1, record_owners( &mutex, &owners, &inner));
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			(*visits_)[i] = static_cast< int>( std::count( inner.begin(), inner.end(), 1));
+		}
+	}
+
+	thread_pool* pool_;
+	std::vector< int>* visits_;
+};
+
+/// \brief It counts its live instances. Its copy constructor throws when the allowed copies are used up.
+struct counted_element
+{
+	counted_element()
+	{
+		boost::mutex::scoped_lock lock( mutex);
+		++live;
+	}
+
+	counted_element( const counted_element&)
+	{
+		boost::mutex::scoped_lock lock( mutex);
+		if( copies == 0)
+		{
+			throw std::runtime_error( "no more copies");
+		}
+		--copies;
+		++live;
+	}
+
+	~counted_element()
+	{
+		boost::mutex::scoped_lock lock( mutex);
+		--live;
+	}
+
+	static boost::mutex mutex;
+	static int live;
+	static std::size_t copies;
+};
+
+boost::mutex counted_element::mutex;
+int counted_element::live = 0;
+std::size_t counted_element::copies = 0;
+
+BOOST_AUTO_TEST_CASE( test_pinned_tasks)
+{
+	thread_pool pool( 3);
+	BOOST_CHECK_EQUAL( 0u, pool.home_node( 0));
+	BOOST_CHECK( !pool.is_worker_thread());
+	std::vector< boost::thread::id> threads( 3 * 20);
+	{
+		task_group group( pool);
+		for( std::size_t round = 0; round < 20; ++round)
+		{
+			for( unsigned worker = 0; worker < 3; ++worker)
+			{
+				group.run_on( worker, boost::bind( &record_thread, &threads, round * 3 + worker));
+			}
+		}
+		group.wait();
+	}
+	for( std::size_t i = 3; i < threads.size(); ++i)
+	{
+		BOOST_CHECK( threads[i] == threads[i % 3]);
+	}
+	BOOST_CHECK( threads[0] != threads[1] && threads[1] != threads[2] && threads[0] != threads[2]);
+	BOOST_CHECK( threads[0] != boost::this_thread::get_id());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_affine_policies)
+{
+	const std::size_t COUNT = 10001;
+	thread_pool pool( 3);
+	boost::mutex mutex;
+	std::map< std::size_t, boost::thread::id> first, second;
+	std::vector< int> visits( COUNT);
+	for_each_chunk( par.on( pool).affine(), 0, COUNT, 1, record_owners( &mutex, &first, &visits));
+	for_each_chunk( par.on( pool).grain( 10).affine(), 0, COUNT, 1, record_owners( &mutex, &second, &visits));
+	BOOST_CHECK( std::count( visits.begin(), visits.end(), 2) == std::ptrdiff_t( COUNT));
+
+	// One part per worker, always processed by the same worker; the calling thread, not bound to a node, only waits.
+	BOOST_REQUIRE_EQUAL( std::size_t( 3), first.size());
+	BOOST_CHECK( first == second);
+	std::map< std::size_t, boost::thread::id>::const_iterator it = first.begin();
+	for( std::size_t k = 0; k < 3; ++k, ++it)
+	{
+		BOOST_CHECK_EQUAL( COUNT * k / 3, it->first);
+		BOOST_CHECK( it->second != boost::this_thread::get_id());
+	}
+
+	// The vector policy keeps the parts aligned.
+	std::map< std::size_t, boost::thread::id> aligned;
+	for_each_chunk( par_vec.on( pool).affine(), 0, COUNT, 1, record_owners( &mutex, &aligned, &visits));
+	BOOST_CHECK_EQUAL( std::size_t( 3), aligned.size());
+	for( it = aligned.begin(); it != aligned.end(); ++it)
+	{
+		BOOST_CHECK_EQUAL( std::size_t( 0), it->first % parallel_vector_policy::VECTOR_WIDTH);
+	}
+
+	// Called from the workers, the affine loops are balanced by work stealing.
+	std::vector< int> nested( 16);
+	for_each_chunk( par.on( pool).grain( 1), 0, nested.size(), 1, nested_affine( &pool, &nested));
+	BOOST_CHECK( std::count( nested.begin(), nested.end(), 1000) == 16);
+
+	// Without workers, the calling thread processes the whole range.
+	thread_pool alone( 0);
+	std::map< std::size_t, boost::thread::id> single;
+	for_each_chunk( par.on( alone).affine(), 0, COUNT, 1, record_owners( &mutex, &single, &visits));
+	BOOST_REQUIRE_EQUAL( std::size_t( 1), single.size());
+	BOOST_CHECK( single.begin()->second == boost::this_thread::get_id());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_placed_array)
+{
+	typedef geometry::hcoord_system< 3, double> coord_system;
+
+	thread_pool pool( 3);
+	const parallel_policy policy = par.on( pool).affine();
+	const std::size_t COUNT = 600000;
+	placed_array< double> x( policy, COUNT), y( policy, COUNT, 2.0), z( seq, COUNT, -1.0);
+	BOOST_CHECK_EQUAL( COUNT, x.size());
+	BOOST_CHECK( std::count( y.begin(), y.end(), 2.0) == std::ptrdiff_t( COUNT));
+	BOOST_CHECK( std::count( z.begin(), z.end(), -1.0) == std::ptrdiff_t( COUNT));
+	for( std::size_t i = 0; i < COUNT; ++i)
+	{
+		x[i] = double( i % 1000);
+	}
+
+	const geometry::vertex_statistics< coord_system> placed = geometry::calculate_statistics< coord_system>(
+		policy, x.data(), y.data(), z.data(), COUNT);
+	const geometry::vertex_statistics< coord_system> sequential = geometry::calculate_statistics< coord_system>(
+		x.data(), y.data(), z.data(), COUNT);
+	BOOST_CHECK_EQUAL( sequential.count(), placed.count());
+	BOOST_CHECK_EQUAL( sequential.centroid().x(), placed.centroid().x());
+	BOOST_CHECK_EQUAL( 999.0, placed.max_corner().x());
+
+	const placed_array< int> empty( policy, 0);
+	BOOST_CHECK( empty.empty());
+	BOOST_CHECK( empty.begin() == empty.end());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_placed_array_failure)
+{
+	const std::size_t COUNT = 20000;
+	thread_pool pool( 3);
+	counted_element::copies = COUNT;
+	{
+		const placed_array< counted_element> filled( par.on( pool), COUNT);
+		BOOST_CHECK_EQUAL( int( COUNT), counted_element::live);
+	}
+	BOOST_CHECK_EQUAL( 0, counted_element::live);
+
+	// A failed copy destroys the elements constructed by all the chunks.
+	counted_element::copies = COUNT / 2;
+	BOOST_CHECK_THROW( placed_array< counted_element> failed( par.on( pool).grain( 100), COUNT), std::runtime_error);
+	BOOST_CHECK_EQUAL( 0, counted_element::live);
+	counted_element::copies = COUNT / 2;
+	BOOST_CHECK_THROW( placed_array< counted_element> failed( par.on( pool).affine(), COUNT), std::runtime_error);
+	BOOST_CHECK_EQUAL( 0, counted_element::live);
+	counted_element::copies = COUNT / 2;
+	BOOST_CHECK_THROW( placed_array< counted_element> failed( seq, COUNT), std::runtime_error);
+	BOOST_CHECK_EQUAL( 0, counted_element::live);
+
+	// The size in bytes does not fit in std::size_t.
+	BOOST_CHECK_THROW( placed_array< double> huge( seq, std::numeric_limits< std::size_t>::max() / 4), std::bad_alloc);
+}
+
+} // namespace
@@ -0,0 +1,235 @@
+#include "parallel/execution.hpp"
+#include "../tests_common.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/static_assert.hpp>
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+using namespace parallel;
+
+/// \brief It counts the visits of each element of a range.
+struct visit_elements
+{
+	explicit visit_elements( std::vector< int>* visits): visits_( visits) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			++(*visits_)[i];
+		}
+	}
+
+	std::vector< int>* visits_;
+};
+
+/// \brief It runs a nested parallel loop for each element of the outer range.
+struct visit_nested
+{
+	visit_nested( thread_pool* pool, std::vector< int>* visits, std::size_t inner)
+		: pool_( pool), visits_( visits), inner_( inner) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			// Each inner range has its own elements, so there are no concurrent increments.
+			std::vector< int> inner_visits( inner_);
+			parallel_for( *pool_, 0, inner_, 7, visit_elements( &inner_visits));
+			for( std::size_t j = 0; j < inner_; ++j)
+			{
+				(*visits_)[i * inner_ + j] += inner_visits[j];
+			}
+		}
+	}
+
+	thread_pool* pool_;
+	std::vector< int>* visits_;
+	std::size_t inner_;
+};
+
+/// \brief It records the boundaries of the chunks.
+struct record_chunks
+{
+	record_chunks( boost::mutex* mutex, std::vector< std::size_t>* begins): mutex_( mutex), begins_( begins) {}
+
+	void operator()( std::size_t begin, std::size_t) const
+	{
+		boost::mutex::scoped_lock lock( *mutex_);
+		begins_->push_back( begin);
+	}
+
+	boost::mutex* mutex_;
+	std::vector< std::size_t>* begins_;
+};
+
+/// \brief It calculates the Fibonacci numbers recursively, each call being a task.
+void fibonacci( thread_pool* pool, unsigned n, unsigned long* result)
+{
+	if( n < 2)
+	{
+		*result = n;
+		return;
+	}
+	unsigned long first = 0, second = 0;
+	task_group group( *pool);
+	group.run( boost::bind( &fibonacci, pool, n - 1, &first));
+	fibonacci( pool, n - 2, &second);
+	group.wait();
+	*result = first + second;
+}
+
+/// \brief It throws for the chunks containing the given element, and counts the visits of the others.
+struct throw_at
+{
+	throw_at( std::vector< int>* visits, std::size_t bad): visits_( visits), bad_( bad) {}
+
+	void operator()( std::size_t begin, std::size_t end) const
+	{
+		if( begin <= bad_ && bad_ < end)
+		{
+			throw std::runtime_error( "bad element");
+		}
+		for( std::size_t i = begin; i < end; ++i)
+		{
+			++(*visits_)[i];
+		}
+	}
+
+	std::vector< int>* visits_;
+	std::size_t bad_;
+};
+
+void throw_bad_alloc()
+{
+	throw std::bad_alloc();
+}
+
+void throw_int()
+{
+	throw 5;
+}
+
+BOOST_AUTO_TEST_CASE( test_task_groups)
+{
+	const unsigned workers[] = { 0, 1, 3 };
+	for( unsigned w = 0; w < 3; ++w)
+	{
+		thread_pool pool( workers[w]);
+		BOOST_CHECK_EQUAL( workers[w] + 1, pool.size());
+		unsigned long result = 0;
+		fibonacci( &pool, 20, &result);
+		BOOST_CHECK_EQUAL( 6765UL, result);
+	}
+	BOOST_CHECK( default_thread_pool().size() >= 1U);
+	BOOST_CHECK_EQUAL( &default_thread_pool(), &par.pool());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_task_exceptions)
+{
+	const unsigned workers[] = { 0, 3 };
+	for( unsigned w = 0; w < 2; ++w)
+	{
+		thread_pool pool( workers[w]);
+		std::vector< int> visits( 1000);
+		{
+			task_group group( pool);
+			group.run( boost::bind< void>( throw_at( &visits, 0), 0, 1));
+			for( std::size_t i = 1; i < visits.size(); ++i)
+			{
+				group.run( boost::bind< void>( visit_elements( &visits), i, i + 1));
+			}
+			BOOST_CHECK_THROW( group.wait(), task_error);
+			BOOST_CHECK_EQUAL( 999, std::count( visits.begin(), visits.end(), 1));
+
+			// The exception is rethrown once; the group can be used again.
+			group.wait();
+			group.run( &throw_bad_alloc);
+			BOOST_CHECK_THROW( group.wait(), std::bad_alloc);
+			group.run( &throw_int);
+			BOOST_CHECK_THROW( group.wait(), task_error);
+
+			// The destructor does not rethrow.
+			group.run( &throw_int);
+		}
+
+		// The other chunks of a loop are processed before the exception reaches the caller.
+		std::fill( visits.begin(), visits.end(), 0);
+		BOOST_CHECK_THROW( parallel_for( pool, 0, visits.size(), 10, throw_at( &visits, 15)), std::runtime_error);
+		BOOST_CHECK_EQUAL( 0, visits[15]);
+		BOOST_CHECK( std::count( visits.begin(), visits.end(), 0) <= 10);
+		BOOST_CHECK_EQUAL( 0, std::count( visits.begin(), visits.end(), 2));
+		std::fill( visits.begin(), visits.end(), 0);
+		BOOST_CHECK_THROW( for_each_chunk( par.on( pool).affine(), 0, visits.size(), 1, throw_at( &visits, 999)),
+			std::runtime_error);
+		const std::size_t parts = std::max( workers[w], 1U);
+		BOOST_CHECK_EQUAL( std::ptrdiff_t( visits.size() * (parts - 1) / parts),
+			std::count( visits.begin(), visits.end(), 1));
+
+		// The pool keeps working.
+		unsigned long result = 0;
+		fibonacci( &pool, 15, &result);
+		BOOST_CHECK_EQUAL( 610UL, result);
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_parallel_for)
+{
+	thread_pool pool( 3);
+	std::vector< int> visits( 100000);
+	parallel_for( pool, 0, visits.size(), 1000, visit_elements( &visits));
+	BOOST_CHECK_EQUAL( std::size_t( 0), std::size_t( std::count( visits.begin(), visits.end(), 0)));
+	BOOST_CHECK_EQUAL( visits.size(), std::size_t( std::count( visits.begin(), visits.end(), 1)));
+
+	// Nested loops in the same pool.
+	const std::size_t outer = 50, inner = 300;
+	std::vector< int> nested_visits( outer * inner);
+	parallel_for( pool, 0, outer, 1, visit_nested( &pool, &nested_visits, inner));
+	BOOST_CHECK_EQUAL( nested_visits.size(),
+		std::size_t( std::count( nested_visits.begin(), nested_visits.end(), 1)));
+
+	// Empty range.
+	parallel_for( pool, 5, 5, 1, visit_elements( &visits));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE( test_policies)
+{
+	BOOST_STATIC_ASSERT( is_execution_policy< sequenced_policy>::value);
+	BOOST_STATIC_ASSERT( is_execution_policy< parallel_vector_policy>::value);
+	BOOST_STATIC_ASSERT( !is_execution_policy< int>::value);
+
+	thread_pool pool( 2);
+	BOOST_CHECK_EQUAL( 1U, concurrency( seq));
+	BOOST_CHECK_EQUAL( 3U, concurrency( par.on( pool)));
+	BOOST_CHECK_EQUAL( std::size_t( 10), par.grain( 10).grain_for( 1000, 100));
+	BOOST_CHECK_EQUAL( std::size_t( 100), par.on( pool).grain_for( 1000, 100));
+
+	boost::mutex mutex;
+	std::vector< std::size_t> begins;
+	for_each_chunk( seq, 3, 1000, 1, record_chunks( &mutex, &begins));
+	BOOST_REQUIRE_EQUAL( std::size_t( 1), begins.size());
+	BOOST_CHECK_EQUAL( std::size_t( 3), begins[0]);
+
+	// The vector policy keeps the chunks aligned to the vector width.
+	begins.clear();
+	for_each_chunk( par_vec.on( pool).grain( 50), 0, 1000, 1, record_chunks( &mutex, &begins));
+	BOOST_CHECK( begins.size() > 1);
+	for( std::size_t i = 0; i < begins.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL( std::size_t( 0), begins[i] % parallel_vector_policy::VECTOR_WIDTH);
+	}
+}
+
+} // namespace
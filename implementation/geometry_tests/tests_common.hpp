@@ -11,6 +11,9 @@
 #include <boost/test/test_case_template.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 #include <boost/test/test_tools.hpp>
+#include <vector>
+#include <cmath>
+#include <cstddef>
 
 typedef boost::mpl::list< float, double> algebraic_types;
 
@@ -31,4 +34,43 @@ typedef boost::mpl::list< float, double> algebraic_types;
 		BOOST_CHECK_MESSAGE( !unit_traits_type::is_valid_number( E), oss.str()); \
 	}
 
+/// \brief It creates a 2D or 3D vertex from the first coordinates of the given ones.
+template< typename V, unsigned D = V::coord_system::DIMENSIONS>
+struct sample_vertex_factory;
+
+template< typename V>
+struct sample_vertex_factory< V, 2>
+{
+	typedef typename V::unit_type unit_type;
+
+	static V create( const double* c) { return V( unit_type( c[0]), unit_type( c[1])); }
+};
+
+template< typename V>
+struct sample_vertex_factory< V, 3>
+{
+	typedef typename V::unit_type unit_type;
+
+	static V create( const double* c) { return V( unit_type( c[0]), unit_type( c[1]), unit_type( c[2])); }
+};
+
+/// \brief It creates vertices spread irregularly in the cube of the given center and half side, the same way for 2D
+///		and 3D vertices.
+/// \details The coordinates are calculated in double precision, so the centers far from the origin keep the spread.
+template< typename V>
+std::vector< V> sample_vertices( std::size_t count, double center = 0, double half_side = 1)
+{
+	std::vector< V> result;
+	result.reserve( count);
+	for( std::size_t i = 0; i < count; ++i)
+	{
+		const double coordinates[3] = {
+			center + half_side * (double( (i * 37) % 101) / 50 - 1),
+			center + half_side * std::sin( double( i)),
+			center + half_side * (double( (i * 53) % 89) / 44 - 1) };
+		result.push_back( sample_vertex_factory< V>::create( coordinates));
+	}
+	return result;
+}
+
 #endif // TESTS_COMMON_HPP